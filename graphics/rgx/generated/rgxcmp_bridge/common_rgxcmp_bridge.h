@@ -60,6 +60,11 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #define PVRSRV_BRIDGE_RGXCMP_RGXSETCOMPUTECONTEXTPRIORITY			PVRSRV_IOWR(PVRSRV_BRIDGE_RGXCMP_CMD_FIRST+4)
 #define PVRSRV_BRIDGE_RGXCMP_CMD_LAST			(PVRSRV_BRIDGE_RGXCMP_CMD_FIRST+4)
 
+#define PVRSRV_BRIDGE_RGXCMP2_CMD_FIRST			(PVRSRV_BRIDGE_RGXCMP2_START)
+#define PVRSRV_BRIDGE_RGXCMP_RGXBINDCOMPUTESYNCS			PVRSRV_IOWR(PVRSRV_BRIDGE_RGXCMP2_CMD_FIRST+0)
+#define PVRSRV_BRIDGE_RGXCMP_RGXKICKCDMBOUND			PVRSRV_IOWR(PVRSRV_BRIDGE_RGXCMP2_CMD_FIRST+1)
+#define PVRSRV_BRIDGE_RGXCMP2_CMD_LAST			(PVRSRV_BRIDGE_RGXCMP2_CMD_FIRST+1)
+
 
 /*******************************************
             RGXCreateComputeContext          
@@ -165,4 +170,53 @@ typedef struct PVRSRV_BRIDGE_OUT_RGXSETCOMPUTECONTEXTPRIORITY_TAG
 	PVRSRV_ERROR eError;
 } PVRSRV_BRIDGE_OUT_RGXSETCOMPUTECONTEXTPRIORITY;
 
+/*******************************************
+            RGXBindComputeSyncs          
+ *******************************************/
+
+/* Bridge in structure for RGXBindComputeSyncs */
+typedef struct PVRSRV_BRIDGE_IN_RGXBINDCOMPUTESYNCS_TAG
+{
+	IMG_HANDLE hComputeContext;
+	IMG_UINT32 ui32UnbindMask;
+	IMG_UINT32 ui32FirstSlot;
+	IMG_UINT32 ui32ServerSyncCount;
+	IMG_UINT32 * pui32ServerSyncFlags;
+	IMG_HANDLE * phServerSyncs;
+} PVRSRV_BRIDGE_IN_RGXBINDCOMPUTESYNCS;
+
+
+/* Bridge out structure for RGXBindComputeSyncs */
+typedef struct PVRSRV_BRIDGE_OUT_RGXBINDCOMPUTESYNCS_TAG
+{
+	PVRSRV_ERROR eError;
+} PVRSRV_BRIDGE_OUT_RGXBINDCOMPUTESYNCS;
+
+/*******************************************
+            RGXKickCDMBound          
+ *******************************************/
+
+/* Bridge in structure for RGXKickCDMBound */
+typedef struct PVRSRV_BRIDGE_IN_RGXKICKCDMBOUND_TAG
+{
+	IMG_HANDLE hComputeContext;
+	IMG_UINT32 ui32ClientFenceCount;
+	PRGXFWIF_UFO_ADDR * psClientFenceUFOAddress;
+	IMG_UINT32 * pui32ClientFenceValue;
+	IMG_UINT32 ui32ClientUpdateCount;
+	PRGXFWIF_UFO_ADDR * psClientUpdateUFOAddress;
+	IMG_UINT32 * pui32ClientUpdateValue;
+	IMG_UINT32 ui32BoundSyncMask;
+	IMG_UINT32 ui32CmdSize;
+	IMG_BYTE * psDMCmd;
+	IMG_BOOL bbPDumpContinuous;
+} PVRSRV_BRIDGE_IN_RGXKICKCDMBOUND;
+
+
+/* Bridge out structure for RGXKickCDMBound */
+typedef struct PVRSRV_BRIDGE_OUT_RGXKICKCDMBOUND_TAG
+{
+	PVRSRV_ERROR eError;
+} PVRSRV_BRIDGE_OUT_RGXKICKCDMBOUND;
+
 #endif /* COMMON_RGXCMP_BRIDGE_H */
@@ -612,6 +612,314 @@ RGXSetComputeContextPriority_exit:
 	return 0;
 }
 
+static IMG_INT
+PVRSRVBridgeRGXBindComputeSyncs(IMG_UINT32 ui32BridgeID,
+					 PVRSRV_BRIDGE_IN_RGXBINDCOMPUTESYNCS *psRGXBindComputeSyncsIN,
+					 PVRSRV_BRIDGE_OUT_RGXBINDCOMPUTESYNCS *psRGXBindComputeSyncsOUT,
+					 CONNECTION_DATA *psConnection)
+{
+	RGX_SERVER_COMPUTE_CONTEXT * psComputeContextInt = IMG_NULL;
+	IMG_HANDLE hComputeContextInt2 = IMG_NULL;
+	IMG_UINT32 *ui32ServerSyncFlagsInt = IMG_NULL;
+	SERVER_SYNC_PRIMITIVE * *psServerSyncsInt = IMG_NULL;
+	IMG_HANDLE *hServerSyncsInt2 = IMG_NULL;
+
+	PVRSRV_BRIDGE_ASSERT_CMD(ui32BridgeID, PVRSRV_BRIDGE_RGXCMP_RGXBINDCOMPUTESYNCS);
+
+
+
+
+	if (psRGXBindComputeSyncsIN->ui32ServerSyncCount != 0)
+	{
+		ui32ServerSyncFlagsInt = OSAllocMem(psRGXBindComputeSyncsIN->ui32ServerSyncCount * sizeof(IMG_UINT32));
+		if (!ui32ServerSyncFlagsInt)
+		{
+			psRGXBindComputeSyncsOUT->eError = PVRSRV_ERROR_OUT_OF_MEMORY;
+
+			goto RGXBindComputeSyncs_exit;
+		}
+	}
+
+			/* Copy the data over */
+			if ( !OSAccessOK(PVR_VERIFY_READ, (IMG_VOID*) psRGXBindComputeSyncsIN->pui32ServerSyncFlags, psRGXBindComputeSyncsIN->ui32ServerSyncCount * sizeof(IMG_UINT32))
+				|| (OSCopyFromUser(NULL, ui32ServerSyncFlagsInt, psRGXBindComputeSyncsIN->pui32ServerSyncFlags,
+				psRGXBindComputeSyncsIN->ui32ServerSyncCount * sizeof(IMG_UINT32)) != PVRSRV_OK) )
+			{
+				psRGXBindComputeSyncsOUT->eError = PVRSRV_ERROR_INVALID_PARAMS;
+
+				goto RGXBindComputeSyncs_exit;
+			}
+	if (psRGXBindComputeSyncsIN->ui32ServerSyncCount != 0)
+	{
+		psServerSyncsInt = OSAllocMem(psRGXBindComputeSyncsIN->ui32ServerSyncCount * sizeof(SERVER_SYNC_PRIMITIVE *));
+		if (!psServerSyncsInt)
+		{
+			psRGXBindComputeSyncsOUT->eError = PVRSRV_ERROR_OUT_OF_MEMORY;
+
+			goto RGXBindComputeSyncs_exit;
+		}
+		hServerSyncsInt2 = OSAllocMem(psRGXBindComputeSyncsIN->ui32ServerSyncCount * sizeof(IMG_HANDLE));
+		if (!hServerSyncsInt2)
+		{
+			psRGXBindComputeSyncsOUT->eError = PVRSRV_ERROR_OUT_OF_MEMORY;
+
+			goto RGXBindComputeSyncs_exit;
+		}
+	}
+
+			/* Copy the data over */
+			if ( !OSAccessOK(PVR_VERIFY_READ, (IMG_VOID*) psRGXBindComputeSyncsIN->phServerSyncs, psRGXBindComputeSyncsIN->ui32ServerSyncCount * sizeof(IMG_HANDLE))
+				|| (OSCopyFromUser(NULL, hServerSyncsInt2, psRGXBindComputeSyncsIN->phServerSyncs,
+				psRGXBindComputeSyncsIN->ui32ServerSyncCount * sizeof(IMG_HANDLE)) != PVRSRV_OK) )
+			{
+				psRGXBindComputeSyncsOUT->eError = PVRSRV_ERROR_INVALID_PARAMS;
+
+				goto RGXBindComputeSyncs_exit;
+			}
+
+				{
+					/* Look up the address from the handle */
+					psRGXBindComputeSyncsOUT->eError =
+						PVRSRVLookupHandle(psConnection->psHandleBase,
+											(IMG_HANDLE *) &hComputeContextInt2,
+											psRGXBindComputeSyncsIN->hComputeContext,
+											PVRSRV_HANDLE_TYPE_RGX_SERVER_COMPUTE_CONTEXT);
+					if(psRGXBindComputeSyncsOUT->eError != PVRSRV_OK)
+					{
+						goto RGXBindComputeSyncs_exit;
+					}
+
+					/* Look up the data from the resman address */
+					psRGXBindComputeSyncsOUT->eError = ResManFindPrivateDataByPtr(hComputeContextInt2, (IMG_VOID **) &psComputeContextInt);
+
+					if(psRGXBindComputeSyncsOUT->eError != PVRSRV_OK)
+					{
+						goto RGXBindComputeSyncs_exit;
+					}
+				}
+
+	{
+		IMG_UINT32 i;
+
+		for (i=0;i<psRGXBindComputeSyncsIN->ui32ServerSyncCount;i++)
+		{
+				{
+					/* Look up the address from the handle */
+					psRGXBindComputeSyncsOUT->eError =
+						PVRSRVLookupHandle(psConnection->psHandleBase,
+											(IMG_HANDLE *) &hServerSyncsInt2[i],
+											psRGXBindComputeSyncsIN->phServerSyncs[i],
+											PVRSRV_HANDLE_TYPE_SERVER_SYNC_PRIMITIVE);
+					if(psRGXBindComputeSyncsOUT->eError != PVRSRV_OK)
+					{
+						goto RGXBindComputeSyncs_exit;
+					}
+
+					/* Look up the data from the resman address */
+					psRGXBindComputeSyncsOUT->eError = ResManFindPrivateDataByPtr(hServerSyncsInt2[i], (IMG_VOID **) &psServerSyncsInt[i]);
+
+					if(psRGXBindComputeSyncsOUT->eError != PVRSRV_OK)
+					{
+						goto RGXBindComputeSyncs_exit;
+					}
+				}
+		}
+	}
+
+	psRGXBindComputeSyncsOUT->eError =
+		PVRSRVRGXBindComputeSyncsKM(
+					psComputeContextInt,
+					psRGXBindComputeSyncsIN->ui32UnbindMask,
+					psRGXBindComputeSyncsIN->ui32FirstSlot,
+					psRGXBindComputeSyncsIN->ui32ServerSyncCount,
+					ui32ServerSyncFlagsInt,
+					psServerSyncsInt);
+
+
+
+RGXBindComputeSyncs_exit:
+	if (ui32ServerSyncFlagsInt)
+		OSFreeMem(ui32ServerSyncFlagsInt);
+	if (psServerSyncsInt)
+		OSFreeMem(psServerSyncsInt);
+	if (hServerSyncsInt2)
+		OSFreeMem(hServerSyncsInt2);
+
+	return 0;
+}
+
+static IMG_INT
+PVRSRVBridgeRGXKickCDMBound(IMG_UINT32 ui32BridgeID,
+					 PVRSRV_BRIDGE_IN_RGXKICKCDMBOUND *psRGXKickCDMBoundIN,
+					 PVRSRV_BRIDGE_OUT_RGXKICKCDMBOUND *psRGXKickCDMBoundOUT,
+					 CONNECTION_DATA *psConnection)
+{
+	RGX_SERVER_COMPUTE_CONTEXT * psComputeContextInt = IMG_NULL;
+	IMG_HANDLE hComputeContextInt2 = IMG_NULL;
+	PRGXFWIF_UFO_ADDR *sClientFenceUFOAddressInt = IMG_NULL;
+	IMG_UINT32 *ui32ClientFenceValueInt = IMG_NULL;
+	PRGXFWIF_UFO_ADDR *sClientUpdateUFOAddressInt = IMG_NULL;
+	IMG_UINT32 *ui32ClientUpdateValueInt = IMG_NULL;
+	IMG_BYTE *psDMCmdInt = IMG_NULL;
+
+	PVRSRV_BRIDGE_ASSERT_CMD(ui32BridgeID, PVRSRV_BRIDGE_RGXCMP_RGXKICKCDMBOUND);
+
+
+
+
+	if (psRGXKickCDMBoundIN->ui32ClientFenceCount != 0)
+	{
+		sClientFenceUFOAddressInt = OSAllocMem(psRGXKickCDMBoundIN->ui32ClientFenceCount * sizeof(PRGXFWIF_UFO_ADDR));
+		if (!sClientFenceUFOAddressInt)
+		{
+			psRGXKickCDMBoundOUT->eError = PVRSRV_ERROR_OUT_OF_MEMORY;
+
+			goto RGXKickCDMBound_exit;
+		}
+	}
+
+			/* Copy the data over */
+			if ( !OSAccessOK(PVR_VERIFY_READ, (IMG_VOID*) psRGXKickCDMBoundIN->psClientFenceUFOAddress, psRGXKickCDMBoundIN->ui32ClientFenceCount * sizeof(PRGXFWIF_UFO_ADDR))
+				|| (OSCopyFromUser(NULL, sClientFenceUFOAddressInt, psRGXKickCDMBoundIN->psClientFenceUFOAddress,
+				psRGXKickCDMBoundIN->ui32ClientFenceCount * sizeof(PRGXFWIF_UFO_ADDR)) != PVRSRV_OK) )
+			{
+				psRGXKickCDMBoundOUT->eError = PVRSRV_ERROR_INVALID_PARAMS;
+
+				goto RGXKickCDMBound_exit;
+			}
+	if (psRGXKickCDMBoundIN->ui32ClientFenceCount != 0)
+	{
+		ui32ClientFenceValueInt = OSAllocMem(psRGXKickCDMBoundIN->ui32ClientFenceCount * sizeof(IMG_UINT32));
+		if (!ui32ClientFenceValueInt)
+		{
+			psRGXKickCDMBoundOUT->eError = PVRSRV_ERROR_OUT_OF_MEMORY;
+
+			goto RGXKickCDMBound_exit;
+		}
+	}
+
+			/* Copy the data over */
+			if ( !OSAccessOK(PVR_VERIFY_READ, (IMG_VOID*) psRGXKickCDMBoundIN->pui32ClientFenceValue, psRGXKickCDMBoundIN->ui32ClientFenceCount * sizeof(IMG_UINT32))
+				|| (OSCopyFromUser(NULL, ui32ClientFenceValueInt, psRGXKickCDMBoundIN->pui32ClientFenceValue,
+				psRGXKickCDMBoundIN->ui32ClientFenceCount * sizeof(IMG_UINT32)) != PVRSRV_OK) )
+			{
+				psRGXKickCDMBoundOUT->eError = PVRSRV_ERROR_INVALID_PARAMS;
+
+				goto RGXKickCDMBound_exit;
+			}
+	if (psRGXKickCDMBoundIN->ui32ClientUpdateCount != 0)
+	{
+		sClientUpdateUFOAddressInt = OSAllocMem(psRGXKickCDMBoundIN->ui32ClientUpdateCount * sizeof(PRGXFWIF_UFO_ADDR));
+		if (!sClientUpdateUFOAddressInt)
+		{
+			psRGXKickCDMBoundOUT->eError = PVRSRV_ERROR_OUT_OF_MEMORY;
+
+			goto RGXKickCDMBound_exit;
+		}
+	}
+
+			/* Copy the data over */
+			if ( !OSAccessOK(PVR_VERIFY_READ, (IMG_VOID*) psRGXKickCDMBoundIN->psClientUpdateUFOAddress, psRGXKickCDMBoundIN->ui32ClientUpdateCount * sizeof(PRGXFWIF_UFO_ADDR))
+				|| (OSCopyFromUser(NULL, sClientUpdateUFOAddressInt, psRGXKickCDMBoundIN->psClientUpdateUFOAddress,
+				psRGXKickCDMBoundIN->ui32ClientUpdateCount * sizeof(PRGXFWIF_UFO_ADDR)) != PVRSRV_OK) )
+			{
+				psRGXKickCDMBoundOUT->eError = PVRSRV_ERROR_INVALID_PARAMS;
+
+				goto RGXKickCDMBound_exit;
+			}
+	if (psRGXKickCDMBoundIN->ui32ClientUpdateCount != 0)
+	{
+		ui32ClientUpdateValueInt = OSAllocMem(psRGXKickCDMBoundIN->ui32ClientUpdateCount * sizeof(IMG_UINT32));
+		if (!ui32ClientUpdateValueInt)
+		{
+			psRGXKickCDMBoundOUT->eError = PVRSRV_ERROR_OUT_OF_MEMORY;
+
+			goto RGXKickCDMBound_exit;
+		}
+	}
+
+			/* Copy the data over */
+			if ( !OSAccessOK(PVR_VERIFY_READ, (IMG_VOID*) psRGXKickCDMBoundIN->pui32ClientUpdateValue, psRGXKickCDMBoundIN->ui32ClientUpdateCount * sizeof(IMG_UINT32))
+				|| (OSCopyFromUser(NULL, ui32ClientUpdateValueInt, psRGXKickCDMBoundIN->pui32ClientUpdateValue,
+				psRGXKickCDMBoundIN->ui32ClientUpdateCount * sizeof(IMG_UINT32)) != PVRSRV_OK) )
+			{
+				psRGXKickCDMBoundOUT->eError = PVRSRV_ERROR_INVALID_PARAMS;
+
+				goto RGXKickCDMBound_exit;
+			}
+	if (psRGXKickCDMBoundIN->ui32CmdSize != 0)
+	{
+		psDMCmdInt = OSAllocMem(psRGXKickCDMBoundIN->ui32CmdSize * sizeof(IMG_BYTE));
+		if (!psDMCmdInt)
+		{
+			psRGXKickCDMBoundOUT->eError = PVRSRV_ERROR_OUT_OF_MEMORY;
+
+			goto RGXKickCDMBound_exit;
+		}
+	}
+
+			/* Copy the data over */
+			if ( !OSAccessOK(PVR_VERIFY_READ, (IMG_VOID*) psRGXKickCDMBoundIN->psDMCmd, psRGXKickCDMBoundIN->ui32CmdSize * sizeof(IMG_BYTE))
+				|| (OSCopyFromUser(NULL, psDMCmdInt, psRGXKickCDMBoundIN->psDMCmd,
+				psRGXKickCDMBoundIN->ui32CmdSize * sizeof(IMG_BYTE)) != PVRSRV_OK) )
+			{
+				psRGXKickCDMBoundOUT->eError = PVRSRV_ERROR_INVALID_PARAMS;
+
+				goto RGXKickCDMBound_exit;
+			}
+
+				{
+					/* Look up the address from the handle */
+					psRGXKickCDMBoundOUT->eError =
+						PVRSRVLookupHandle(psConnection->psHandleBase,
+											(IMG_HANDLE *) &hComputeContextInt2,
+											psRGXKickCDMBoundIN->hComputeContext,
+											PVRSRV_HANDLE_TYPE_RGX_SERVER_COMPUTE_CONTEXT);
+					if(psRGXKickCDMBoundOUT->eError != PVRSRV_OK)
+					{
+						goto RGXKickCDMBound_exit;
+					}
+
+					/* Look up the data from the resman address */
+					psRGXKickCDMBoundOUT->eError = ResManFindPrivateDataByPtr(hComputeContextInt2, (IMG_VOID **) &psComputeContextInt);
+
+					if(psRGXKickCDMBoundOUT->eError != PVRSRV_OK)
+					{
+						goto RGXKickCDMBound_exit;
+					}
+				}
+
+	psRGXKickCDMBoundOUT->eError =
+		PVRSRVRGXKickCDMBoundKM(
+					psComputeContextInt,
+					psRGXKickCDMBoundIN->ui32ClientFenceCount,
+					sClientFenceUFOAddressInt,
+					ui32ClientFenceValueInt,
+					psRGXKickCDMBoundIN->ui32ClientUpdateCount,
+					sClientUpdateUFOAddressInt,
+					ui32ClientUpdateValueInt,
+					psRGXKickCDMBoundIN->ui32BoundSyncMask,
+					psRGXKickCDMBoundIN->ui32CmdSize,
+					psDMCmdInt,
+					psRGXKickCDMBoundIN->bbPDumpContinuous);
+
+
+
+RGXKickCDMBound_exit:
+	if (sClientFenceUFOAddressInt)
+		OSFreeMem(sClientFenceUFOAddressInt);
+	if (ui32ClientFenceValueInt)
+		OSFreeMem(ui32ClientFenceValueInt);
+	if (sClientUpdateUFOAddressInt)
+		OSFreeMem(sClientUpdateUFOAddressInt);
+	if (ui32ClientUpdateValueInt)
+		OSFreeMem(ui32ClientUpdateValueInt);
+	if (psDMCmdInt)
+		OSFreeMem(psDMCmdInt);
+
+	return 0;
+}
+
 #ifdef CONFIG_COMPAT
 
 #include <linux/compat.h>
@@ -853,6 +1161,145 @@ compat_PVRSRVBridgeRGXSetComputeContextPriority(IMG_UINT32 ui32BridgeID,
 					 psConnection);
 
 }
+
+/* Bridge in structure for RGXBindComputeSyncs */
+typedef struct compat_PVRSRV_BRIDGE_IN_RGXBINDCOMPUTESYNCS_TAG
+{
+	/* IMG_HANDLE hComputeContext; */
+	IMG_UINT32 hComputeContext;
+	IMG_UINT32 ui32UnbindMask;
+	IMG_UINT32 ui32FirstSlot;
+	IMG_UINT32 ui32ServerSyncCount;
+	/* IMG_UINT32 * pui32ServerSyncFlags; */
+	IMG_UINT32 pui32ServerSyncFlags;
+	/* IMG_HANDLE * phServerSyncs; */
+	IMG_UINT32 phServerSyncs;
+} compat_PVRSRV_BRIDGE_IN_RGXBINDCOMPUTESYNCS;
+
+static IMG_INT
+compat_PVRSRVBridgeRGXBindComputeSyncs(IMG_UINT32 ui32BridgeID,
+					 compat_PVRSRV_BRIDGE_IN_RGXBINDCOMPUTESYNCS *psRGXBindComputeSyncsIN_32,
+					 PVRSRV_BRIDGE_OUT_RGXBINDCOMPUTESYNCS *psRGXBindComputeSyncsOUT,
+					 CONNECTION_DATA *psConnection)
+{
+	IMG_HANDLE *hServerSyncsInt2 = IMG_NULL;
+	IMG_UINT32 *hServerSyncsInt3 = IMG_NULL;
+
+	PVRSRV_BRIDGE_IN_RGXBINDCOMPUTESYNCS sRGXBindComputeSyncsIN;
+	PVRSRV_BRIDGE_IN_RGXBINDCOMPUTESYNCS *psRGXBindComputeSyncsIN = &sRGXBindComputeSyncsIN;
+
+	psRGXBindComputeSyncsIN->hComputeContext = (IMG_HANDLE)(IMG_UINT64)psRGXBindComputeSyncsIN_32->hComputeContext;
+	psRGXBindComputeSyncsIN->ui32UnbindMask = psRGXBindComputeSyncsIN_32->ui32UnbindMask;
+	psRGXBindComputeSyncsIN->ui32FirstSlot = psRGXBindComputeSyncsIN_32->ui32FirstSlot;
+	psRGXBindComputeSyncsIN->ui32ServerSyncCount = psRGXBindComputeSyncsIN_32->ui32ServerSyncCount;
+	psRGXBindComputeSyncsIN->pui32ServerSyncFlags = (IMG_UINT32*)(IMG_UINT64)psRGXBindComputeSyncsIN_32->pui32ServerSyncFlags;
+	psRGXBindComputeSyncsIN->phServerSyncs = (IMG_HANDLE*)(IMG_UINT64)psRGXBindComputeSyncsIN_32->phServerSyncs;
+
+	if (psRGXBindComputeSyncsIN->ui32ServerSyncCount != 0)
+	{
+		hServerSyncsInt2 = compat_alloc_user_space(psRGXBindComputeSyncsIN->ui32ServerSyncCount * sizeof(IMG_HANDLE));
+		if (!hServerSyncsInt2)
+		{
+			psRGXBindComputeSyncsOUT->eError = PVRSRV_ERROR_OUT_OF_MEMORY;
+
+			goto RGXBindComputeSyncs_exit;
+		}
+		hServerSyncsInt3 = OSAllocMem(psRGXBindComputeSyncsIN->ui32ServerSyncCount * sizeof(IMG_UINT32));
+		if (!hServerSyncsInt3)
+		{
+			psRGXBindComputeSyncsOUT->eError = PVRSRV_ERROR_OUT_OF_MEMORY;
+
+			goto RGXBindComputeSyncs_exit;
+		}
+	}
+
+	if ( !OSAccessOK(PVR_VERIFY_READ, (IMG_VOID*) psRGXBindComputeSyncsIN->phServerSyncs, psRGXBindComputeSyncsIN->ui32ServerSyncCount * sizeof(IMG_UINT32))
+		|| (OSCopyFromUser(NULL, hServerSyncsInt3, psRGXBindComputeSyncsIN->phServerSyncs,
+		psRGXBindComputeSyncsIN->ui32ServerSyncCount * sizeof(IMG_UINT32)) != PVRSRV_OK) )
+	{
+		psRGXBindComputeSyncsOUT->eError = PVRSRV_ERROR_INVALID_PARAMS;
+
+		goto RGXBindComputeSyncs_exit;
+	}
+
+
+	{
+		IMG_UINT32 i;
+
+		for (i=0;i<psRGXBindComputeSyncsIN->ui32ServerSyncCount;i++)
+		{
+            if (!access_ok(VERIFY_WRITE, &hServerSyncsInt2[i], sizeof(IMG_HANDLE))
+                || __put_user((unsigned long)hServerSyncsInt3[i], &hServerSyncsInt2[i])) {
+                psRGXBindComputeSyncsOUT->eError = PVRSRV_ERROR_INVALID_PARAMS;
+                goto RGXBindComputeSyncs_exit;
+            }
+		}
+        psRGXBindComputeSyncsIN->phServerSyncs = hServerSyncsInt2;
+	}
+
+    PVRSRVBridgeRGXBindComputeSyncs(ui32BridgeID,
+					 psRGXBindComputeSyncsIN,
+					 psRGXBindComputeSyncsOUT,
+					 psConnection);
+
+
+RGXBindComputeSyncs_exit:
+	if (hServerSyncsInt3)
+		OSFreeMem(hServerSyncsInt3);
+
+	return 0;
+}
+
+/* Bridge in structure for RGXKickCDMBound */
+typedef struct compat_PVRSRV_BRIDGE_IN_RGXKICKCDMBOUND_TAG
+{
+	/* IMG_HANDLE hComputeContext; */
+	IMG_UINT32 hComputeContext;
+	IMG_UINT32 ui32ClientFenceCount;
+	/* PRGXFWIF_UFO_ADDR * psClientFenceUFOAddress; */
+	IMG_UINT32 psClientFenceUFOAddress;
+	/* IMG_UINT32 * pui32ClientFenceValue; */
+	IMG_UINT32 pui32ClientFenceValue;
+	IMG_UINT32 ui32ClientUpdateCount;
+	/* PRGXFWIF_UFO_ADDR * psClientUpdateUFOAddress; */
+	IMG_UINT32 psClientUpdateUFOAddress;
+	/* IMG_UINT32 * pui32ClientUpdateValue; */
+	IMG_UINT32 pui32ClientUpdateValue;
+	IMG_UINT32 ui32BoundSyncMask;
+	IMG_UINT32 ui32CmdSize;
+	/* IMG_BYTE * psDMCmd; */
+	IMG_UINT32 psDMCmd;
+	IMG_BOOL bbPDumpContinuous;
+} compat_PVRSRV_BRIDGE_IN_RGXKICKCDMBOUND;
+
+static IMG_INT
+compat_PVRSRVBridgeRGXKickCDMBound(IMG_UINT32 ui32BridgeID,
+					 compat_PVRSRV_BRIDGE_IN_RGXKICKCDMBOUND *psRGXKickCDMBoundIN_32,
+					 PVRSRV_BRIDGE_OUT_RGXKICKCDMBOUND *psRGXKickCDMBoundOUT,
+					 CONNECTION_DATA *psConnection)
+{
+	PVRSRV_BRIDGE_IN_RGXKICKCDMBOUND sRGXKickCDMBoundIN;
+	PVRSRV_BRIDGE_IN_RGXKICKCDMBOUND *psRGXKickCDMBoundIN = &sRGXKickCDMBoundIN;
+
+	psRGXKickCDMBoundIN->hComputeContext = (IMG_HANDLE)(IMG_UINT64)psRGXKickCDMBoundIN_32->hComputeContext;
+	psRGXKickCDMBoundIN->ui32ClientFenceCount = psRGXKickCDMBoundIN_32->ui32ClientFenceCount;
+	psRGXKickCDMBoundIN->psClientFenceUFOAddress = (PRGXFWIF_UFO_ADDR*)(IMG_UINT64)psRGXKickCDMBoundIN_32->psClientFenceUFOAddress;
+	psRGXKickCDMBoundIN->pui32ClientFenceValue = (IMG_UINT32*)(IMG_UINT64)psRGXKickCDMBoundIN_32->pui32ClientFenceValue;
+	psRGXKickCDMBoundIN->ui32ClientUpdateCount = psRGXKickCDMBoundIN_32->ui32ClientUpdateCount;
+	psRGXKickCDMBoundIN->psClientUpdateUFOAddress = (PRGXFWIF_UFO_ADDR*)(IMG_UINT64)psRGXKickCDMBoundIN_32->psClientUpdateUFOAddress;
+	psRGXKickCDMBoundIN->pui32ClientUpdateValue = (IMG_UINT32*)(IMG_UINT64)psRGXKickCDMBoundIN_32->pui32ClientUpdateValue;
+	psRGXKickCDMBoundIN->ui32BoundSyncMask = psRGXKickCDMBoundIN_32->ui32BoundSyncMask;
+	psRGXKickCDMBoundIN->ui32CmdSize = psRGXKickCDMBoundIN_32->ui32CmdSize;
+	psRGXKickCDMBoundIN->psDMCmd = (IMG_BYTE*)(IMG_UINT64)psRGXKickCDMBoundIN_32->psDMCmd;
+	psRGXKickCDMBoundIN->bbPDumpContinuous = psRGXKickCDMBoundIN_32->bbPDumpContinuous;
+
+	return PVRSRVBridgeRGXKickCDMBound(ui32BridgeID,
+					psRGXKickCDMBoundIN,
+					psRGXKickCDMBoundOUT,
+					psConnection);
+
+}
+
 #endif
 
 /* ***************************************************************************
@@ -861,6 +1308,8 @@ compat_PVRSRVBridgeRGXSetComputeContextPriority(IMG_UINT32 ui32BridgeID,
 
 PVRSRV_ERROR RegisterRGXCMPFunctions(IMG_VOID);
 IMG_VOID UnregisterRGXCMPFunctions(IMG_VOID);
+PVRSRV_ERROR RegisterRGXCMP2Functions(IMG_VOID);
+IMG_VOID UnregisterRGXCMP2Functions(IMG_VOID);
 
 /*
  * Register all RGXCMP functions with services
@@ -890,3 +1339,27 @@ PVRSRV_ERROR RegisterRGXCMPFunctions(IMG_VOID)
 IMG_VOID UnregisterRGXCMPFunctions(IMG_VOID)
 {
 }
+
+/*
+ * Register the RGXCMP functions in the appended RGXCMP2 group. Their IDs
+ * follow RGXHWPERF2's, so this must be called after that group.
+ */
+PVRSRV_ERROR RegisterRGXCMP2Functions(IMG_VOID)
+{
+#ifdef CONFIG_COMPAT
+	SetDispatchTableEntry(PVRSRV_BRIDGE_RGXCMP_RGXBINDCOMPUTESYNCS, compat_PVRSRVBridgeRGXBindComputeSyncs);
+	SetDispatchTableEntry(PVRSRV_BRIDGE_RGXCMP_RGXKICKCDMBOUND, compat_PVRSRVBridgeRGXKickCDMBound);
+#else
+	SetDispatchTableEntry(PVRSRV_BRIDGE_RGXCMP_RGXBINDCOMPUTESYNCS, PVRSRVBridgeRGXBindComputeSyncs);
+	SetDispatchTableEntry(PVRSRV_BRIDGE_RGXCMP_RGXKICKCDMBOUND, PVRSRVBridgeRGXKickCDMBound);
+
+#endif
+	return PVRSRV_OK;
+}
+
+/*
+ * Unregister all rgxcmp2 functions with services
+ */
+IMG_VOID UnregisterRGXCMP2Functions(IMG_VOID)
+{
+}
@@ -57,6 +57,11 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #define PVRSRV_BRIDGE_RGXHWPERF_RGXCTRLHWPERFCOUNTERS			PVRSRV_IOWR(PVRSRV_BRIDGE_RGXHWPERF_CMD_FIRST+2)
 #define PVRSRV_BRIDGE_RGXHWPERF_CMD_LAST			(PVRSRV_BRIDGE_RGXHWPERF_CMD_FIRST+2)
 
+#define PVRSRV_BRIDGE_RGXHWPERF2_CMD_FIRST			(PVRSRV_BRIDGE_RGXHWPERF2_START)
+#define PVRSRV_BRIDGE_RGXHWPERF_RGXSETHWPERFHOSTFILTER			PVRSRV_IOWR(PVRSRV_BRIDGE_RGXHWPERF2_CMD_FIRST+0)
+#define PVRSRV_BRIDGE_RGXHWPERF_RGXSETHWPERFDRAIN			PVRSRV_IOWR(PVRSRV_BRIDGE_RGXHWPERF2_CMD_FIRST+1)
+#define PVRSRV_BRIDGE_RGXHWPERF2_CMD_LAST			(PVRSRV_BRIDGE_RGXHWPERF2_CMD_FIRST+1)
+
 
 /*******************************************
             RGXCtrlHWPerf          
@@ -116,4 +121,42 @@ typedef struct PVRSRV_BRIDGE_OUT_RGXCTRLHWPERFCOUNTERS_TAG
 	PVRSRV_ERROR eError;
 } PVRSRV_BRIDGE_OUT_RGXCTRLHWPERFCOUNTERS;
 
+/*******************************************
+            RGXSetHWPerfHostFilter          
+ *******************************************/
+
+/* Bridge in structure for RGXSetHWPerfHostFilter */
+typedef struct PVRSRV_BRIDGE_IN_RGXSETHWPERFHOSTFILTER_TAG
+{
+	IMG_HANDLE hDevNode;
+	IMG_UINT64 ui64EventMask;
+	IMG_UINT32 ui32PID;
+} PVRSRV_BRIDGE_IN_RGXSETHWPERFHOSTFILTER;
+
+
+/* Bridge out structure for RGXSetHWPerfHostFilter */
+typedef struct PVRSRV_BRIDGE_OUT_RGXSETHWPERFHOSTFILTER_TAG
+{
+	PVRSRV_ERROR eError;
+} PVRSRV_BRIDGE_OUT_RGXSETHWPERFHOSTFILTER;
+
+/*******************************************
+            RGXSetHWPerfDrain          
+ *******************************************/
+
+/* Bridge in structure for RGXSetHWPerfDrain */
+typedef struct PVRSRV_BRIDGE_IN_RGXSETHWPERFDRAIN_TAG
+{
+	IMG_HANDLE hDevNode;
+	IMG_UINT32 ui32WatermarkPercent;
+	IMG_UINT32 ui32PeriodMs;
+} PVRSRV_BRIDGE_IN_RGXSETHWPERFDRAIN;
+
+
+/* Bridge out structure for RGXSetHWPerfDrain */
+typedef struct PVRSRV_BRIDGE_OUT_RGXSETHWPERFDRAIN_TAG
+{
+	PVRSRV_ERROR eError;
+} PVRSRV_BRIDGE_OUT_RGXSETHWPERFDRAIN;
+
 #endif /* COMMON_RGXHWPERF_BRIDGE_H */
@@ -245,6 +245,88 @@ RGXCtrlHWPerfCounters_exit:
 	return 0;
 }
 
+static IMG_INT
+PVRSRVBridgeRGXSetHWPerfHostFilter(IMG_UINT32 ui32BridgeID,
+					 PVRSRV_BRIDGE_IN_RGXSETHWPERFHOSTFILTER *psRGXSetHWPerfHostFilterIN,
+					 PVRSRV_BRIDGE_OUT_RGXSETHWPERFHOSTFILTER *psRGXSetHWPerfHostFilterOUT,
+					 CONNECTION_DATA *psConnection)
+{
+	IMG_HANDLE hDevNodeInt = IMG_NULL;
+
+	PVRSRV_BRIDGE_ASSERT_CMD(ui32BridgeID, PVRSRV_BRIDGE_RGXHWPERF_RGXSETHWPERFHOSTFILTER);
+
+
+
+
+
+				{
+					/* Look up the address from the handle */
+					psRGXSetHWPerfHostFilterOUT->eError =
+						PVRSRVLookupHandle(psConnection->psHandleBase,
+											(IMG_HANDLE *) &hDevNodeInt,
+											psRGXSetHWPerfHostFilterIN->hDevNode,
+											PVRSRV_HANDLE_TYPE_DEV_NODE);
+					if(psRGXSetHWPerfHostFilterOUT->eError != PVRSRV_OK)
+					{
+						goto RGXSetHWPerfHostFilter_exit;
+					}
+
+				}
+
+	psRGXSetHWPerfHostFilterOUT->eError =
+		PVRSRVRGXSetHWPerfHostFilterKM(
+					hDevNodeInt,
+					psRGXSetHWPerfHostFilterIN->ui64EventMask,
+					psRGXSetHWPerfHostFilterIN->ui32PID);
+
+
+
+RGXSetHWPerfHostFilter_exit:
+
+	return 0;
+}
+
+static IMG_INT
+PVRSRVBridgeRGXSetHWPerfDrain(IMG_UINT32 ui32BridgeID,
+					 PVRSRV_BRIDGE_IN_RGXSETHWPERFDRAIN *psRGXSetHWPerfDrainIN,
+					 PVRSRV_BRIDGE_OUT_RGXSETHWPERFDRAIN *psRGXSetHWPerfDrainOUT,
+					 CONNECTION_DATA *psConnection)
+{
+	IMG_HANDLE hDevNodeInt = IMG_NULL;
+
+	PVRSRV_BRIDGE_ASSERT_CMD(ui32BridgeID, PVRSRV_BRIDGE_RGXHWPERF_RGXSETHWPERFDRAIN);
+
+
+
+
+
+				{
+					/* Look up the address from the handle */
+					psRGXSetHWPerfDrainOUT->eError =
+						PVRSRVLookupHandle(psConnection->psHandleBase,
+											(IMG_HANDLE *) &hDevNodeInt,
+											psRGXSetHWPerfDrainIN->hDevNode,
+											PVRSRV_HANDLE_TYPE_DEV_NODE);
+					if(psRGXSetHWPerfDrainOUT->eError != PVRSRV_OK)
+					{
+						goto RGXSetHWPerfDrain_exit;
+					}
+
+				}
+
+	psRGXSetHWPerfDrainOUT->eError =
+		PVRSRVRGXSetHWPerfDrainKM(
+					hDevNodeInt,
+					psRGXSetHWPerfDrainIN->ui32WatermarkPercent,
+					psRGXSetHWPerfDrainIN->ui32PeriodMs);
+
+
+
+RGXSetHWPerfDrain_exit:
+
+	return 0;
+}
+
 #ifdef CONFIG_COMPAT
 /* Bridge in structure for RGXCtrlHWPerf */
 typedef struct compat_PVRSRV_BRIDGE_IN_RGXCTRLHWPERF_TAG
@@ -338,6 +420,64 @@ compat_PVRSRVBridgeRGXCtrlHWPerfCounters(IMG_UINT32 ui32BridgeID,
 
 }
 
+/* Bridge in structure for RGXSetHWPerfHostFilter */
+typedef struct compat_PVRSRV_BRIDGE_IN_RGXSETHWPERFHOSTFILTER_TAG
+{
+	/* IMG_HANDLE hDevNode; */
+	IMG_UINT32 hDevNode;
+	IMG_UINT64 ui64EventMask __attribute__ ((__packed__));
+	IMG_UINT32 ui32PID;
+} compat_PVRSRV_BRIDGE_IN_RGXSETHWPERFHOSTFILTER;
+
+static IMG_INT
+compat_PVRSRVBridgeRGXSetHWPerfHostFilter(IMG_UINT32 ui32BridgeID,
+					 compat_PVRSRV_BRIDGE_IN_RGXSETHWPERFHOSTFILTER *psRGXSetHWPerfHostFilterIN_32,
+					 PVRSRV_BRIDGE_OUT_RGXSETHWPERFHOSTFILTER *psRGXSetHWPerfHostFilterOUT,
+					 CONNECTION_DATA *psConnection)
+{
+	PVRSRV_BRIDGE_IN_RGXSETHWPERFHOSTFILTER sRGXSetHWPerfHostFilterIN;
+	PVRSRV_BRIDGE_IN_RGXSETHWPERFHOSTFILTER *psRGXSetHWPerfHostFilterIN = &sRGXSetHWPerfHostFilterIN;
+
+	psRGXSetHWPerfHostFilterIN->hDevNode = (IMG_HANDLE)(IMG_UINT64)psRGXSetHWPerfHostFilterIN_32->hDevNode;
+	psRGXSetHWPerfHostFilterIN->ui64EventMask = psRGXSetHWPerfHostFilterIN_32->ui64EventMask;
+	psRGXSetHWPerfHostFilterIN->ui32PID = psRGXSetHWPerfHostFilterIN_32->ui32PID;
+
+	return PVRSRVBridgeRGXSetHWPerfHostFilter(ui32BridgeID,
+					 psRGXSetHWPerfHostFilterIN,
+					 psRGXSetHWPerfHostFilterOUT,
+					 psConnection);
+
+}
+
+/* Bridge in structure for RGXSetHWPerfDrain */
+typedef struct compat_PVRSRV_BRIDGE_IN_RGXSETHWPERFDRAIN_TAG
+{
+	/* IMG_HANDLE hDevNode; */
+	IMG_UINT32 hDevNode;
+	IMG_UINT32 ui32WatermarkPercent;
+	IMG_UINT32 ui32PeriodMs;
+} compat_PVRSRV_BRIDGE_IN_RGXSETHWPERFDRAIN;
+
+static IMG_INT
+compat_PVRSRVBridgeRGXSetHWPerfDrain(IMG_UINT32 ui32BridgeID,
+					 compat_PVRSRV_BRIDGE_IN_RGXSETHWPERFDRAIN *psRGXSetHWPerfDrainIN_32,
+					 PVRSRV_BRIDGE_OUT_RGXSETHWPERFDRAIN *psRGXSetHWPerfDrainOUT,
+					 CONNECTION_DATA *psConnection)
+{
+	PVRSRV_BRIDGE_IN_RGXSETHWPERFDRAIN sRGXSetHWPerfDrainIN;
+	PVRSRV_BRIDGE_IN_RGXSETHWPERFDRAIN *psRGXSetHWPerfDrainIN = &sRGXSetHWPerfDrainIN;
+
+	psRGXSetHWPerfDrainIN->hDevNode = (IMG_HANDLE)(IMG_UINT64)psRGXSetHWPerfDrainIN_32->hDevNode;
+	psRGXSetHWPerfDrainIN->ui32WatermarkPercent = psRGXSetHWPerfDrainIN_32->ui32WatermarkPercent;
+	psRGXSetHWPerfDrainIN->ui32PeriodMs = psRGXSetHWPerfDrainIN_32->ui32PeriodMs;
+
+	return PVRSRVBridgeRGXSetHWPerfDrain(ui32BridgeID,
+					 psRGXSetHWPerfDrainIN,
+					 psRGXSetHWPerfDrainOUT,
+					 psConnection);
+
+}
+
 
 #endif
 
@@ -347,6 +487,8 @@ compat_PVRSRVBridgeRGXCtrlHWPerfCounters(IMG_UINT32 ui32BridgeID,
 
 PVRSRV_ERROR RegisterRGXHWPERFFunctions(IMG_VOID);
 IMG_VOID UnregisterRGXHWPERFFunctions(IMG_VOID);
+PVRSRV_ERROR RegisterRGXHWPERF2Functions(IMG_VOID);
+IMG_VOID UnregisterRGXHWPERF2Functions(IMG_VOID);
 
 /*
  * Register all RGXHWPERF functions with services
@@ -372,3 +514,27 @@ PVRSRV_ERROR RegisterRGXHWPERFFunctions(IMG_VOID)
 IMG_VOID UnregisterRGXHWPERFFunctions(IMG_VOID)
 {
 }
+
+/*
+ * Register the RGXHWPERF functions in the appended RGXHWPERF2 group. Their
+ * IDs follow REGCONFIG's, so this must be called after that group.
+ */
+PVRSRV_ERROR RegisterRGXHWPERF2Functions(IMG_VOID)
+{
+#ifdef CONFIG_COMPAT
+	SetDispatchTableEntry(PVRSRV_BRIDGE_RGXHWPERF_RGXSETHWPERFHOSTFILTER, compat_PVRSRVBridgeRGXSetHWPerfHostFilter);
+	SetDispatchTableEntry(PVRSRV_BRIDGE_RGXHWPERF_RGXSETHWPERFDRAIN, compat_PVRSRVBridgeRGXSetHWPerfDrain);
+#else
+	SetDispatchTableEntry(PVRSRV_BRIDGE_RGXHWPERF_RGXSETHWPERFHOSTFILTER, PVRSRVBridgeRGXSetHWPerfHostFilter);
+	SetDispatchTableEntry(PVRSRV_BRIDGE_RGXHWPERF_RGXSETHWPERFDRAIN, PVRSRVBridgeRGXSetHWPerfDrain);
+
+#endif
+	return PVRSRV_OK;
+}
+
+/*
+ * Unregister all rgxhwperf2 functions with services
+ */
+IMG_VOID UnregisterRGXHWPERF2Functions(IMG_VOID)
+{
+}
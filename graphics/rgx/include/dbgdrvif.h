@@ -84,6 +84,25 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #define DEBUG_FLAGS_ENABLESAMPLE		0x00000004UL
 #define DEBUG_FLAGS_READONLY			0x00000008UL
 #define DEBUG_FLAGS_WRITEONLY			0x00000010UL
+#define DEBUG_FLAGS_COMPRESSED			0x00000020UL
+
+/*
+	DEBUG_FLAGS_COMPRESSED is never set by the stream's creator. A reader that
+	can expand the format below asks for it with DEBUG_SERVICE_SETSTREAMFLAGS,
+	which only succeeds while the main buffer holds no unread data, so every
+	byte read afterwards is packet encoded. Resetting the stream through
+	DEBUG_SERVICE_GETSTREAM returns it to plain data, as does clearing the
+	flag. The init phase buffer is always plain.
+
+	Packet headers used in DEBUG_FLAGS_COMPRESSED streams. Each packet starts
+	with a host order IMG_UINT32 header holding the uncompressed length in
+	bytes, at most DEBUG_COMPRESSED_PACKET_MAXLEN. A literal packet is followed
+	by that many raw bytes; a repeat packet is followed by a single 32-bit word
+	which expands to fill the length. DBGExpandCompressed() decodes them.
+*/
+#define DEBUG_COMPRESSED_PACKET_REPEAT	0x80000000UL
+#define DEBUG_COMPRESSED_PACKET_LENMASK	0x7FFFFFFFUL
+#define DEBUG_COMPRESSED_PACKET_MAXLEN	0x00010000UL
 
 #define DEBUG_FLAGS_TEXTSTREAM			0x80000000UL
 
@@ -145,6 +164,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #define DEBUG_SERVICE_WRITELF			CTL_CODE(FILE_DEVICE_UNKNOWN, DEBUG_SERVICE_IOCTL_BASE + 0x16, METHOD_BUFFERED, FILE_ANY_ACCESS)
 #define DEBUG_SERVICE_READLF			CTL_CODE(FILE_DEVICE_UNKNOWN, DEBUG_SERVICE_IOCTL_BASE + 0x17, METHOD_BUFFERED, FILE_ANY_ACCESS)
 #define DEBUG_SERVICE_WAITFOREVENT		CTL_CODE(FILE_DEVICE_UNKNOWN, DEBUG_SERVICE_IOCTL_BASE + 0x18, METHOD_BUFFERED, FILE_ANY_ACCESS)
+#define DEBUG_SERVICE_GETSTREAMFLAGS	CTL_CODE(FILE_DEVICE_UNKNOWN, DEBUG_SERVICE_IOCTL_BASE + 0x19, METHOD_BUFFERED, FILE_ANY_ACCESS)
+#define DEBUG_SERVICE_SETSTREAMFLAGS	CTL_CODE(FILE_DEVICE_UNKNOWN, DEBUG_SERVICE_IOCTL_BASE + 0x1A, METHOD_BUFFERED, FILE_ANY_ACCESS)
 
 #if defined(_WIN32)
 /*****************************************************************************
@@ -304,6 +325,70 @@ typedef struct _DBG_IN_WRITE_LF_
 	IMG_UINT32 ui32BufferSize;
 } DBG_IN_WRITE_LF, *PDBG_IN_WRITE_LF;
 
+typedef struct _DBG_IN_SETSTREAMFLAGS_
+{
+	IMG_SID hStream;
+	IMG_UINT32 ui32Flags;			/*!< only DEBUG_FLAGS_COMPRESSED may be changed */
+} DBG_IN_SETSTREAMFLAGS, *PDBG_IN_SETSTREAMFLAGS;
+
+/*!****************************************************************************
+ @name		DBGExpandCompressed
+ @brief		Expands the whole packets at the start of data read from a
+			DEBUG_FLAGS_COMPRESSED stream. A read may end part way through a
+			packet, so the caller keeps the unconsumed input and passes it
+			again ahead of the next read. An output buffer of at least
+			DEBUG_COMPRESSED_PACKET_MAXLEN bytes always makes progress.
+ @param		pui8In - compressed data
+ @param		ui32InSize - bytes of compressed data
+ @param		pui8Out - output buffer
+ @param		pui32OutSize - in: size of output buffer, out: bytes expanded
+ @return	input bytes consumed
+*****************************************************************************/
+static INLINE IMG_UINT32 DBGExpandCompressed(const IMG_UINT8 *pui8In,
+											 IMG_UINT32 ui32InSize,
+											 IMG_UINT8 *pui8Out,
+											 IMG_UINT32 *pui32OutSize)
+{
+	IMG_UINT32 ui32InOff = 0;
+	IMG_UINT32 ui32OutOff = 0;
+	IMG_UINT32 ui32Header;
+	IMG_UINT32 ui32Len;
+	IMG_UINT32 ui32PacketSize;
+	IMG_UINT32 i;
+
+	while ((ui32InSize - ui32InOff) >= sizeof(IMG_UINT32))
+	{
+		for (i = 0; i < sizeof(IMG_UINT32); i++)
+		{
+			((IMG_UINT8 *) &ui32Header)[i] = pui8In[ui32InOff + i];
+		}
+
+		ui32Len = ui32Header & DEBUG_COMPRESSED_PACKET_LENMASK;
+		ui32PacketSize = sizeof(IMG_UINT32) +
+			((ui32Header & DEBUG_COMPRESSED_PACKET_REPEAT) ? sizeof(IMG_UINT32) : ui32Len);
+
+		if ((ui32PacketSize > (ui32InSize - ui32InOff)) ||
+			(ui32Len > (*pui32OutSize - ui32OutOff)))
+		{
+			break;
+		}
+
+		for (i = 0; i < ui32Len; i++)
+		{
+			pui8Out[ui32OutOff + i] = (ui32Header & DEBUG_COMPRESSED_PACKET_REPEAT) ?
+				pui8In[ui32InOff + sizeof(IMG_UINT32) + (i % sizeof(IMG_UINT32))] :
+				pui8In[ui32InOff + sizeof(IMG_UINT32) + i];
+		}
+
+		ui32InOff += ui32PacketSize;
+		ui32OutOff += ui32Len;
+	}
+
+	*pui32OutSize = ui32OutOff;
+
+	return(ui32InOff);
+}
+
 /* 
 	DBG STREAM abstract types
 */
@@ -0,0 +1,90 @@
+/*************************************************************************/ /*!
+@File
+@Title          RGX firmware trace stream definitions
+@Copyright      Copyright (c) Imagination Technologies Ltd. All Rights Reserved
+@Description    Layout of the packets the host driver writes to the firmware
+                trace Transport Layer stream
+@License        Dual MIT/GPLv2
+
+The contents of this file are subject to the MIT license as set out below.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+Alternatively, the contents of this file may be used under the terms of
+the GNU General Public License Version 2 ("GPL") in which case the provisions
+of GPL are applicable instead of those above.
+
+If you wish to allow use of your version of this file only under the terms of
+GPL, and not to allow others to use your version of this file under the terms
+of the MIT license, indicate your decision by deleting the provisions above
+and replace them with the notice and other provisions required by GPL as set
+out in the file called "GPL-COPYING" included in this distribution. If you do
+not delete the provisions above, a recipient may use your version of this file
+under the terms of either the MIT license or GPL.
+
+This License is also included in this distribution in the file called
+"MIT-COPYING".
+
+EXCEPT AS OTHERWISE STATED IN A NEGOTIATED AGREEMENT: (A) THE SOFTWARE IS
+PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT; AND (B) IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/ /**************************************************************************/
+#ifndef RGX_FWTRACE_KM_H_
+#define RGX_FWTRACE_KM_H_
+
+/*
+ * The host driver copies new firmware trace buffer entries, undecoded, into
+ * the "fwtrace" TL stream. Each TL packet holds one RGX_FWTRACE_STREAM_HDR
+ * followed by ui32DWords raw trace buffer dwords and, if
+ * RGX_FWTRACE_STREAM_FLAG_ASSERT is set, an RGXFWIF_ASSERTBUF. Decoding with
+ * the rgx_fwif_sf.h string table is left to the user mode reader.
+ */
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+#include "img_types.h"
+
+#define RGX_FWTRACE_STREAM_NAME					"fwtrace"
+
+/*! Maximum number of trace dwords carried by one packet */
+#define RGX_FWTRACE_STREAM_MAX_DWORDS			1200
+
+/*! Entries before this packet were lost, the reader must resynchronise on
+    the next valid log ID */
+#define RGX_FWTRACE_STREAM_FLAG_DISCONTINUITY	(1U << 0)
+/*! The firmware thread has asserted, the assert buffer follows the data */
+#define RGX_FWTRACE_STREAM_FLAG_ASSERT			(1U << 1)
+
+typedef struct _RGX_FWTRACE_STREAM_HDR_
+{
+	IMG_UINT32	ui32ThreadID;		/*!< Firmware thread the entries belong to */
+	IMG_UINT32	ui32StartPos;		/*!< Trace buffer index of the first dword */
+	IMG_UINT32	ui32DWords;			/*!< Trace dwords following this header */
+	IMG_UINT32	ui32LogType;		/*!< Firmware log type when streamed */
+	IMG_UINT32	ui32Flags;			/*!< RGX_FWTRACE_STREAM_FLAG_* */
+	IMG_UINT32	ui32Reserved;
+} RGX_FWTRACE_STREAM_HDR;
+
+#if defined (__cplusplus)
+}
+#endif
+
+#endif /* RGX_FWTRACE_KM_H_ */
+
+/******************************************************************************
+ End of file
+******************************************************************************/
@@ -34,6 +34,7 @@
 #include "dc_mrfld.h"
 #include "pwr_mgmt.h"
 #include "psb_drv.h"
+#include "pvr_debugfs.h"
 
 #if !defined(SUPPORT_DRM)
 #error "SUPPORT_DRM must be set"
@@ -53,10 +54,16 @@ static DC_MRFLD_DEVICE *gpsDevice;
 #define DC_MRFLD_STRIDE_ALIGN 64
 #define DC_MRFLD_STRIDE_ALIGN_MASK (DC_MRFLD_STRIDE_ALIGN - 1)
 
-struct power_off_req {
-	struct delayed_work work;
-	u32 power_off_islands;
-};
+/*
+ * vsync intervals longer than this are gaps where the interrupt was off
+ * (or missed), not a refresh period, and don't feed the prediction
+ */
+#define DC_MRFLD_VSYNC_MAX_PERIOD_NS (25 * NSEC_PER_MSEC)
+
+/*late latching is off until a margin is set through debugfs*/
+#define DC_MRFLD_LATE_LATCH_MARGIN_US 0
+
+static void display_power_work(struct work_struct *work);
 
 static IMG_PIXFMT DC_MRFLD_Supported_PixelFormats[] = {
 	/*supported RGB formats*/
@@ -454,14 +461,130 @@ static bool _Can_Flip(int iPipe)
 	return ret;
 }
 
+static void _Vsync_Update_Prediction(int iPipe, ktime_t sNow)
+{
+	struct DC_MRFLD_VSYNC_INFO *psInfo = &gpsDevice->asVsyncInfo[iPipe];
+	s64 iDeltaNs;
+
+	if (ktime_to_ns(psInfo->sLastVsync)) {
+		iDeltaNs = ktime_to_ns(ktime_sub(sNow, psInfo->sLastVsync));
+
+		if (iDeltaNs > 0 && iDeltaNs <= DC_MRFLD_VSYNC_MAX_PERIOD_NS) {
+			/*
+			 * follow small jitter with a 1/8 moving average, a
+			 * larger step means the refresh rate changed
+			 */
+			if (!psInfo->iPeriodNs ||
+			    abs64(iDeltaNs - psInfo->iPeriodNs) >
+					(psInfo->iPeriodNs >> 2))
+				psInfo->iPeriodNs = iDeltaNs;
+			else
+				psInfo->iPeriodNs +=
+					(iDeltaNs - psInfo->iPeriodNs) >> 3;
+		}
+	}
+
+	psInfo->sLastVsync = sNow;
+}
+
+/*
+ * time left until the predicted next vblank on this pipe, negative if
+ * there's no reliable prediction (vsync was off or an interrupt is late)
+ */
+static s64 _Vsync_Predict_Remaining(int iPipe, ktime_t sNow)
+{
+	struct DC_MRFLD_VSYNC_INFO *psInfo = &gpsDevice->asVsyncInfo[iPipe];
+	s64 iSinceNs;
+
+	if (!psInfo->iPeriodNs || !ktime_to_ns(psInfo->sLastVsync))
+		return -1;
+
+	iSinceNs = ktime_to_ns(ktime_sub(sNow, psInfo->sLastVsync));
+	if (iSinceNs < 0 || iSinceNs >= psInfo->iPeriodNs)
+		return -1;
+
+	return psInfo->iPeriodNs - iSinceNs;
+}
+
+static void _Record_Flip_Latency(DC_MRFLD_FLIP *psFlip, int iPipe,
+				ktime_t sScanout)
+{
+	struct DC_MRFLD_VSYNC_INFO *psInfo = &gpsDevice->asVsyncInfo[iPipe];
+	u64 uiLatencyUs, uiLatencyMs;
+	int iBucket;
+
+	if (!ktime_to_ns(psFlip->sQueueTime))
+		return;
+
+	uiLatencyUs = ktime_to_us(ktime_sub(sScanout, psFlip->sQueueTime));
+	uiLatencyMs = div_u64(uiLatencyUs, USEC_PER_MSEC);
+
+	/*power of two buckets in ms, starting at 2ms*/
+	if (uiLatencyMs >= (1 << DC_MRFLD_LATENCY_BUCKETS))
+		iBucket = DC_MRFLD_LATENCY_BUCKETS - 1;
+	else
+		iBucket = max(fls((u32)uiLatencyMs) - 1, 0);
+
+	psInfo->auiLatency[iBucket]++;
+	psInfo->uiLatencyCount++;
+	psInfo->uiLatencySumUs += uiLatencyUs;
+	if (uiLatencyUs > psInfo->uiLatencyMaxUs)
+		psInfo->uiLatencyMaxUs = uiLatencyUs;
+}
+
+/*
+ * A flip that arrives while the previous one has been written to the
+ * display controller but not yet latched by a vblank can simply overwrite
+ * the plane registers, provided the predicted vblank is far enough away
+ * that the writes can't straddle it. Returns the flip that would be
+ * superseded, or NULL if the new flip has to be queued.
+ */
+static DC_MRFLD_FLIP *_Late_Latch_Flip(int iPipe)
+{
+	struct list_head *psFlipQueue;
+	DC_MRFLD_FLIP *psFlip, *psTmp;
+	DC_MRFLD_FLIP *psUpdatedFlip = IMG_NULL;
+	s64 iRemainingNs;
+
+	if (!gpsDevice->uiLateLatchMarginUs)
+		return IMG_NULL;
+
+	psFlipQueue = &gpsDevice->sFlipQueues[iPipe];
+	list_for_each_entry_safe(psFlip, psTmp, psFlipQueue, sFlips[iPipe])
+	{
+		if (psFlip->eFlipStates[iPipe] == DC_MRFLD_FLIP_QUEUED)
+			return IMG_NULL;
+
+		if (psFlip->eFlipStates[iPipe] == DC_MRFLD_FLIP_DC_UPDATED) {
+			if (psUpdatedFlip)
+				return IMG_NULL;
+			psUpdatedFlip = psFlip;
+		}
+	}
+
+	/*a flip asking for a minimum display period must be shown*/
+	if (!psUpdatedFlip || psUpdatedFlip->asPipeInfo[iPipe].uiSwapInterval)
+		return IMG_NULL;
+
+	iRemainingNs = _Vsync_Predict_Remaining(iPipe, ktime_get());
+	if (iRemainingNs < (s64)gpsDevice->uiLateLatchMarginUs * NSEC_PER_USEC)
+		return IMG_NULL;
+
+	return psUpdatedFlip;
+}
+
 static void _Dispatch_Flip(DC_MRFLD_FLIP *psFlip)
 {
+	DC_MRFLD_FLIP *psSupersededFlip;
 	DC_MRFLD_SURF_CUSTOM *psSurfCustom;
 	DC_MRFLD_BUFFER *pasBuffers;
 	IMG_UINT32 uiNumBuffers;
 	int type, index, pipe;
 	int i, j;
 	bool send_wms = false;
+	bool can_flip;
+	IMG_UINT32 uiPowerIslands;
+	IMG_BOOL bPowered;
 
 	if (!gpsDevice || !psFlip) {
 		DRM_ERROR("%s: Invalid Flip\n", __func__);
@@ -541,6 +664,27 @@ static void _Dispatch_Flip(DC_MRFLD_FLIP *psFlip)
 	mutex_unlock(&gpsDevice->sMappingLock);
 
 	mutex_lock(&gpsDevice->sFlipQueueLock);
+
+	/*turn on pipe power island based on active pipes*/
+	for (i = 0; i < MAX_PIPE_NUM; i++) {
+		if (!psFlip->bActivePipes[i] || !gpsDevice->bFlipEnabled[i] ||
+		    !DCCBIsPipeActive(gpsDevice->psDrmDevice, i))
+			continue;
+
+		if (i == 0)
+			psFlip->uiPowerIslands |= OSPM_DISPLAY_A;
+		else
+			psFlip->uiPowerIslands |= OSPM_DISPLAY_B;
+	}
+
+	/*
+	 * hold every island this flip needs until all its pipes have been
+	 * programmed, so the per pipe get/put in _Do_Flip only adjusts
+	 * reference counts instead of cycling the power rails
+	 */
+	uiPowerIslands = psFlip->uiPowerIslands;
+	bPowered = power_island_get(uiPowerIslands);
+
 	/* dispatch this flip*/
 	for (i = 0; i < MAX_PIPE_NUM; i++) {
 		if (psFlip->bActivePipes[i] && gpsDevice->bFlipEnabled[i]) {
@@ -548,22 +692,34 @@ static void _Dispatch_Flip(DC_MRFLD_FLIP *psFlip)
 			if (!DCCBIsPipeActive(gpsDevice->psDrmDevice, i))
 				continue;
 
-			/*turn on pipe power island based on active pipes*/
-			if (i == 0)
-				psFlip->uiPowerIslands |= OSPM_DISPLAY_A;
-			else
-				psFlip->uiPowerIslands |= OSPM_DISPLAY_B;
-
 			psFlip->asPipeInfo[i].uiSwapInterval =
 				psFlip->uiSwapInterval;
 
-			/* if there's no pending queued flip, flip it*/
-			if (_Can_Flip(i)) {
+			/*
+			 * if there's no pending queued flip, flip it; a flip
+			 * that can be latched before the next vblank replaces
+			 * the one which hasn't been displayed yet
+			 */
+			can_flip = _Can_Flip(i);
+			psSupersededFlip = can_flip ? IMG_NULL :
+						_Late_Latch_Flip(i);
+			if (can_flip || psSupersededFlip) {
 				/* don't queue it, if failed to update DC*/
 				if (!_Do_Flip(psFlip,i))
 					continue;
 				else if (i != DC_PIPE_B)
 					send_wms = true;
+
+				/*
+				 * the superseded flip is retired on the next
+				 * vsync along with the displayed one, which
+				 * also balances its vsync and DSR references
+				 */
+				if (psSupersededFlip) {
+					psSupersededFlip->eFlipStates[i] =
+						DC_MRFLD_FLIP_DISPLAYED;
+					gpsDevice->asVsyncInfo[i].uiLateLatched++;
+				}
 			}
 
 			/*increase refCount*/
@@ -575,6 +731,9 @@ static void _Dispatch_Flip(DC_MRFLD_FLIP *psFlip)
 		}
 	}
 
+	if (bPowered)
+		power_island_put(uiPowerIslands);
+
 	/* if failed to dispatch, skip this flip*/
 	if (!psFlip->uiRefCount) {
 		DCDisplayConfigurationRetired(psFlip->hConfigData);
@@ -636,6 +795,8 @@ static void _Queue_Flip(IMG_HANDLE hConfigData, IMG_HANDLE *ahBuffers,
 
 	psFlip->hConfigData = hConfigData;
 
+	psFlip->sQueueTime = ktime_get();
+
 	/*queue it to flip queue*/
 	_Dispatch_Flip(psFlip);
 }
@@ -646,6 +807,7 @@ static int _Vsync_ISR(struct drm_device *psDrmDev, int iPipe)
 	DC_MRFLD_FLIP *psFlip, *psTmp;
 	DC_MRFLD_FLIP *psNextFlip;
 	IMG_UINT32 eFlipState;
+	ktime_t sVsyncTime;
 
 	if (!gpsDevice)
 		return IMG_TRUE;
@@ -653,9 +815,13 @@ static int _Vsync_ISR(struct drm_device *psDrmDev, int iPipe)
 	if (iPipe != DC_PIPE_A && iPipe != DC_PIPE_B)
 		return IMG_FALSE;
 
+	sVsyncTime = ktime_get();
+
 	/* acquire flip queue mutex */
 	mutex_lock(&gpsDevice->sFlipQueueLock);
 
+	_Vsync_Update_Prediction(iPipe, sVsyncTime);
+
 	psFlipQueue = &gpsDevice->sFlipQueues[iPipe];
 
 	/*
@@ -694,6 +860,7 @@ static int _Vsync_ISR(struct drm_device *psDrmDev, int iPipe)
 			}
 		} else if (eFlipState == DC_MRFLD_FLIP_DC_UPDATED) {
 			psFlip->eFlipStates[iPipe] = DC_MRFLD_FLIP_DISPLAYED;
+			_Record_Flip_Latency(psFlip, iPipe, sVsyncTime);
 			break;
 		}
 	}
@@ -1357,6 +1524,156 @@ static IMG_VOID _SystemBuffer_Deinit(DC_MRFLD_DEVICE *psDevice)
 	}
 }
 
+static void *_Debugfs_SeqStart(struct seq_file *psSeqFile, loff_t *puiPos)
+{
+	/*single record, shown in one go*/
+	return (*puiPos == 0) ? (void *)1 : NULL;
+}
+
+static void _Debugfs_SeqStop(struct seq_file *psSeqFile, void *pvData)
+{
+}
+
+static void *_Debugfs_SeqNext(struct seq_file *psSeqFile, void *pvData,
+				loff_t *puiPos)
+{
+	return NULL;
+}
+
+static int _Flip_Latency_Show(struct seq_file *psSeqFile, void *pvData)
+{
+	DC_MRFLD_DEVICE *psDevice = psSeqFile->private;
+	struct DC_MRFLD_VSYNC_INFO *psInfo;
+	int i, j;
+
+	mutex_lock(&psDevice->sFlipQueueLock);
+
+	for (i = DC_PIPE_A; i <= DC_PIPE_B; i++) {
+		psInfo = &psDevice->asVsyncInfo[i];
+
+		seq_printf(psSeqFile, "pipe %d: vsync period %lld ns, "
+			   "late latched %u\n", i,
+			   psInfo->iPeriodNs, psInfo->uiLateLatched);
+		seq_printf(psSeqFile, "  flips %u, avg %llu us, max %llu us\n",
+			   psInfo->uiLatencyCount,
+			   psInfo->uiLatencyCount ?
+				div_u64(psInfo->uiLatencySumUs,
+					psInfo->uiLatencyCount) : 0,
+			   psInfo->uiLatencyMaxUs);
+
+		for (j = 0; j < DC_MRFLD_LATENCY_BUCKETS - 1; j++)
+			seq_printf(psSeqFile, "  <%4d ms: %u\n", 2 << j,
+				   psInfo->auiLatency[j]);
+		seq_printf(psSeqFile, "  >=%3d ms: %u\n", 1 << j,
+			   psInfo->auiLatency[j]);
+	}
+
+	mutex_unlock(&psDevice->sFlipQueueLock);
+	return 0;
+}
+
+static struct seq_operations gsFlipLatencyReadOps = {
+	.start = _Debugfs_SeqStart,
+	.stop = _Debugfs_SeqStop,
+	.next = _Debugfs_SeqNext,
+	.show = _Flip_Latency_Show,
+};
+
+/*any write clears the latency statistics*/
+static ssize_t _Flip_Latency_Reset(const char __user *pszBuffer,
+				   size_t uiCount, loff_t uiPosition,
+				   void *pvData)
+{
+	DC_MRFLD_DEVICE *psDevice = pvData;
+	struct DC_MRFLD_VSYNC_INFO *psInfo;
+	int i;
+
+	mutex_lock(&psDevice->sFlipQueueLock);
+
+	for (i = 0; i < MAX_PIPE_NUM; i++) {
+		psInfo = &psDevice->asVsyncInfo[i];
+
+		psInfo->uiLateLatched = 0;
+		psInfo->uiLatencyCount = 0;
+		psInfo->uiLatencySumUs = 0;
+		psInfo->uiLatencyMaxUs = 0;
+		memset(psInfo->auiLatency, 0, sizeof(psInfo->auiLatency));
+	}
+
+	mutex_unlock(&psDevice->sFlipQueueLock);
+	return uiCount;
+}
+
+static int _Late_Latch_Margin_Show(struct seq_file *psSeqFile, void *pvData)
+{
+	DC_MRFLD_DEVICE *psDevice = psSeqFile->private;
+
+	seq_printf(psSeqFile, "%u\n", psDevice->uiLateLatchMarginUs);
+	return 0;
+}
+
+static struct seq_operations gsLateLatchMarginReadOps = {
+	.start = _Debugfs_SeqStart,
+	.stop = _Debugfs_SeqStop,
+	.next = _Debugfs_SeqNext,
+	.show = _Late_Latch_Margin_Show,
+};
+
+static ssize_t _Late_Latch_Margin_Set(const char __user *pszBuffer,
+				      size_t uiCount, loff_t uiPosition,
+				      void *pvData)
+{
+	DC_MRFLD_DEVICE *psDevice = pvData;
+	char acBuffer[12];
+	unsigned int uiMarginUs;
+
+	if (uiPosition != 0)
+		return -EIO;
+
+	if (!uiCount || uiCount >= sizeof(acBuffer))
+		return -EINVAL;
+
+	if (copy_from_user(acBuffer, pszBuffer, uiCount))
+		return -EFAULT;
+
+	acBuffer[uiCount] = '\0';
+	if (kstrtouint(acBuffer, 0, &uiMarginUs))
+		return -EINVAL;
+
+	mutex_lock(&psDevice->sFlipQueueLock);
+	psDevice->uiLateLatchMarginUs = uiMarginUs;
+	mutex_unlock(&psDevice->sFlipQueueLock);
+
+	return uiCount;
+}
+
+static void _Debugfs_Init(DC_MRFLD_DEVICE *psDevice)
+{
+	/*statistics only, the display works without them*/
+	if (PVRDebugFSCreateEntry("dc_flip_latency", NULL,
+				  &gsFlipLatencyReadOps,
+				  _Flip_Latency_Reset,
+				  psDevice,
+				  &psDevice->psLatencyEntry))
+		DRM_INFO("Failed to create dc_flip_latency debugfs entry\n");
+
+	if (PVRDebugFSCreateEntry("dc_late_latch_margin_us", NULL,
+				  &gsLateLatchMarginReadOps,
+				  _Late_Latch_Margin_Set,
+				  psDevice,
+				  &psDevice->psMarginEntry))
+		DRM_INFO("Failed to create dc_late_latch_margin_us entry\n");
+}
+
+static void _Debugfs_Deinit(DC_MRFLD_DEVICE *psDevice)
+{
+	if (psDevice->psMarginEntry)
+		PVRDebugFSRemoveEntry(psDevice->psMarginEntry);
+
+	if (psDevice->psLatencyEntry)
+		PVRDebugFSRemoveEntry(psDevice->psLatencyEntry);
+}
+
 static PVRSRV_ERROR DC_MRFLD_init(struct drm_device *psDrmDev)
 {
 	PVRSRV_ERROR eRes = PVRSRV_OK;
@@ -1403,9 +1720,14 @@ static PVRSRV_ERROR DC_MRFLD_init(struct drm_device *psDrmDev)
 		psDevice->bFlipEnabled[i] = IMG_TRUE;
 	}
 
+	psDevice->uiLateLatchMarginUs = DC_MRFLD_LATE_LATCH_MARGIN_US;
+
 	/*init plane pipe mapping lock */
 	mutex_init(&psDevice->sMappingLock);
 
+	/*init deferred extra power island off*/
+	INIT_DELAYED_WORK(&psDevice->sPowerOffWork, display_power_work);
+
 	/*init plane pipe mapping */
 	for (i = 1; i < DC_PLANE_MAX; i++) {
 		for (j = 0; j < MAX_PLANE_INDEX; j++) {
@@ -1431,6 +1753,8 @@ static PVRSRV_ERROR DC_MRFLD_init(struct drm_device *psDrmDev)
 
 	gpsDevice = psDevice;
 
+	_Debugfs_Init(psDevice);
+
 	return PVRSRV_OK;
 reg_error:
 	_SystemBuffer_Deinit(psDevice);
@@ -1444,6 +1768,10 @@ static PVRSRV_ERROR DC_MRFLD_exit(void)
 	if (!gpsDevice)
 		return PVRSRV_ERROR_INVALID_PARAMS;
 
+	_Debugfs_Deinit(gpsDevice);
+
+	cancel_delayed_work_sync(&gpsDevice->sPowerOffWork);
+
 	/*unregister display device*/
 	DCUnregisterDevice(gpsDevice->hSrvHandle);
 
@@ -1638,27 +1966,27 @@ int DC_MRFLD_Enable_Plane(int type, int index, u32 ctx)
 	return err;
 }
 
-void display_power_work(struct work_struct *work)
+static void display_power_work(struct work_struct *work)
 {
-	struct power_off_req *req = container_of(work,
-				struct power_off_req, work.work);
+	IMG_UINT32 uiPowerIslands;
 
 	mutex_lock(&gpsDevice->sFlipQueueLock);
 	mutex_lock(&gpsDevice->sMappingLock);
 
-	_Disable_ExtraPowerIslands(gpsDevice, req->power_off_islands);
+	/*one transition for every plane disabled since the work was queued*/
+	uiPowerIslands = gpsDevice->uiPendingPowerOffIslands;
+	gpsDevice->uiPendingPowerOffIslands = 0;
+
+	_Disable_ExtraPowerIslands(gpsDevice, uiPowerIslands);
 
 	mutex_unlock(&gpsDevice->sMappingLock);
 	mutex_unlock(&gpsDevice->sFlipQueueLock);
-
-	kfree(req);
 }
 
 int DC_MRFLD_Disable_Plane(int type, int index, u32 ctx)
 {
 	int err = 0;
 	IMG_INT32 *ui32ActivePlanes;
-	struct power_off_req *req;
 	struct drm_psb_private *dev_priv = gpsDevice->psDrmDevice->dev_private;
 	IMG_UINT32 uiExtraPowerIslands = 0;
 
@@ -1694,19 +2022,17 @@ int DC_MRFLD_Disable_Plane(int type, int index, u32 ctx)
 		/* power off extra power islands if required */
 		uiExtraPowerIslands = DC_MRFLD_ExtraPowerIslands[type][index];
 		if (uiExtraPowerIslands) {
-			req = kzalloc(sizeof(*req), GFP_KERNEL);
-			if (!req) {
-				DRM_ERROR("fail to alloc power_off_req\n");
-				goto out_mapping;
-			}
-			INIT_DELAYED_WORK(&req->work, display_power_work);
-
-			req->power_off_islands = uiExtraPowerIslands;
-
+			/*
+			 * planes disabled by the same commit join the pending
+			 * request, a no-op if the work is already queued
+			 */
+			gpsDevice->uiPendingPowerOffIslands |=
+				uiExtraPowerIslands;
 			queue_delayed_work(dev_priv->power_wq,
-					   &req->work, msecs_to_jiffies(32));
+					   &gpsDevice->sPowerOffWork,
+					   msecs_to_jiffies(32));
 		}
-out_mapping:
+
 		/* update plane pipe mapping */
 		_Update_PlanePipeMapping(gpsDevice, type, index, -1);
 	}
@@ -84,6 +84,23 @@ typedef struct {
 	DC_MRFLD_SURF_CUSTOM sContext[MAX_CONTEXT_COUNT];
 } DC_MRFLD_BUFFER;
 
+/* flip-to-scanout latency histogram: <2ms, <4ms, ... <128ms, >=128ms */
+#define DC_MRFLD_LATENCY_BUCKETS 8
+
+/*per pipe vsync prediction and flip latency statistics*/
+struct DC_MRFLD_VSYNC_INFO {
+	/*time of the last vsync interrupt*/
+	ktime_t sLastVsync;
+	/*smoothed vsync period in ns, 0 until it is known*/
+	s64 iPeriodNs;
+	/*flips late latched over a not yet displayed flip*/
+	IMG_UINT32 uiLateLatched;
+	IMG_UINT32 uiLatencyCount;
+	u64 uiLatencySumUs;
+	u64 uiLatencyMaxUs;
+	IMG_UINT32 auiLatency[DC_MRFLD_LATENCY_BUCKETS];
+};
+
 /*Display Controller Device*/
 typedef struct {
 	IMG_HANDLE hSrvHandle;
@@ -112,6 +129,21 @@ typedef struct {
 	IMG_UINT32 ui32PlanePipeMapping[DC_PLANE_MAX][MAX_PLANE_INDEX];
 	IMG_UINT32 ui32ExtraPowerIslandsStatus;
 
+	/*extra power islands of disabled planes, turned off together*/
+	struct delayed_work sPowerOffWork;
+	IMG_UINT32 uiPendingPowerOffIslands;
+
+	/*vsync prediction, protected by sFlipQueueLock*/
+	struct DC_MRFLD_VSYNC_INFO asVsyncInfo[MAX_PIPE_NUM];
+	/*
+	 * a flip may replace a not yet displayed one if the predicted
+	 * next vblank is at least this far away, 0 disables late latching
+	 */
+	IMG_UINT32 uiLateLatchMarginUs;
+
+	/*debugfs entries*/
+	struct dentry *psLatencyEntry;
+	struct dentry *psMarginEntry;
 } DC_MRFLD_DEVICE;
 
 typedef struct {
@@ -140,6 +172,8 @@ typedef struct {
 	IMG_HANDLE hConfigData;
 	IMG_UINT32 uiSwapInterval;
 	IMG_UINT32 uiPowerIslands;
+	/*time this flip was queued, for latency statistics*/
+	ktime_t sQueueTime;
 	DC_MRFLD_BUFFER asBuffers[0];
 } DC_MRFLD_FLIP;
 
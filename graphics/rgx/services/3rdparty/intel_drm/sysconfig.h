@@ -136,6 +136,7 @@ static IMG_UINT32 gauiBIFTilingHeapXStrides[RGXFWIF_NUM_BIF_TILING_CONFIGS] =
 
 static PVRSRV_SYSTEM_CONFIG sSysConfig = {
 	.pszSystemName = "Merrifield with Rogue",
+	.uiSysFlags = PVRSRV_SYS_FLAGS_PARALLEL_POWER,
 	.uiDeviceCount = sizeof(sDevices)/sizeof(PVRSRV_DEVICE_CONFIG),
 	.pasDevices = &sDevices[0],
 
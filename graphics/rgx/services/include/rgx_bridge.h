@@ -87,7 +87,13 @@ extern "C" {
 #define PVRSRV_BRIDGE_RGXRAY_CMD_LAST     (PVRSRV_BRIDGE_RGXRAY_START -1)
 #endif
 #define PVRSRV_BRIDGE_REGCONFIG_START  (PVRSRV_BRIDGE_RGXRAY_CMD_LAST +1)
-#define PVRSRV_BRIDGE_LAST_RGX_CMD     (PVRSRV_BRIDGE_REGCONFIG_CMD_LAST)
+
+/* Commands added to a module after its group shipped go in a further group
+ * appended here, so the IDs of every existing command keep their values.
+ */
+#define PVRSRV_BRIDGE_RGXHWPERF2_START (PVRSRV_BRIDGE_REGCONFIG_CMD_LAST +1)
+#define PVRSRV_BRIDGE_RGXCMP2_START    (PVRSRV_BRIDGE_RGXHWPERF2_CMD_LAST +1)
+#define PVRSRV_BRIDGE_LAST_RGX_CMD     (PVRSRV_BRIDGE_RGXCMP2_CMD_LAST)
 
 #if defined (__cplusplus)
 }
@@ -55,6 +55,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "sync_server.h"
 #include "pvrsrv.h"
 #include "debug_request_ids.h"
+#include "dllist.h"
 
 #if defined(PVR_RI_DEBUG)
 #include "ri_server.h"
@@ -77,8 +78,25 @@ struct _DC_DISPLAY_CONTEXT_
 	IMG_HANDLE		hMISR;
 	IMG_HANDLE		hDebugNotify;
 	IMG_PVOID		hTimer;
+
+	/*
+		Buffers which are no longer part of any configuration but are kept
+		mapped, oldest first. hMapCacheLock also protects the map state of
+		every buffer belonging to this context.
+	*/
+	POS_LOCK		hMapCacheLock;
+	DLLIST_NODE		sMapCache;
+	IMG_UINT32		ui32MapCacheCount;
+	IMG_UINT32		ui32MapCacheHits;
+	IMG_UINT32		ui32MapCacheMisses;
 };
 
+/*
+	Compositors cycle through a handful of buffers per layer, keep enough
+	mappings around for a few layers' worth
+*/
+#define DC_MAP_CACHE_SIZE	16
+
 struct _DC_DEVICE_
 {
 	const DC_DEVICE_FUNCTIONS	*psFuncTable;
@@ -130,7 +148,9 @@ struct _DC_BUFFER_
 	IMG_UINT32			ui32MapCount;
 	IMG_UINT32			ui32RefCount;
 	POS_LOCK			hLock;
-	POS_LOCK			hMapLock;
+	IMG_BOOL			bMapped;		/*!< DC mapping exists, it's cached if ui32MapCount is 0 */
+	IMG_BOOL			bCacheable;		/*!< Cleared once the client has freed the buffer */
+	DLLIST_NODE			sMapCacheNode;	/*!< Link in the display context's map cache */
 };
 
 typedef struct _DC_CMD_RDY_DATA_
@@ -242,6 +262,23 @@ static IMG_VOID _DCDeviceReleaseRef(DC_DEVICE *psDevice)
 					  __FUNCTION__, psDevice, ui32RefCount);
 }
 
+static PVRSRV_ERROR _DCMapCacheInit(DC_DISPLAY_CONTEXT *psDisplayContext)
+{
+	dllist_init(&psDisplayContext->sMapCache);
+	psDisplayContext->ui32MapCacheCount = 0;
+	psDisplayContext->ui32MapCacheHits = 0;
+	psDisplayContext->ui32MapCacheMisses = 0;
+
+	return OSLockCreate(&psDisplayContext->hMapCacheLock, LOCK_TYPE_NONE);
+}
+
+static IMG_VOID _DCMapCacheDeInit(DC_DISPLAY_CONTEXT *psDisplayContext)
+{
+	/* Every cached buffer holds a reference on the context */
+	PVR_ASSERT(dllist_is_empty(&psDisplayContext->sMapCache));
+	OSLockDestroy(psDisplayContext->hMapCacheLock);
+}
+
 static IMG_VOID _DCDisplayContextAcquireRef(DC_DISPLAY_CONTEXT *psDisplayContext)
 {
 	OSLockAcquire(psDisplayContext->hLock);
@@ -273,6 +310,7 @@ static IMG_VOID _DCDisplayContextReleaseRef(DC_DISPLAY_CONTEXT *psDisplayContext
 		SCPDestroy(psDisplayContext->psSCPContext);
 		psDevice->psFuncTable->pfnContextDestroy(psDisplayContext->hDisplayContext);
 		_DCDeviceReleaseRef(psDevice);
+		_DCMapCacheDeInit(psDisplayContext);
 		OSLockDestroy(psDisplayContext->hLock);
 		OSFreeMem(psDisplayContext);
 	}
@@ -350,7 +388,6 @@ static IMG_VOID _DCBufferReleaseRef(DC_BUFFER *psBuffer)
 			default:
 					PVR_ASSERT(IMG_FALSE);
 		}
-		OSLockDestroy(psBuffer->hMapLock);
 		OSLockDestroy(psBuffer->hLock);
 		OSFreeMem(psBuffer);
 	}
@@ -358,57 +395,142 @@ static IMG_VOID _DCBufferReleaseRef(DC_BUFFER *psBuffer)
 					  __FUNCTION__, psBuffer, ui32RefCount);
 }
 
+/*
+	Drop the DC mapping of a buffer which has been taken out of the map
+	cache (or was never put in it). Must be called without hMapCacheLock
+	held as this can free the buffer.
+*/
+static IMG_VOID _DCBufferUnmapDevice(DC_BUFFER *psBuffer)
+{
+	DC_DEVICE *psDevice = psBuffer->psDisplayContext->psDevice;
+
+	if(psDevice->psFuncTable->pfnBufferUnmap)
+	{
+		psDevice->psFuncTable->pfnBufferUnmap(psBuffer->hBuffer);
+	}
+
+	_DCBufferReleaseRef(psBuffer);
+}
+
 static PVRSRV_ERROR _DCBufferMap(DC_BUFFER *psBuffer)
 {
+	DC_DISPLAY_CONTEXT *psDisplayContext = psBuffer->psDisplayContext;
 	PVRSRV_ERROR eError = PVRSRV_OK;
 
-	OSLockAcquire(psBuffer->hMapLock);
+	OSLockAcquire(psDisplayContext->hMapCacheLock);
 	if (psBuffer->ui32MapCount++ == 0)
 	{
-		DC_DEVICE *psDevice = psBuffer->psDisplayContext->psDevice;
-
-		if(psDevice->psFuncTable->pfnBufferMap)
+		if (psBuffer->bMapped)
 		{
-			eError = psDevice->psFuncTable->pfnBufferMap(psBuffer->hBuffer);
-			if (eError != PVRSRV_OK)
+			/* Still mapped from an earlier configuration */
+			dllist_remove_node(&psBuffer->sMapCacheNode);
+			psDisplayContext->ui32MapCacheCount--;
+			psDisplayContext->ui32MapCacheHits++;
+		}
+		else
+		{
+			DC_DEVICE *psDevice = psDisplayContext->psDevice;
+
+			psDisplayContext->ui32MapCacheMisses++;
+
+			if(psDevice->psFuncTable->pfnBufferMap)
 			{
-				goto out_unlock;
+				eError = psDevice->psFuncTable->pfnBufferMap(psBuffer->hBuffer);
+				if (eError != PVRSRV_OK)
+				{
+					psBuffer->ui32MapCount--;
+					goto out_unlock;
+				}
 			}
-		}
 
-		_DCBufferAcquireRef(psBuffer);
+			psBuffer->bMapped = IMG_TRUE;
+			_DCBufferAcquireRef(psBuffer);
+		}
 	}
 
 	DC_REFCOUNT_PRINT("%s: DC buffer %p, MapCount = %d",
 					  __FUNCTION__, psBuffer, psBuffer->ui32MapCount);
 
 out_unlock:
-	OSLockRelease(psBuffer->hMapLock);
+	OSLockRelease(psDisplayContext->hMapCacheLock);
 	return eError;
 }
 
 static IMG_VOID _DCBufferUnmap(DC_BUFFER *psBuffer)
 {
-	DC_DEVICE *psDevice = psBuffer->psDisplayContext->psDevice;
+	DC_DISPLAY_CONTEXT *psDisplayContext = psBuffer->psDisplayContext;
+	DC_BUFFER *psUnmapBuffer = IMG_NULL;
 	IMG_UINT32 ui32MapCount;
 
-	OSLockAcquire(psBuffer->hMapLock);
+	OSLockAcquire(psDisplayContext->hMapCacheLock);
 	ui32MapCount = --psBuffer->ui32MapCount;
-	OSLockRelease(psBuffer->hMapLock);
 
 	if (ui32MapCount == 0)
 	{
-		if(psDevice->psFuncTable->pfnBufferUnmap)
+		if (psBuffer->bCacheable)
+		{
+			/*
+				Keep the mapping for the next configuration which uses this
+				buffer, making room by dropping the least recently used one
+			*/
+			dllist_add_to_tail(&psDisplayContext->sMapCache,
+							   &psBuffer->sMapCacheNode);
+
+			if (++psDisplayContext->ui32MapCacheCount > DC_MAP_CACHE_SIZE)
+			{
+				PDLLIST_NODE psNode = dllist_get_next_node(&psDisplayContext->sMapCache);
+
+				psUnmapBuffer = IMG_CONTAINER_OF(psNode, DC_BUFFER, sMapCacheNode);
+				dllist_remove_node(psNode);
+				psDisplayContext->ui32MapCacheCount--;
+				psUnmapBuffer->bMapped = IMG_FALSE;
+			}
+		}
+		else
 		{
-			psDevice->psFuncTable->pfnBufferUnmap(psBuffer->hBuffer);
+			psBuffer->bMapped = IMG_FALSE;
+			psUnmapBuffer = psBuffer;
 		}
+	}
+	OSLockRelease(psDisplayContext->hMapCacheLock);
 
-		_DCBufferReleaseRef(psBuffer);
+	if (psUnmapBuffer)
+	{
+		_DCBufferUnmapDevice(psUnmapBuffer);
 	}
 	DC_REFCOUNT_PRINT("%s: DC Buffer %p, MapCount = %d",
 					  __FUNCTION__, psBuffer, ui32MapCount);
 }
 
+/*
+	_DCBufferUncache
+
+	The client is done with the buffer (its PMR is on the way out), so
+	stop caching its mapping. It stays mapped for as long as configurations
+	still using it are in flight.
+*/
+static IMG_VOID _DCBufferUncache(DC_BUFFER *psBuffer)
+{
+	DC_DISPLAY_CONTEXT *psDisplayContext = psBuffer->psDisplayContext;
+	IMG_BOOL bUnmap = IMG_FALSE;
+
+	OSLockAcquire(psDisplayContext->hMapCacheLock);
+	psBuffer->bCacheable = IMG_FALSE;
+	if (psBuffer->bMapped && (psBuffer->ui32MapCount == 0))
+	{
+		dllist_remove_node(&psBuffer->sMapCacheNode);
+		psDisplayContext->ui32MapCacheCount--;
+		psBuffer->bMapped = IMG_FALSE;
+		bUnmap = IMG_TRUE;
+	}
+	OSLockRelease(psDisplayContext->hMapCacheLock);
+
+	if (bUnmap)
+	{
+		_DCBufferUnmapDevice(psBuffer);
+	}
+}
+
 static PVRSRV_ERROR _DCDeviceBufferArrayCreate(IMG_UINT32 ui32BufferCount,
 											   DC_BUFFER **papsBuffers,
 											   IMG_HANDLE **pahDeviceBuffers)
@@ -439,6 +561,72 @@ static IMG_VOID _DCDeviceBufferArrayDestroy(IMG_HANDLE ahDeviceBuffers)
 	OSFreeMem(ahDeviceBuffers);
 }
 
+/*
+	_DCBufferIsRepeat
+
+	A buffer can back more than one plane of a configuration, it only
+	needs to be mapped once for the lifetime of that configuration
+*/
+static IMG_BOOL _DCBufferIsRepeat(DC_BUFFER **papsBuffers,
+								  IMG_UINT32 ui32Index)
+{
+	IMG_UINT32 i;
+
+	for (i=0;i<ui32Index;i++)
+	{
+		if (papsBuffers[i] == papsBuffers[ui32Index])
+		{
+			return IMG_TRUE;
+		}
+	}
+	return IMG_FALSE;
+}
+
+/*
+	_DCDisplayContextValidate
+
+	Validation shared by the test-only check and the commit, so a
+	configuration which passes DCDisplayContextConfigureCheck is accepted
+	as-is by DCDisplayContextConfigure. On success the caller owns the
+	device buffer handle array.
+*/
+static PVRSRV_ERROR _DCDisplayContextValidate(DC_DISPLAY_CONTEXT *psDisplayContext,
+											  IMG_UINT32 ui32PipeCount,
+											  PVRSRV_SURFACE_CONFIG_INFO *pasSurfAttrib,
+											  DC_BUFFER **papsBuffers,
+											  IMG_HANDLE **pahDeviceBuffers)
+{
+	DC_DEVICE *psDevice = psDisplayContext->psDevice;
+	IMG_HANDLE *ahBuffers;
+	PVRSRV_ERROR eError;
+
+	/* Create an array of private device specific buffer handles */
+	eError = _DCDeviceBufferArrayCreate(ui32PipeCount,
+										papsBuffers,
+										&ahBuffers);
+	if (eError != PVRSRV_OK)
+	{
+		return eError;
+	}
+
+	/* Do we need to check if this is valid config? */
+	if (psDevice->psFuncTable->pfnContextConfigureCheck)
+	{
+		eError = psDevice->psFuncTable->pfnContextConfigureCheck(psDisplayContext->hDisplayContext,
+																ui32PipeCount,
+																pasSurfAttrib,
+																ahBuffers);
+		if (eError != PVRSRV_OK)
+		{
+			_DCDeviceBufferArrayDestroy(ahBuffers);
+			return eError;
+		}
+	}
+
+	*pahDeviceBuffers = ahBuffers;
+	return PVRSRV_OK;
+}
+
 static IMG_BOOL _DCDisplayContextReady(IMG_PVOID hReadyData)
 {
 	DC_CMD_RDY_DATA *psReadyData = (DC_CMD_RDY_DATA *) hReadyData;
@@ -518,6 +706,40 @@ static IMG_VOID _DCDisplayContextConfigure(IMG_PVOID hReadyData,
 											   hCompleteData);
 }
 
+/*
+	_DCDisplayContextDrop
+
+	Called instead of _DCDisplayContextConfigure when a later config has
+	already been sent out. The config is never shown so just release what
+	was taken for it at DCDisplayContextConfigure time.
+*/
+static IMG_VOID _DCDisplayContextDrop(IMG_PVOID hReadyData,
+									  IMG_PVOID hCompleteData)
+{
+	DC_CMD_COMP_DATA *psData = hCompleteData;
+	DC_DISPLAY_CONTEXT *psDisplayContext = psData->psDisplayContext;
+	IMG_UINT32 i;
+
+	PVR_UNREFERENCED_PARAMETER(hReadyData);
+
+	DC_DEBUG_PRINT("_DCDisplayContextDrop: Command (%d) dropped", psData->ui32Token);
+
+	OSLockAcquire(psDisplayContext->hLock);
+	psDisplayContext->ui32TokenIn++;
+	OSLockRelease(psDisplayContext->hLock);
+
+	for (i = 0; i < psData->ui32BufferCount; i++)
+	{
+		_DCBufferUnmap(psData->apsBuffer[i]);
+	}
+
+	/*
+		This can't be the last reference as the display context isn't
+		destroyed until the SCP has been flushed
+	*/
+	_DCDisplayContextReleaseRef(psDisplayContext);
+}
+
 /*
 	_DCDisplayContextRun
 
@@ -829,6 +1051,10 @@ static IMG_VOID _DCDebugRequest(PVRSRV_DBGREQ_HANDLE hDebugRequestHandle, IMG_UI
 	{
 		case DEBUG_REQUEST_VERBOSITY_LOW:
 			PVR_LOG(("Configs in-flight = %d", psDisplayContext->ui32ConfigsInFlight));
+			PVR_LOG(("Buffer map cache: %d cached, %d hits, %d misses",
+					 psDisplayContext->ui32MapCacheCount,
+					 psDisplayContext->ui32MapCacheHits,
+					 psDisplayContext->ui32MapCacheMisses));
 			break;
 
 		case DEBUG_REQUEST_VERBOSITY_MEDIUM:
@@ -1050,12 +1276,6 @@ PVRSRV_ERROR DCSystemBufferAcquire(DC_DEVICE *psDevice,
 		goto fail_lock;
 	}
 
-	eError = OSLockCreate(&psNew->hMapLock, LOCK_TYPE_NONE);
-	if (eError != PVRSRV_OK)
-	{
-		goto fail_maplock;
-	}
-
 	eError = psDevice->psFuncTable->pfnBufferSystemAcquire(psDevice->hDeviceData,
 														   &uiLog2PageSize,
 														   &ui32PageCount,
@@ -1071,6 +1291,7 @@ PVRSRV_ERROR DCSystemBufferAcquire(DC_DEVICE *psDevice,
 	psNew->eType = DC_BUFFER_TYPE_SYSTEM;
 	psNew->ui32MapCount = 0;
 	psNew->ui32RefCount = 1;
+	psNew->bCacheable = IMG_TRUE;
 
 	/*
 		Creating the PMR for the system buffer is a bit tricky as there is no
@@ -1155,8 +1376,6 @@ PVRSRV_ERROR DCSystemBufferAcquire(DC_DEVICE *psDevice,
 
 fail_createpmr:
 fail_bufferacquire:
-	OSLockDestroy(psNew->hMapLock);
-fail_maplock:
 	OSLockDestroy(psNew->hLock);
 fail_lock:
 	OSFreeMem(psNew);
@@ -1167,6 +1386,7 @@ fail_nopfn:
 
 PVRSRV_ERROR DCSystemBufferRelease(DC_BUFFER *psBuffer)
 {
+	_DCBufferUncache(psBuffer);
 	PMRUnrefPMR(psBuffer->uBufferData.sAllocData.psPMR);
 	_DCBufferReleaseRef(psBuffer);
 	return PVRSRV_OK;
@@ -1198,6 +1418,12 @@ PVRSRV_ERROR DCDisplayContextCreate(DC_DEVICE *psDevice,
 		goto FailLock;
 	}
 
+	eError = _DCMapCacheInit(psDisplayContext);
+	if (eError != PVRSRV_OK)
+	{
+		goto FailMapCache;
+	}
+
 	/* Create a Software Command Processor with 4K CCB size. 
 	 * With the HWC it might be possible to reach the limit off the buffer.
 	 * This could be bad when the buffers currently on the screen can't be
@@ -1210,6 +1436,13 @@ PVRSRV_ERROR DCDisplayContextCreate(DC_DEVICE *psDevice,
 		goto FailSCP;
 	}
 
+	/*
+		Let a config whose fences are met go out ahead of an older one that
+		is still waiting, the older one is dropped as it would be replaced
+		on screen straight away
+	*/
+	SCPSetOutOfOrder(psDisplayContext->psSCPContext, IMG_TRUE);
+
 	eError = psDevice->psFuncTable->pfnContextCreate(psDevice->hDeviceData,
 													 &psDisplayContext->hDisplayContext);
 
@@ -1263,6 +1496,8 @@ FailMISR:
 FailDCDeviceContext:
 	SCPDestroy(psDisplayContext->psSCPContext);
 FailSCP:
+	_DCMapCacheDeInit(psDisplayContext);
+FailMapCache:
 	OSLockDestroy(psDisplayContext->hLock);
 FailLock:
 	OSFreeMem(psDisplayContext);
@@ -1274,45 +1509,23 @@ PVRSRV_ERROR DCDisplayContextConfigureCheck(DC_DISPLAY_CONTEXT *psDisplayContext
 											PVRSRV_SURFACE_CONFIG_INFO *pasSurfAttrib,
 											DC_BUFFER **papsBuffers)
 {
-	DC_DEVICE *psDevice = psDisplayContext->psDevice;
 	PVRSRV_ERROR eError;
 	IMG_HANDLE *ahBuffers;
 	
 	_DCDisplayContextAcquireRef(psDisplayContext);
 
-	/* Create an array of private device specific buffer handles */
-	eError = _DCDeviceBufferArrayCreate(ui32PipeCount,
-										papsBuffers,
-										&ahBuffers);
-	if (eError != PVRSRV_OK)
+	/* Test only, nothing is mapped or queued */
+	eError = _DCDisplayContextValidate(psDisplayContext,
+									   ui32PipeCount,
+									   pasSurfAttrib,
+									   papsBuffers,
+									   &ahBuffers);
+	if (eError == PVRSRV_OK)
 	{
-		goto FailBufferArrayCreate;
-	}
-
-	/* Do we need to check if this is valid config? */
-	if (psDevice->psFuncTable->pfnContextConfigureCheck)
-	{
-
-		eError = psDevice->psFuncTable->pfnContextConfigureCheck(psDisplayContext->hDisplayContext,
-																ui32PipeCount,
-																pasSurfAttrib,
-																ahBuffers);
-		if (eError != PVRSRV_OK)
-		{
-			goto FailConfigCheck;
-		}
+		_DCDeviceBufferArrayDestroy(ahBuffers);
 	}
 
-	_DCDeviceBufferArrayDestroy(ahBuffers);
-	_DCDisplayContextReleaseRef(psDisplayContext);
-	return PVRSRV_OK;
-
-FailConfigCheck:
-	_DCDeviceBufferArrayDestroy(ahBuffers);
-FailBufferArrayCreate:
 	_DCDisplayContextReleaseRef(psDisplayContext);
-
-	PVR_ASSERT(eError != PVRSRV_OK);
 	return eError;
 }
 
@@ -1328,11 +1541,10 @@ PVRSRV_ERROR DCDisplayContextConfigure(DC_DISPLAY_CONTEXT *psDisplayContext,
 									   IMG_INT32 i32AcquireFenceFd,
 									   IMG_INT32 *pi32ReleaseFenceFd)
 {
-	DC_DEVICE *psDevice = psDisplayContext->psDevice;
 	PVRSRV_ERROR eError;
 	IMG_HANDLE *ahBuffers;
 	IMG_UINT32 ui32BuffersMapped = 0;
-	IMG_UINT32 i;
+	IMG_UINT32 i, j;
 	IMG_UINT32 ui32CmdRdySize;
 	IMG_UINT32 ui32CmdCompSize;
 	IMG_UINT32 ui32CopySize;
@@ -1366,32 +1578,28 @@ PVRSRV_ERROR DCDisplayContextConfigure(DC_DISPLAY_CONTEXT *psDisplayContext,
 	/* If we get sent a NULL flip then we don't need to do the check or map */
 	if (ui32PipeCount != 0)
 	{
-		/* Create an array of private device specific buffer handles */
-		eError = _DCDeviceBufferArrayCreate(ui32PipeCount,
-											papsBuffers,
-											&ahBuffers);
+		eError = _DCDisplayContextValidate(psDisplayContext,
+										   ui32PipeCount,
+										   pasSurfAttrib,
+										   papsBuffers,
+										   &ahBuffers);
 		if (eError != PVRSRV_OK)
 		{
-			goto FailBufferArrayCreate;
+			goto FailValidate;
 		}
 	
-		/* Do we need to check if this is valid config? */
-		if (psDevice->psFuncTable->pfnContextConfigureCheck)
+		/*
+			Map all the buffers that are going to be used, once per buffer
+			however many planes it backs. Only the distinct buffers are
+			handed to the retire which unmaps them again.
+		*/
+		for (i=0;i<ui32PipeCount;i++)
 		{
-	
-			eError = psDevice->psFuncTable->pfnContextConfigureCheck(psDisplayContext->hDisplayContext,
-																	ui32PipeCount,
-																	pasSurfAttrib,
-																	ahBuffers);
-			if (eError != PVRSRV_OK)
+			if (_DCBufferIsRepeat(papsBuffers, i))
 			{
-				goto FailConfigCheck;
+				continue;
 			}
-		}
-	
-		/* Map all the buffers that are going to be used */
-		for (i=0;i<ui32PipeCount;i++)
-		{
+
 			eError = _DCBufferMap(papsBuffers[i]);
 			if (eError != PVRSRV_OK)
 			{
@@ -1406,7 +1614,7 @@ PVRSRV_ERROR DCDisplayContextConfigure(DC_DISPLAY_CONTEXT *psDisplayContext,
 					 ((sizeof(IMG_HANDLE) + sizeof(PVRSRV_SURFACE_CONFIG_INFO))
 					 * ui32PipeCount);
 	ui32CmdCompSize = sizeof(DC_CMD_COMP_DATA) + 
-					  (sizeof(DC_BUFFER *) * ui32PipeCount);
+					  (sizeof(DC_BUFFER *) * ui32BuffersMapped);
 
 	/* Allocate a command */
 	eError = SCPAllocCommand(psDisplayContext->psSCPContext,
@@ -1416,6 +1624,7 @@ PVRSRV_ERROR DCDisplayContextConfigure(DC_DISPLAY_CONTEXT *psDisplayContext,
 							 i32AcquireFenceFd,
 							 _DCDisplayContextReady,
 							 _DCDisplayContextConfigure,
+							 _DCDisplayContextDrop,
 							 ui32CmdRdySize,
 							 ui32CmdCompSize,
 							 (IMG_PVOID *)&pui8ReadyData,
@@ -1470,16 +1679,20 @@ PVRSRV_ERROR DCDisplayContextConfigure(DC_DISPLAY_CONTEXT *psDisplayContext,
 
 	psCompleteData->psDisplayContext = psDisplayContext;
 	psCompleteData->ui32Token = psDisplayContext->ui32TokenOut++;
-	psCompleteData->ui32BufferCount = ui32PipeCount;
+	psCompleteData->ui32BufferCount = ui32BuffersMapped;
 
-	if (ui32PipeCount != 0)
+	if (ui32BuffersMapped != 0)
 	{
-		/* Copy the buffer pointers */
+		/* Copy the pointers of the buffers we mapped */
 		psCompleteData->apsBuffer = pvCompleteData;
-		for (i=0;i<ui32PipeCount;i++)
+		for (i=0,j=0;i<ui32PipeCount;i++)
 		{
-			psCompleteData->apsBuffer[i] = papsBuffers[i];
+			if (!_DCBufferIsRepeat(papsBuffers, i))
+			{
+				psCompleteData->apsBuffer[j++] = papsBuffers[i];
+			}
 		}
+		PVR_ASSERT(j == ui32BuffersMapped);
 	}
 
 	/* Check if we need to do any CPU cache operations before sending the config */
@@ -1504,19 +1717,19 @@ PVRSRV_ERROR DCDisplayContextConfigure(DC_DISPLAY_CONTEXT *psDisplayContext,
 
 FailCommandAlloc:
 FailMapBuffer:
-	if (ui32PipeCount != 0)
+	for (i=0;ui32BuffersMapped!=0;i++)
 	{
-		for (i=0;i<ui32BuffersMapped;i++)
+		if (!_DCBufferIsRepeat(papsBuffers, i))
 		{
 			_DCBufferUnmap(papsBuffers[i]);
+			ui32BuffersMapped--;
 		}
 	}
-FailConfigCheck:
 	if (ui32PipeCount != 0)
 	{
 		_DCDeviceBufferArrayDestroy(ahBuffers);
 	}
-FailBufferArrayCreate:
+FailValidate:
 FailMaxDepth:
 	_DCDisplayContextReleaseRef(psDisplayContext);
 
@@ -1596,12 +1809,6 @@ PVRSRV_ERROR DCBufferAlloc(DC_DISPLAY_CONTEXT *psDisplayContext,
 		goto fail_lock;
 	}
 
-	eError = OSLockCreate(&psNew->hMapLock, LOCK_TYPE_NONE);
-	if (eError != PVRSRV_OK)
-	{
-		goto fail_maplock;
-	}
-
 	eError = psDevice->psFuncTable->pfnBufferAlloc(psDisplayContext->hDisplayContext,
 												  psSurfInfo,
 												  &uiLog2PageSize,
@@ -1622,6 +1829,7 @@ PVRSRV_ERROR DCBufferAlloc(DC_DISPLAY_CONTEXT *psDisplayContext,
 	psNew->eType = DC_BUFFER_TYPE_ALLOC;
 	psNew->ui32MapCount = 0;
 	psNew->ui32RefCount = 1;
+	psNew->bCacheable = IMG_TRUE;
 
 	eError = _DCCreatePMR(uiLog2PageSize,
 						  ui32PageCount,
@@ -1658,8 +1866,6 @@ PVRSRV_ERROR DCBufferAlloc(DC_DISPLAY_CONTEXT *psDisplayContext,
 fail_createpmr:
 	psDevice->psFuncTable->pfnBufferFree(psNew->hBuffer);
 fail_bufferalloc:
-	OSLockDestroy(psNew->hMapLock);
-fail_maplock:
 	OSLockDestroy(psNew->hLock);
 fail_lock:
 	OSFreeMem(psNew);
@@ -1668,6 +1874,8 @@ fail_lock:
 
 PVRSRV_ERROR DCBufferFree(DC_BUFFER *psBuffer)
 {
+	_DCBufferUncache(psBuffer);
+
 	/*
 		Only drop the reference on the PMR if this is a DC allocated
 		buffer. In the case of imported buffers the 3rd party DC
@@ -1713,12 +1921,6 @@ PVRSRV_ERROR DCBufferImport(DC_DISPLAY_CONTEXT *psDisplayContext,
 		goto FailLock;
 	}
 
-	eError = OSLockCreate(&psNew->hMapLock, LOCK_TYPE_NONE);
-	if (eError != PVRSRV_OK)
-	{
-		goto FailMapLock;
-	}
-
 	eError = psDevice->psFuncTable->pfnBufferImport(psDisplayContext->hDisplayContext,
 													ui32NumPlanes,
 													(IMG_HANDLE **)papsImport,
@@ -1745,14 +1947,13 @@ PVRSRV_ERROR DCBufferImport(DC_DISPLAY_CONTEXT *psDisplayContext,
 	psNew->uBufferData.sImportData.ui32NumPlanes = ui32NumPlanes;
 	psNew->ui32MapCount = 0;
 	psNew->ui32RefCount = 1;
+	psNew->bCacheable = IMG_TRUE;
 
 	*ppsBuffer = psNew;
 
 	return PVRSRV_OK;
 
 FailBufferImport:
-	OSLockDestroy(psNew->hMapLock);
-FailMapLock:
 	OSLockDestroy(psNew->hLock);
 FailLock:
 	OSFreeMem(psNew);
@@ -1763,6 +1964,7 @@ FailEarlyError:
 
 PVRSRV_ERROR DCBufferUnimport(DC_BUFFER *psBuffer)
 {
+	_DCBufferUncache(psBuffer);
 	_DCBufferReleaseRef(psBuffer);
 	return PVRSRV_OK;
 }
@@ -1854,6 +2056,11 @@ PVRSRV_ERROR DCRegisterDevice(DC_DEVICE_FUNCTIONS *psFuncTable,
 	psNew->psSystemBufferPMR = IMG_NULL;
 	psNew->sSystemContext.psDevice = psNew;
 	psNew->sSystemContext.hDisplayContext = hDeviceData;	/* FIXME: Is this the correct thing to do? */
+	eError = _DCMapCacheInit(&psNew->sSystemContext);
+	if (eError != PVRSRV_OK)
+	{
+		return eError;
+	}
 
 	OSLockAcquire(g_hDCListLock);
 	psNew->psNext = g_psDCDeviceList;
@@ -1931,6 +2138,7 @@ IMG_VOID DCUnregisterDevice(IMG_HANDLE hSrvHandle)
 	_DCDeviceReleaseRef(psDevice);
 
 	PVR_ASSERT(psDevice->ui32RefCount == 0);
+	_DCMapCacheDeInit(&psDevice->sSystemContext);
 	OSEventObjectDestroy(psDevice->psEventList);
 	OSLockDestroy(psDevice->hLock);
 	OSFreeMem(psDevice);
@@ -60,6 +60,7 @@ IMPLEMENT_LIST_REMOVE(PVRSRV_DEVICE_NODE)
 
 IMPLEMENT_LIST_ANY_VA(PVRSRV_POWER_DEV)
 IMPLEMENT_LIST_ANY_VA_2(PVRSRV_POWER_DEV, PVRSRV_ERROR, PVRSRV_OK)
+IMPLEMENT_LIST_FOR_EACH(PVRSRV_POWER_DEV)
 IMPLEMENT_LIST_INSERT(PVRSRV_POWER_DEV)
 IMPLEMENT_LIST_REMOVE(PVRSRV_POWER_DEV)
 
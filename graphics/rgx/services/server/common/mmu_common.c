@@ -866,14 +866,19 @@ static IMG_VOID _PxMemFree(MMU_CONTEXT *psMMUContext,
 /*************************************************************************/ /*!
 @Function       _SetupPxE
 
-@Description    Sets up an entry of an MMU object to point to the
-                provided address
+@Description    Sets up a run of entries of an MMU object to point to the
+                provided address. The object is CPU mapped, PDumped and
+                invalidated once for the whole run.
 
 @Input          psMMUContext    MMU context to operate on
 
 @Input          psLevel         Level info for MMU object
 
-@Input          uiIndex         Index into the MMU object to setup
+@Input          uiIndex         Index into the MMU object of the first entry
+                                to setup
+
+@Input          uiCount         Number of entries to setup. Only an
+                                invalidation may set up more than one
 
 @Input          psConfig        MMU Px config
 
@@ -895,6 +900,7 @@ static IMG_VOID _PxMemFree(MMU_CONTEXT *psMMUContext,
 static PVRSRV_ERROR _SetupPxE(MMU_CONTEXT *psMMUContext,
 								MMU_Levelx_INFO *psLevel,
 								IMG_UINT32 uiIndex,
+								IMG_UINT32 uiCount,
 								const MMU_PxE_CONFIG *psConfig,
 								MMU_LEVEL eMMULevel,
 								const IMG_DEV_PHYADDR *psDevPAddr,
@@ -908,6 +914,8 @@ static PVRSRV_ERROR _SetupPxE(MMU_CONTEXT *psMMUContext,
 	PVRSRV_DEVICE_NODE *psDevNode = psMMUContext->psDevNode;
 	MMU_MEMORY_DESC *psMemDesc = &psLevel->sMemDesc;
 	PVRSRV_ERROR eError;
+	IMG_UINT64 ui64PxE64;
+	IMG_UINT32 i;
 
 	IMG_UINT32 (*pfnDerivePxEProt4)(IMG_UINT32);
 	IMG_UINT64 (*pfnDerivePxEProt8)(IMG_UINT32);
@@ -929,8 +937,14 @@ static PVRSRV_ERROR _SetupPxE(MMU_CONTEXT *psMMUContext,
 			PVR_DPF((PVR_DBG_ERROR, "A physical address was specified when requesting invalidation of entry"));
 			uiProtFlags |= MMU_PROTFLAGS_INVALID;
 		}
+
+		/* Every entry of a run gets the same value, which only makes sense
+		   when invalidating */
+		PVR_ASSERT(uiCount == 1);
 	}
 
+	PVR_ASSERT(uiIndex + uiCount <= psLevel->ui32NumOfEntries);
+
 	switch(eMMULevel)
 	{
 		case MMU_LEVEL_3:
@@ -961,50 +975,52 @@ static PVRSRV_ERROR _SetupPxE(MMU_CONTEXT *psMMUContext,
 		return PVRSRV_ERROR_FAILED_TO_MAP_PAGE_TABLE;
 	}
 
+	ui64PxE64 = psDevPAddr->uiAddr
+					>> psConfig->uiLog2Align
+					<< psConfig->uiAddrShift
+					& psConfig->uiAddrMask;
+
 	/* how big is a PxE in bytes? */
 	switch(psConfig->uiBytesPerEntry)
 	{
 		case 4:
 		{
-			IMG_UINT32 *pui32Px;
-			IMG_UINT64 ui64PxE64;
-
-			pui32Px = psMemDesc->pvCpuVAddr;
-
-			ui64PxE64 = psDevPAddr->uiAddr
-							>> psConfig->uiLog2Align
-							<< psConfig->uiAddrShift
-							& psConfig->uiAddrMask;
+			IMG_UINT32 *pui32Px = psMemDesc->pvCpuVAddr;
 
 			ui64PxE64 |= pfnDerivePxEProt4(uiProtFlags);
 			/* assert that the result fits into 32 bits before writing
 			   it into the 32-bit array with a cast */
 			PVR_ASSERT(ui64PxE64 == (ui64PxE64 & 0xffffffffU));
 
-			/* We should never invalidate an invalid page */
-			if (uiProtFlags & MMU_PROTFLAGS_INVALID)
+			for (i = uiIndex; i < uiIndex + uiCount; i++)
 			{
-				PVR_ASSERT(pui32Px[uiIndex] != ui64PxE64);
+				/* We should never invalidate an invalid page */
+				if (uiProtFlags & MMU_PROTFLAGS_INVALID)
+				{
+					PVR_ASSERT(pui32Px[i] != ui64PxE64);
+				}
+				pui32Px[i] = (IMG_UINT32) ui64PxE64;
+				_MMU_LogPxEModification(psLevel,
+										i,
+										(uiProtFlags & MMU_PROTFLAGS_INVALID)?MMU_MOD_UNMAP:MMU_MOD_MAP,
+										ui64PxE64);
 			}
-			pui32Px[uiIndex] = (IMG_UINT32) ui64PxE64;
-			_MMU_LogPxEModification(psLevel,
-									uiIndex,
-									(uiProtFlags & MMU_PROTFLAGS_INVALID)?MMU_MOD_UNMAP:MMU_MOD_MAP,
-									ui64PxE64);
 			break;	
 		}
 		case 8:
 		{
 			IMG_UINT64 *pui64Px = psMemDesc->pvCpuVAddr;
-			pui64Px[uiIndex] = psDevPAddr->uiAddr
-								>> psConfig->uiLog2Align
-								<< psConfig->uiAddrShift
-								& psConfig->uiAddrMask;
-			pui64Px[uiIndex] |= pfnDerivePxEProt8(uiProtFlags);
-			_MMU_LogPxEModification(psLevel,
-									uiIndex,
-									(uiProtFlags & MMU_PROTFLAGS_INVALID)?MMU_MOD_UNMAP:MMU_MOD_MAP,
-									pui64Px[uiIndex]);
+
+			ui64PxE64 |= pfnDerivePxEProt8(uiProtFlags);
+
+			for (i = uiIndex; i < uiIndex + uiCount; i++)
+			{
+				pui64Px[i] = ui64PxE64;
+				_MMU_LogPxEModification(psLevel,
+										i,
+										(uiProtFlags & MMU_PROTFLAGS_INVALID)?MMU_MOD_UNMAP:MMU_MOD_MAP,
+										ui64PxE64);
+			}
 			break;	
 		}
 		default:
@@ -1022,7 +1038,7 @@ static PVRSRV_ERROR _SetupPxE(MMU_CONTEXT *psMMUContext,
 						  psMemDesc->pvCpuVAddr,
 						  psMemDesc->sDevPAddr,
 						  uiIndex,
-						  1,
+						  uiCount,
 						  pszMemspaceName,
 						  pszSymbolicAddr,
 						  uiSymbolicAddrOffset,
@@ -1185,6 +1201,7 @@ static IMG_BOOL _MMU_FreeLevel(MMU_CONTEXT *psMMUContext,
 					eError = _SetupPxE(psMMUContext,
 									psLevel,
 									i,
+									1,
 									psConfig,
 									aeMMULevel[uiThisLevel],
 									IMG_NULL,
@@ -1353,6 +1370,7 @@ static PVRSRV_ERROR _MMU_AllocLevel(MMU_CONTEXT *psMMUContext,
 				eError = _SetupPxE(psMMUContext,
 									psLevel,
 									i,
+									1,
 									psConfig,
 									aeMMULevel[uiThisLevel],
 									&psNextLevel->sMemDesc.sDevPAddr,
@@ -1931,7 +1949,7 @@ _MMU_MapPage (MMU_CONTEXT *psMMUContext,
 						uiLog2DataPageSize, &psLevel, &uiPTEIndex, &psConfig,
 						&hPriv);
 
-	eError = _SetupPxE(psMMUContext, psLevel, uiPTEIndex,
+	eError = _SetupPxE(psMMUContext, psLevel, uiPTEIndex, 1,
 						psConfig, MMU_LEVEL_1, &sDevPAddr,
 #if defined(PDUMP)
 						pszMemspaceName, pszSymbolicAddr, uiSymbolicAddrOffset,
@@ -1951,26 +1969,32 @@ _MMU_MapPage (MMU_CONTEXT *psMMUContext,
 }
 
 /*************************************************************************/ /*!
-@Function       _MMU_UnmapPage
+@Function       _MMU_UnmapPTERange
 
-@Description    Unmap a page from the MMU.
+@Description    Unmap a run of pages from the MMU. The run is clipped to the
+                end of the page table holding the first page so the table
+                only has to be looked up, CPU mapped and invalidated once.
 
 @Input          psMMUContext            MMU context to operate on
 
-@Input          psDevVAddr              Device virtual address to unmap the page
-                                        from
+@Input          psDevVAddr              Device virtual address of the first
+                                        page to unmap
 
-@Return         None
+@Input          ui32PageCount           Number of pages to unmap
+
+@Return         Number of pages unmapped
 */
 /*****************************************************************************/
-static IMG_VOID
-_MMU_UnmapPage (MMU_CONTEXT *psMMUContext,
-               IMG_DEV_VIRTADDR sDevVAddr)
+static IMG_UINT32
+_MMU_UnmapPTERange (MMU_CONTEXT *psMMUContext,
+                    IMG_DEV_VIRTADDR sDevVAddr,
+                    IMG_UINT32 ui32PageCount)
 {
 	const MMU_PxE_CONFIG *psConfig = IMG_NULL;
 	MMU_Levelx_INFO *psLevel;
 	PVRSRV_ERROR eError;
 	IMG_UINT32 uiPTEIndex;
+	IMG_UINT32 ui32Count;
 	IMG_HANDLE hPriv;
 
 	/* This should be passed in */
@@ -1980,8 +2004,16 @@ _MMU_UnmapPage (MMU_CONTEXT *psMMUContext,
 	_MMU_GetPTEInfo(psMMUContext, sDevVAddr, uiLog2DataPageSize,
 						&psLevel, &uiPTEIndex, &psConfig, &hPriv);
 
-	eError = _SetupPxE(psMMUContext, psLevel, uiPTEIndex, psConfig,
-						MMU_LEVEL_1, IMG_NULL,
+	/* Don't run off the end of this page table */
+	PVR_ASSERT(uiPTEIndex < psLevel->ui32NumOfEntries);
+	ui32Count = psLevel->ui32NumOfEntries - uiPTEIndex;
+	if (ui32Count > ui32PageCount)
+	{
+		ui32Count = ui32PageCount;
+	}
+
+	eError = _SetupPxE(psMMUContext, psLevel, uiPTEIndex, ui32Count,
+						psConfig, MMU_LEVEL_1, IMG_NULL,
 #if defined(PDUMP)
 						IMG_NULL, IMG_NULL, 0U,
 #endif
@@ -1991,13 +2023,14 @@ _MMU_UnmapPage (MMU_CONTEXT *psMMUContext,
 
 	if(eError != PVRSRV_OK)
 	{
-		PVR_DPF((PVR_DBG_ERROR, "MMU_UnmapPage: _SetupPxE failed"));
+		PVR_DPF((PVR_DBG_ERROR, "_MMU_UnmapPTERange: _SetupPxE failed"));
 		PVR_ASSERT(0);
-		return; //eError;
 	}
 
 	/* Check we haven't wrapped around */
 	PVR_ASSERT(psLevel->ui32RefCount <= psLevel->ui32NumOfEntries);
+
+	return ui32Count;
 }
 
 /*****************************************************************************
@@ -2304,9 +2337,12 @@ MMU_UnmapPages (MMU_CONTEXT *psMMUContext,
 #endif
 	while (ui32PageCount !=0)
 	{
-		_MMU_UnmapPage(psMMUContext, sDevVAddr);
-		sDevVAddr.uiAddr += uiPageSize;
-		ui32PageCount--;
+		IMG_UINT32 ui32Unmapped;
+
+		/* Invalidate a page table's worth of entries at a time */
+		ui32Unmapped = _MMU_UnmapPTERange(psMMUContext, sDevVAddr, ui32PageCount);
+		sDevVAddr.uiAddr += (IMG_UINT64)uiPageSize * ui32Unmapped;
+		ui32PageCount -= ui32Unmapped;
 	}
 }
 
@@ -150,8 +150,9 @@ static IMG_BOOL _IsSystemStatePowered(PVRSRV_SYS_POWER_STATE eSystemPowerState)
 
  @Function	PVRSRVPowerLock
 
- @Description	Obtain the mutex for power transitions. Only allowed when
-                system power is on.
+ @Description	Obtain the system power lock. Only allowed when system power
+                is on. This serialises system-wide power transitions; device
+                transitions and kicks use the device power lock instead.
 
  @Return	PVRSRV_ERROR_RETRY or PVRSRV_OK
 
@@ -181,8 +182,7 @@ PVRSRV_ERROR PVRSRVPowerLock()
 
  @Function	PVRSRVForcedPowerLock
 
- @Description	Obtain the mutex for power transitions regardless of
-                system power state
+ @Description	Obtain the system power lock regardless of system power state
 
  @Return	PVRSRV_ERROR_RETRY or PVRSRV_OK
 
@@ -200,7 +200,7 @@ IMG_VOID PVRSRVForcedPowerLock()
 
  @Function	PVRSRVPowerUnlock
 
- @Description	Release the mutex for power transitions
+ @Description	Release the system power lock
 
  @Return	PVRSRV_ERROR
 
@@ -214,115 +214,342 @@ IMG_VOID PVRSRVPowerUnlock()
 }
 
 
+static PVRSRV_POWER_DEV *_LookupPowerDevice(IMG_UINT32 ui32DeviceIndex)
+{
+	PVRSRV_DATA	*psPVRSRVData = PVRSRVGetPVRSRVData();
+
+	return (PVRSRV_POWER_DEV*)
+			List_PVRSRV_POWER_DEV_Any_va(psPVRSRVData->psPowerDeviceList,
+										 &MatchPowerDeviceIndex_AnyVaCb,
+										 ui32DeviceIndex);
+}
+
+static IMG_VOID _PowerDeviceLockExclusive(PVRSRV_POWER_DEV *psPowerDevice)
+{
+	OSWRLockAcquireWrite(psPowerDevice->hPowerLock);
+	psPowerDevice->bExclusive = IMG_TRUE;
+}
+
+static IMG_VOID _PowerDeviceUnlockExclusive(PVRSRV_POWER_DEV *psPowerDevice)
+{
+	psPowerDevice->bExclusive = IMG_FALSE;
+	OSWRLockReleaseWrite(psPowerDevice->hPowerLock);
+}
+
+
 /*!
 ******************************************************************************
 
- @Function	PVRSRVDevicePrePowerStateKM_AnyVaCb
+ @Function	PVRSRVDevicePowerLock
+
+ @Description	Obtain a device's power lock.
+
+                Exclusive access is needed to change the device power state.
+                Shared access may be requested by paths that only need the
+                device to stay powered while they kick it: it is granted
+                when the device is already on, so concurrent kicks do not
+                serialise against each other. Otherwise the lock is taken
+                exclusively so the caller can power the device up.
+
+ @Input		ui32DeviceIndex : device index
+ @Input		bForced : TRUE to take the lock regardless of system power state
+ @Output	pbShared : IMG_NULL for exclusive access. Otherwise shared
+                       access is requested and on return this says whether
+                       it was granted (TRUE) or the lock is held
+                       exclusively (FALSE).
+
+ @Return	PVRSRV_ERROR_RETRY or PVRSRV_OK
+
+******************************************************************************/
+IMG_EXPORT
+PVRSRV_ERROR PVRSRVDevicePowerLock(IMG_UINT32	ui32DeviceIndex,
+								   IMG_BOOL		bForced,
+								   IMG_BOOL		*pbShared)
+{
+	PVRSRV_DATA			*psPVRSRVData = PVRSRVGetPVRSRVData();
+	PVRSRV_POWER_DEV	*psPowerDevice;
+
+	if (pbShared != IMG_NULL)
+	{
+		*pbShared = IMG_FALSE;
+	}
+
+	psPowerDevice = _LookupPowerDevice(ui32DeviceIndex);
+	if (psPowerDevice == IMG_NULL)
+	{
+		/* Nothing to serialise against: the device has no power management */
+		return (bForced || _IsSystemStatePowered(psPVRSRVData->eCurrentPowerState)) ?
+				PVRSRV_OK : PVRSRV_ERROR_RETRY;
+	}
+
+	/*
+		System transitions hold every device lock exclusively, so the system
+		power state is stable once the device lock is held in either mode.
+	*/
+	if (pbShared != IMG_NULL)
+	{
+		OSWRLockAcquireRead(psPowerDevice->hPowerLock);
+
+		if (psPowerDevice->eCurrentPowerState == PVRSRV_DEV_POWER_STATE_ON &&
+			(bForced || _IsSystemStatePowered(psPVRSRVData->eCurrentPowerState)))
+		{
+			*pbShared = IMG_TRUE;
+			return PVRSRV_OK;
+		}
+
+		OSWRLockReleaseRead(psPowerDevice->hPowerLock);
+	}
+
+	_PowerDeviceLockExclusive(psPowerDevice);
+
+	if (!bForced && !_IsSystemStatePowered(psPVRSRVData->eCurrentPowerState))
+	{
+		_PowerDeviceUnlockExclusive(psPowerDevice);
+		return PVRSRV_ERROR_RETRY;
+	}
+
+	return PVRSRV_OK;
+}
+
+
+/*!
+******************************************************************************
+
+ @Function	PVRSRVDevicePowerUnlock
+
+ @Description	Release a device's power lock
+
+ @Input		ui32DeviceIndex : device index
+ @Input		bShared : the mode returned by PVRSRVDevicePowerLock
+
+ @Return	IMG_VOID
+
+******************************************************************************/
+IMG_EXPORT
+IMG_VOID PVRSRVDevicePowerUnlock(IMG_UINT32 ui32DeviceIndex, IMG_BOOL bShared)
+{
+	PVRSRV_POWER_DEV	*psPowerDevice = _LookupPowerDevice(ui32DeviceIndex);
+
+	if (psPowerDevice == IMG_NULL)
+	{
+		return;
+	}
+
+	if (bShared)
+	{
+		OSWRLockReleaseRead(psPowerDevice->hPowerLock);
+	}
+	else
+	{
+		_PowerDeviceUnlockExclusive(psPowerDevice);
+	}
+}
+
+
+/*!
+******************************************************************************
+
+ @Function	PVRSRVDevicePowerLockIsHeld
+
+ @Description	Whether a device's power lock is held in either mode
+
+ @Input		ui32DeviceIndex : device index
+
+ @Return	IMG_BOOL
+
+******************************************************************************/
+IMG_EXPORT
+IMG_BOOL PVRSRVDevicePowerLockIsHeld(IMG_UINT32 ui32DeviceIndex)
+{
+	PVRSRV_POWER_DEV	*psPowerDevice = _LookupPowerDevice(ui32DeviceIndex);
+
+	if (psPowerDevice == IMG_NULL)
+	{
+		return IMG_FALSE;
+	}
+
+	return OSWRLockIsLocked(psPowerDevice->hPowerLock);
+}
+
+
+/*!
+******************************************************************************
+
+ @Function	_DevicePrePowerState
 
  @Description
 
  Perform device-specific processing required before a power transition
 
  @Input		psPowerDevice : the device
- @Input		va : variable argument list with:
- 				bAllDevices : IMG_TRUE - All devices
- 						  	  IMG_FALSE - Use ui32DeviceIndex
-				ui32DeviceIndex : device index
-				eNewPowerState : New power state
+ @Input		eNewPowerState : New power state
+ @Input		bForced : TRUE if the transition should not fail (e.g. OS request)
 
  @Return	PVRSRV_ERROR
 
 ******************************************************************************/
-static PVRSRV_ERROR PVRSRVDevicePrePowerStateKM_AnyVaCb(PVRSRV_POWER_DEV *psPowerDevice, va_list va)
+static PVRSRV_ERROR _DevicePrePowerState(PVRSRV_POWER_DEV		*psPowerDevice,
+										 PVRSRV_DEV_POWER_STATE	eNewPowerState,
+										 IMG_BOOL				bForced)
+{
+	PVRSRV_DEV_POWER_STATE	eNewDevicePowerState;
+	PVRSRV_ERROR			eError = PVRSRV_OK;
+	IMG_UINT32				ui32StartUs;
+
+	eNewDevicePowerState = (eNewPowerState == PVRSRV_DEV_POWER_STATE_DEFAULT) ?
+						psPowerDevice->eDefaultPowerState : eNewPowerState;
+
+	if (psPowerDevice->eCurrentPowerState != eNewDevicePowerState)
+	{
+		ui32StartUs = OSClockus();
+
+		if (psPowerDevice->pfnDevicePrePower != IMG_NULL)
+		{
+			/* Call the device's power callback. */
+			eError = psPowerDevice->pfnDevicePrePower(psPowerDevice->hDevCookie,
+														eNewDevicePowerState,
+														psPowerDevice->eCurrentPowerState,
+														bForced);
+		}
+
+		/* Do any required system-layer processing. */
+		if (eError == PVRSRV_OK && psPowerDevice->pfnSystemPrePower != IMG_NULL)
+		{
+			eError = psPowerDevice->pfnSystemPrePower(eNewDevicePowerState,
+													  psPowerDevice->eCurrentPowerState,
+													  bForced);
+		}
+
+		psPowerDevice->ui32TransitionUs = OSClockus() - ui32StartUs;
+	}
+
+	return eError;
+}
+
+/*!
+******************************************************************************
+
+ @Function	_DevicePostPowerState
+
+ @Description
+
+ Perform device-specific processing required after a power transition
+
+ @Input		psPowerDevice : the device
+ @Input		eNewPowerState : New power state
+ @Input		bForced : TRUE if the transition should not fail (e.g. OS request)
+
+ @Return	PVRSRV_ERROR
+
+******************************************************************************/
+static PVRSRV_ERROR _DevicePostPowerState(PVRSRV_POWER_DEV		*psPowerDevice,
+										  PVRSRV_DEV_POWER_STATE	eNewPowerState,
+										  IMG_BOOL					bForced)
 {
 	PVRSRV_DEV_POWER_STATE	eNewDevicePowerState;
 	PVRSRV_ERROR			eError;
+	IMG_UINT32				ui32StartUs;
+	IMG_UINT32				ui32TotalUs;
 
-	/*Variable Argument variables*/
-	IMG_BOOL				bAllDevices;
-	IMG_UINT32				ui32DeviceIndex;
-	PVRSRV_DEV_POWER_STATE	eNewPowerState;
-	IMG_BOOL				bForced;
+	eNewDevicePowerState = (eNewPowerState == PVRSRV_DEV_POWER_STATE_DEFAULT) ?
+							psPowerDevice->eDefaultPowerState : eNewPowerState;
 
-	/*WARNING! if types were not aligned to 4 bytes, this could be dangerous!!!*/
-	bAllDevices = va_arg(va, IMG_BOOL);
-	ui32DeviceIndex = va_arg(va, IMG_UINT32);
-	eNewPowerState = va_arg(va, PVRSRV_DEV_POWER_STATE);
-	bForced = va_arg(va, IMG_BOOL);
+	if (psPowerDevice->eCurrentPowerState == eNewDevicePowerState)
+	{
+		return PVRSRV_OK;
+	}
 
-	if (bAllDevices || (ui32DeviceIndex == psPowerDevice->ui32DeviceIndex))
+	ui32StartUs = OSClockus();
+
+	/* Do any required system-layer processing. */
+	if (psPowerDevice->pfnSystemPostPower != IMG_NULL)
 	{
-		eNewDevicePowerState = (eNewPowerState == PVRSRV_DEV_POWER_STATE_DEFAULT) ?
-							psPowerDevice->eDefaultPowerState : eNewPowerState;
+		eError = psPowerDevice->pfnSystemPostPower(eNewDevicePowerState,
+												   psPowerDevice->eCurrentPowerState,
+												   bForced);
+		if (eError != PVRSRV_OK)
+		{
+			return eError;
+		}
+	}
 
-		if (psPowerDevice->eCurrentPowerState != eNewDevicePowerState)
+	if (psPowerDevice->pfnDevicePostPower != IMG_NULL)
+	{
+		/* Call the device's power callback. */
+		eError = psPowerDevice->pfnDevicePostPower(psPowerDevice->hDevCookie,
+												   eNewDevicePowerState,
+												   psPowerDevice->eCurrentPowerState,
+												   bForced);
+		if (eError != PVRSRV_OK)
 		{
-			if (psPowerDevice->pfnDevicePrePower != IMG_NULL)
-			{
-				/* Call the device's power callback. */
-				eError = psPowerDevice->pfnDevicePrePower(psPowerDevice->hDevCookie,
-															eNewDevicePowerState,
-															psPowerDevice->eCurrentPowerState,
-															bForced);
-				if (eError != PVRSRV_OK)
-				{
-					return eError;
-				}
-			}
+			return eError;
+		}
+	}
 
-			/* Do any required system-layer processing. */
-			if (psPowerDevice->pfnSystemPrePower != IMG_NULL)
-			{
-				eError = psPowerDevice->pfnSystemPrePower(eNewDevicePowerState,
-														  psPowerDevice->eCurrentPowerState,
-														  bForced);
-				if (eError != PVRSRV_OK)
-				{
-					return eError;
-				}
-			}
+	psPowerDevice->eCurrentPowerState = eNewDevicePowerState;
+
+	/* Account the whole transition (pre and post callbacks) */
+	ui32TotalUs = psPowerDevice->ui32TransitionUs + (OSClockus() - ui32StartUs);
+	if (eNewDevicePowerState == PVRSRV_DEV_POWER_STATE_OFF)
+	{
+		psPowerDevice->sTiming.ui32LastSuspendUs = ui32TotalUs;
+		if (ui32TotalUs > psPowerDevice->sTiming.ui32MaxSuspendUs)
+		{
+			psPowerDevice->sTiming.ui32MaxSuspendUs = ui32TotalUs;
+		}
+	}
+	else
+	{
+		psPowerDevice->sTiming.ui32LastResumeUs = ui32TotalUs;
+		if (ui32TotalUs > psPowerDevice->sTiming.ui32MaxResumeUs)
+		{
+			psPowerDevice->sTiming.ui32MaxResumeUs = ui32TotalUs;
 		}
 	}
+	psPowerDevice->ui32TransitionUs = 0;
 
-	return  PVRSRV_OK;
+	return PVRSRV_OK;
 }
 
 /*!
 ******************************************************************************
 
- @Function	PVRSRVDevicePrePowerStateKM
+ @Function	PVRSRVDevicePrePowerStateKM_AnyVaCb
 
  @Description
 
  Perform device-specific processing required before a power transition
 
- @Input		bAllDevices : IMG_TRUE - All devices
- 						  IMG_FALSE - Use ui32DeviceIndex
- @Input		ui32DeviceIndex : device index
- @Input		eNewPowerState : New power state
- @Input		bForced : TRUE if the transition should not fail (e.g. OS request)
+ @Input		psPowerDevice : the device
+ @Input		va : variable argument list with:
+ 				bAllDevices : IMG_TRUE - All devices
+ 						  	  IMG_FALSE - Use ui32DeviceIndex
+				ui32DeviceIndex : device index
+				eNewPowerState : New power state
 
  @Return	PVRSRV_ERROR
 
 ******************************************************************************/
-static
-PVRSRV_ERROR PVRSRVDevicePrePowerStateKM(IMG_BOOL				bAllDevices,
-										 IMG_UINT32				ui32DeviceIndex,
-										 PVRSRV_DEV_POWER_STATE	eNewPowerState,
-										 IMG_BOOL				bForced)
+static PVRSRV_ERROR PVRSRVDevicePrePowerStateKM_AnyVaCb(PVRSRV_POWER_DEV *psPowerDevice, va_list va)
 {
-	PVRSRV_ERROR		eError;
-	PVRSRV_DATA			*psPVRSRVData = PVRSRVGetPVRSRVData();
+	/*Variable Argument variables*/
+	IMG_BOOL				bAllDevices;
+	IMG_UINT32				ui32DeviceIndex;
+	PVRSRV_DEV_POWER_STATE	eNewPowerState;
+	IMG_BOOL				bForced;
 
-	/* Loop through the power devices. */
-	eError = List_PVRSRV_POWER_DEV_PVRSRV_ERROR_Any_va(psPVRSRVData->psPowerDeviceList,
-														&PVRSRVDevicePrePowerStateKM_AnyVaCb,
-														bAllDevices,
-														ui32DeviceIndex,
-														eNewPowerState,
-														bForced);
+	/*WARNING! if types were not aligned to 4 bytes, this could be dangerous!!!*/
+	bAllDevices = va_arg(va, IMG_BOOL);
+	ui32DeviceIndex = va_arg(va, IMG_UINT32);
+	eNewPowerState = va_arg(va, PVRSRV_DEV_POWER_STATE);
+	bForced = va_arg(va, IMG_BOOL);
 
-	return eError;
+	if (bAllDevices || (ui32DeviceIndex == psPowerDevice->ui32DeviceIndex))
+	{
+		return _DevicePrePowerState(psPowerDevice, eNewPowerState, bForced);
+	}
+
+	return  PVRSRV_OK;
 }
 
 /*!
@@ -346,9 +573,6 @@ PVRSRV_ERROR PVRSRVDevicePrePowerStateKM(IMG_BOOL				bAllDevices,
 ******************************************************************************/
 static PVRSRV_ERROR PVRSRVDevicePostPowerStateKM_AnyVaCb(PVRSRV_POWER_DEV *psPowerDevice, va_list va)
 {
-	PVRSRV_DEV_POWER_STATE	eNewDevicePowerState;
-	PVRSRV_ERROR			eError;
-
 	/*Variable Argument variables*/
 	IMG_BOOL				bAllDevices;
 	IMG_UINT32				ui32DeviceIndex;
@@ -363,40 +587,232 @@ static PVRSRV_ERROR PVRSRVDevicePostPowerStateKM_AnyVaCb(PVRSRV_POWER_DEV *psPow
 
 	if (bAllDevices || (ui32DeviceIndex == psPowerDevice->ui32DeviceIndex))
 	{
-		eNewDevicePowerState = (eNewPowerState == PVRSRV_DEV_POWER_STATE_DEFAULT) ?
-								psPowerDevice->eDefaultPowerState : eNewPowerState;
+		return _DevicePostPowerState(psPowerDevice, eNewPowerState, bForced);
+	}
+
+	return PVRSRV_OK;
+}
+
 
-		if (psPowerDevice->eCurrentPowerState != eNewDevicePowerState)
+/*
+	Parallel power callbacks
+
+	On system transitions the devices are visited in waves. Each wave holds
+	every remaining device whose dependencies are satisfied: on power-up a
+	device waits for the devices it depends on, on power-down the devices
+	depending on it go first. The first device of a wave runs on the calling
+	thread and the others on helper threads, so the callbacks must not rely
+	on locks owned by the calling thread. Each helper signals the wave's event
+	object once its callback has returned, and is only destroyed after that,
+	so no callback is skipped by stopping a helper before it first runs.
+*/
+typedef struct _POWER_CALLBACK_JOB_
+{
+	PVRSRV_POWER_DEV		*psPowerDevice;
+	IMG_BOOL				bPost;
+	PVRSRV_DEV_POWER_STATE	eNewPowerState;
+	IMG_BOOL				bForced;
+	PVRSRV_ERROR			eError;
+	IMG_HANDLE				hThread;
+	IMG_HANDLE				hEventObject;	/*!< signalled when the callback returns */
+	volatile IMG_BOOL		bDone;
+} POWER_CALLBACK_JOB;
+
+#define POWER_DEVICE_BIT(psPowerDevice)	(1U << ((psPowerDevice)->ui32DeviceIndex & 31))
+
+static IMG_VOID _PowerCallbackJob(IMG_VOID *pvData)
+{
+	POWER_CALLBACK_JOB *psJob = pvData;
+
+	psJob->eError = psJob->bPost ?
+			_DevicePostPowerState(psJob->psPowerDevice, psJob->eNewPowerState, psJob->bForced) :
+			_DevicePrePowerState(psJob->psPowerDevice, psJob->eNewPowerState, psJob->bForced);
+
+	/* Publish the result before the completion flag */
+	OSMemoryBarrier();
+	psJob->bDone = IMG_TRUE;
+
+	if (psJob->hEventObject != IMG_NULL)
+	{
+		OSEventObjectSignal(psJob->hEventObject);
+	}
+}
+
+static PVRSRV_ERROR _DevicePowerStateParallel(IMG_BOOL					bPost,
+											  PVRSRV_DEV_POWER_STATE	eNewPowerState,
+											  IMG_BOOL					bForced)
+{
+	PVRSRV_DATA			*psPVRSRVData = PVRSRVGetPVRSRVData();
+	POWER_CALLBACK_JOB	asJobs[SYS_DEVICE_COUNT];
+	PVRSRV_POWER_DEV	*psPowerDevice;
+	IMG_BOOL			bPowerUp = (eNewPowerState != PVRSRV_DEV_POWER_STATE_OFF) ? IMG_TRUE : IMG_FALSE;
+	IMG_UINT32			ui32Pending = 0;
+	IMG_UINT32			ui32Blocked;
+	IMG_UINT32			ui32Jobs;
+	IMG_UINT32			i;
+	IMG_HANDLE			hEventObject = IMG_NULL;
+	IMG_HANDLE			hOSEvent = IMG_NULL;
+	PVRSRV_ERROR		eError = PVRSRV_OK;
+
+	/* Without an event object to wait on the callbacks run one at a time */
+	if (OSEventObjectCreate("PVRSRV_POWER_CALLBACK_EVENTOBJECT", &hEventObject) != PVRSRV_OK)
+	{
+		hEventObject = IMG_NULL;
+	}
+	else if (OSEventObjectOpen(hEventObject, &hOSEvent) != PVRSRV_OK)
+	{
+		OSEventObjectDestroy(hEventObject);
+		hEventObject = IMG_NULL;
+	}
+
+	for (psPowerDevice = psPVRSRVData->psPowerDeviceList; psPowerDevice != IMG_NULL; psPowerDevice = psPowerDevice->psNext)
+	{
+		ui32Pending |= POWER_DEVICE_BIT(psPowerDevice);
+	}
+
+	while (ui32Pending != 0 && eError == PVRSRV_OK)
+	{
+		/* Devices still waiting for a dependent device to power down first */
+		ui32Blocked = 0;
+		if (!bPowerUp)
+		{
+			for (psPowerDevice = psPVRSRVData->psPowerDeviceList; psPowerDevice != IMG_NULL; psPowerDevice = psPowerDevice->psNext)
+			{
+				if (ui32Pending & POWER_DEVICE_BIT(psPowerDevice))
+				{
+					ui32Blocked |= psPowerDevice->ui32Dependencies & ~POWER_DEVICE_BIT(psPowerDevice);
+				}
+			}
+		}
+
+		ui32Jobs = 0;
+		for (psPowerDevice = psPVRSRVData->psPowerDeviceList;
+			 psPowerDevice != IMG_NULL && ui32Jobs < SYS_DEVICE_COUNT;
+			 psPowerDevice = psPowerDevice->psNext)
+		{
+			IMG_UINT32 ui32Bit = POWER_DEVICE_BIT(psPowerDevice);
+			IMG_UINT32 ui32Waiting = bPowerUp ?
+					(psPowerDevice->ui32Dependencies & ~ui32Bit & ui32Pending) :
+					(ui32Blocked & ui32Bit);
+
+			if ((ui32Pending & ui32Bit) && ui32Waiting == 0)
+			{
+				asJobs[ui32Jobs].psPowerDevice = psPowerDevice;
+				ui32Jobs++;
+			}
+		}
+
+		if (ui32Jobs == 0)
 		{
-			/* Do any required system-layer processing. */
-			if (psPowerDevice->pfnSystemPostPower != IMG_NULL)
+			/* Circular dependency: finish the remaining devices one at a time */
+			PVR_DPF((PVR_DBG_WARNING, "_DevicePowerStateParallel: circular power dependency (pending 0x%x)", ui32Pending));
+			for (psPowerDevice = psPVRSRVData->psPowerDeviceList; psPowerDevice != IMG_NULL; psPowerDevice = psPowerDevice->psNext)
 			{
-				eError = psPowerDevice->pfnSystemPostPower(eNewDevicePowerState,
-														   psPowerDevice->eCurrentPowerState,
-														   bForced);
-				if (eError != PVRSRV_OK)
+				if (ui32Pending & POWER_DEVICE_BIT(psPowerDevice))
 				{
-					return eError;
+					asJobs[0].psPowerDevice = psPowerDevice;
+					ui32Jobs = 1;
+					break;
 				}
 			}
+		}
+
+		for (i = 0; i < ui32Jobs; i++)
+		{
+			asJobs[i].bPost = bPost;
+			asJobs[i].eNewPowerState = eNewPowerState;
+			asJobs[i].bForced = bForced;
+			asJobs[i].eError = PVRSRV_OK;
+			asJobs[i].hThread = IMG_NULL;
+			asJobs[i].hEventObject = hEventObject;
+			asJobs[i].bDone = IMG_FALSE;
+		}
+
+		for (i = 1; i < ui32Jobs; i++)
+		{
+			if (hEventObject == IMG_NULL ||
+				OSThreadCreate(&asJobs[i].hThread, "pvr_power_cb", _PowerCallbackJob, &asJobs[i]) != PVRSRV_OK)
+			{
+				/* No helper thread, run it here instead */
+				asJobs[i].hThread = IMG_NULL;
+				_PowerCallbackJob(&asJobs[i]);
+			}
+		}
 
-			if (psPowerDevice->pfnDevicePostPower != IMG_NULL)
+		_PowerCallbackJob(&asJobs[0]);
+
+		for (i = 0; i < ui32Jobs; i++)
+		{
+			if (asJobs[i].hThread != IMG_NULL)
 			{
-				/* Call the device's power callback. */
-				eError = psPowerDevice->pfnDevicePostPower(psPowerDevice->hDevCookie,
-														   eNewDevicePowerState,
-														   psPowerDevice->eCurrentPowerState,
-														   bForced);
-				if (eError != PVRSRV_OK)
+				/* Stopping the thread before it has run would skip the callback */
+				while (!asJobs[i].bDone)
 				{
-					return eError;
+					OSEventObjectWaitUntimed(hOSEvent);
 				}
+				OSMemoryBarrier();
+
+				OSThreadDestroy(asJobs[i].hThread);
 			}
 
-			psPowerDevice->eCurrentPowerState = eNewDevicePowerState;
+			ui32Pending &= ~POWER_DEVICE_BIT(asJobs[i].psPowerDevice);
+			if (asJobs[i].eError != PVRSRV_OK && eError == PVRSRV_OK)
+			{
+				eError = asJobs[i].eError;
+			}
 		}
 	}
-	return PVRSRV_OK;
+
+	if (hEventObject != IMG_NULL)
+	{
+		OSEventObjectClose(hOSEvent);
+		OSEventObjectDestroy(hEventObject);
+	}
+
+	return eError;
+}
+
+/*!
+******************************************************************************
+
+ @Function	PVRSRVDevicePrePowerStateKM
+
+ @Description
+
+ Perform device-specific processing required before a power transition
+
+ @Input		bAllDevices : IMG_TRUE - All devices
+ 						  IMG_FALSE - Use ui32DeviceIndex
+ @Input		ui32DeviceIndex : device index
+ @Input		eNewPowerState : New power state
+ @Input		bForced : TRUE if the transition should not fail (e.g. OS request)
+
+ @Return	PVRSRV_ERROR
+
+******************************************************************************/
+static
+PVRSRV_ERROR PVRSRVDevicePrePowerStateKM(IMG_BOOL				bAllDevices,
+										 IMG_UINT32				ui32DeviceIndex,
+										 PVRSRV_DEV_POWER_STATE	eNewPowerState,
+										 IMG_BOOL				bForced)
+{
+	PVRSRV_ERROR		eError;
+	PVRSRV_DATA			*psPVRSRVData = PVRSRVGetPVRSRVData();
+
+	if (bAllDevices && psPVRSRVData->bParallelPower)
+	{
+		return _DevicePowerStateParallel(IMG_FALSE, eNewPowerState, bForced);
+	}
+
+	/* Loop through the power devices. */
+	eError = List_PVRSRV_POWER_DEV_PVRSRV_ERROR_Any_va(psPVRSRVData->psPowerDeviceList,
+														&PVRSRVDevicePrePowerStateKM_AnyVaCb,
+														bAllDevices,
+														ui32DeviceIndex,
+														eNewPowerState,
+														bForced);
+
+	return eError;
 }
 
 /*!
@@ -425,6 +841,11 @@ PVRSRV_ERROR PVRSRVDevicePostPowerStateKM(IMG_BOOL					bAllDevices,
 	PVRSRV_ERROR		eError;
 	PVRSRV_DATA			*psPVRSRVData = PVRSRVGetPVRSRVData();
 
+	if (bAllDevices && psPVRSRVData->bParallelPower)
+	{
+		return _DevicePowerStateParallel(IMG_TRUE, eNewPowerState, bForced);
+	}
+
 	/* Loop through the power devices. */
 	eError = List_PVRSRV_POWER_DEV_PVRSRV_ERROR_Any_va(psPVRSRVData->psPowerDeviceList,
 														&PVRSRVDevicePostPowerStateKM_AnyVaCb,
@@ -442,7 +863,8 @@ PVRSRV_ERROR PVRSRVDevicePostPowerStateKM(IMG_BOOL					bAllDevices,
 
  @Function	PVRSRVSetDevicePowerStateKM
 
- @Description	Set the Device into a new state
+ @Description	Set the Device into a new state. The caller must hold the
+                device power lock exclusively.
 
  @Input		ui32DeviceIndex : device index
  @Input		eNewPowerState : New power state
@@ -530,6 +952,22 @@ Exit:
 	return eError;
 }
 
+static IMG_VOID _LogSuspendTiming(PVRSRV_POWER_DEV *psPowerDevice)
+{
+	PVR_DPF((PVR_DBG_MESSAGE, "PVRSRVSetPowerStateKM: device %u suspend took %uus (max %uus)",
+			psPowerDevice->ui32DeviceIndex,
+			psPowerDevice->sTiming.ui32LastSuspendUs,
+			psPowerDevice->sTiming.ui32MaxSuspendUs));
+}
+
+static IMG_VOID _LogResumeTiming(PVRSRV_POWER_DEV *psPowerDevice)
+{
+	PVR_DPF((PVR_DBG_MESSAGE, "PVRSRVSetPowerStateKM: device %u resume took %uus (max %uus)",
+			psPowerDevice->ui32DeviceIndex,
+			psPowerDevice->sTiming.ui32LastResumeUs,
+			psPowerDevice->sTiming.ui32MaxResumeUs));
+}
+
 /*!
 ******************************************************************************
 
@@ -568,6 +1006,10 @@ PVRSRV_ERROR PVRSRVSetPowerStateKM(PVRSRV_SYS_POWER_STATE eNewSysPowerState, IMG
 	/* Prevent simultaneous SetPowerStateKM calls */
 	PVRSRVForcedPowerLock();
 
+	/* Exclude device transitions and kicks for the whole system transition */
+	List_PVRSRV_POWER_DEV_ForEach(psPVRSRVData->psPowerDeviceList,
+								  &_PowerDeviceLockExclusive);
+
 	/* Perform pre transitions: first device and then sys layer */
 	eError = PVRSRVDevicePrePowerStateKM(IMG_TRUE, 0, eNewDevicePowerState, bForced);
 	if (eError != PVRSRV_OK)
@@ -599,6 +1041,11 @@ PVRSRV_ERROR PVRSRVSetPowerStateKM(PVRSRV_SYS_POWER_STATE eNewSysPowerState, IMG
 	psPVRSRVData->eCurrentPowerState = eNewSysPowerState;
 	psPVRSRVData->eFailedPowerState = PVRSRV_SYS_POWER_STATE_Unspecified;
 
+	List_PVRSRV_POWER_DEV_ForEach(psPVRSRVData->psPowerDeviceList,
+								  _IsSystemStatePowered(eNewSysPowerState) ? &_LogResumeTiming : &_LogSuspendTiming);
+
+	List_PVRSRV_POWER_DEV_ForEach(psPVRSRVData->psPowerDeviceList,
+								  &_PowerDeviceUnlockExclusive);
 	PVRSRVPowerUnlock();
 
 	/*
@@ -617,6 +1064,8 @@ ErrorExit:
 	/* save the power state for the re-attempt */
 	psPVRSRVData->eFailedPowerState = eNewSysPowerState;
 
+	List_PVRSRV_POWER_DEV_ForEach(psPVRSRVData->psPowerDeviceList,
+								  &_PowerDeviceUnlockExclusive);
 	PVRSRVPowerUnlock();
 
 	PVR_DPF((PVR_DBG_ERROR,
@@ -642,6 +1091,8 @@ PVRSRV_ERROR PVRSRVRegisterPowerDevice(IMG_UINT32					ui32DeviceIndex,
 {
 	PVRSRV_DATA			*psPVRSRVData = PVRSRVGetPVRSRVData();
 	PVRSRV_POWER_DEV	*psPowerDevice;
+	PVRSRV_DEVICE_NODE	*psDeviceNode;
+	PVRSRV_ERROR		eError;
 
 	if (pfnDevicePrePower == IMG_NULL &&
 		pfnDevicePostPower == IMG_NULL)
@@ -656,6 +1107,15 @@ PVRSRV_ERROR PVRSRVRegisterPowerDevice(IMG_UINT32					ui32DeviceIndex,
 		return PVRSRV_ERROR_OUT_OF_MEMORY;
 	}
 
+	eError = OSWRLockCreate(&psPowerDevice->hPowerLock);
+	if (eError != PVRSRV_OK)
+	{
+		PVR_DPF((PVR_DBG_ERROR,"PVRSRVRegisterPowerDevice: Failed to create power lock"));
+		OSFreeMem(psPowerDevice);
+		return eError;
+	}
+	psPowerDevice->bExclusive = IMG_FALSE;
+
 	/* setup device for power manager */
 	psPowerDevice->pfnDevicePrePower = pfnDevicePrePower;
 	psPowerDevice->pfnDevicePostPower = pfnDevicePostPower;
@@ -667,6 +1127,17 @@ PVRSRV_ERROR PVRSRVRegisterPowerDevice(IMG_UINT32					ui32DeviceIndex,
 	psPowerDevice->ui32DeviceIndex = ui32DeviceIndex;
 	psPowerDevice->eCurrentPowerState = eCurrentPowerState;
 	psPowerDevice->eDefaultPowerState = eDefaultPowerState;
+	psPowerDevice->ui32TransitionUs = 0;
+	OSMemSet(&psPowerDevice->sTiming, 0, sizeof(psPowerDevice->sTiming));
+
+	/* the system layer declares which devices this one depends on */
+	psDeviceNode = (PVRSRV_DEVICE_NODE*)
+					List_PVRSRV_DEVICE_NODE_Any_va(psPVRSRVData->psDeviceNodeList,
+												   &MatchDeviceKM_AnyVaCb,
+												   ui32DeviceIndex,
+												   IMG_TRUE);
+	psPowerDevice->ui32Dependencies = (psDeviceNode != IMG_NULL && psDeviceNode->psDevConfig != IMG_NULL) ?
+										psDeviceNode->psDevConfig->ui32PowerDependencies : 0;
 
 	/* insert into power device list */
 	List_PVRSRV_POWER_DEV_Insert(&(psPVRSRVData->psPowerDeviceList), psPowerDevice);
@@ -703,6 +1174,7 @@ PVRSRV_ERROR PVRSRVRemovePowerDevice (IMG_UINT32 ui32DeviceIndex)
 	if (psPowerDev)
 	{
 		List_PVRSRV_POWER_DEV_Remove(psPowerDev);
+		OSWRLockDestroy(psPowerDev->hPowerLock);
 		OSFreeMem(psPowerDev);
 		/*not nulling pointer, copy on stack*/
 	}
@@ -746,6 +1218,37 @@ PVRSRV_ERROR PVRSRVGetDevicePowerState(IMG_UINT32 ui32DeviceIndex, PPVRSRV_DEV_P
 	return PVRSRV_OK;
 }
 
+/*!
+******************************************************************************
+
+ @Function	PVRSRVGetDevicePowerTiming
+
+ @Description
+
+	Return the time the device's power callbacks took on its last and
+	slowest suspend and resume
+
+ @Input		ui32DeviceIndex : device index
+ @Output	psTiming : callback timings
+
+ @Return	PVRSRV_ERROR_UNKNOWN_POWER_STATE if device could not be found. PVRSRV_OK otherwise.
+
+******************************************************************************/
+IMG_EXPORT
+PVRSRV_ERROR PVRSRVGetDevicePowerTiming(IMG_UINT32 ui32DeviceIndex, PVRSRV_POWER_DEV_TIMING *psTiming)
+{
+	PVRSRV_POWER_DEV	*psPowerDevice = _LookupPowerDevice(ui32DeviceIndex);
+
+	if (psPowerDevice == IMG_NULL)
+	{
+		return PVRSRV_ERROR_UNKNOWN_POWER_STATE;
+	}
+
+	*psTiming = psPowerDevice->sTiming;
+
+	return PVRSRV_OK;
+}
+
 /*!
 ******************************************************************************
 
@@ -763,20 +1266,15 @@ PVRSRV_ERROR PVRSRVGetDevicePowerState(IMG_UINT32 ui32DeviceIndex, PPVRSRV_DEV_P
 IMG_EXPORT
 IMG_BOOL PVRSRVIsDevicePowered(IMG_UINT32 ui32DeviceIndex)
 {
-	PVRSRV_DATA            *psPVRSRVData = PVRSRVGetPVRSRVData();
-	PVRSRV_DEV_POWER_STATE ePowerState;
-
-	if (OSLockIsLocked(psPVRSRVData->hPowerLock))
-	{
-		return IMG_FALSE;
-	}
+	PVRSRV_POWER_DEV	*psPowerDevice = _LookupPowerDevice(ui32DeviceIndex);
 
-	if (PVRSRVGetDevicePowerState(ui32DeviceIndex, &ePowerState) != PVRSRV_OK)
+	/* A device in the middle of a transition is not considered powered */
+	if (psPowerDevice == IMG_NULL || psPowerDevice->bExclusive)
 	{
 		return IMG_FALSE;
 	}
 
-	return (ePowerState == PVRSRV_DEV_POWER_STATE_ON);
+	return (psPowerDevice->eCurrentPowerState == PVRSRV_DEV_POWER_STATE_ON);
 }
 
 
@@ -815,8 +1313,8 @@ PVRSRV_ERROR PVRSRVDevicePreClockSpeedChange(IMG_UINT32	ui32DeviceIndex,
 	do
 	{
 
-		/* This mutex is released in PVRSRVDevicePostClockSpeedChange. */
-		eError = PVRSRVPowerLock();
+		/* This lock is released in PVRSRVDevicePostClockSpeedChange. */
+		eError = PVRSRVDevicePowerLock(ui32DeviceIndex, IMG_FALSE, IMG_NULL);
 		if (eError != PVRSRV_OK)
 		{
 			PVR_DPF((PVR_DBG_ERROR,	"PVRSRVDevicePreClockSpeedChange : failed to acquire lock, error:0x%x", eError));
@@ -842,7 +1340,7 @@ PVRSRV_ERROR PVRSRVDevicePreClockSpeedChange(IMG_UINT32	ui32DeviceIndex,
 						ui32DeviceIndex));
 		
 
-				PVRSRVPowerUnlock();
+				PVRSRVDevicePowerUnlock(ui32DeviceIndex, IMG_FALSE);
 				OSSleepms(1);
 			}
 		}
@@ -851,7 +1349,7 @@ PVRSRV_ERROR PVRSRVDevicePreClockSpeedChange(IMG_UINT32	ui32DeviceIndex,
 
 	if (eError != PVRSRV_OK)
 	{
-		PVRSRVPowerUnlock();
+		PVRSRVDevicePowerUnlock(ui32DeviceIndex, IMG_FALSE);
 	}
 
 	return eError;
@@ -904,8 +1402,8 @@ IMG_VOID PVRSRVDevicePostClockSpeedChange(IMG_UINT32	ui32DeviceIndex,
 	}
 
 
-	/* This mutex was acquired in PVRSRVDevicePreClockSpeedChange. */
-	PVRSRVPowerUnlock();
+	/* This lock was acquired in PVRSRVDevicePreClockSpeedChange. */
+	PVRSRVDevicePowerUnlock(ui32DeviceIndex, IMG_FALSE);
 
 }
 
@@ -86,6 +86,9 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 /*! Sleep time (1h) for Devices Watchdog thread when GPU is in power off state */
 #define DEVICES_WATCHDOG_POWER_OFF_SLEEP_TIMEOUT 60 * 60 * 1000
 
+/*! Number of sync primitives pre-reserved on each device's sync context */
+#define SYNC_PRIM_DEVICE_RESERVE 64
+
 
 typedef struct DEBUG_REQUEST_ENTRY_TAG
 {
@@ -341,7 +344,7 @@ PVRSRV_ERROR IMG_CALLCONV PVRSRVEnumerateDevicesKM(IMG_UINT32 *pui32NumDevices,
 static IMG_VOID CleanupThread(IMG_PVOID pvData)
 {
 	PVRSRV_DATA *psPVRSRVData = pvData;
-	IMG_BOOL     bRetryCleanup = IMG_FALSE;
+	PVRSRV_ERROR eFlush = PVRSRV_OK;
 	IMG_HANDLE	 hOSEvent;
 	PVRSRV_ERROR eRc;
 
@@ -364,36 +367,51 @@ static IMG_VOID CleanupThread(IMG_PVOID pvData)
 	while ((psPVRSRVData->eServicesState == PVRSRV_SERVICES_STATE_OK) && 
 			(!psPVRSRVData->bUnload))
 	{
-		/* We don't want to hold the bridge lock while we are
-		 * descheduled in the EO wait call */
-		OSSetReleasePVRLock();
-
-		/* Wait until RESMAN signals for deferred clean up OR wait for a
-		 * short period if the previous deferred clean up was not able
-		 * to release all the resources before trying again.
-		 * Bridge lock re-acquired on our behalf before the wait call returns.
-		 */
-		eRc = OSEventObjectWaitTimeout(hOSEvent, (bRetryCleanup) ?
-				CLEANUP_THREAD_WAIT_RETRY_TIMEOUT :
-				CLEANUP_THREAD_WAIT_SLEEP_TIMEOUT);
-		if (eRc == PVRSRV_ERROR_TIMEOUT)
-		{
-			PVR_DPF((CLEANUP_DPFL, "CleanupThread: wait timeout"));
-		}
-		else if (eRc == PVRSRV_OK)
+		if (eFlush == PVRSRV_ERROR_TIMEOUT)
 		{
-			PVR_DPF((CLEANUP_DPFL, "CleanupThread: wait OK, signal received"));
+			/* The last batch used up its time but there is more to free.
+			 * Drop the bridge lock so waiting client calls can get in
+			 * before we carry on with the next batch.
+			 */
+			OSReleaseBridgeLock();
+			OSReleaseThreadQuanta();
+			OSAcquireBridgeLock();
 		}
 		else
 		{
-			PVR_DPF((PVR_DBG_ERROR, "CleanupThread: wait error %d", eRc));
+			/* We don't want to hold the bridge lock while we are
+			 * descheduled in the EO wait call */
+			OSSetReleasePVRLock();
+
+			/* Wait until RESMAN signals for deferred clean up OR wait for a
+			 * short period if the previous deferred clean up was not able
+			 * to release all the resources before trying again.
+			 * Bridge lock re-acquired on our behalf before the wait call returns.
+			 */
+			eRc = OSEventObjectWaitTimeout(hOSEvent, (eFlush == PVRSRV_ERROR_RETRY) ?
+					CLEANUP_THREAD_WAIT_RETRY_TIMEOUT :
+					CLEANUP_THREAD_WAIT_SLEEP_TIMEOUT);
+			if (eRc == PVRSRV_ERROR_TIMEOUT)
+			{
+				PVR_DPF((CLEANUP_DPFL, "CleanupThread: wait timeout"));
+			}
+			else if (eRc == PVRSRV_OK)
+			{
+				PVR_DPF((CLEANUP_DPFL, "CleanupThread: wait OK, signal received"));
+			}
+			else
+			{
+				PVR_DPF((PVR_DBG_ERROR, "CleanupThread: wait error %d", eRc));
+			}
 		}
 
-		/* Attempt to clean up all deferred contexts that may exist. If
-		 * resources still need cleanup on exit bRetryCleanup set to true.
+		/* Free the next batch from the deferred contexts that may exist.
+		 * Returns timeout if the batch budget ran out and retry if
+		 * resources were busy and still need cleanup.
 		 */
-		bRetryCleanup = PVRSRVResManFlushDeferContext(
-				psPVRSRVData->hResManDeferContext);
+		eFlush = PVRSRVResManFlushDeferContext(
+				psPVRSRVData->hResManDeferContext,
+				RESMAN_DEFER_BATCH_BUDGET_US);
 	}
 
 	/* Thread about to exit -release our hold of the bridge lock and clean up */
@@ -612,7 +630,7 @@ PVRSRV_ERROR IMG_CALLCONV PVRSRVInit(IMG_VOID)
 		goto Error;
 	}
 
-	/* Initialise Power Manager Lock */
+	/* Initialise the system power lock */
 	eError = OSLockCreate(&gpsPVRSRVData->hPowerLock, LOCK_TYPE_PASSIVE);
 	if (eError != PVRSRV_OK)
 	{
@@ -622,6 +640,7 @@ PVRSRV_ERROR IMG_CALLCONV PVRSRVInit(IMG_VOID)
 	/* Initialise system power state */
 	gpsPVRSRVData->eCurrentPowerState = PVRSRV_SYS_POWER_STATE_ON;
 	gpsPVRSRVData->eFailedPowerState = PVRSRV_SYS_POWER_STATE_Unspecified;
+	gpsPVRSRVData->bParallelPower = (psSysConfig->uiSysFlags & PVRSRV_SYS_FLAGS_PARALLEL_POWER) ? IMG_TRUE : IMG_FALSE;
 
 	/* Initialise overall system state */
 	gpsPVRSRVData->eServicesState = PVRSRV_SERVICES_STATE_OK;
@@ -1320,7 +1339,7 @@ static PVRSRV_ERROR PVRSRVFinaliseSystem_SetPowerState_AnyCb(PVRSRV_DEVICE_NODE
 
 	ePowState = va_arg(va, PVRSRV_DEV_POWER_STATE);
 
-	eError = PVRSRVPowerLock();
+	eError = PVRSRVDevicePowerLock(psDeviceNode->sDevId.ui32DeviceIndex, IMG_FALSE, IMG_NULL);
 	if (eError != PVRSRV_OK)
 	{
 		PVR_DPF((PVR_DBG_ERROR,"PVRSRVFinaliseSystem_SetPowerState_AnyCb: Failed to acquire power lock"));
@@ -1337,7 +1356,7 @@ static PVRSRV_ERROR PVRSRVFinaliseSystem_SetPowerState_AnyCb(PVRSRV_DEVICE_NODE
 						psDeviceNode->sDevId.ui32DeviceIndex));
 	}
 	
-	PVRSRVPowerUnlock();
+	PVRSRVDevicePowerUnlock(psDeviceNode->sDevId.ui32DeviceIndex, IMG_FALSE);
 
 	return eError;
 }
@@ -1391,6 +1410,15 @@ PVRSRV_ERROR IMG_CALLCONV PVRSRVFinaliseSystem(IMG_BOOL bInitSuccessful, IMG_UIN
 								  psDeviceNode,
 								  &psDeviceNode->hSyncPrimContext);
 
+			/* Pre-reserve sync prims so steady state allocations don't need
+			   to import new sync blocks */
+			eError = SyncPrimContextReserve(psDeviceNode->hSyncPrimContext,
+											SYNC_PRIM_DEVICE_RESERVE);
+			if (eError != PVRSRV_OK)
+			{
+				PVR_DPF((PVR_DBG_WARNING,"PVRSRVFinaliseSystem: Failed to reserve sync primitives (%u)", eError));
+			}
+
 			/* Allocate general purpose sync primitive */
 			eError = SyncPrimAlloc(psDeviceNode->hSyncPrimContext, &psDeviceNode->psSyncPrim);
 			if (eError != PVRSRV_OK)
@@ -1593,7 +1621,7 @@ static PVRSRV_ERROR IMG_CALLCONV PVRSRVUnregisterDevice(PVRSRV_DEVICE_NODE *psDe
 	PVRSRV_DEVICE_PHYS_HEAP ePhysHeapIdx;
 	PVRSRV_ERROR			eError;
 
-	eError = PVRSRVPowerLock();
+	eError = PVRSRVDevicePowerLock(psDeviceNode->sDevId.ui32DeviceIndex, IMG_FALSE, IMG_NULL);
 	if (eError != PVRSRV_OK)
 	{
 		PVR_DPF((PVR_DBG_ERROR,"PVRSRVUnregisterDevice: Failed to acquire power lock"));
@@ -1615,7 +1643,7 @@ static PVRSRV_ERROR IMG_CALLCONV PVRSRVUnregisterDevice(PVRSRV_DEVICE_NODE *psDe
 		/* If the driver is okay then return the error, otherwise we can ignore this error. */
 		if (PVRSRVGetPVRSRVData()->eServicesState == PVRSRV_SERVICES_STATE_OK)
 		{
-			PVRSRVPowerUnlock();
+			PVRSRVDevicePowerUnlock(psDeviceNode->sDevId.ui32DeviceIndex, IMG_FALSE);
 			return eError;
 		}
 		else
@@ -1624,7 +1652,7 @@ static PVRSRV_ERROR IMG_CALLCONV PVRSRVUnregisterDevice(PVRSRV_DEVICE_NODE *psDe
 		}
 	}
 
-	PVRSRVPowerUnlock();
+	PVRSRVDevicePowerUnlock(psDeviceNode->sDevId.ui32DeviceIndex, IMG_FALSE);
 
 	/*
 		De-init the device.
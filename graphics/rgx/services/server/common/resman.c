@@ -54,6 +54,14 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #define RESMAN_SIGNATURE 0x12345678
 
+/*
+	Items are kept on one list per resource type so that freeing by type
+	only visits matching items. All RESMAN_TYPE_ values fit in the table,
+	the mask only keeps unknown types in range.
+*/
+#define RESMAN_TYPE_LIST_COUNT		64
+#define RESMAN_TYPE_LIST(ui32ResType)	((ui32ResType) & (RESMAN_TYPE_LIST_COUNT - 1))
+
 /******************************************************************************
  * resman structures
  *****************************************************************************/
@@ -69,6 +77,7 @@ typedef struct _RESMAN_ITEM_
 	IMG_UINT32				ui32ResType;/*!< res type */
 	IMG_PVOID				pvParam;	/*!< param for callback */
 	RESMAN_FREE_FN			pfnFreeResource;/*!< resman item free callback */
+	struct _RESMAN_CONTEXT_	*psResManContext;/*!< context owning this item */
 } RESMAN_ITEM;
 
 
@@ -82,7 +91,8 @@ typedef struct _RESMAN_CONTEXT_
 	struct	_RESMAN_CONTEXT_	**ppsThis;/*!< list navigation */
 	struct	_RESMAN_CONTEXT_	*psNext;/*!< list navigation */
 
-	RESMAN_ITEM					*psResItemList;/*!< res item list for context */
+	RESMAN_ITEM					*apsResItemList[RESMAN_TYPE_LIST_COUNT];/*!< res item lists for context, indexed by type */
+	IMG_UINT32					ui32ResItemCount;/*!< number of items on the lists */
 
 } RESMAN_CONTEXT;
 
@@ -117,14 +127,21 @@ static IMPLEMENT_LIST_INSERT(RESMAN_CONTEXT)
 
 static PVRSRV_ERROR FreeResourceByPtr(RESMAN_ITEM *psItem);
 
+static RESMAN_ITEM *FindResourceByCriteria(PRESMAN_CONTEXT	psResManContext,
+										   IMG_UINT32		ui32SearchCriteria,
+										   IMG_UINT32		ui32ResType,
+										   IMG_PVOID		pvParam);
+
 static PVRSRV_ERROR FreeResourceByCriteria(PRESMAN_CONTEXT	psContext,
 										   IMG_UINT32		ui32SearchCriteria,
 										   IMG_UINT32		ui32ResType,
 										   IMG_PVOID		pvParam,
-										   IMG_BOOL			bDefer);
+										   IMG_BOOL			bDefer,
+										   IMG_UINT64		ui64DeadlineUs);
 
-static IMG_VOID ResManFreeResources(PRESMAN_CONTEXT psResManContext,
-									IMG_BOOL bDefer);
+static PVRSRV_ERROR ResManFreeResources(PRESMAN_CONTEXT psResManContext,
+										IMG_BOOL bDefer,
+										IMG_UINT64 ui64DeadlineUs);
 
 /*!
 ******************************************************************************
@@ -183,7 +200,8 @@ PVRSRV_ERROR PVRSRVResManConnect(PRESMAN_DEFER_CONTEXT psDeferContext,
 	}
 
 	psResManContext->ui32Signature = RESMAN_SIGNATURE;
-	psResManContext->psResItemList	= IMG_NULL;
+	OSMemSet(psResManContext->apsResItemList, 0, sizeof(psResManContext->apsResItemList));
+	psResManContext->ui32ResItemCount = 0;
 	psResManContext->psDeferContext = psDeferContext;
 
 	/*Acquire resource list sync object*/
@@ -213,21 +231,27 @@ PVRSRV_ERROR PVRSRVResManConnect(PRESMAN_DEFER_CONTEXT psDeferContext,
 IMG_VOID PVRSRVResManDisconnect(PRESMAN_CONTEXT psResManContext)
 {
 	IMG_BOOL bDefer = IMG_FALSE;
+	IMG_UINT64 ui64DeadlineUs = 0;
 
-	/* If we have a deferred resman context then allow freeing to be deferred */
+	/*
+		If we have a deferred resman context then allow freeing to be
+		deferred. Only spend a short time freeing here, whatever is left
+		over is freed in batches by the clean up thread.
+	*/
 	if (psResManContext->psDeferContext)
 	{
 		bDefer = IMG_TRUE;
+		ui64DeadlineUs = OSClockus64() + RESMAN_DISCONNECT_BUDGET_US;
 	}
 
 	/* Acquire resource list sync object */
 	ACQUIRE_SYNC_OBJ;
 
 	/* Free or defer all the resources */
-	ResManFreeResources(psResManContext, bDefer);
+	(IMG_VOID)ResManFreeResources(psResManContext, bDefer, ui64DeadlineUs);
 
 	/* Ensure that there are no resources left */
-	if (psResManContext->psResItemList != IMG_NULL)
+	if (psResManContext->ui32ResItemCount != 0)
 	{
 		PVR_ASSERT(psResManContext->psDeferContext);
 		PVR_DPF((PVR_DBG_WARNING, "PVRSRVResManDisconnect: Resman context (%p) disconnect deferred", psResManContext));
@@ -283,21 +307,24 @@ PVRSRV_ERROR PVRSRVResManCreateDeferContext(IMG_HANDLE hCleanupEventObject,
 	return PVRSRV_OK;
 }
 
-static IMG_VOID FlushDeferResManContext(PRESMAN_CONTEXT psResManContext)
+static PVRSRV_ERROR FlushDeferResManContext(PRESMAN_CONTEXT psResManContext,
+											IMG_UINT64 ui64DeadlineUs)
 {
+	PVRSRV_ERROR eError = PVRSRV_OK;
+
 	/* If there are no items on this list then it shouldn’t be here */
-	PVR_ASSERT(psResManContext->psResItemList);
-	if (psResManContext->psResItemList)
+	PVR_ASSERT(psResManContext->ui32ResItemCount);
+	if (psResManContext->ui32ResItemCount)
 	{
 		/* Free what we can */
-		ResManFreeResources(psResManContext, IMG_FALSE);
+		eError = ResManFreeResources(psResManContext, IMG_FALSE, ui64DeadlineUs);
 	}
 
 	/*
 		If we've freed everything then remove this context from
 		the defer context and destroy it
 	*/
-	if (!psResManContext->psResItemList)
+	if (!psResManContext->ui32ResItemCount)
 	{
 		PVR_DPF((PVR_DBG_WARNING, "PVRSRVResManDisconnect: Resman context (%p) deferred free finished", psResManContext));
 		List_RESMAN_CONTEXT_Remove(psResManContext);
@@ -305,12 +332,19 @@ static IMG_VOID FlushDeferResManContext(PRESMAN_CONTEXT psResManContext)
 	}
 	else
 	{
+#if defined(DEBUG)
+		RESMAN_ITEM *psResItem = FindResourceByCriteria(psResManContext, RESMAN_CRITERIA_ALL, 0, IMG_NULL);
+#endif
+
 		PVR_DPF((PVR_DBG_MESSAGE, "PVRSRVResManDisconnect: Resman context (%p) still has pending resources", psResManContext));
-		PVR_DPF((PVR_DBG_MESSAGE, "PVRSRVResManDisconnect: psResManContext->psResItemList = %p", psResManContext->psResItemList));
+		PVR_DPF((PVR_DBG_MESSAGE, "PVRSRVResManDisconnect: %u items left, first = %p",
+				psResManContext->ui32ResItemCount, psResItem));
 		PVR_DPF((PVR_DBG_MESSAGE, "PVRSRVResManDisconnect: type = %d, pvParam = %p",
-				psResManContext->psResItemList->ui32ResType,
-				psResManContext->psResItemList->pvParam));
+				psResItem->ui32ResType,
+				psResItem->pvParam));
 	}
+
+	return eError;
 }
 
 /*!
@@ -323,23 +357,55 @@ static IMG_VOID FlushDeferResManContext(PRESMAN_CONTEXT psResManContext)
             this defer context
 
  @input 	psResManDeferContext - Defer context
+ @input 	ui32BudgetUs - Time to spend freeing before returning, 0 to
+                           free everything that can be freed now
 
- @Return	IMG_BOOL - true when resources still need deferred cleanup
-                       false otherwise, the deferred context list is empty
+ @Return	PVRSRV_OK - the deferred context list is empty
+            PVRSRV_ERROR_TIMEOUT - the budget ran out, call again soon
+            PVRSRV_ERROR_RETRY - resources are busy, try again later
 
 ******************************************************************************/
-IMG_BOOL PVRSRVResManFlushDeferContext(PRESMAN_DEFER_CONTEXT psDeferContext)
+PVRSRV_ERROR PVRSRVResManFlushDeferContext(PRESMAN_DEFER_CONTEXT psDeferContext,
+										   IMG_UINT32 ui32BudgetUs)
 {
+	RESMAN_CONTEXT	*psResManContext;
+	RESMAN_CONTEXT	*psNext;
+	IMG_UINT64		ui64DeadlineUs = 0;
+	PVRSRV_ERROR	eError = PVRSRV_OK;
+
+	if (ui32BudgetUs != 0)
+	{
+		ui64DeadlineUs = OSClockus64() + ui32BudgetUs;
+	}
+
 	/* Acquire resource list sync object */
 	ACQUIRE_SYNC_OBJ;
 
 	/* Go through checking all resman contexts on this defer context */
-	List_RESMAN_CONTEXT_ForEachSafe(psDeferContext->psDeferResManContextList, FlushDeferResManContext);
+	psResManContext = psDeferContext->psDeferResManContextList;
+	while (psResManContext != IMG_NULL)
+	{
+		/* The context is freed if it has been emptied */
+		psNext = psResManContext->psNext;
+
+		if (FlushDeferResManContext(psResManContext, ui64DeadlineUs) == PVRSRV_ERROR_TIMEOUT)
+		{
+			eError = PVRSRV_ERROR_TIMEOUT;
+			break;
+		}
+
+		psResManContext = psNext;
+	}
+
+	if ((eError == PVRSRV_OK) && (psDeferContext->psDeferResManContextList != IMG_NULL))
+	{
+		eError = PVRSRV_ERROR_RETRY;
+	}
 
 	/* Release resource list sync object */
 	RELEASE_SYNC_OBJ;
 
-	PVR_DPF_RETURN_VAL((psDeferContext->psDeferResManContextList != IMG_NULL) ? IMG_TRUE : IMG_FALSE);
+	return eError;
 }
 
 /*!
@@ -377,7 +443,7 @@ IMG_VOID PVRSRVResManDestroyDeferContext(PRESMAN_DEFER_CONTEXT psDeferContext)
 		/* Attempt to free more resources... */
 		LOOP_UNTIL_TIMEOUT(MAX_HW_TIME_US)
 		{
-			PVRSRVResManFlushDeferContext(psDeferContext);
+			PVRSRVResManFlushDeferContext(psDeferContext, 0);
 			
 			/* If the driver is not in a okay state then don't try again... */
 			if (PVRSRVGetPVRSRVData()->eServicesState != PVRSRV_SERVICES_STATE_OK)
@@ -395,7 +461,7 @@ IMG_VOID PVRSRVResManDestroyDeferContext(PRESMAN_DEFER_CONTEXT psDeferContext)
 		} END_LOOP_UNTIL_TIMEOUT();
 
 		/* Once more for luck and then force the issue... */
-		PVRSRVResManFlushDeferContext(psDeferContext);
+		PVRSRVResManFlushDeferContext(psDeferContext, 0);
 		if (psDeferContext->psDeferResManContextList != IMG_NULL)
 		{
 			ui32DeferedCount = 0;
@@ -476,9 +542,11 @@ PRESMAN_ITEM ResManRegisterRes(PRESMAN_CONTEXT	psResManContext,
 	psNewResItem->ui32ResType		= ui32ResType;
 	psNewResItem->pvParam			= pvParam;
 	psNewResItem->pfnFreeResource	= pfnFreeResource;
+	psNewResItem->psResManContext	= psResManContext;
 
-	/* Insert new structure after dummy first entry */
-	List_RESMAN_ITEM_Insert(&psResManContext->psResItemList, psNewResItem);
+	/* Insert new structure on the list for its type */
+	List_RESMAN_ITEM_Insert(&psResManContext->apsResItemList[RESMAN_TYPE_LIST(ui32ResType)], psNewResItem);
+	psResManContext->ui32ResItemCount++;
 
 	/* Release resource list sync object */
 	RELEASE_SYNC_OBJ;
@@ -604,7 +672,7 @@ PVRSRV_ERROR ResManFreeResByCriteria(PRESMAN_CONTEXT	psResManContext,
 
 	/* Free resources by criteria for this context */
 	eError = FreeResourceByCriteria(psResManContext, ui32SearchCriteria,
-									ui32ResType, pvParam, IMG_FALSE);
+									ui32ResType, pvParam, IMG_FALSE, 0);
 
 	/* Release resource list sync object */
 	RELEASE_SYNC_OBJ;
@@ -640,20 +708,19 @@ PVRSRV_ERROR ResManDissociateRes(RESMAN_ITEM		*psResItem,
 
 	PVR_ASSERT(psResItem->ui32Signature == RESMAN_SIGNATURE);
 
+	/* Remove this item from its old resource list */
+	List_RESMAN_ITEM_Remove(psResItem);
+	psResItem->psResManContext->ui32ResItemCount--;
+
 	if (psNewResManContext != IMG_NULL)
 	{
-		/* Remove this item from its old resource list */
-		List_RESMAN_ITEM_Remove(psResItem);
-
 		/* Re-insert into new list */
-		List_RESMAN_ITEM_Insert(&psNewResManContext->psResItemList, psResItem);
-
+		List_RESMAN_ITEM_Insert(&psNewResManContext->apsResItemList[RESMAN_TYPE_LIST(psResItem->ui32ResType)], psResItem);
+		psResItem->psResManContext = psNewResManContext;
+		psNewResManContext->ui32ResItemCount++;
 	}
 	else
 	{
-		/* Remove this item from its old resource list */
-		List_RESMAN_ITEM_Remove(psResItem);
-		
 		/* Free this item as no one refers to it now */
 		OSFreeMem(psResItem);
 	}
@@ -728,8 +795,8 @@ IMG_INTERNAL PVRSRV_ERROR ResManFindResourceByPtr(PRESMAN_CONTEXT	psResManContex
 			psResManContext, psItem->ui32ResType, psItem->pvParam,
 			psItem->pfnFreeResource));
 
-	/* Search resource items starting at after the first dummy item */
-	if(List_RESMAN_ITEM_IMG_BOOL_Any_va(psResManContext->psResItemList,
+	/* Only the list for the item's type can hold it */
+	if(List_RESMAN_ITEM_IMG_BOOL_Any_va(psResManContext->apsResItemList[RESMAN_TYPE_LIST(psItem->ui32ResType)],
 										&ResManFindResourceByPtr_AnyVaCb,
 										psItem))
 	{
@@ -806,7 +873,8 @@ static PVRSRV_ERROR FreeResourceByPtr(RESMAN_ITEM	*psItem)
 	{
 		/* Remove this item from the resource list */
 		List_RESMAN_ITEM_Remove(psItem);
-	
+		psItem->psResManContext->ui32ResItemCount--;
+
 		/* Free memory for the resource item */
 		OSFreeMem(psItem);
 	}
@@ -861,6 +929,53 @@ static IMG_VOID* FreeResourceByCriteria_AnyVaCb(RESMAN_ITEM *psCurItem, va_list
 	}
 }
 
+/*!
+******************************************************************************
+ @Function	 	FindResourceByCriteria
+
+ @Description
+ 					Finds the first resource on the context matching the
+ 					given criteria. When matching by type only the list for
+ 					that type is searched.
+
+ @inputs        psResManContext - pointer to resman context
+ @inputs        ui32SearchCriteria - indicates which parameters should be used
+ @inputs        ui32ResType - identify what kind of resource to find
+ @inputs        pvParam - address of resource to find
+
+ @Return   		matching item or IMG_NULL
+**************************************************************************/
+static RESMAN_ITEM *FindResourceByCriteria(PRESMAN_CONTEXT	psResManContext,
+										   IMG_UINT32		ui32SearchCriteria,
+										   IMG_UINT32		ui32ResType,
+										   IMG_PVOID		pvParam)
+{
+	RESMAN_ITEM	*psItem = IMG_NULL;
+	IMG_UINT32	i;
+
+	if (ui32SearchCriteria & RESMAN_CRITERIA_RESTYPE)
+	{
+		return (RESMAN_ITEM *)
+				List_RESMAN_ITEM_Any_va(psResManContext->apsResItemList[RESMAN_TYPE_LIST(ui32ResType)],
+										&FreeResourceByCriteria_AnyVaCb,
+										ui32SearchCriteria,
+										ui32ResType,
+										pvParam);
+	}
+
+	for (i = 0; (i < RESMAN_TYPE_LIST_COUNT) && (psItem == IMG_NULL); i++)
+	{
+		psItem = (RESMAN_ITEM *)
+				List_RESMAN_ITEM_Any_va(psResManContext->apsResItemList[i],
+										&FreeResourceByCriteria_AnyVaCb,
+										ui32SearchCriteria,
+										ui32ResType,
+										pvParam);
+	}
+
+	return psItem;
+}
+
 /*!
 ******************************************************************************
  @Function	 	FreeResourceByCriteria
@@ -876,6 +991,9 @@ static IMG_VOID* FreeResourceByCriteria_AnyVaCb(RESMAN_ITEM *psCurItem, va_list
                 of any errors. If any resource returns a retry error then this
                 will be returned (after we've tried to free all the other
                 resources).
+                If a deadline is given and it passes we stop freeing and
+                treat the remaining resources as if they had returned retry,
+                returning PVRSRV_ERROR_TIMEOUT.
 
  @inputs        psResManContext - pointer to resman context
  @inputs        ui32SearchCriteria - indicates which parameters should be used
@@ -883,6 +1001,7 @@ static IMG_VOID* FreeResourceByCriteria_AnyVaCb(RESMAN_ITEM *psCurItem, va_list
  @inputs        ui32ResType - identify what kind of resource to free
  @inputs        pvParam - address of resource to be free
  @inputs        bDefer - If the free fails defer the resource free from this process
+ @inputs        ui64DeadlineUs - OSClockus64 time to stop freeing at, 0 for none
 
  @Return   		PVRSRV_ERROR
 **************************************************************************/
@@ -890,7 +1009,8 @@ static PVRSRV_ERROR FreeResourceByCriteria(PRESMAN_CONTEXT	psResManContext,
 										   IMG_UINT32		ui32SearchCriteria,
 										   IMG_UINT32		ui32ResType,
 										   IMG_PVOID		pvParam,
-										   IMG_BOOL			bDefer)
+										   IMG_BOOL			bDefer,
+										   IMG_UINT64		ui64DeadlineUs)
 {
 	PRESMAN_ITEM	psCurItem;
 	PVRSRV_ERROR	eError = PVRSRV_OK;
@@ -899,26 +1019,40 @@ static PVRSRV_ERROR FreeResourceByCriteria(PRESMAN_CONTEXT	psResManContext,
 
 	/* Search resource items starting at after the first dummy item */
 	/*while we get a match and not an error*/
-	while((psCurItem = (PRESMAN_ITEM)
-				List_RESMAN_ITEM_Any_va(psResManContext->psResItemList,
-										&FreeResourceByCriteria_AnyVaCb,
-										ui32SearchCriteria,
-										ui32ResType,
-						 				pvParam)) != IMG_NULL
+	while((psCurItem = FindResourceByCriteria(psResManContext,
+											  ui32SearchCriteria,
+											  ui32ResType,
+											  pvParam)) != IMG_NULL
 		  	&& bContinue)
 	{
-		eError = FreeResourceByPtr(psCurItem);
+		if ((ui64DeadlineUs != 0) && (OSClockus64() >= ui64DeadlineUs))
+		{
+			/* Out of time, leave the rest for the next batch */
+			eError = PVRSRV_ERROR_TIMEOUT;
+		}
+		else
+		{
+			eError = FreeResourceByPtr(psCurItem);
+		}
 
 		/*
-			We failed to free the resource, if we got a retry and this process
-			disconnect time then defer the free until later.
+			We failed to free the resource, if we got a retry or ran out of
+			time and this process disconnect time then defer the free until
+			later.
 		*/
-		if ((eError == PVRSRV_ERROR_RETRY) && bDefer)
+		if (((eError == PVRSRV_ERROR_RETRY) || (eError == PVRSRV_ERROR_TIMEOUT)) && bDefer)
 		{
 			PVRSRV_ERROR ret;
 
 			PVR_ASSERT(psResManContext->psDeferContext);
-			PVR_DPF((PVR_DBG_WARNING, "FreeResourceByCriteria: Resource %p (type %d) returned retry. Moving resman context to defer context", psCurItem, ui32ResType));
+			if (eError == PVRSRV_ERROR_RETRY)
+			{
+				PVR_DPF((PVR_DBG_WARNING, "FreeResourceByCriteria: Resource %p (type %d) returned retry. Moving resman context to defer context", psCurItem, ui32ResType));
+			}
+			else
+			{
+				PVR_DPF((PVR_DBG_MESSAGE, "FreeResourceByCriteria: Out of time at resource %p (type %d). Moving resman context to defer context", psCurItem, ui32ResType));
+			}
 
 			/*
 				Due to the fact the not all resources are refcounted against each
@@ -952,6 +1086,10 @@ static PVRSRV_ERROR FreeResourceByCriteria(PRESMAN_CONTEXT	psResManContext,
 				bRetry = IMG_TRUE;
 				bContinue = IMG_FALSE;
 			}
+			else if (eError == PVRSRV_ERROR_TIMEOUT)
+			{
+				bContinue = IMG_FALSE;
+			}
 			else if (eError != PVRSRV_OK)
 			{
 				PVR_DPF((PVR_DBG_ERROR, "FreeResourceByCriteria: Error freeing resource %p (%s)", psCurItem, PVRSRVGetErrorStringKM(eError)));
@@ -1041,24 +1179,28 @@ static IMG_UINT32 g_ui32OrderedFreeList [] = {
 
  @inputs        psResManContext - pointer to resman context
  @inputs        bDefer - Defer the free if we can't free the resource now
+ @inputs        ui64DeadlineUs - OSClockus64 time to stop freeing at, 0 for none
 
- @Return   		None
+ @Return   		PVRSRV_ERROR from the first resource type that failed
 **************************************************************************/
-static IMG_VOID ResManFreeResources(PRESMAN_CONTEXT psResManContext,
-									IMG_BOOL bDefer)
+static PVRSRV_ERROR ResManFreeResources(PRESMAN_CONTEXT psResManContext,
+										IMG_BOOL bDefer,
+										IMG_UINT64 ui64DeadlineUs)
 {
 	IMG_UINT32 i;
-	PVRSRV_ERROR eError;
+	PVRSRV_ERROR eError = PVRSRV_OK;
 
 	for (i=0;i<(sizeof(g_ui32OrderedFreeList)/sizeof(g_ui32OrderedFreeList[0]));i++)
 	{
-		eError = FreeResourceByCriteria(psResManContext, RESMAN_CRITERIA_RESTYPE, g_ui32OrderedFreeList[i], IMG_NULL, bDefer);
+		eError = FreeResourceByCriteria(psResManContext, RESMAN_CRITERIA_RESTYPE, g_ui32OrderedFreeList[i], IMG_NULL, bDefer, ui64DeadlineUs);
 		if (eError != PVRSRV_OK)
 		{
 			/* Bail on error */
 			break;
 		}
 	}
+
+	return eError;
 }
 
 /******************************************************************************
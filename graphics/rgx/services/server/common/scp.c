@@ -112,6 +112,9 @@ struct _SCP_CONTEXT_
 	IMG_UINT32			ui32CCBSize;        /*!< CCB size */
 	IMG_UINT32			psSyncRequesterID;	/*!< Sync requester ID, used when taking sync operations */
 	POS_LOCK			hLock;				/*!< Lock for this structure */
+	IMG_BOOL			bOutOfOrder;		/*!< Allow independent commands to overtake blocked ones */
+	IMG_UINT32			ui32IssueSeq;		/*!< Sequence number for the next command issued */
+	IMG_UINT32			ui32CompleteSeq;	/*!< Sequence number of the next command to complete */
 #if defined(PVR_ANDROID_NATIVE_WINDOW_HAS_SYNC)
 	IMG_VOID            *pvTimeline;
 	IMG_UINT32          ui32TimelineVal;
@@ -132,10 +135,17 @@ typedef struct _SCP_SYNC_DATA_
 #define SCP_COMMAND_INVALID     0   /*!< Invalid command */
 #define SCP_COMMAND_CALLBACK    1   /*!< Command with callbacks */
 #define SCP_COMMAND_PADDING     2   /*!< Padding */
+
+#define SCP_COMMAND_STATE_PENDING	0	/*!< Waiting for its dependencies */
+#define SCP_COMMAND_STATE_ISSUED	1	/*!< Run, waiting to be completed */
+#define SCP_COMMAND_STATE_COMPLETE	2	/*!< Completed, space can be reclaimed */
+#define SCP_COMMAND_STATE_SUPERSEDED	3	/*!< Overtaken, to be dropped once its fences are met */
 typedef struct _SCP_COMMAND_
 {
 	IMG_UINT32				ui32CmdType;        /*!< Command type */
 	IMG_UINT32				ui32CmdSize;		/*!< Total size of the command (i.e. includes header) */
+	IMG_UINT32				ui32State;			/*!< Command state */
+	IMG_UINT32				ui32IssueSeq;		/*!< Order in which the command was issued */
 	IMG_UINT32				ui32SyncCount;      /*!< Total number of syncs in pasSync */
 	SCP_SYNC_DATA			*pasSCPSyncData;    /*!< Pointer to the array of sync data (allocated in the CCB) */
 #if defined(PVR_ANDROID_NATIVE_WINDOW_HAS_SYNC)
@@ -144,6 +154,7 @@ typedef struct _SCP_COMMAND_
 #endif /* defined(PVR_ANDROID_NATIVE_WINDOW_HAS_SYNC) */
 	SCPReady				pfnReady;           /*!< Pointer to the funtion to check if the command is ready */
 	SCPDo					pfnDo;           	/*!< Pointer to the funtion to call when the command is ready to go */
+	SCPDo					pfnDrop;			/*!< Pointer to the funtion to call if the command is superseded */
 	IMG_PVOID				pvReadyData;        /*!< Data to pass into pfnReady */
 	IMG_PVOID				pvCompleteData;     /*!< Data to pass into pfnComplete */
 } SCP_COMMAND;
@@ -253,6 +264,7 @@ PVRSRV_ERROR _SCPAlloc(SCP_CONTEXT *psContext,
 		psCommand = pvCommand;
 		psCommand->ui32CmdType = SCP_COMMAND_PADDING;
 		psCommand->ui32CmdSize = ui32Remain;
+		psCommand->ui32State = SCP_COMMAND_STATE_PENDING;
 
 		UPDATE_CCB_OFFSET(psContext->ui32WriteOffset, ui32Remain, psContext->ui32CCBSize);
 	}
@@ -286,18 +298,17 @@ IMG_VOID _SCPInsert(SCP_CONTEXT *psContext,
 					  psContext->ui32CCBSize);
 }
 /*************************************************************************/ /*!
-@Function       _SCPCommandReady
+@Function       _SCPCommandFencesMet
 
-@Description    Check if a command is ready. Checks to see if the command
-                has had it's fences meet and is ready to go.
+@Description    Check if the fences of a command have been met
 
 @Input          psCommand               Command to check
 
-@Return         PVRSRV_OK if the command is ready
+@Return         PVRSRV_OK if the command's fences have been met
 */
 /*****************************************************************************/
 static
-PVRSRV_ERROR _SCPCommandReady(SCP_COMMAND *psCommand)
+PVRSRV_ERROR _SCPCommandFencesMet(SCP_COMMAND *psCommand)
 {
 	IMG_UINT32 i;
 	
@@ -344,6 +355,32 @@ PVRSRV_ERROR _SCPCommandReady(SCP_COMMAND *psCommand)
 	}
 #endif /* defined(PVR_ANDROID_NATIVE_WINDOW_HAS_SYNC) */
 
+	return PVRSRV_OK;
+}
+
+/*************************************************************************/ /*!
+@Function       _SCPCommandReady
+
+@Description    Check if a command is ready. Checks to see if the command
+                has had it's fences meet and is ready to go.
+
+@Input          psCommand               Command to check
+
+@Return         PVRSRV_OK if the command is ready
+*/
+/*****************************************************************************/
+static
+PVRSRV_ERROR _SCPCommandReady(SCP_COMMAND *psCommand)
+{
+	PVRSRV_ERROR eError;
+
+	eError = _SCPCommandFencesMet(psCommand);
+	if ((eError != PVRSRV_OK) ||
+		(psCommand->ui32CmdType == SCP_COMMAND_PADDING))
+	{
+		return eError;
+	}
+
 	/* Command is ready */
 	if (psCommand->pfnReady(psCommand->pvReadyData))
 	{
@@ -376,6 +413,212 @@ IMG_VOID _SCPCommandDo(SCP_COMMAND *psCommand)
 	}
 }
 
+/*************************************************************************/ /*!
+@Function       _SCPCommandIsIndependent
+
+@Description    Check if a command can be issued ahead of the pending
+                commands queued before it. Syncs used by commands from the
+                same context don't carry a fence between them (see
+                PVRSRVServerSyncQueueSWOpKM) so any sync shared with an
+                earlier pending command forces the command to wait its turn.
+                Going ahead supersedes the earlier commands, so each of them
+                must also be able to be dropped.
+
+@Input          psContext               Context the command is on
+
+@Input          psCommand               Command to check
+
+@Input          ui32CmdOffset           Offset of the command in the CCB
+
+@Return         IMG_TRUE if the command shares no syncs with earlier
+                pending commands and they can all be dropped
+*/
+/*****************************************************************************/
+static
+IMG_BOOL _SCPCommandIsIndependent(SCP_CONTEXT *psContext,
+								  SCP_COMMAND *psCommand,
+								  IMG_UINT32 ui32CmdOffset)
+{
+	IMG_UINT32 ui32Offset = psContext->ui32DepOffset;
+
+	if (psCommand->ui32CmdType != SCP_COMMAND_CALLBACK)
+	{
+		return IMG_TRUE;
+	}
+
+	while (ui32Offset != ui32CmdOffset)
+	{
+		SCP_COMMAND *psEarlier;
+		IMG_UINT32 i, j;
+
+		psEarlier = (SCP_COMMAND *)((IMG_UINT8 *)psContext->pvCCB + ui32Offset);
+
+		if ((psEarlier->ui32CmdType == SCP_COMMAND_CALLBACK) &&
+			((psEarlier->ui32State == SCP_COMMAND_STATE_PENDING) ||
+			 (psEarlier->ui32State == SCP_COMMAND_STATE_SUPERSEDED)))
+		{
+			if ((psEarlier->ui32State == SCP_COMMAND_STATE_PENDING) &&
+				(psEarlier->pfnDrop == IMG_NULL))
+			{
+				return IMG_FALSE;
+			}
+
+			for (i = 0; i < psCommand->ui32SyncCount; i++)
+			{
+				for (j = 0; j < psEarlier->ui32SyncCount; j++)
+				{
+					if (psCommand->pasSCPSyncData[i].psSync ==
+						psEarlier->pasSCPSyncData[j].psSync)
+					{
+						return IMG_FALSE;
+					}
+				}
+			}
+		}
+
+		UPDATE_CCB_OFFSET(ui32Offset,
+						  psEarlier->ui32CmdSize,
+						  psContext->ui32CCBSize);
+	}
+
+	return IMG_TRUE;
+}
+
+/*************************************************************************/ /*!
+@Function       _SCPCommandSupersede
+
+@Description    Mark the pending commands queued before a command that is
+                being issued ahead of them as superseded
+
+@Input          psContext               Context the command is on
+
+@Input          ui32CmdOffset           Offset of the command in the CCB
+
+@Return         None
+*/
+/*****************************************************************************/
+static
+IMG_VOID _SCPCommandSupersede(SCP_CONTEXT *psContext,
+							  IMG_UINT32 ui32CmdOffset)
+{
+	IMG_UINT32 ui32Offset = psContext->ui32DepOffset;
+
+	while (ui32Offset != ui32CmdOffset)
+	{
+		SCP_COMMAND *psEarlier;
+
+		psEarlier = (SCP_COMMAND *)((IMG_UINT8 *)psContext->pvCCB + ui32Offset);
+
+		if ((psEarlier->ui32CmdType == SCP_COMMAND_CALLBACK) &&
+			(psEarlier->ui32State == SCP_COMMAND_STATE_PENDING))
+		{
+			SCP_DEBUG_PRINT("%s: Command %p superseded for ctx %p", 
+					__FUNCTION__, psEarlier, psContext);
+			psEarlier->ui32State = SCP_COMMAND_STATE_SUPERSEDED;
+		}
+
+		UPDATE_CCB_OFFSET(ui32Offset,
+						  psEarlier->ui32CmdSize,
+						  psContext->ui32CCBSize);
+	}
+}
+
+/*************************************************************************/ /*!
+@Function       _SCPCommandSyncComplete
+
+@Description    Complete the sync operations of a command
+
+@Input          psCommand               Command to complete
+
+@Return         None
+*/
+/*****************************************************************************/
+static
+IMG_VOID _SCPCommandSyncComplete(SCP_COMMAND *psCommand)
+{
+	IMG_UINT32 i;
+
+	/* Do any fence updates */
+	for (i=0;i<psCommand->ui32SyncCount;i++)
+	{
+		SCP_SYNC_DATA *psSCPSyncData = &psCommand->pasSCPSyncData[i];
+		IMG_BOOL bUpdate = (psSCPSyncData->ui32Flags & SCP_SYNC_DATA_UPDATE);
+
+		ServerSyncCompleteOp(psSCPSyncData->psSync, bUpdate, psSCPSyncData->ui32Update);
+
+		if (bUpdate)
+		{
+			psSCPSyncData->ui32Flags = 0; /* Stop future interaction with this sync prim. */
+			psSCPSyncData->psSync = NULL; /* Clear psSync as it is no longer referenced. */
+		}
+	}
+}
+
+/*************************************************************************/ /*!
+@Function       _SCPCommandDrop
+
+@Description    Drop a superseded command whose fences have been met. The
+                client releases the command's resources and the sync
+                updates are done as if the command had run and completed.
+
+@Input          psCommand               Command to drop
+
+@Return         None
+*/
+/*****************************************************************************/
+static
+IMG_VOID _SCPCommandDrop(SCP_COMMAND *psCommand)
+{
+	psCommand->pfnDrop(psCommand->pvReadyData, psCommand->pvCompleteData);
+	_SCPCommandSyncComplete(psCommand);
+	psCommand->ui32State = SCP_COMMAND_STATE_COMPLETE;
+}
+
+/*************************************************************************/ /*!
+@Function       _SCPCommandRetire
+
+@Description    Reclaim the CCB space of completed commands from the read
+                offset onwards. Release fences are signalled here, in CCB
+                order, as the timeline values were handed out in that order.
+
+@Input          psContext               Context to process
+
+@Return         None
+*/
+/*****************************************************************************/
+static
+IMG_VOID _SCPCommandRetire(SCP_CONTEXT *psContext)
+{
+	while (psContext->ui32ReadOffset != psContext->ui32WriteOffset)
+	{
+		SCP_COMMAND *psCommand;
+
+		psCommand = (SCP_COMMAND *) ((IMG_UINT8 *) psContext->pvCCB + 
+					psContext->ui32ReadOffset);
+
+		if (psCommand->ui32State != SCP_COMMAND_STATE_COMPLETE)
+		{
+			break;
+		}
+
+#if defined(PVR_ANDROID_NATIVE_WINDOW_HAS_SYNC)
+		if ((psCommand->ui32CmdType == SCP_COMMAND_CALLBACK) &&
+			psCommand->psReleaseFence)
+		{
+			sw_sync_timeline_inc(psContext->pvTimeline, 1);
+			/* Decrease the ref to this fence */
+			sync_fence_put(psCommand->psReleaseFence);
+			psCommand->psReleaseFence = IMG_NULL;
+		}
+#endif /* defined(PVR_ANDROID_NATIVE_WINDOW_HAS_SYNC) */
+
+		/* processed cmd so update queue */
+		UPDATE_CCB_OFFSET(psContext->ui32ReadOffset,
+						  psCommand->ui32CmdSize,
+						  psContext->ui32CCBSize);
+	}
+}
+
 #if defined(PVR_ANDROID_NATIVE_WINDOW_HAS_SYNC)
 static void _SCPDumpFence(const char *psczName, struct sync_fence *psFence)
 {
@@ -545,6 +788,18 @@ ErrorExit:
 	return eError;
 }
 
+/*
+	SCPSetOutOfOrder
+*/
+IMG_EXPORT
+IMG_VOID IMG_CALLCONV SCPSetOutOfOrder(SCP_CONTEXT *psContext,
+									   IMG_BOOL bOutOfOrder)
+{
+	OSLockAcquire(psContext->hLock);
+	psContext->bOutOfOrder = bOutOfOrder;
+	OSLockRelease(psContext->hLock);
+}
+
 /*
 	SCPAllocCommand
 */
@@ -556,6 +811,7 @@ PVRSRV_ERROR IMG_CALLCONV SCPAllocCommand(SCP_CONTEXT *psContext,
 										  IMG_INT32 i32AcquireFenceFd,
 										  SCPReady pfnCommandReady,
 										  SCPDo pfnCommandDo,
+										  SCPDo pfnCommandDrop,
 										  IMG_SIZE_T ui32ReadyDataByteSize,
 										  IMG_SIZE_T ui32CompleteDataByteSize,
 										  IMG_PVOID *ppvReadyData,
@@ -610,6 +866,7 @@ PVRSRV_ERROR IMG_CALLCONV SCPAllocCommand(SCP_CONTEXT *psContext,
 	/* setup the command */
 	psCommand->ui32CmdSize = ui32CommandSize;
 	psCommand->ui32CmdType = SCP_COMMAND_CALLBACK;
+	psCommand->ui32State = SCP_COMMAND_STATE_PENDING;
 	psCommand->ui32SyncCount = ui32SyncPrimCount;
 
 	/* Set up command pointers */
@@ -617,6 +874,7 @@ PVRSRV_ERROR IMG_CALLCONV SCPAllocCommand(SCP_CONTEXT *psContext,
 
 	psCommand->pfnReady = pfnCommandReady;
 	psCommand->pfnDo = pfnCommandDo;
+	psCommand->pfnDrop = pfnCommandDrop;
 
 	psCommand->pvReadyData = ((IMG_CHAR *) psCommand) +
 							 sizeof(SCP_COMMAND) + ui32SyncOpSize;
@@ -712,6 +970,9 @@ IMG_EXPORT
 PVRSRV_ERROR SCPRun(SCP_CONTEXT *psContext)
 {
 	SCP_COMMAND *psCommand;
+	IMG_UINT32 ui32Offset;
+	IMG_BOOL bBlocked = IMG_FALSE;
+	IMG_BOOL bDropped = IMG_FALSE;
 
 	if (psContext == IMG_NULL)
 	{
@@ -719,37 +980,111 @@ PVRSRV_ERROR SCPRun(SCP_CONTEXT *psContext)
 	}
 
 	OSLockAcquire(psContext->hLock);
-	while (psContext->ui32DepOffset != psContext->ui32WriteOffset)
+	ui32Offset = psContext->ui32DepOffset;
+	while (ui32Offset != psContext->ui32WriteOffset)
 	{
-		PVRSRV_ERROR eError;
+		PVRSRV_ERROR eError = PVRSRV_OK;
 
 		psCommand = (SCP_COMMAND *)((IMG_UINT8 *)psContext->pvCCB +
-		            psContext->ui32DepOffset);
+		            ui32Offset);
 
-		/* See if the command is ready to go */
-		eError = _SCPCommandReady(psCommand);
+		if (psCommand->ui32State == SCP_COMMAND_STATE_PENDING)
+		{
+			/*
+				Once a command is blocked later ones may only go ahead of
+				it if they don't depend on anything still pending
+			*/
+			if (bBlocked && !_SCPCommandIsIndependent(psContext, psCommand, ui32Offset))
+			{
+				eError = PVRSRV_ERROR_FAILED_DEPENDENCIES;
+			}
+			else
+			{
+				/* See if the command is ready to go */
+				eError = _SCPCommandReady(psCommand);
+			}
 
-		SCP_DEBUG_PRINT("%s: Processes command %p for ctx %p (%d)", 
-				__FUNCTION__, psCommand, psContext, eError);
+			SCP_DEBUG_PRINT("%s: Processes command %p for ctx %p (%d)", 
+					__FUNCTION__, psCommand, psContext, eError);
 
-		if (eError == PVRSRV_OK)
+			if (eError == PVRSRV_OK)
+			{
+				if (psCommand->ui32CmdType == SCP_COMMAND_CALLBACK)
+				{
+					if (bBlocked)
+					{
+						_SCPCommandSupersede(psContext, ui32Offset);
+					}
+					psCommand->ui32State = SCP_COMMAND_STATE_ISSUED;
+					psCommand->ui32IssueSeq = psContext->ui32IssueSeq++;
+				}
+				else
+				{
+					/* Nothing to do for padding */
+					psCommand->ui32State = SCP_COMMAND_STATE_COMPLETE;
+				}
+
+				/* Run the command */
+				_SCPCommandDo(psCommand);
+			}
+			else if (!psContext->bOutOfOrder ||
+					 (eError == PVRSRV_ERROR_NOT_READY))
+			{
+				/*
+					As soon as we hit a command that can't run break out.
+					If the client isn't ready it won't take any other
+					command either.
+				*/
+				break;
+			}
+			else
+			{
+				bBlocked = IMG_TRUE;
+			}
+		}
+		else if (psCommand->ui32State == SCP_COMMAND_STATE_SUPERSEDED)
 		{
-			/* processed cmd so update queue */
-			UPDATE_CCB_OFFSET(psContext->ui32DepOffset,
-							  psCommand->ui32CmdSize,
-							  psContext->ui32CCBSize);
+			/*
+				A later command has already been issued in place of this
+				one so it's dropped rather than run, but only once its
+				fences are met so the sync updates still happen in order
+			*/
+			if (_SCPCommandFencesMet(psCommand) == PVRSRV_OK)
+			{
+				SCP_DEBUG_PRINT("%s: Drop command %p for ctx %p", 
+						__FUNCTION__, psCommand, psContext);
+				_SCPCommandDrop(psCommand);
+				bDropped = IMG_TRUE;
+			}
+			else
+			{
+				bBlocked = IMG_TRUE;
+			}
 		}
-		else
+
+		UPDATE_CCB_OFFSET(ui32Offset,
+						  psCommand->ui32CmdSize,
+						  psContext->ui32CCBSize);
+
+		/* The dependency offset tracks the oldest pending command */
+		if (!bBlocked)
 		{
-			/* As soon as we hit a command that can't run break out */
-			break;
+			psContext->ui32DepOffset = ui32Offset;
 		}
+	}
 
-		/* Run the command */
-		_SCPCommandDo(psCommand);
+	if (bDropped)
+	{
+		_SCPCommandRetire(psContext);
 	}
 	OSLockRelease(psContext->hLock);
 
+	if (bDropped)
+	{
+		/* Notify devices in case the sync updates have unblocked them */
+		PVRSRVCheckStatus(IMG_NULL);
+	}
+
 	return PVRSRV_OK;
 }
 
@@ -771,64 +1106,50 @@ IMG_EXPORT
 IMG_VOID SCPCommandComplete(SCP_CONTEXT *psContext)
 {
 	SCP_COMMAND *psCommand;
-	IMG_UINT32 i;
-	IMG_BOOL bContinue = IMG_TRUE;
+	IMG_UINT32 ui32Offset;
 
 	if (psContext == IMG_NULL)
 	{
 		return;
 	}
 
-	if (psContext->ui32ReadOffset == psContext->ui32DepOffset)
+	if (psContext->ui32CompleteSeq == psContext->ui32IssueSeq)
 	{
 		PVR_DPF((PVR_DBG_ERROR, "SCPCommandComplete: Called with no work to do!"));
 		return;
 	}	
 
-	while(bContinue)
+	/*
+		Commands complete in the order they were issued which, when
+		commands are allowed to overtake each other, needn't be CCB order
+	*/
+	ui32Offset = psContext->ui32ReadOffset;
+	while (ui32Offset != psContext->ui32WriteOffset)
 	{
 		psCommand = (SCP_COMMAND *) ((IMG_UINT8 *) psContext->pvCCB + 
-					psContext->ui32ReadOffset);
+					ui32Offset);
 
-		if (psCommand->ui32CmdType == SCP_COMMAND_CALLBACK)
+		if ((psCommand->ui32State == SCP_COMMAND_STATE_ISSUED) &&
+			(psCommand->ui32IssueSeq == psContext->ui32CompleteSeq))
 		{
-			/* Do any fence updates */
-			for (i=0;i<psCommand->ui32SyncCount;i++)
-			{
-				SCP_SYNC_DATA *psSCPSyncData = &psCommand->pasSCPSyncData[i];
-				IMG_BOOL bUpdate = (psSCPSyncData->ui32Flags & SCP_SYNC_DATA_UPDATE);
-	
-				ServerSyncCompleteOp(psSCPSyncData->psSync, bUpdate, psSCPSyncData->ui32Update);
-
-				if (bUpdate)
-				{
-					psSCPSyncData->ui32Flags = 0; /* Stop future interaction with this sync prim. */
-					psSCPSyncData->psSync = NULL; /* Clear psSync as it is no longer referenced. */
-				}
-			}
+			_SCPCommandSyncComplete(psCommand);
 
-#if defined(PVR_ANDROID_NATIVE_WINDOW_HAS_SYNC)
-			if (psCommand->psReleaseFence)
-			{
-				sw_sync_timeline_inc(psContext->pvTimeline, 1);
-				/* Decrease the ref to this fence */
-				sync_fence_put(psCommand->psReleaseFence);
-				psCommand->psReleaseFence = IMG_NULL;
-			}
-#endif /* defined(PVR_ANDROID_NATIVE_WINDOW_HAS_SYNC) */
+			psCommand->ui32State = SCP_COMMAND_STATE_COMPLETE;
+			psContext->ui32CompleteSeq++;
 
-			bContinue = IMG_FALSE;
+			SCP_DEBUG_PRINT("%s: Complete command %p for ctx %p", 
+					__FUNCTION__, psCommand, psContext);
+			break;
 		}
 
-		/* processed cmd so update queue */
-		UPDATE_CCB_OFFSET(psContext->ui32ReadOffset,
+		UPDATE_CCB_OFFSET(ui32Offset,
 						  psCommand->ui32CmdSize,
 						  psContext->ui32CCBSize);
+	}
 
-		SCP_DEBUG_PRINT("%s: Complete command %p for ctx %p (continue: %d)", 
-				__FUNCTION__, psCommand, psContext, bContinue);
+	PVR_ASSERT(ui32Offset != psContext->ui32WriteOffset);
 
-	}
+	_SCPCommandRetire(psContext);
 }
 
 IMG_EXPORT
@@ -844,7 +1165,7 @@ IMG_VOID IMG_CALLCONV SCPDumpStatus(SCP_CONTEXT *psContext)
 	OSLockAcquire(psContext->hLock);
 
 	PVR_LOG(("Pending command:"));
-	if (psContext->ui32DepOffset == psContext->ui32ReadOffset)
+	if (psContext->ui32DepOffset == psContext->ui32WriteOffset)
 	{
 		PVR_LOG(("\tNone"));
 	}
@@ -859,7 +1180,7 @@ IMG_VOID IMG_CALLCONV SCPDumpStatus(SCP_CONTEXT *psContext)
 	}
 	
 	PVR_LOG(("Active command(s):"));
-	if (psContext->ui32DepOffset == psContext->ui32ReadOffset)
+	if (psContext->ui32CompleteSeq == psContext->ui32IssueSeq)
 	{
 		PVR_LOG(("\tNone"));
 	}
@@ -868,12 +1189,15 @@ IMG_VOID IMG_CALLCONV SCPDumpStatus(SCP_CONTEXT *psContext)
 		SCP_COMMAND *psCommand;
 		IMG_UINT32 ui32ReadOffset = psContext->ui32ReadOffset;
 		
-		while (ui32ReadOffset != psContext->ui32DepOffset)
+		while (ui32ReadOffset != psContext->ui32WriteOffset)
 		{
 			psCommand = (SCP_COMMAND *)((IMG_UINT8 *)psContext->pvCCB +
 			            ui32ReadOffset);
 
-			_SCPDumpCommand(psCommand);
+			if (psCommand->ui32State == SCP_COMMAND_STATE_ISSUED)
+			{
+				_SCPDumpCommand(psCommand);
+			}
 
 			/* processed cmd so update queue */
 			UPDATE_CCB_OFFSET(ui32ReadOffset,
@@ -0,0 +1,190 @@
+/*************************************************************************/ /*!
+@File
+@Title          RGX active power management policy
+@Copyright      Copyright (c) Imagination Technologies Ltd. All Rights Reserved
+@Description    Decides from the history of idle intervals whether powering
+                down an idle GPU pays off. Only depends on img_types.h, so
+                recorded kick timestamps can be replayed through it
+                off-target.
+@License        Dual MIT/GPLv2
+
+The contents of this file are subject to the MIT license as set out below.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+Alternatively, the contents of this file may be used under the terms of
+the GNU General Public License Version 2 ("GPL") in which case the provisions
+of GPL are applicable instead of those above.
+
+If you wish to allow use of your version of this file only under the terms of
+GPL, and not to allow others to use your version of this file under the terms
+of the MIT license, indicate your decision by deleting the provisions above
+and replace them with the notice and other provisions required by GPL as set
+out in the file called "GPL-COPYING" included in this distribution. If you do
+not delete the provisions above, a recipient may use your version of this file
+under the terms of either the MIT license or GPL.
+
+This License is also included in this distribution in the file called
+"MIT-COPYING".
+
+EXCEPT AS OTHERWISE STATED IN A NEGOTIATED AGREEMENT: (A) THE SOFTWARE IS
+PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT; AND (B) IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/ /**************************************************************************/
+
+#include "rgxapmpolicy.h"
+
+static IMG_UINT32 _ElapsedUs(IMG_UINT64 ui64StartUs, IMG_UINT64 ui64NowUs)
+{
+	IMG_UINT64 ui64DeltaUs = (ui64NowUs > ui64StartUs) ? (ui64NowUs - ui64StartUs) : 0;
+
+	return (ui64DeltaUs > RGX_APM_MAX_INTERVAL_US) ? RGX_APM_MAX_INTERVAL_US : (IMG_UINT32)ui64DeltaUs;
+}
+
+static IMG_UINT32 _PredictIdleUs(RGX_APM_POLICY *psPolicy)
+{
+	IMG_UINT32 ui32Sum = 0;
+	IMG_UINT32 i;
+
+	for (i = 0; i < psPolicy->ui32IdleCount; i++)
+	{
+		ui32Sum += psPolicy->aui32IdleUs[i];
+	}
+
+	return ui32Sum / psPolicy->ui32IdleCount;
+}
+
+static IMG_UINT32 _BreakEvenUs(RGX_APM_POLICY *psPolicy)
+{
+	/* A power-down has to cover at least the power-up it causes and the
+	   power-down handshake, which takes about as long */
+	IMG_UINT32 ui32MeasuredUs = 2 * psPolicy->ui32PowerUpAvgUs;
+
+	return (ui32MeasuredUs > psPolicy->ui32BreakEvenUs) ? ui32MeasuredUs : psPolicy->ui32BreakEvenUs;
+}
+
+IMG_VOID RGXAPMPolicyInit(RGX_APM_POLICY		*psPolicy,
+						  RGX_APM_POLICY_TYPE	eType,
+						  IMG_UINT32			ui32BreakEvenUs,
+						  IMG_UINT32			ui32HysteresisUs)
+{
+	RGX_APM_POLICY sInit = { 0 };
+
+	*psPolicy = sInit;
+	psPolicy->eType = eType;
+	psPolicy->ui32BreakEvenUs = ui32BreakEvenUs;
+	psPolicy->ui32HysteresisUs = ui32HysteresisUs;
+}
+
+IMG_BOOL RGXAPMPolicyShouldPowerDown(RGX_APM_POLICY	*psPolicy,
+									 IMG_UINT64		ui64NowUs,
+									 IMG_UINT32		*pui32RecheckUs)
+{
+	IMG_UINT32 ui32ElapsedUs;
+	IMG_UINT32 ui32PredictedUs;
+
+	if (!psPolicy->bIdle)
+	{
+		psPolicy->bIdle = IMG_TRUE;
+		psPolicy->ui64IdleStartUs = ui64NowUs;
+	}
+
+	*pui32RecheckUs = 0;
+
+	/* Without history there is nothing to predict from */
+	if ((psPolicy->eType == RGX_APM_POLICY_IMMEDIATE) || (psPolicy->ui32IdleCount == 0))
+	{
+		return IMG_TRUE;
+	}
+
+	ui32ElapsedUs = _ElapsedUs(psPolicy->ui64IdleStartUs, ui64NowUs);
+	ui32PredictedUs = _PredictIdleUs(psPolicy);
+
+	/* The rest of the predicted idle time pays for the power cycle */
+	if (ui32PredictedUs >= ui32ElapsedUs + _BreakEvenUs(psPolicy))
+	{
+		return IMG_TRUE;
+	}
+
+	/* Idle for longer than predicted: the prediction was wrong */
+	if (ui32ElapsedUs >= ui32PredictedUs + psPolicy->ui32HysteresisUs)
+	{
+		return IMG_TRUE;
+	}
+
+	psPolicy->ui32Deferred++;
+	*pui32RecheckUs = ui32PredictedUs + psPolicy->ui32HysteresisUs - ui32ElapsedUs;
+
+	return IMG_FALSE;
+}
+
+IMG_VOID RGXAPMPolicyPoweredDown(RGX_APM_POLICY *psPolicy, IMG_UINT64 ui64NowUs)
+{
+	psPolicy->bPoweredDown = IMG_TRUE;
+	psPolicy->ui64PowerDownUs = ui64NowUs;
+	psPolicy->ui32PowerDowns++;
+}
+
+IMG_VOID RGXAPMPolicyKick(RGX_APM_POLICY	*psPolicy,
+						  IMG_UINT64		ui64NowUs,
+						  IMG_BOOL			bPoweredUp,
+						  IMG_UINT32		ui32PowerUpUs)
+{
+	if (bPoweredUp)
+	{
+		psPolicy->ui32WakeKicks++;
+		psPolicy->ui64WakeLatencyUs += ui32PowerUpUs;
+		if (ui32PowerUpUs > psPolicy->ui32WakeLatencyMaxUs)
+		{
+			psPolicy->ui32WakeLatencyMaxUs = ui32PowerUpUs;
+		}
+
+		/* 1/4 weight for the new sample */
+		if (psPolicy->ui32PowerUpAvgUs == 0)
+		{
+			psPolicy->ui32PowerUpAvgUs = ui32PowerUpUs;
+		}
+		else
+		{
+			psPolicy->ui32PowerUpAvgUs = (3 * psPolicy->ui32PowerUpAvgUs + ui32PowerUpUs) / 4;
+		}
+	}
+
+	if (!psPolicy->bIdle)
+	{
+		return;
+	}
+
+	if (psPolicy->bPoweredDown)
+	{
+		IMG_UINT32 ui32OffUs = _ElapsedUs(psPolicy->ui64PowerDownUs, ui64NowUs);
+
+		psPolicy->ui64OffResidencyUs += ui32OffUs;
+		if (ui32OffUs < _BreakEvenUs(psPolicy))
+		{
+			psPolicy->ui32ShortPowerDowns++;
+		}
+	}
+
+	psPolicy->aui32IdleUs[psPolicy->ui32IdleNext] = _ElapsedUs(psPolicy->ui64IdleStartUs, ui64NowUs);
+	psPolicy->ui32IdleNext = (psPolicy->ui32IdleNext + 1) % RGX_APM_HISTORY_SIZE;
+	if (psPolicy->ui32IdleCount < RGX_APM_HISTORY_SIZE)
+	{
+		psPolicy->ui32IdleCount++;
+	}
+
+	psPolicy->bIdle = IMG_FALSE;
+	psPolicy->bPoweredDown = IMG_FALSE;
+}
@@ -0,0 +1,156 @@
+/*************************************************************************/ /*!
+@File
+@Title          RGX active power management policy
+@Copyright      Copyright (c) Imagination Technologies Ltd. All Rights Reserved
+@Description    Header for the RGX active power management policy
+@License        Dual MIT/GPLv2
+
+The contents of this file are subject to the MIT license as set out below.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+Alternatively, the contents of this file may be used under the terms of
+the GNU General Public License Version 2 ("GPL") in which case the provisions
+of GPL are applicable instead of those above.
+
+If you wish to allow use of your version of this file only under the terms of
+GPL, and not to allow others to use your version of this file under the terms
+of the MIT license, indicate your decision by deleting the provisions above
+and replace them with the notice and other provisions required by GPL as set
+out in the file called "GPL-COPYING" included in this distribution. If you do
+not delete the provisions above, a recipient may use your version of this file
+under the terms of either the MIT license or GPL.
+
+This License is also included in this distribution in the file called
+"MIT-COPYING".
+
+EXCEPT AS OTHERWISE STATED IN A NEGOTIATED AGREEMENT: (A) THE SOFTWARE IS
+PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT; AND (B) IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/ /**************************************************************************/
+
+#if !defined(__RGXAPMPOLICY_H__)
+#define __RGXAPMPOLICY_H__
+
+#include "img_types.h"
+
+/* Number of idle intervals the prediction is based on */
+#define RGX_APM_HISTORY_SIZE			8
+
+/* Idle time a power-down has to last before it saves more than the
+   power-up costs, used until power-ups have been measured */
+#define RGX_APM_BREAK_EVEN_US_DEFAULT	2000
+
+/* How far the idle time may overrun the prediction before the
+   prediction is considered wrong and the GPU is powered down */
+#define RGX_APM_HYSTERESIS_US_DEFAULT	1000
+
+/* Intervals longer than this are recorded as this */
+#define RGX_APM_MAX_INTERVAL_US			1000000
+
+typedef enum _RGX_APM_POLICY_TYPE_
+{
+	RGX_APM_POLICY_IMMEDIATE = 0,	/*!< Power down as soon as the firmware is idle */
+	RGX_APM_POLICY_PREDICTIVE		/*!< Power down when the predicted idle time pays off */
+} RGX_APM_POLICY_TYPE;
+
+typedef struct _RGX_APM_POLICY_
+{
+	RGX_APM_POLICY_TYPE	eType;
+	IMG_UINT32			ui32BreakEvenUs;	/*!< Minimum break-even idle time */
+	IMG_UINT32			ui32HysteresisUs;	/*!< Allowed overrun of the prediction */
+
+	IMG_UINT32			aui32IdleUs[RGX_APM_HISTORY_SIZE];	/*!< Most recent idle intervals */
+	IMG_UINT32			ui32IdleCount;		/*!< Valid entries in aui32IdleUs */
+	IMG_UINT32			ui32IdleNext;		/*!< Next entry of aui32IdleUs to replace */
+	IMG_UINT32			ui32PowerUpAvgUs;	/*!< Moving average of the power-up latency */
+
+	IMG_BOOL			bIdle;				/*!< Firmware reported idle since the last kick */
+	IMG_UINT64			ui64IdleStartUs;	/*!< When the idle interval started */
+	IMG_BOOL			bPoweredDown;		/*!< GPU powered down during this idle interval */
+	IMG_UINT64			ui64PowerDownUs;	/*!< When the GPU was powered down */
+
+	/* Statistics */
+	IMG_UINT64			ui64OffResidencyUs;	/*!< Time spent powered down by the policy */
+	IMG_UINT32			ui32PowerDowns;		/*!< Power transitions made by the policy */
+	IMG_UINT32			ui32Deferred;		/*!< Idle reports on which power-down was deferred */
+	IMG_UINT32			ui32ShortPowerDowns;/*!< Power-downs ended before the break-even time */
+	IMG_UINT32			ui32WakeKicks;		/*!< Kicks which had to power the GPU up */
+	IMG_UINT64			ui64WakeLatencyUs;	/*!< Latency added to those kicks */
+	IMG_UINT32			ui32WakeLatencyMaxUs;
+} RGX_APM_POLICY;
+
+/*!
+*******************************************************************************
+ @Function	RGXAPMPolicyInit
+
+ @Description Reset a policy and its statistics
+
+ @Input psPolicy - policy
+ @Input eType - decision rule to apply
+ @Input ui32BreakEvenUs - minimum break-even idle time
+ @Input ui32HysteresisUs - allowed overrun of the prediction
+******************************************************************************/
+IMG_VOID RGXAPMPolicyInit(RGX_APM_POLICY		*psPolicy,
+						  RGX_APM_POLICY_TYPE	eType,
+						  IMG_UINT32			ui32BreakEvenUs,
+						  IMG_UINT32			ui32HysteresisUs);
+
+/*!
+*******************************************************************************
+ @Function	RGXAPMPolicyShouldPowerDown
+
+ @Description Called while the firmware reports idle. The first call after a
+              kick starts the idle interval.
+
+ @Input psPolicy - policy
+ @Input ui64NowUs - current time
+ @Output pui32RecheckUs - when IMG_FALSE is returned, time after which the
+                          decision should be taken again
+
+ @Return   IMG_BOOL - IMG_TRUE to power the GPU down now
+******************************************************************************/
+IMG_BOOL RGXAPMPolicyShouldPowerDown(RGX_APM_POLICY	*psPolicy,
+									 IMG_UINT64		ui64NowUs,
+									 IMG_UINT32		*pui32RecheckUs);
+
+/*!
+*******************************************************************************
+ @Function	RGXAPMPolicyPoweredDown
+
+ @Description Record that the GPU was powered down on the policy's advice
+
+ @Input psPolicy - policy
+ @Input ui64NowUs - current time
+******************************************************************************/
+IMG_VOID RGXAPMPolicyPoweredDown(RGX_APM_POLICY *psPolicy, IMG_UINT64 ui64NowUs);
+
+/*!
+*******************************************************************************
+ @Function	RGXAPMPolicyKick
+
+ @Description Record that work was submitted, ending any idle interval
+
+ @Input psPolicy - policy
+ @Input ui64NowUs - current time
+ @Input bPoweredUp - the kick had to power the GPU up
+ @Input ui32PowerUpUs - time the power-up added to the kick
+******************************************************************************/
+IMG_VOID RGXAPMPolicyKick(RGX_APM_POLICY	*psPolicy,
+						  IMG_UINT64		ui64NowUs,
+						  IMG_BOOL			bPoweredUp,
+						  IMG_UINT32		ui32PowerUpUs);
+
+#endif /* __RGXAPMPOLICY_H__ */
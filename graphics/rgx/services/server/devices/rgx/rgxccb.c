@@ -488,6 +488,9 @@ IMG_INTERNAL IMG_VOID RGXReleaseCCB(RGX_CLIENT_CCB *psClientCCB,
 					  ui32CmdSize,
 					  psClientCCB->ui32Size);
 
+	/* The context now has work outstanding, let the MISR track its progress */
+	FWCommonContextMarkActive(psClientCCB->psServerCommonContext);
+
 	/*
 		PDumpSetFrame will detect as we Transition out of capture range for
 		frame based data but if we are PDumping continuous data then we
@@ -522,6 +525,11 @@ IMG_UINT32 RGXGetHostWriteOffsetCCB(RGX_CLIENT_CCB *psClientCCB)
 	return psClientCCB->ui32HostWriteOffset;
 }
 
+IMG_UINT32 RGXGetReadOffsetCCB(RGX_CLIENT_CCB *psClientCCB)
+{
+	return psClientCCB->psClientCCBCtrl->ui32ReadOffset;
+}
+
 #define SUPPORT_DUMP_CLIENT_CCB_COMMANDS_DBG_LEVEL PVR_DBG_ERROR
 #define CHECK_COMMAND(cmd, fenceupdate) \
 				case RGXFWIF_CCB_CMD_TYPE_##cmd: \
@@ -120,6 +120,8 @@ IMG_INTERNAL IMG_VOID RGXReleaseCCB(RGX_CLIENT_CCB *psClientCCB,
 
 IMG_UINT32 RGXGetHostWriteOffsetCCB(RGX_CLIENT_CCB *psClientCCB);
 
+IMG_UINT32 RGXGetReadOffsetCCB(RGX_CLIENT_CCB *psClientCCB);
+
 PVRSRV_ERROR RGXCmdHelperInitCmdCCB(RGX_CLIENT_CCB 			*psClientCCB,
 								    IMG_UINT32				ui32ClientFenceCount,
 								    PRGXFWIF_UFO_ADDR		*pauiFenceUFOAddress,
@@ -58,6 +58,13 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "sync_internal.h"
 #include "rgx_memallocflags.h"
 
+#define RGX_CDM_SYNC_BINDING_MASK	((1U << RGX_CDM_MAX_SYNC_BINDINGS) - 1)
+
+typedef struct {
+	SERVER_SYNC_PRIMITIVE		*psServerSync;
+	IMG_UINT32					ui32Flags;
+} RGX_SERVER_COMPUTE_SYNC_BINDING;
+
 struct _RGX_SERVER_COMPUTE_CONTEXT_ {
 	PVRSRV_DEVICE_NODE			*psDeviceNode;
 	RGX_SERVER_COMMON_CONTEXT	*psServerCommonContext;
@@ -65,8 +72,29 @@ struct _RGX_SERVER_COMPUTE_CONTEXT_ {
 	DEVMEM_MEMDESC				*psFWComputeContextStateMemDesc;
 	PVRSRV_CLIENT_SYNC_PRIM		*psSync;
 	DLLIST_NODE					sListNode;
+	/* Persistent server sync bindings, see PVRSRVRGXBindComputeSyncsKM */
+	RGX_SERVER_COMPUTE_SYNC_BINDING	asSyncBinding[RGX_CDM_MAX_SYNC_BINDINGS];
+	IMG_UINT32					ui32BoundSyncMask;
 };
 
+static IMG_VOID _UnbindComputeSyncs(RGX_SERVER_COMPUTE_CONTEXT *psComputeContext,
+									IMG_UINT32 ui32SlotMask)
+{
+	IMG_UINT32 ui32Slot;
+
+	ui32SlotMask &= psComputeContext->ui32BoundSyncMask;
+
+	for (ui32Slot = 0; ui32SlotMask != 0; ui32Slot++, ui32SlotMask >>= 1)
+	{
+		if (ui32SlotMask & 1)
+		{
+			ServerSyncUnref(psComputeContext->asSyncBinding[ui32Slot].psServerSync);
+			psComputeContext->asSyncBinding[ui32Slot].psServerSync = IMG_NULL;
+			psComputeContext->ui32BoundSyncMask &= ~(1U << ui32Slot);
+		}
+	}
+}
+
 IMG_EXPORT
 PVRSRV_ERROR PVRSRVRGXCreateComputeContextKM(CONNECTION_DATA			*psConnection,
 											 PVRSRV_DEVICE_NODE			*psDeviceNode,
@@ -212,6 +240,7 @@ PVRSRV_ERROR PVRSRVRGXDestroyComputeContextKM(RGX_SERVER_COMPUTE_CONTEXT *psComp
 
 	dllist_remove_node(&(psComputeContext->sListNode));
 
+	_UnbindComputeSyncs(psComputeContext, psComputeContext->ui32BoundSyncMask);
 	FWCommonContextFree(psComputeContext->psServerCommonContext);
 	DevmemFwFree(psComputeContext->psFWFrameworkMemDesc);
 	DevmemFwFree(psComputeContext->psFWComputeContextStateMemDesc);
@@ -222,28 +251,11 @@ PVRSRV_ERROR PVRSRVRGXDestroyComputeContextKM(RGX_SERVER_COMPUTE_CONTEXT *psComp
 }
 
 
-IMG_EXPORT
-PVRSRV_ERROR PVRSRVRGXKickCDMKM(RGX_SERVER_COMPUTE_CONTEXT	*psComputeContext,
-								IMG_UINT32					ui32ClientFenceCount,
-								PRGXFWIF_UFO_ADDR			*pauiClientFenceUFOAddress,
-								IMG_UINT32					*paui32ClientFenceValue,
-								IMG_UINT32					ui32ClientUpdateCount,
-								PRGXFWIF_UFO_ADDR			*pauiClientUpdateUFOAddress,
-								IMG_UINT32					*paui32ClientUpdateValue,
-								IMG_UINT32					ui32ServerSyncPrims,
-								IMG_UINT32					*paui32ServerSyncFlags,
-								SERVER_SYNC_PRIMITIVE 		**pasServerSyncs,
-								IMG_UINT32					ui32CmdSize,
-								IMG_PBYTE					pui8DMCmd,
-								IMG_BOOL					bPDumpContinuous)
+static PVRSRV_ERROR _CheckServerSyncFlags(IMG_UINT32 ui32ServerSyncPrims,
+										   IMG_UINT32 *paui32ServerSyncFlags)
 {
-	RGXFWIF_KCCB_CMD		sCmpKCCBCmd;
-	RGX_CCB_CMD_HELPER_DATA	sCmdHelperData;
-	IMG_BOOL				bKickRequired;
-	PVRSRV_ERROR			eError;
-	PVRSRV_ERROR			eError2;
-	IMG_UINT32				i;
-	
+	IMG_UINT32 i;
+
 	/* Sanity check the server fences */
 	for (i=0;i<ui32ServerSyncPrims;i++)
 	{
@@ -253,6 +265,28 @@ PVRSRV_ERROR PVRSRVRGXKickCDMKM(RGX_SERVER_COMPUTE_CONTEXT	*psComputeContext,
 			return PVRSRV_ERROR_INVALID_SYNC_PRIM_OP;
 		}
 	}
+	return PVRSRV_OK;
+}
+
+static PVRSRV_ERROR _KickCDM(RGX_SERVER_COMPUTE_CONTEXT	*psComputeContext,
+							 IMG_UINT32					ui32ClientFenceCount,
+							 PRGXFWIF_UFO_ADDR			*pauiClientFenceUFOAddress,
+							 IMG_UINT32					*paui32ClientFenceValue,
+							 IMG_UINT32					ui32ClientUpdateCount,
+							 PRGXFWIF_UFO_ADDR			*pauiClientUpdateUFOAddress,
+							 IMG_UINT32					*paui32ClientUpdateValue,
+							 IMG_UINT32					ui32ServerSyncPrims,
+							 IMG_UINT32					*paui32ServerSyncFlags,
+							 SERVER_SYNC_PRIMITIVE 		**pasServerSyncs,
+							 IMG_UINT32					ui32CmdSize,
+							 IMG_PBYTE					pui8DMCmd,
+							 IMG_BOOL					bPDumpContinuous)
+{
+	RGXFWIF_KCCB_CMD		sCmpKCCBCmd;
+	RGX_CCB_CMD_HELPER_DATA	sCmdHelperData;
+	IMG_BOOL				bKickRequired;
+	PVRSRV_ERROR			eError;
+	PVRSRV_ERROR			eError2;
 
 	eError = RGXCmdHelperInitCmdCCB(FWCommonContextGetClientCCB(psComputeContext->psServerCommonContext),
 									  ui32ClientFenceCount,
@@ -319,11 +353,12 @@ PVRSRV_ERROR PVRSRVRGXKickCDMKM(RGX_SERVER_COMPUTE_CONTEXT	*psComputeContext,
 	 */
 	LOOP_UNTIL_TIMEOUT(MAX_HW_TIME_US)
 	{
-		eError2 = RGXScheduleCommand(psComputeContext->psDeviceNode->pvDevice,
-									RGXFWIF_DM_CDM,
-									&sCmpKCCBCmd,
-									sizeof(sCmpKCCBCmd),
-									bPDumpContinuous);
+		eError2 = RGXScheduleCommandPriority(psComputeContext->psDeviceNode->pvDevice,
+											RGXFWIF_DM_CDM,
+											&sCmpKCCBCmd,
+											sizeof(sCmpKCCBCmd),
+											bPDumpContinuous,
+											FWCommonContextGetPriority(psComputeContext->psServerCommonContext));
 		if (eError2 != PVRSRV_ERROR_RETRY)
 		{
 			break;
@@ -352,6 +387,144 @@ fail_cmdinit:
 	return eError;
 }
 
+IMG_EXPORT
+PVRSRV_ERROR PVRSRVRGXKickCDMKM(RGX_SERVER_COMPUTE_CONTEXT	*psComputeContext,
+								IMG_UINT32					ui32ClientFenceCount,
+								PRGXFWIF_UFO_ADDR			*pauiClientFenceUFOAddress,
+								IMG_UINT32					*paui32ClientFenceValue,
+								IMG_UINT32					ui32ClientUpdateCount,
+								PRGXFWIF_UFO_ADDR			*pauiClientUpdateUFOAddress,
+								IMG_UINT32					*paui32ClientUpdateValue,
+								IMG_UINT32					ui32ServerSyncPrims,
+								IMG_UINT32					*paui32ServerSyncFlags,
+								SERVER_SYNC_PRIMITIVE 		**pasServerSyncs,
+								IMG_UINT32					ui32CmdSize,
+								IMG_PBYTE					pui8DMCmd,
+								IMG_BOOL					bPDumpContinuous)
+{
+	PVRSRV_ERROR eError;
+
+	eError = _CheckServerSyncFlags(ui32ServerSyncPrims, paui32ServerSyncFlags);
+	if (eError != PVRSRV_OK)
+	{
+		return eError;
+	}
+
+	return _KickCDM(psComputeContext,
+					ui32ClientFenceCount,
+					pauiClientFenceUFOAddress,
+					paui32ClientFenceValue,
+					ui32ClientUpdateCount,
+					pauiClientUpdateUFOAddress,
+					paui32ClientUpdateValue,
+					ui32ServerSyncPrims,
+					paui32ServerSyncFlags,
+					pasServerSyncs,
+					ui32CmdSize,
+					pui8DMCmd,
+					bPDumpContinuous);
+}
+
+IMG_EXPORT
+PVRSRV_ERROR PVRSRVRGXBindComputeSyncsKM(RGX_SERVER_COMPUTE_CONTEXT	*psComputeContext,
+										 IMG_UINT32					ui32UnbindMask,
+										 IMG_UINT32					ui32FirstSlot,
+										 IMG_UINT32					ui32ServerSyncCount,
+										 IMG_UINT32					*paui32ServerSyncFlags,
+										 SERVER_SYNC_PRIMITIVE		**papsServerSyncs)
+{
+	PVRSRV_ERROR eError;
+	IMG_UINT32 i;
+
+	if ((ui32UnbindMask & ~RGX_CDM_SYNC_BINDING_MASK) ||
+		(ui32FirstSlot > RGX_CDM_MAX_SYNC_BINDINGS) ||
+		(ui32ServerSyncCount > RGX_CDM_MAX_SYNC_BINDINGS - ui32FirstSlot))
+	{
+		return PVRSRV_ERROR_INVALID_PARAMS;
+	}
+
+	/*
+		Do the checks the kick would otherwise do on every submit now, and
+		before touching any of the existing bindings
+	*/
+	eError = _CheckServerSyncFlags(ui32ServerSyncCount, paui32ServerSyncFlags);
+	if (eError != PVRSRV_OK)
+	{
+		return eError;
+	}
+
+	_UnbindComputeSyncs(psComputeContext, ui32UnbindMask);
+
+	for (i=0;i<ui32ServerSyncCount;i++)
+	{
+		RGX_SERVER_COMPUTE_SYNC_BINDING *psBinding = &psComputeContext->asSyncBinding[ui32FirstSlot + i];
+
+		/* Take the new reference first in case the same sync is rebound */
+		ServerSyncRef(papsServerSyncs[i]);
+		_UnbindComputeSyncs(psComputeContext, 1U << (ui32FirstSlot + i));
+
+		psBinding->psServerSync = papsServerSyncs[i];
+		psBinding->ui32Flags = paui32ServerSyncFlags[i];
+		psComputeContext->ui32BoundSyncMask |= 1U << (ui32FirstSlot + i);
+	}
+
+	return PVRSRV_OK;
+}
+
+IMG_EXPORT
+PVRSRV_ERROR PVRSRVRGXKickCDMBoundKM(RGX_SERVER_COMPUTE_CONTEXT	*psComputeContext,
+									 IMG_UINT32					ui32ClientFenceCount,
+									 PRGXFWIF_UFO_ADDR			*pauiClientFenceUFOAddress,
+									 IMG_UINT32					*paui32ClientFenceValue,
+									 IMG_UINT32					ui32ClientUpdateCount,
+									 PRGXFWIF_UFO_ADDR			*pauiClientUpdateUFOAddress,
+									 IMG_UINT32					*paui32ClientUpdateValue,
+									 IMG_UINT32					ui32BoundSyncMask,
+									 IMG_UINT32					ui32CmdSize,
+									 IMG_PBYTE					pui8DMCmd,
+									 IMG_BOOL					bPDumpContinuous)
+{
+	SERVER_SYNC_PRIMITIVE	*apsServerSyncs[RGX_CDM_MAX_SYNC_BINDINGS];
+	IMG_UINT32				aui32ServerSyncFlags[RGX_CDM_MAX_SYNC_BINDINGS];
+	IMG_UINT32				ui32ServerSyncPrims = 0;
+	IMG_UINT32				ui32Slot;
+
+	if ((ui32BoundSyncMask & ~psComputeContext->ui32BoundSyncMask) != 0)
+	{
+		PVR_DPF((PVR_DBG_ERROR, "%s: Kick refers to unbound sync slots (0x%x, bound 0x%x)",
+				 __FUNCTION__, ui32BoundSyncMask, psComputeContext->ui32BoundSyncMask));
+		return PVRSRV_ERROR_INVALID_PARAMS;
+	}
+
+	/*
+		The bound syncs were referenced and checked when they were bound so
+		all that's left to do here is to gather them
+	*/
+	for (ui32Slot = 0; ui32BoundSyncMask != 0; ui32Slot++, ui32BoundSyncMask >>= 1)
+	{
+		if (ui32BoundSyncMask & 1)
+		{
+			apsServerSyncs[ui32ServerSyncPrims] = psComputeContext->asSyncBinding[ui32Slot].psServerSync;
+			aui32ServerSyncFlags[ui32ServerSyncPrims] = psComputeContext->asSyncBinding[ui32Slot].ui32Flags;
+			ui32ServerSyncPrims++;
+		}
+	}
+
+	return _KickCDM(psComputeContext,
+					ui32ClientFenceCount,
+					pauiClientFenceUFOAddress,
+					paui32ClientFenceValue,
+					ui32ClientUpdateCount,
+					pauiClientUpdateUFOAddress,
+					paui32ClientUpdateValue,
+					ui32ServerSyncPrims,
+					aui32ServerSyncFlags,
+					apsServerSyncs,
+					ui32CmdSize,
+					pui8DMCmd,
+					bPDumpContinuous);
+}
+
 IMG_EXPORT PVRSRV_ERROR PVRSRVRGXFlushComputeDataKM(RGX_SERVER_COMPUTE_CONTEXT *psComputeContext)
 {
 	RGXFWIF_KCCB_CMD sFlushCmd;
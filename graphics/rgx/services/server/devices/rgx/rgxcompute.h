@@ -59,6 +59,9 @@ extern "C" {
 
 typedef struct _RGX_SERVER_COMPUTE_CONTEXT_ RGX_SERVER_COMPUTE_CONTEXT;
 
+/* Number of persistent server sync binding slots per compute context */
+#define RGX_CDM_MAX_SYNC_BINDINGS	16
+
 /*!
 *******************************************************************************
  @Function	PVRSRVRGXCreateComputeContextKM
@@ -126,6 +129,59 @@ PVRSRV_ERROR PVRSRVRGXKickCDMKM(RGX_SERVER_COMPUTE_CONTEXT	*psComputeContext,
 								IMG_PBYTE					pui8DMCmd,
 								IMG_BOOL					bPDumpContinuous);
 								
+/*!
+*******************************************************************************
+ @Function	PVRSRVRGXBindComputeSyncsKM
+
+ @Description
+	Bind server syncs to slots of a compute context so later kicks can refer
+	to them by slot rather than passing (and looking up) them every time.
+	A reference is held on each bound sync until it's unbound or the
+	context is destroyed.
+
+ @Input psComputeContext - Compute context
+ @Input ui32UnbindMask - Mask of slots to release before binding
+ @Input ui32FirstSlot - First slot to bind
+ @Input ui32ServerSyncCount - Number of server syncs to bind
+ @Input paui32ServerSyncFlags - Sync op flags, must include CHECK
+ @Input papsServerSyncs - Server syncs to bind
+
+ @Return   PVRSRV_ERROR
+******************************************************************************/
+IMG_EXPORT
+PVRSRV_ERROR PVRSRVRGXBindComputeSyncsKM(RGX_SERVER_COMPUTE_CONTEXT	*psComputeContext,
+										 IMG_UINT32					ui32UnbindMask,
+										 IMG_UINT32					ui32FirstSlot,
+										 IMG_UINT32					ui32ServerSyncCount,
+										 IMG_UINT32					*paui32ServerSyncFlags,
+										 SERVER_SYNC_PRIMITIVE		**papsServerSyncs);
+
+/*!
+*******************************************************************************
+ @Function	PVRSRVRGXKickCDMBoundKM
+
+ @Description
+	As PVRSRVRGXKickCDMKM but the server syncs come from the slots bound
+	with PVRSRVRGXBindComputeSyncsKM
+
+ @Input psComputeContext - Compute context
+ @Input ui32BoundSyncMask - Mask of bound slots to apply to this kick
+
+ @Return   PVRSRV_ERROR
+******************************************************************************/
+IMG_EXPORT
+PVRSRV_ERROR PVRSRVRGXKickCDMBoundKM(RGX_SERVER_COMPUTE_CONTEXT	*psComputeContext,
+									 IMG_UINT32					ui32ClientFenceCount,
+									 PRGXFWIF_UFO_ADDR			*pauiClientFenceUFOAddress,
+									 IMG_UINT32					*paui32ClientFenceValue,
+									 IMG_UINT32					ui32ClientUpdateCount,
+									 PRGXFWIF_UFO_ADDR			*pauiClientUpdateUFOAddress,
+									 IMG_UINT32					*paui32ClientUpdateValue,
+									 IMG_UINT32					ui32BoundSyncMask,
+									 IMG_UINT32					ui32CmdSize,
+									 IMG_PBYTE					pui8DMCmd,
+									 IMG_BOOL					bPDumpContinuous);
+
 /*!
 *******************************************************************************
  @Function	PVRSRVRGXFlushComputeDataKM
@@ -740,6 +740,7 @@ static IMG_VOID _RGXDumpRGXDebugSummary(DUMPDEBUG_PRINTF_FUNC *pfnDumpDebugPrint
 {
 	IMG_CHAR *pszState;
 	RGXFWIF_TRACEBUF *psRGXFWIfTraceBuf = psDevInfo->psRGXFWIfTraceBuf;
+	PVRSRV_POWER_DEV_TIMING sDevPowerTiming;
 
 	if (bRGXPoweredON)
 	{
@@ -794,6 +795,46 @@ static IMG_VOID _RGXDumpRGXDebugSummary(DUMPDEBUG_PRINTF_FUNC *pfnDumpDebugPrint
 	                  psDevInfo->ui32ActivePMReqDenied,
 	                  psDevInfo->ui32ActivePMReqTotal - psDevInfo->ui32ActivePMReqOk - psDevInfo->ui32ActivePMReqDenied,
 	                  psDevInfo->ui32ActivePMReqTotal));
+	if (psDevInfo->pfnActivePowerCheck)
+	{
+		RGX_APM_POLICY *psAPMPolicy = &psDevInfo->sAPMPolicy;
+
+		PVR_DUMPDEBUG_LOG(("RGX APM Policy: %s, %u power-downs (%u short), %u deferred, off for %llu us, %u woken kicks (+%llu us, max %u us)",
+		                  (psAPMPolicy->eType == RGX_APM_POLICY_PREDICTIVE) ? "predictive" : "immediate",
+		                  psAPMPolicy->ui32PowerDowns,
+		                  psAPMPolicy->ui32ShortPowerDowns,
+		                  psAPMPolicy->ui32Deferred,
+		                  psAPMPolicy->ui64OffResidencyUs,
+		                  psAPMPolicy->ui32WakeKicks,
+		                  psAPMPolicy->ui64WakeLatencyUs,
+		                  psAPMPolicy->ui32WakeLatencyMaxUs));
+	}
+	PVR_DUMPDEBUG_LOG(("RGX Power-up: %u, last/max us: reset %u/%u, config %u/%u, META %u/%u, FW wait %u/%u, total %u/%u",
+	                  psDevInfo->sPowerTiming.ui32PowerUps,
+	                  psDevInfo->sPowerTiming.aui32LastUs[RGX_POWER_PHASE_RESET],
+	                  psDevInfo->sPowerTiming.aui32MaxUs[RGX_POWER_PHASE_RESET],
+	                  psDevInfo->sPowerTiming.aui32LastUs[RGX_POWER_PHASE_CONFIG],
+	                  psDevInfo->sPowerTiming.aui32MaxUs[RGX_POWER_PHASE_CONFIG],
+	                  psDevInfo->sPowerTiming.aui32LastUs[RGX_POWER_PHASE_META_BOOT],
+	                  psDevInfo->sPowerTiming.aui32MaxUs[RGX_POWER_PHASE_META_BOOT],
+	                  psDevInfo->sPowerTiming.aui32LastUs[RGX_POWER_PHASE_FW_WAIT],
+	                  psDevInfo->sPowerTiming.aui32MaxUs[RGX_POWER_PHASE_FW_WAIT],
+	                  psDevInfo->sPowerTiming.aui32LastUs[RGX_POWER_PHASE_TOTAL],
+	                  psDevInfo->sPowerTiming.aui32MaxUs[RGX_POWER_PHASE_TOTAL]));
+	if (psDevInfo->hLockPBReserve != IMG_NULL)
+	{
+		PVR_DUMPDEBUG_LOG(("RGX PB reserve: %u grows served from the reserve, %u allocated",
+		                  psDevInfo->ui32PBReserveHits,
+		                  psDevInfo->ui32PBReserveMisses));
+	}
+	if (PVRSRVGetDevicePowerTiming(psDevInfo->psDeviceNode->sDevId.ui32DeviceIndex, &sDevPowerTiming) == PVRSRV_OK)
+	{
+		PVR_DUMPDEBUG_LOG(("RGX Power callbacks, last/max us: suspend %u/%u, resume %u/%u",
+		                  sDevPowerTiming.ui32LastSuspendUs,
+		                  sDevPowerTiming.ui32MaxSuspendUs,
+		                  sDevPowerTiming.ui32LastResumeUs,
+		                  sDevPowerTiming.ui32MaxResumeUs));
+	}
 
 
 	_RGXDumpFWAssert(pfnDumpDebugPrintf, psRGXFWIfTraceBuf);
@@ -1206,6 +1247,50 @@ IMG_VOID RGXDebugRequestProcess(DUMPDEBUG_PRINTF_FUNC *pfnDumpDebugPrintf,
 				                  g_ui32HostSampleIRQCount));
 			}
 
+			/* Dump the HWPerf transport counters */
+			if (psDevInfo->hHWPerfStream)
+			{
+				PVR_DUMPDEBUG_LOG(("RGX HWPerf FW drops = %d, L2 full = %d, host filtered = %d",
+				                  psDevInfo->psRGXFWIfTraceBuf->ui32HWPerfDropCount,
+				                  psDevInfo->ui32HWPerfL2FullCount,
+				                  psDevInfo->ui32HWPerfHostFiltered));
+				PVR_DUMPDEBUG_LOG(("RGX HWPerf drain: watermark %d%%, period %dms, wakeups %d, latency last %dus max %dus",
+				                  psDevInfo->ui32HWPerfDrainWatermark,
+				                  psDevInfo->ui32HWPerfDrainPeriodMs,
+				                  psDevInfo->ui32HWPerfDrainWakeups,
+				                  psDevInfo->ui32HWPerfDrainLatencyLastUs,
+				                  psDevInfo->ui32HWPerfDrainLatencyMaxUs));
+			}
+
+			/* Dump the kernel CCB admission counters */
+			{
+				RGXFWIF_DM eKCCBType;
+
+				for (eKCCBType = 0; eKCCBType < RGXFWIF_DM_MAX; eKCCBType++)
+				{
+					RGX_KCCB_GATE *psGate = &psDevInfo->asKCCBGate[eKCCBType];
+
+					if (psGate->ui32Contended != 0)
+					{
+						PVR_DUMPDEBUG_LOG(("RGX kCCB(%d) admission: contended %u, reordered %u, max wait %uus at priority 0x%x",
+						                  eKCCBType,
+						                  psGate->ui32Contended,
+						                  psGate->ui32Reordered,
+						                  psGate->ui32MaxWaitUs,
+						                  psGate->ui32MaxWaitPriority));
+					}
+				}
+			}
+
+			/* Dump the FW trace stream counters */
+			if (psDevInfo->hFWTraceStream)
+			{
+				PVR_DUMPDEBUG_LOG(("RGX FW trace stream: streamed %u dwords, dropped %u dwords, T0 at %X",
+				                  psDevInfo->ui32FWTraceStreamedDWords,
+				                  psDevInfo->ui32FWTraceDroppedDWords,
+				                  psDevInfo->aui32FWTraceStreamPos[0]));
+			}
+
 			/* Dump the FW config flags */
 			{
 				RGXFWIF_INIT		*psRGXFWInit;
@@ -1327,8 +1412,9 @@ IMG_VOID RGXDebugRequestProcess(DUMPDEBUG_PRINTF_FUNC *pfnDumpDebugPrintf,
 				{
 					PVR_DUMPDEBUG_LOG(("------[ Stalled FWCtxs ]------"));
 
-					if (psDevInfo)
+					if (psDevInfo && !RGXDumpStalledContexts(psDevInfo))
 					{
+						/* Some contexts are not tracked, walk them all */
 						CheckForStalledTransferCtxt(psDevInfo);
 						CheckForStalledRenderCtxt(psDevInfo);
 #if !defined(UNDER_WDDM)
@@ -52,6 +52,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "rgxscript.h"
 #include "cache_external.h"
 #include "device.h"
+#include "osfunc.h"
+#include "rgxapmpolicy.h"
 
 
 typedef struct _RGX_SERVER_COMMON_CONTEXT_ RGX_SERVER_COMMON_CONTEXT;
@@ -69,6 +71,47 @@ typedef struct {
 #define RGXKM_DEVICE_STATE_ZERO_FREELIST		(0x1 << 0)		/*!< Zeroing the physical pages of reconstructed free lists */
 #define RGXKM_DEVICE_STATE_FTRACE_EN			(0x1 << 1)		/*!< Used to enable device FTrace thread to consume HWPerf data */
 
+/*!
+ ******************************************************************************
+ * On-demand ZS-Buffer backing pool
+ *****************************************************************************/
+#define RGX_ZSBUFFER_POOL_CLASSES			8	/*!< Size classes: <=1MB, 2MB, 4MB, ... >=128MB */
+#define RGX_ZSBUFFER_POOL_CLASS_MIN_SHIFT	20
+#define RGX_ZSBUFFER_POOL_CLASS_ENTRIES		2	/*!< LRU cap of retained backings per size class */
+
+/*!
+ ******************************************************************************
+ * PB block reserve
+ *****************************************************************************/
+#define RGX_PB_RESERVE_SIZES				4	/*!< Distinct freelist grow sizes the reserve keeps blocks for */
+
+/*!
+ ******************************************************************************
+ * Kernel CCB admission
+ *****************************************************************************/
+#define RGX_KCCB_PRIORITY_KERNEL			0xFFFFFFFFU	/*!< Driver internal commands, never overtaken */
+#define RGX_KCCB_PRIORITY_CONTEXT_MAX		(RGX_KCCB_PRIORITY_KERNEL - 1)	/*!< Highest priority a context reaches, aged or not */
+#define RGX_KCCB_AGING_US					2000		/*!< Waiting this long raises a kick by one priority level */
+
+typedef struct _RGX_KCCB_GATE_
+{
+	POS_LOCK				hLock;					/*!< Protects the gate state */
+	IMG_BOOL				bBusy;					/*!< A submitter owns the kernel CCB */
+	DLLIST_NODE				sWaiterList;			/*!< Waiting submitters in arrival order */
+	IMG_UINT32				ui32Contended;			/*!< Admissions which had to wait */
+	IMG_UINT32				ui32Reordered;			/*!< Admissions granted ahead of an earlier waiter */
+	IMG_UINT32				ui32MaxWaitUs;
+	IMG_UINT32				ui32MaxWaitPriority;	/*!< Priority of the submitter which waited ui32MaxWaitUs */
+} RGX_KCCB_GATE;
+
+/*!
+ ******************************************************************************
+ * Stalled context tracking
+ *****************************************************************************/
+#define RGX_STALL_TRACK_MAX_CTXS			256	/*!< Common contexts with a tracking slot, the rest fall back to list walks */
+#define RGX_STALL_TRACK_INVALID_SLOT		0xFFFFFFFFU
+#define RGX_STALL_TRACK_EPOCHS				2	/*!< Health check periods without progress before a context counts as stalled */
+
 #define RGXFWIF_GPU_STATS_WINDOW_SIZE_US					1000000
 #define RGXFWIF_GPU_STATS_MAX_VALUE_OF_STATE				10000
 
@@ -85,6 +128,28 @@ typedef struct _RGX_GPU_DVFS_HIST_
 	IMG_UINT32				 aui32DVFSClockCB[RGX_GPU_DVFS_HIST_SIZE];   /*!< Circular buffer of DVFS clock history in Hz */
 } RGX_GPU_DVFS_HIST;
 
+/*!
+ ******************************************************************************
+ * Power-up latency
+ *****************************************************************************/
+
+typedef enum _RGX_POWER_PHASE_
+{
+	RGX_POWER_PHASE_RESET = 0,		/*!< Soft reset sequence */
+	RGX_POWER_PHASE_CONFIG,			/*!< Clock, AXI and BIF configuration */
+	RGX_POWER_PHASE_META_BOOT,		/*!< Taking META out of reset */
+	RGX_POWER_PHASE_FW_WAIT,		/*!< Waiting for the firmware to report it has started */
+	RGX_POWER_PHASE_TOTAL,			/*!< Whole power-up in RGXPostPowerState */
+	RGX_POWER_PHASE_MAX
+} RGX_POWER_PHASE;
+
+typedef struct _RGX_POWER_TIMING_
+{
+	IMG_UINT32				aui32LastUs[RGX_POWER_PHASE_MAX];	/*!< Duration of each phase in the last power-up */
+	IMG_UINT32				aui32MaxUs[RGX_POWER_PHASE_MAX];	/*!< Longest duration of each phase */
+	IMG_UINT32				ui32PowerUps;		/*!< Number of power-ups measured */
+} RGX_POWER_TIMING;
+
 typedef struct _RGXFWIF_GPU_UTIL_STATS_
 {
 	IMG_BOOL				bPoweredOn;			/* if TRUE, device is powered on and statistic are valid. 
@@ -155,6 +220,7 @@ typedef struct _PVRSRV_RGXDEV_INFO_
 	RGXFWIF_CCB_CTL			*apsKernelCCBCtl[RGXFWIF_DM_MAX];			/*!< kernel CCB control kernel mapping */
 	DEVMEM_MEMDESC			*apsKernelCCBMemDesc[RGXFWIF_DM_MAX];		/*!< memdesc for kernel CCB */
 	IMG_UINT8				*apsKernelCCB[RGXFWIF_DM_MAX];				/*!< kernel CCB kernel mapping */
+	RGX_KCCB_GATE			asKCCBGate[RGXFWIF_DM_MAX];					/*!< admits writers of each kernel CCB in priority order */
 
 	/* Firmware CCBs */
 	DEVMEM_MEMDESC			*apsFirmwareCCBCtlMemDesc[RGXFWIF_DM_MAX];	/*!< memdesc for Firmware CCB control */
@@ -235,6 +301,52 @@ typedef struct _PVRSRV_RGXDEV_INFO_
 	 */
 	POS_LOCK 				hLockHWPerfStream;
 	IMG_HANDLE				hHWPerfStream;
+
+	/*! Host side filter applied when packets are moved from the L1 FW
+	 * buffer to the L2 stream, see PVRSRVRGXSetHWPerfHostFilterKM().
+	 * Protected by hLockHWPerfStream. When bHWPerfHostFilter is not set
+	 * all packets are passed on unchanged.
+	 */
+	IMG_BOOL				bHWPerfHostFilter;
+	IMG_UINT64				ui64HWPerfHostEventMask;	/*!< Bit per RGX_HWPERF_EVENT_TYPE to pass */
+	IMG_UINT32				ui32HWPerfHostPID;			/*!< Only pass HW packets for this PID, 0 for all */
+	IMG_UINT32				ui32HWPerfHostFiltered;		/*!< Packets dropped by the host filter */
+
+	/*! Dedicated worker draining the L1 FW buffer into the L2 stream, woken
+	 * from the MISR when the L1 fill level reaches the watermark. It also
+	 * polls every ui32HWPerfDrainPeriodMs, but only while HWPerf events are
+	 * enabled and the GPU is powered; otherwise it sleeps untimed until the
+	 * MISR or PVRSRVRGXCtrlHWPerfKM() wakes it. See RGXHWPerfCheckDrain().
+	 */
+	IMG_HANDLE				hHWPerfDrainThread;
+	IMG_HANDLE				hHWPerfDrainEvObj;
+	volatile IMG_BOOL		bHWPerfDrainStop;
+	volatile IMG_BOOL		bHWPerfDrainRequested;
+	volatile IMG_BOOL		bHWPerfDrainIdle;			/*!< Worker is in an untimed wait */
+	IMG_BOOL				bHWPerfEventsEnabled;		/*!< FW has been asked to generate HWPerf events */
+	IMG_UINT64				ui64HWPerfDrainRequestTime;	/*!< OSClockus64() when the drain was requested */
+	IMG_UINT32				ui32HWPerfDrainWatermark;	/*!< L1 fill level in percent which wakes the worker */
+	IMG_UINT32				ui32HWPerfDrainPeriodMs;	/*!< Maximum time between drains */
+	IMG_UINT32				ui32HWPerfDrainWakeups;		/*!< Drains requested by the watermark */
+	IMG_UINT32				ui32HWPerfDrainLatencyLastUs;
+	IMG_UINT32				ui32HWPerfDrainLatencyMaxUs;
+	IMG_UINT32				ui32HWPerfL2FullCount;		/*!< Drains which left data in L1 as L2 was full */
+
+	/*! Worker copying new firmware trace buffer entries, undecoded, into
+	 * the firmware trace TL stream. Woken from the MISR when the trace
+	 * pointer has moved or an assert is pending, and also polls while the
+	 * GPU is powered and tracing is on. See rgxfwtrace.c.
+	 */
+	IMG_HANDLE				hFWTraceStream;
+	IMG_HANDLE				hFWTraceThread;
+	IMG_HANDLE				hFWTraceEvObj;
+	volatile IMG_BOOL		bFWTraceStop;
+	volatile IMG_BOOL		bFWTraceRequested;
+	IMG_UINT32				aui32FWTraceStreamPos[RGXFW_THREAD_NUM];	/*!< Next trace buffer dword to stream */
+	IMG_UINT32				aui32FWTraceFlags[RGXFW_THREAD_NUM];		/*!< Flags pending for the next packet */
+	IMG_BOOL				abFWTraceAssertStreamed[RGXFW_THREAD_NUM];
+	IMG_UINT32				ui32FWTraceStreamedDWords;
+	IMG_UINT32				ui32FWTraceDroppedDWords;	/*!< Dropped because the stream was full */
 #if defined(SUPPORT_GPUTRACE_EVENTS)
 	IMG_HANDLE				hGPUTraceCmdCompleteHandle;
 	IMG_BOOL				bFTraceGPUEventsEnabled;
@@ -248,8 +360,22 @@ typedef struct _PVRSRV_RGXDEV_INFO_
 
 	POS_LOCK 				hLockZSBuffer;		/*!< Lock to protect simultaneous access to ZSBuffers */
 	DLLIST_NODE				sZSBufferHead;		/*!< List of on-demand ZSBuffers */
+	DLLIST_NODE				asZSBufferPoolHead[RGX_ZSBUFFER_POOL_CLASSES];	/*!< LRU lists of unbacked ZSBuffers which kept their backing */
+	IMG_UINT32				aui32ZSBufferPoolCount[RGX_ZSBUFFER_POOL_CLASSES];	/*!< Number of ZSBuffers on each LRU list */
+	IMG_UINT32				ui32ZSBufferPoolHits;	/*!< Backing requests served by a retained backing */
+	IMG_UINT32				ui32ZSBufferPoolMisses;	/*!< Backing requests which had to map (and allocate) pages */
 	POS_LOCK 				hLockFreeList;		/*!< Lock to protect simultaneous access to Freelists */
 	DLLIST_NODE				sFreeListHead;		/*!< List of growable Freelists */
+
+	POS_LOCK 				hLockPBReserve;		/*!< Lock to protect the PB block reserve */
+	DLLIST_NODE				asPBReserveHead[RGX_PB_RESERVE_SIZES];	/*!< Pre-allocated PB blocks used to serve FW grow requests, per grow size */
+	IMG_UINT32				aui32PBReserveCount[RGX_PB_RESERVE_SIZES];	/*!< Number of blocks currently held for each grow size */
+	IMG_UINT32				aui32PBReserveBlockPages[RGX_PB_RESERVE_SIZES];	/*!< Grow size (in PM pages) of each slot, 0 if unused */
+	IMG_UINT32				aui32PBReserveFreeLists[RGX_PB_RESERVE_SIZES];	/*!< Number of freelists growing by each slot's size */
+	IMG_UINT32				ui32PBReserveHits;	/*!< Number of grows served from the reserve */
+	IMG_UINT32				ui32PBReserveMisses;	/*!< Number of grows which had to allocate */
+	IMG_HANDLE				hPBReserveMISR;		/*!< MISR refilling the PB reserve */
+
 	PSYNC_PRIM_CONTEXT		hSyncPrimContext;
 	PVRSRV_CLIENT_SYNC_PRIM *psPowSyncPrim;
 
@@ -257,6 +383,9 @@ typedef struct _PVRSRV_RGXDEV_INFO_
 	IMG_UINT32				ui32ActivePMReqOk;
 	IMG_UINT32				ui32ActivePMReqDenied;
 	IMG_UINT32				ui32ActivePMReqTotal;
+	RGX_APM_POLICY			sAPMPolicy;			/*!< Decides whether an idle GPU is powered down */
+	IMG_HANDLE				hAPMTimer;			/*!< Re-runs a deferred power-down decision */
+	IMG_BOOL				bAPMTimerEnabled;
 	
 	IMG_HANDLE				hProcessQueuesMISR;
 
@@ -274,6 +403,9 @@ typedef struct _PVRSRV_RGXDEV_INFO_
 	/* Register configuration */
 	RGX_REG_CONFIG		sRegCongfig;
 
+	/* Power-up latency */
+	RGX_POWER_TIMING		sPowerTiming;
+
 	IMG_BOOL				bIgnoreFurtherIRQs;
 	DLLIST_NODE				sMemoryContextList;
 
@@ -283,6 +415,19 @@ typedef struct _PVRSRV_RGXDEV_INFO_
 	DLLIST_NODE 		sTransferCtxtListHead;
 	DLLIST_NODE 		sRaytraceCtxtListHead;
 
+	/* Stalled context tracking. A kick marks its context active without
+	   taking a lock; the MISR samples only the active contexts and keeps
+	   the stalled summary up to date. */
+	POS_LOCK				hStallTrackLock;
+	RGX_SERVER_COMMON_CONTEXT	*apsStallTrackCtxts[RGX_STALL_TRACK_MAX_CTXS];
+	IMG_UINTPTR_T			auiStallTrackAllocMap[OS_BITMAP_WORDS(RGX_STALL_TRACK_MAX_CTXS)];
+	volatile IMG_UINTPTR_T	auiStallTrackActiveMap[OS_BITMAP_WORDS(RGX_STALL_TRACK_MAX_CTXS)];
+	IMG_UINTPTR_T			auiStallTrackStalledMap[OS_BITMAP_WORDS(RGX_STALL_TRACK_MAX_CTXS)];
+	IMG_UINT32				ui32StallTrackEpoch;		/*!< Advanced by each timed health check */
+	IMG_UINT32				ui32StallTrackSampledEpoch;	/*!< Epoch of the last progress sample */
+	IMG_UINT32				ui32StalledCtxtCount;
+	IMG_UINT32				ui32UntrackedCtxtCount;		/*!< Contexts created while all slots were in use */
+
 #if defined(RGXFW_POWMON_TEST)
 	IMG_HANDLE			hPowerMonitoringThread;	    /*!< Fatal Error Detection thread */
 	IMG_BOOL			bPowMonEnable;
@@ -0,0 +1,338 @@
+/*************************************************************************/ /*!
+@File
+@Title          RGX firmware trace streaming
+@Copyright      Copyright (c) Imagination Technologies Ltd. All Rights Reserved
+@Description    Copies new firmware trace buffer entries into a TL stream as
+                they appear, so firmware logging can be left on and decoded
+                by a user mode reader instead of in a debug dump
+@License        Dual MIT/GPLv2
+
+The contents of this file are subject to the MIT license as set out below.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+Alternatively, the contents of this file may be used under the terms of
+the GNU General Public License Version 2 ("GPL") in which case the provisions
+of GPL are applicable instead of those above.
+
+If you wish to allow use of your version of this file only under the terms of
+GPL, and not to allow others to use your version of this file under the terms
+of the MIT license, indicate your decision by deleting the provisions above
+and replace them with the notice and other provisions required by GPL as set
+out in the file called "GPL-COPYING" included in this distribution. If you do
+not delete the provisions above, a recipient may use your version of this file
+under the terms of either the MIT license or GPL.
+
+This License is also included in this distribution in the file called
+"MIT-COPYING".
+
+EXCEPT AS OTHERWISE STATED IN A NEGOTIATED AGREEMENT: (A) THE SOFTWARE IS
+PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT; AND (B) IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/ /**************************************************************************/
+
+#include "img_defs.h"
+#include "pvr_debug.h"
+#include "osfunc.h"
+#include "tlstream.h"
+#include "srvkm.h"
+#include "power.h"
+#include "rgx_fwif_km.h"
+#include "rgx_fwtrace_km.h"
+#include "rgxfwtrace.h"
+
+/* Maximum time between two passes of the worker while the GPU is powered
+   and the firmware is tracing */
+#define FWTRACE_STREAM_PERIOD_MS		100
+
+/* The stream holds a whole trace buffer, so a reader which keeps up with
+   the worker never loses entries */
+#define FWTRACE_STREAM_SIZE \
+	((RGXFW_TRACE_BUFFER_SIZE * sizeof(IMG_UINT32)) + \
+	 ((RGXFW_TRACE_BUFFER_SIZE / RGX_FWTRACE_STREAM_MAX_DWORDS) + 2) * (sizeof(RGX_FWTRACE_STREAM_HDR) + sizeof(RGXFWIF_ASSERTBUF) + 64))
+
+
+static PVRSRV_ERROR _FWTraceStreamPacket(PVRSRV_RGXDEV_INFO *psDevInfo,
+										 IMG_UINT32 ui32Thread,
+										 IMG_UINT32 ui32StartPos,
+										 IMG_UINT32 ui32DWords,
+										 IMG_UINT32 ui32Flags)
+{
+	RGXFWIF_TRACEBUF_SPACE *psTraceBuf = &psDevInfo->psRGXFWIfTraceBuf->sTraceBuf[ui32Thread];
+	RGX_FWTRACE_STREAM_HDR *psHdr;
+	IMG_UINT8              *pui8Dest;
+	IMG_UINT32             ui32FirstDWords;
+	IMG_UINT32             ui32Size;
+	PVRSRV_ERROR           eError;
+
+	ui32Size = sizeof(*psHdr) + (ui32DWords * sizeof(IMG_UINT32));
+	if (ui32Flags & RGX_FWTRACE_STREAM_FLAG_ASSERT)
+	{
+		ui32Size += sizeof(RGXFWIF_ASSERTBUF);
+	}
+
+	eError = TLStreamReserve(psDevInfo->hFWTraceStream, &pui8Dest, ui32Size);
+	if (eError != PVRSRV_OK)
+	{
+		return eError;
+	}
+
+	psHdr = (RGX_FWTRACE_STREAM_HDR *) pui8Dest;
+	psHdr->ui32ThreadID = ui32Thread;
+	psHdr->ui32StartPos = ui32StartPos;
+	psHdr->ui32DWords = ui32DWords;
+	psHdr->ui32LogType = psDevInfo->psRGXFWIfTraceBuf->ui32LogType;
+	psHdr->ui32Flags = ui32Flags;
+	psHdr->ui32Reserved = 0;
+	pui8Dest += sizeof(*psHdr);
+
+	/* The entries may wrap around the end of the trace buffer */
+	ui32FirstDWords = RGXFW_TRACE_BUFFER_SIZE - ui32StartPos;
+	if (ui32FirstDWords > ui32DWords)
+	{
+		ui32FirstDWords = ui32DWords;
+	}
+	OSMemCopy(pui8Dest, &psTraceBuf->aui32TraceBuffer[ui32StartPos], ui32FirstDWords * sizeof(IMG_UINT32));
+	pui8Dest += ui32FirstDWords * sizeof(IMG_UINT32);
+	if (ui32DWords > ui32FirstDWords)
+	{
+		OSMemCopy(pui8Dest, &psTraceBuf->aui32TraceBuffer[0], (ui32DWords - ui32FirstDWords) * sizeof(IMG_UINT32));
+		pui8Dest += (ui32DWords - ui32FirstDWords) * sizeof(IMG_UINT32);
+	}
+
+	if (ui32Flags & RGX_FWTRACE_STREAM_FLAG_ASSERT)
+	{
+		OSMemCopy(pui8Dest, &psTraceBuf->sAssertBuf, sizeof(RGXFWIF_ASSERTBUF));
+	}
+
+	return TLStreamCommit(psDevInfo->hFWTraceStream, ui32Size);
+}
+
+
+/*
+	_FWTraceStreamThreadEntries
+
+	Streams the entries written by one firmware thread since the last pass.
+	Only the trace pointer is visible to the host, so if the firmware
+	writes more than a whole trace buffer between two passes the oldest
+	entries are overwritten before they can be streamed. The reader copes
+	with that as with any other corrupt entry, by resynchronising on the
+	next valid log ID.
+*/
+static IMG_VOID _FWTraceStreamThreadEntries(PVRSRV_RGXDEV_INFO *psDevInfo, IMG_UINT32 ui32Thread)
+{
+	RGXFWIF_TRACEBUF_SPACE *psTraceBuf = &psDevInfo->psRGXFWIfTraceBuf->sTraceBuf[ui32Thread];
+	IMG_UINT32             ui32WritePos = psTraceBuf->ui32TracePointer % RGXFW_TRACE_BUFFER_SIZE;
+	IMG_UINT32             ui32Pos = psDevInfo->aui32FWTraceStreamPos[ui32Thread];
+	IMG_UINT32             ui32Pending;
+	IMG_BOOL               bAssert;
+
+	/* A cleared assert buffer means the firmware has been restarted */
+	if (psTraceBuf->sAssertBuf.szInfo[0] == '\0')
+	{
+		psDevInfo->abFWTraceAssertStreamed[ui32Thread] = IMG_FALSE;
+	}
+	bAssert = (psTraceBuf->sAssertBuf.szInfo[0] != '\0') && !psDevInfo->abFWTraceAssertStreamed[ui32Thread];
+
+	ui32Pending = (ui32WritePos + RGXFW_TRACE_BUFFER_SIZE - ui32Pos) % RGXFW_TRACE_BUFFER_SIZE;
+
+	while (ui32Pending != 0 || bAssert)
+	{
+		IMG_UINT32   ui32DWords = MIN(ui32Pending, RGX_FWTRACE_STREAM_MAX_DWORDS);
+		IMG_UINT32   ui32Flags = psDevInfo->aui32FWTraceFlags[ui32Thread];
+		PVRSRV_ERROR eError;
+
+		if (bAssert && ui32DWords == ui32Pending)
+		{
+			ui32Flags |= RGX_FWTRACE_STREAM_FLAG_ASSERT;
+		}
+
+		eError = _FWTraceStreamPacket(psDevInfo, ui32Thread, ui32Pos, ui32DWords, ui32Flags);
+		if (eError != PVRSRV_OK)
+		{
+			/* The reader is not keeping up, skip what is pending and let
+			   it know entries are missing */
+			PVR_DPF((PVR_DBG_MESSAGE, "_FWTraceStreamThreadEntries: T%u dropping %u dwords (%s)",
+					 ui32Thread, ui32Pending, PVRSRVGetErrorStringKM(eError)));
+			psDevInfo->ui32FWTraceDroppedDWords += ui32Pending;
+			psDevInfo->aui32FWTraceFlags[ui32Thread] = RGX_FWTRACE_STREAM_FLAG_DISCONTINUITY;
+			ui32Pos = ui32WritePos;
+			break;
+		}
+
+		psDevInfo->aui32FWTraceFlags[ui32Thread] = 0;
+		psDevInfo->ui32FWTraceStreamedDWords += ui32DWords;
+		ui32Pos = (ui32Pos + ui32DWords) % RGXFW_TRACE_BUFFER_SIZE;
+		ui32Pending -= ui32DWords;
+		if (ui32Flags & RGX_FWTRACE_STREAM_FLAG_ASSERT)
+		{
+			psDevInfo->abFWTraceAssertStreamed[ui32Thread] = IMG_TRUE;
+			bAssert = IMG_FALSE;
+		}
+	}
+
+	psDevInfo->aui32FWTraceStreamPos[ui32Thread] = ui32Pos;
+}
+
+
+static IMG_VOID _FWTraceStreamThread(IMG_PVOID pvData)
+{
+	PVRSRV_RGXDEV_INFO *psDevInfo = pvData;
+	IMG_HANDLE         hOSEvent;
+	IMG_UINT32         ui32Thread;
+	PVRSRV_ERROR       eError;
+
+	eError = OSEventObjectOpen(psDevInfo->hFWTraceEvObj, &hOSEvent);
+	PVR_LOGRN_IF_ERROR(eError, "OSEventObjectOpen");
+
+	while (!psDevInfo->bFWTraceStop)
+	{
+		/* The trace buffer only moves while the firmware runs with tracing
+		   on, otherwise sleep until the MISR sees new entries or an assert */
+		if ((psDevInfo->psRGXFWIfTraceBuf->ui32LogType & RGXFWIF_LOG_TYPE_TRACE) &&
+			PVRSRVIsDevicePowered(psDevInfo->psDeviceNode->sDevId.ui32DeviceIndex))
+		{
+			eError = OSEventObjectWaitTimeout(hOSEvent, FWTRACE_STREAM_PERIOD_MS);
+		}
+		else
+		{
+			eError = OSEventObjectWaitUntimed(hOSEvent);
+		}
+		if (eError != PVRSRV_OK && eError != PVRSRV_ERROR_TIMEOUT)
+		{
+			PVR_DPF((PVR_DBG_ERROR, "_FWTraceStreamThread: "
+					"Error (%d) when waiting for event!", eError));
+		}
+
+		if (psDevInfo->bFWTraceStop)
+		{
+			break;
+		}
+
+		psDevInfo->bFWTraceRequested = IMG_FALSE;
+		for (ui32Thread = 0; ui32Thread < RGXFW_THREAD_NUM; ui32Thread++)
+		{
+			_FWTraceStreamThreadEntries(psDevInfo, ui32Thread);
+		}
+	}
+
+	eError = OSEventObjectClose(hOSEvent);
+	PVR_LOG_IF_ERROR(eError, "OSEventObjectClose");
+}
+
+
+PVRSRV_ERROR RGXFWTraceStreamInit(PVRSRV_DEVICE_NODE *psDeviceNode)
+{
+	PVRSRV_RGXDEV_INFO *psDevInfo = psDeviceNode->pvDevice;
+	IMG_UINT32         ui32Thread;
+	PVRSRV_ERROR       eError;
+
+	psDevInfo->hFWTraceStream = IMG_NULL;
+	psDevInfo->hFWTraceThread = IMG_NULL;
+	psDevInfo->hFWTraceEvObj = IMG_NULL;
+	psDevInfo->bFWTraceStop = IMG_FALSE;
+	psDevInfo->bFWTraceRequested = IMG_FALSE;
+
+	for (ui32Thread = 0; ui32Thread < RGXFW_THREAD_NUM; ui32Thread++)
+	{
+		psDevInfo->aui32FWTraceStreamPos[ui32Thread] =
+			psDevInfo->psRGXFWIfTraceBuf->sTraceBuf[ui32Thread].ui32TracePointer % RGXFW_TRACE_BUFFER_SIZE;
+		psDevInfo->aui32FWTraceFlags[ui32Thread] = RGX_FWTRACE_STREAM_FLAG_DISCONTINUITY;
+		psDevInfo->abFWTraceAssertStreamed[ui32Thread] = IMG_FALSE;
+	}
+
+	eError = TLStreamCreate(&psDevInfo->hFWTraceStream, RGX_FWTRACE_STREAM_NAME,
+							FWTRACE_STREAM_SIZE, TL_FLAG_DROP_DATA,
+							IMG_NULL, IMG_NULL);
+	PVR_LOGG_IF_ERROR(eError, "TLStreamCreate", e0);
+
+	eError = OSEventObjectCreate("PVRSRV_FWTRACE_EVENTOBJECT", &psDevInfo->hFWTraceEvObj);
+	PVR_LOGG_IF_ERROR(eError, "OSEventObjectCreate", e1);
+
+	eError = OSThreadCreate(&psDevInfo->hFWTraceThread,
+							"pvr_fwtrace",
+							_FWTraceStreamThread,
+							psDevInfo);
+	PVR_LOGG_IF_ERROR(eError, "OSThreadCreate", e2);
+
+	return PVRSRV_OK;
+
+e2:
+	OSEventObjectDestroy(psDevInfo->hFWTraceEvObj);
+	psDevInfo->hFWTraceEvObj = IMG_NULL;
+	psDevInfo->hFWTraceThread = IMG_NULL;
+e1:
+	TLStreamClose(psDevInfo->hFWTraceStream);
+	psDevInfo->hFWTraceStream = IMG_NULL;
+e0:
+	return eError;
+}
+
+
+IMG_VOID RGXFWTraceStreamDeInit(PVRSRV_RGXDEV_INFO *psDevInfo)
+{
+	PVRSRV_ERROR eError;
+
+	if (psDevInfo->hFWTraceThread)
+	{
+		psDevInfo->bFWTraceStop = IMG_TRUE;
+		eError = OSEventObjectSignal(psDevInfo->hFWTraceEvObj);
+		PVR_LOG_IF_ERROR(eError, "OSEventObjectSignal");
+		eError = OSThreadDestroy(psDevInfo->hFWTraceThread);
+		PVR_LOG_IF_ERROR(eError, "OSThreadDestroy");
+		psDevInfo->hFWTraceThread = IMG_NULL;
+	}
+	if (psDevInfo->hFWTraceEvObj)
+	{
+		eError = OSEventObjectDestroy(psDevInfo->hFWTraceEvObj);
+		PVR_LOG_IF_ERROR(eError, "OSEventObjectDestroy");
+		psDevInfo->hFWTraceEvObj = IMG_NULL;
+	}
+	if (psDevInfo->hFWTraceStream)
+	{
+		TLStreamClose(psDevInfo->hFWTraceStream);
+		psDevInfo->hFWTraceStream = IMG_NULL;
+	}
+}
+
+
+IMG_VOID RGXFWTraceStreamCheck(PVRSRV_RGXDEV_INFO *psDevInfo)
+{
+	IMG_UINT32 ui32Thread;
+
+	if (psDevInfo->hFWTraceThread == IMG_NULL || psDevInfo->bFWTraceRequested)
+	{
+		return;
+	}
+
+	for (ui32Thread = 0; ui32Thread < RGXFW_THREAD_NUM; ui32Thread++)
+	{
+		RGXFWIF_TRACEBUF_SPACE *psTraceBuf = &psDevInfo->psRGXFWIfTraceBuf->sTraceBuf[ui32Thread];
+
+		if (((psTraceBuf->ui32TracePointer % RGXFW_TRACE_BUFFER_SIZE) !=
+			 psDevInfo->aui32FWTraceStreamPos[ui32Thread]) ||
+			((psTraceBuf->sAssertBuf.szInfo[0] != '\0') &&
+			 !psDevInfo->abFWTraceAssertStreamed[ui32Thread]))
+		{
+			psDevInfo->bFWTraceRequested = IMG_TRUE;
+			(void) OSEventObjectSignal(psDevInfo->hFWTraceEvObj);
+			return;
+		}
+	}
+}
+
+/******************************************************************************
+ End of file (rgxfwtrace.c)
+******************************************************************************/
@@ -63,6 +63,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "pvrsrv.h"
 #include "rgxdebug.h"
 #include "rgxhwperf.h"
+#include "rgxfwtrace.h"
 #include "rgxccb.h"
 #include "rgxmem.h"
 #include "rgxta3d.h"
@@ -297,8 +298,85 @@ struct _RGX_SERVER_COMMON_CONTEXT_ {
 	DEVMEM_MEMDESC *psClientCCBCtrlMemDesc;
 	IMG_BOOL bCommonContextMemProvided;
 	RGXFWIF_CONTEXT_RESET_REASON eLastResetReason;
+	PVRSRV_RGXDEV_INFO *psDevInfo;
+	IMG_UINT32 ui32Priority;			/*!< Host copy of the context priority, orders kernel CCB admission */
+	IMG_UINT32 ui32StallTrackSlot;		/*!< Slot in the device stall tracking maps */
+	IMG_UINT32 ui32LastReadOffset;		/*!< Client CCB read offset at the last progress sample */
+	IMG_UINT32 ui32ProgressEpoch;		/*!< Stall tracking epoch in which progress was last seen */
 };
 
+static IMG_UINT32 _StallTrackFirstBit(IMG_UINTPTR_T uiWord)
+{
+	IMG_UINT32 ui32Bit = 0;
+
+	PVR_ASSERT(uiWord != 0);
+	while ((uiWord & 1) == 0)
+	{
+		uiWord >>= 1;
+		ui32Bit++;
+	}
+	return ui32Bit;
+}
+
+static IMG_VOID _StallTrackAddContext(PVRSRV_RGXDEV_INFO *psDevInfo,
+									  RGX_SERVER_COMMON_CONTEXT *psServerCommonContext)
+{
+	IMG_UINT32 ui32Word;
+
+	psServerCommonContext->psDevInfo = psDevInfo;
+	psServerCommonContext->ui32StallTrackSlot = RGX_STALL_TRACK_INVALID_SLOT;
+	psServerCommonContext->ui32LastReadOffset = 0;
+
+	OSLockAcquire(psDevInfo->hStallTrackLock);
+	for (ui32Word = 0; ui32Word < OS_BITMAP_WORDS(RGX_STALL_TRACK_MAX_CTXS); ui32Word++)
+	{
+		IMG_UINTPTR_T uiFree = ~psDevInfo->auiStallTrackAllocMap[ui32Word];
+
+		if (uiFree != 0)
+		{
+			IMG_UINT32 ui32Bit = _StallTrackFirstBit(uiFree);
+
+			psDevInfo->auiStallTrackAllocMap[ui32Word] |= ((IMG_UINTPTR_T)1 << ui32Bit);
+			psServerCommonContext->ui32StallTrackSlot = (ui32Word * OS_BITMAP_WORD_BITS) + ui32Bit;
+			psDevInfo->apsStallTrackCtxts[psServerCommonContext->ui32StallTrackSlot] = psServerCommonContext;
+			break;
+		}
+	}
+	if (psServerCommonContext->ui32StallTrackSlot == RGX_STALL_TRACK_INVALID_SLOT)
+	{
+		psDevInfo->ui32UntrackedCtxtCount++;
+	}
+	psServerCommonContext->ui32ProgressEpoch = psDevInfo->ui32StallTrackEpoch;
+	OSLockRelease(psDevInfo->hStallTrackLock);
+}
+
+static IMG_VOID _StallTrackRemoveContext(RGX_SERVER_COMMON_CONTEXT *psServerCommonContext)
+{
+	PVRSRV_RGXDEV_INFO *psDevInfo = psServerCommonContext->psDevInfo;
+	IMG_UINT32 ui32Slot = psServerCommonContext->ui32StallTrackSlot;
+
+	OSLockAcquire(psDevInfo->hStallTrackLock);
+	if (ui32Slot == RGX_STALL_TRACK_INVALID_SLOT)
+	{
+		psDevInfo->ui32UntrackedCtxtCount--;
+	}
+	else
+	{
+		IMG_UINT32 ui32Word = ui32Slot / OS_BITMAP_WORD_BITS;
+		IMG_UINTPTR_T uiMask = (IMG_UINTPTR_T)1 << (ui32Slot % OS_BITMAP_WORD_BITS);
+
+		psDevInfo->apsStallTrackCtxts[ui32Slot] = IMG_NULL;
+		psDevInfo->auiStallTrackAllocMap[ui32Word] &= ~uiMask;
+		OSAtomicClearBit(ui32Slot, psDevInfo->auiStallTrackActiveMap);
+		if (psDevInfo->auiStallTrackStalledMap[ui32Word] & uiMask)
+		{
+			psDevInfo->auiStallTrackStalledMap[ui32Word] &= ~uiMask;
+			psDevInfo->ui32StalledCtxtCount--;
+		}
+	}
+	OSLockRelease(psDevInfo->hStallTrackLock);
+}
+
 PVRSRV_ERROR FWCommonContextAllocate(CONNECTION_DATA *psConnection,
 									 PVRSRV_DEVICE_NODE *psDeviceNode,
 									 const IMG_CHAR *pszContextName,
@@ -415,6 +493,7 @@ PVRSRV_ERROR FWCommonContextAllocate(CONNECTION_DATA *psConnection,
 						  0, RFW_FWADDR_METACACHED_FLAG);
 
 	psFWCommonContext->ui32Priority = ui32Priority;
+	psServerCommonContext->ui32Priority = MIN(ui32Priority, RGX_KCCB_PRIORITY_CONTEXT_MAX);
 
 	if(psInfo->psMCUFenceAddr != IMG_NULL)
 	{
@@ -459,6 +538,8 @@ PVRSRV_ERROR FWCommonContextAllocate(CONNECTION_DATA *psConnection,
 						  ui32FWCommonContextOffset,
 						  RFW_FWADDR_METACACHED_FLAG);
 
+	_StallTrackAddContext(psDevInfo, psServerCommonContext);
+
 #if defined(LINUX)
 	trace_pvr_create_fw_context(OSGetCurrentProcessNameKM(),
 								pszContextName,
@@ -484,6 +565,9 @@ fail_alloc:
 
 IMG_VOID FWCommonContextFree(RGX_SERVER_COMMON_CONTEXT *psServerCommonContext)
 {
+	/* Stop the MISR from sampling this context's CCB */
+	_StallTrackRemoveContext(psServerCommonContext);
+
 	/*
 		Unmap the context itself and then all it's resources
 	*/
@@ -519,6 +603,37 @@ PRGXFWIF_FWCOMMONCONTEXT FWCommonContextGetFWAddress(RGX_SERVER_COMMON_CONTEXT *
 	return psServerCommonContext->sFWCommonContextFWAddr;
 }
 
+IMG_UINT32 FWCommonContextGetPriority(RGX_SERVER_COMMON_CONTEXT *psServerCommonContext)
+{
+	return psServerCommonContext->ui32Priority;
+}
+
+IMG_VOID FWCommonContextMarkActive(RGX_SERVER_COMMON_CONTEXT *psServerCommonContext)
+{
+	PVRSRV_RGXDEV_INFO *psDevInfo = psServerCommonContext->psDevInfo;
+	IMG_UINT32 ui32Slot = psServerCommonContext->ui32StallTrackSlot;
+	IMG_UINTPTR_T uiMask;
+
+	if (ui32Slot == RGX_STALL_TRACK_INVALID_SLOT)
+	{
+		return;
+	}
+	uiMask = (IMG_UINTPTR_T)1 << (ui32Slot % OS_BITMAP_WORD_BITS);
+
+	/*
+		Order the new CCB write offset before the test of the active bit.
+		The sampler clears the bit before re-reading the write offset so
+		either it sees our command or we see the bit clear and set it.
+	*/
+	OSMemoryBarrier();
+	if ((psDevInfo->auiStallTrackActiveMap[ui32Slot / OS_BITMAP_WORD_BITS] & uiMask) == 0)
+	{
+		/* Idle until now, don't count the idle time as lack of progress */
+		psServerCommonContext->ui32ProgressEpoch = psDevInfo->ui32StallTrackEpoch;
+		OSAtomicSetBit(ui32Slot, psDevInfo->auiStallTrackActiveMap);
+	}
+}
+
 RGX_CLIENT_CCB *FWCommonContextGetClientCCB(RGX_SERVER_COMMON_CONTEXT *psServerCommonContext)
 {
 	return psServerCommonContext->psClientCCB;
@@ -1311,6 +1426,7 @@ PVRSRV_ERROR RGXSetupFirmware(PVRSRV_DEVICE_NODE	*psDeviceNode,
 	psDevInfo->psRGXFWIfTraceBuf->ui32HWPerfWrapCount = 0;
 	psDevInfo->psRGXFWIfTraceBuf->ui32HWPerfSize = psDevInfo->ui32RGXFWIfHWPerfBufSize;
 	psRGXFWInit->ui64HWPerfFilter = ui64HWPerfFilter;
+	psDevInfo->bHWPerfEventsEnabled = (ui64HWPerfFilter != 0) ? IMG_TRUE : IMG_FALSE;
 	psDevInfo->psRGXFWIfTraceBuf->ui32HWPerfUt = 0;
 	psDevInfo->psRGXFWIfTraceBuf->ui32HWPerfDropCount = 0;
 	psDevInfo->psRGXFWIfTraceBuf->ui32FirstDropOrdinal = 0;
@@ -1332,6 +1448,11 @@ PVRSRV_ERROR RGXSetupFirmware(PVRSRV_DEVICE_NODE	*psDeviceNode,
 	}
 	psDevInfo->psRGXFWIfTraceBuf->ui32LogType = ui32LogType;
 
+	/* Stream the firmware trace from here on. Not fatal, the trace is
+	   still decoded in debug dumps without it */
+	eError = RGXFWTraceStreamInit(psDeviceNode);
+	PVR_LOG_IF_ERROR(eError, "RGXFWTraceStreamInit");
+
 	/* Allocate FW CB for GPU utilization */
 	uiMemAllocFlags =	PVRSRV_MEMALLOCFLAG_DEVICE_FLAG(PMMETA_PROTECT) |
 						PVRSRV_MEMALLOCFLAG_GPU_READABLE |
@@ -1895,7 +2016,7 @@ failFWIfGpuUtilFWCbCtlMemDescAqCpuVirt:
 	DevmemFwFree(psDevInfo->psRGXFWIfGpuUtilFWCbCtlMemDesc);
 
 failFWIfGpuUtilFWCbCtlMemDescAlloc:
-	/* Nothing to do for invalid log type check */
+	RGXFWTraceStreamDeInit(psDevInfo);
 
 failInvalidLogType:
 	RGXHWPerfDeinit();
@@ -2047,6 +2168,8 @@ IMG_VOID RGXFreeFirmware(PVRSRV_RGXDEV_INFO 	*psDevInfo)
 		DevmemFwFree(psDevInfo->psRGXFWIfHWRInfoBufCtlMemDesc);
 	}
 
+	RGXFWTraceStreamDeInit(psDevInfo);
+
 	RGXHWPerfDeinit();
 	
 	if (psDevInfo->psRGXFWIfHWPerfBufCtlMemDesc)
@@ -2113,6 +2236,174 @@ PVRSRV_ERROR RGXStartFirmware(PVRSRV_RGXDEV_INFO 	*psDevInfo)
 }
 
 
+/*
+	Kernel CCB admission
+
+	Submitters of one kernel CCB are admitted one at a time. When the CCB
+	is free and nobody waits a submitter goes straight in. Otherwise it
+	queues, and whoever leaves the CCB hands it to the waiter with the
+	highest effective priority: its context priority plus one level for
+	every RGX_KCCB_AGING_US it has waited, so low priority work is delayed
+	but never starved. Ties go to the earliest arrival. Context priorities
+	never reach RGX_KCCB_PRIORITY_KERNEL, however long they wait, so driver
+	internal commands are always admitted first.
+
+	Each waiter sleeps on an event object of its own, so a release wakes
+	only the waiter it hands the CCB to rather than every queued submitter.
+*/
+typedef struct _RGX_KCCB_WAITER_
+{
+	DLLIST_NODE		sNode;
+	IMG_UINT32		ui32Priority;
+	IMG_UINT64		ui64EnqueueUs;
+	IMG_HANDLE		hEvObj;				/*!< Signalled on grant, IMG_NULL if the waiter polls */
+	volatile IMG_BOOL	bGranted;
+} RGX_KCCB_WAITER;
+
+PVRSRV_ERROR RGXKCCBGateInit(RGX_KCCB_GATE *psGate)
+{
+	OSMemSet(psGate, 0, sizeof(*psGate));
+	dllist_init(&psGate->sWaiterList);
+
+	return OSLockCreate(&psGate->hLock, LOCK_TYPE_PASSIVE);
+}
+
+IMG_VOID RGXKCCBGateDeInit(RGX_KCCB_GATE *psGate)
+{
+	PVR_ASSERT(dllist_is_empty(&psGate->sWaiterList));
+
+	if (psGate->hLock != IMG_NULL)
+	{
+		OSLockDestroy(psGate->hLock);
+		psGate->hLock = IMG_NULL;
+	}
+}
+
+static IMG_UINT32 _KCCBWaiterPriority(RGX_KCCB_WAITER *psWaiter, IMG_UINT64 ui64NowUs)
+{
+	IMG_UINT64 ui64Priority;
+
+	if (psWaiter->ui32Priority == RGX_KCCB_PRIORITY_KERNEL)
+	{
+		return RGX_KCCB_PRIORITY_KERNEL;
+	}
+
+	ui64Priority = (IMG_UINT64)psWaiter->ui32Priority + ((ui64NowUs - psWaiter->ui64EnqueueUs) / RGX_KCCB_AGING_US);
+	return (IMG_UINT32)MIN(ui64Priority, RGX_KCCB_PRIORITY_CONTEXT_MAX);
+}
+
+static IMG_VOID _KCCBGateAcquire(RGX_KCCB_GATE *psGate, IMG_UINT32 ui32Priority)
+{
+	RGX_KCCB_WAITER sWaiter;
+	IMG_HANDLE      hOSEvent = IMG_NULL;
+	IMG_UINT32      ui32WaitUs;
+
+	OSLockAcquire(psGate->hLock);
+	if (!psGate->bBusy && dllist_is_empty(&psGate->sWaiterList))
+	{
+		psGate->bBusy = IMG_TRUE;
+		OSLockRelease(psGate->hLock);
+		return;
+	}
+
+	sWaiter.ui32Priority = ui32Priority;
+	sWaiter.ui64EnqueueUs = OSClockus64();
+	sWaiter.hEvObj = IMG_NULL;
+	sWaiter.bGranted = IMG_FALSE;
+
+	/* Set up the event before queueing so a grant can't be missed. Without
+	   one the waiter falls back to polling bGranted */
+	if (OSEventObjectCreate("PVRSRV_KCCB_WAITER_EVENTOBJECT", &sWaiter.hEvObj) == PVRSRV_OK)
+	{
+		if (OSEventObjectOpen(sWaiter.hEvObj, &hOSEvent) != PVRSRV_OK)
+		{
+			OSEventObjectDestroy(sWaiter.hEvObj);
+			sWaiter.hEvObj = IMG_NULL;
+			hOSEvent = IMG_NULL;
+		}
+	}
+	else
+	{
+		sWaiter.hEvObj = IMG_NULL;
+	}
+
+	dllist_add_to_tail(&psGate->sWaiterList, &sWaiter.sNode);
+	psGate->ui32Contended++;
+	OSLockRelease(psGate->hLock);
+
+	while (!sWaiter.bGranted)
+	{
+		if ((hOSEvent == IMG_NULL) || (OSEventObjectWaitUntimed(hOSEvent) != PVRSRV_OK))
+		{
+			OSWaitus(50);
+		}
+	}
+
+	/* The releaser signals under the lock, so once we hold it the event
+	   is no longer in use and can go */
+	ui32WaitUs = (IMG_UINT32)(OSClockus64() - sWaiter.ui64EnqueueUs);
+	OSLockAcquire(psGate->hLock);
+	if (ui32WaitUs > psGate->ui32MaxWaitUs)
+	{
+		psGate->ui32MaxWaitUs = ui32WaitUs;
+		psGate->ui32MaxWaitPriority = ui32Priority;
+	}
+	OSLockRelease(psGate->hLock);
+
+	if (hOSEvent != IMG_NULL)
+	{
+		OSEventObjectClose(hOSEvent);
+		OSEventObjectDestroy(sWaiter.hEvObj);
+	}
+}
+
+static IMG_VOID _KCCBGateRelease(RGX_KCCB_GATE *psGate)
+{
+	PDLLIST_NODE    psNode;
+	RGX_KCCB_WAITER *psBest = IMG_NULL;
+	IMG_UINT32      ui32BestPriority = 0;
+	IMG_UINT64      ui64NowUs;
+
+	OSLockAcquire(psGate->hLock);
+	if (dllist_is_empty(&psGate->sWaiterList))
+	{
+		psGate->bBusy = IMG_FALSE;
+		OSLockRelease(psGate->hLock);
+		return;
+	}
+
+	ui64NowUs = OSClockus64();
+	for (psNode = dllist_get_next_node(&psGate->sWaiterList);
+		 psNode != &psGate->sWaiterList;
+		 psNode = psNode->psNextNode)
+	{
+		RGX_KCCB_WAITER *psWaiter = IMG_CONTAINER_OF(psNode, RGX_KCCB_WAITER, sNode);
+		IMG_UINT32      ui32WaiterPriority = _KCCBWaiterPriority(psWaiter, ui64NowUs);
+
+		if (psBest == IMG_NULL || ui32WaiterPriority > ui32BestPriority)
+		{
+			psBest = psWaiter;
+			ui32BestPriority = ui32WaiterPriority;
+		}
+	}
+
+	if (&psBest->sNode != dllist_get_next_node(&psGate->sWaiterList))
+	{
+		psGate->ui32Reordered++;
+	}
+
+	/* The gate stays busy, ownership passes straight to the waiter. Only
+	   that waiter is woken, the others keep sleeping */
+	dllist_remove_node(&psBest->sNode);
+	psBest->bGranted = IMG_TRUE;
+	if (psBest->hEvObj != IMG_NULL)
+	{
+		(void) OSEventObjectSignal(psBest->hEvObj);
+	}
+	OSLockRelease(psGate->hLock);
+}
+
+
 /******************************************************************************
  FUNCTION	: RGXAcquireKernelCCBSlot
 
@@ -2163,17 +2454,32 @@ static PVRSRV_ERROR RGXAcquireKernelCCBSlot(RGXFWIF_CCB_CTL	*psKCCBCtl,
 }
 
 
-PVRSRV_ERROR RGXSendCommandWithPowLock(PVRSRV_RGXDEV_INFO 	*psDevInfo,
-										 RGXFWIF_DM			eKCCBType,
-										 RGXFWIF_KCCB_CMD	*psKCCBCmd,
-										 IMG_UINT32			ui32CmdSize,
-										 IMG_BOOL			bPDumpContinuous)
+static PVRSRV_ERROR _RGXSendCommandRaw(PVRSRV_RGXDEV_INFO 	*psDevInfo,
+										RGXFWIF_DM			eKCCBType,
+										RGXFWIF_KCCB_CMD	*psKCCBCmd,
+										IMG_UINT32			ui32CmdSize,
+										PDUMP_FLAGS_T		uiPdumpFlags,
+										IMG_UINT32			ui32Priority);
+
+static PVRSRV_ERROR _RGXSendCommandWithPowLock(PVRSRV_RGXDEV_INFO 	*psDevInfo,
+											   RGXFWIF_DM			eKCCBType,
+											   RGXFWIF_KCCB_CMD	*psKCCBCmd,
+											   IMG_UINT32			ui32CmdSize,
+											   IMG_BOOL			bPDumpContinuous,
+											   IMG_UINT32			ui32Priority)
 {
 	PVRSRV_ERROR		eError;
 	PVRSRV_DEVICE_NODE *psDeviceNode = psDevInfo->psDeviceNode;
+	IMG_UINT32			ui32DeviceIndex = psDeviceNode->sDevId.ui32DeviceIndex;
+	PVRSRV_DEV_POWER_STATE	ePowerState = PVRSRV_DEV_POWER_STATE_ON;
+	IMG_UINT64			ui64PowerUpStartUs = 0;
+	IMG_BOOL			bShared;
 
-	/* Ensure RGX is powered up before kicking MTS */
-	eError = PVRSRVPowerLock();
+	/*
+		Ensure RGX is powered up before kicking MTS. Kicks to a powered
+		device only need shared access to the device power lock.
+	*/
+	eError = PVRSRVDevicePowerLock(ui32DeviceIndex, IMG_FALSE, &bShared);
 
 	if (eError != PVRSRV_OK) 
 	{
@@ -2182,53 +2488,114 @@ PVRSRV_ERROR RGXSendCommandWithPowLock(PVRSRV_RGXDEV_INFO 	*psDevInfo,
 
 		goto _PVRSRVPowerLock_Exit;
 	}
-	
-	PDUMPPOWCMDSTART();
 
-	eError = PVRSRVSetDevicePowerStateKM(psDeviceNode->sDevId.ui32DeviceIndex,
-										 PVRSRV_DEV_POWER_STATE_ON,
-										 IMG_FALSE);
-	PDUMPPOWCMDEND();
+	/* The APM policy is only updated under exclusive access */
+	if (bShared && psDevInfo->pfnActivePowerCheck && psDevInfo->sAPMPolicy.bIdle)
+	{
+		PVRSRVDevicePowerUnlock(ui32DeviceIndex, IMG_TRUE);
+		bShared = IMG_FALSE;
 
-	if (eError != PVRSRV_OK) 
+		eError = PVRSRVDevicePowerLock(ui32DeviceIndex, IMG_FALSE, IMG_NULL);
+		if (eError != PVRSRV_OK)
+		{
+			PVR_DPF((PVR_DBG_WARNING, "RGXSendCommandWithPowLock: failed to acquire powerlock (%s)",
+						PVRSRVGetErrorStringKM(eError)));
+
+			goto _PVRSRVPowerLock_Exit;
+		}
+	}
+
+	if (!bShared)
 	{
-		PVR_DPF((PVR_DBG_WARNING, "RGXSendCommandWithPowLock: failed to transition RGX to ON (%s)",
-					PVRSRVGetErrorStringKM(eError)));
+		PDUMPPOWCMDSTART();
 
-		goto _PVRSRVSetDevicePowerStateKM_Exit;
+		if (psDevInfo->pfnActivePowerCheck)
+		{
+			/* Measure what an active power-down costs this kick */
+			PVRSRVGetDevicePowerState(ui32DeviceIndex, &ePowerState);
+			ui64PowerUpStartUs = OSClockus64();
+		}
+
+		eError = PVRSRVSetDevicePowerStateKM(ui32DeviceIndex,
+											 PVRSRV_DEV_POWER_STATE_ON,
+											 IMG_FALSE);
+		PDUMPPOWCMDEND();
+
+		if (eError != PVRSRV_OK) 
+		{
+			PVR_DPF((PVR_DBG_WARNING, "RGXSendCommandWithPowLock: failed to transition RGX to ON (%s)",
+						PVRSRVGetErrorStringKM(eError)));
+
+			goto _PVRSRVSetDevicePowerStateKM_Exit;
+		}
+
+		if (psDevInfo->pfnActivePowerCheck)
+		{
+			IMG_UINT64 ui64NowUs = OSClockus64();
+
+			RGXAPMPolicyKick(&psDevInfo->sAPMPolicy,
+							 ui64NowUs,
+							 (ePowerState == PVRSRV_DEV_POWER_STATE_OFF) ? IMG_TRUE : IMG_FALSE,
+							 (IMG_UINT32)(ui64NowUs - ui64PowerUpStartUs));
+		}
 	}
 
-	RGXSendCommandRaw(psDevInfo, eKCCBType,  psKCCBCmd, ui32CmdSize, bPDumpContinuous?PDUMP_FLAGS_CONTINUOUS:0);
+	_RGXSendCommandRaw(psDevInfo, eKCCBType,  psKCCBCmd, ui32CmdSize, bPDumpContinuous?PDUMP_FLAGS_CONTINUOUS:0, ui32Priority);
 
 _PVRSRVSetDevicePowerStateKM_Exit:
-	PVRSRVPowerUnlock();
+	PVRSRVDevicePowerUnlock(ui32DeviceIndex, bShared);
 
 _PVRSRVPowerLock_Exit:
 	return eError;
 }
 
+PVRSRV_ERROR RGXSendCommandWithPowLock(PVRSRV_RGXDEV_INFO 	*psDevInfo,
+										 RGXFWIF_DM			eKCCBType,
+										 RGXFWIF_KCCB_CMD	*psKCCBCmd,
+										 IMG_UINT32			ui32CmdSize,
+										 IMG_BOOL			bPDumpContinuous)
+{
+	return _RGXSendCommandWithPowLock(psDevInfo, eKCCBType, psKCCBCmd, ui32CmdSize,
+									  bPDumpContinuous, RGX_KCCB_PRIORITY_KERNEL);
+}
+
 PVRSRV_ERROR RGXSendCommandRaw(PVRSRV_RGXDEV_INFO 	*psDevInfo,
 								 RGXFWIF_DM			eKCCBType,
 								 RGXFWIF_KCCB_CMD	*psKCCBCmd,
 								 IMG_UINT32			ui32CmdSize,
 								 PDUMP_FLAGS_T		uiPdumpFlags)
+{
+	return _RGXSendCommandRaw(psDevInfo, eKCCBType, psKCCBCmd, ui32CmdSize,
+							  uiPdumpFlags, RGX_KCCB_PRIORITY_KERNEL);
+}
+
+static PVRSRV_ERROR _RGXSendCommandRaw(PVRSRV_RGXDEV_INFO 	*psDevInfo,
+										RGXFWIF_DM			eKCCBType,
+										RGXFWIF_KCCB_CMD	*psKCCBCmd,
+										IMG_UINT32			ui32CmdSize,
+										PDUMP_FLAGS_T		uiPdumpFlags,
+										IMG_UINT32			ui32Priority)
 {
 	PVRSRV_ERROR		eError;
 	RGXFWIF_CCB_CTL		*psKCCBCtl = psDevInfo->apsKernelCCBCtl[eKCCBType];
 	IMG_UINT8			*pui8KCCB = psDevInfo->apsKernelCCB[eKCCBType];
 	IMG_UINT32			ui32NewWriteOffset;
-	IMG_UINT32			ui32OldWriteOffset = psKCCBCtl->ui32WriteOffset;
+	IMG_UINT32			ui32OldWriteOffset;
 #if !defined(PDUMP)
 	PVR_UNREFERENCED_PARAMETER(uiPdumpFlags);
 #endif
 	
 	PVR_ASSERT(ui32CmdSize == psKCCBCtl->ui32CmdSize);
 
-	if (!OSLockIsLocked(PVRSRVGetPVRSRVData()->hPowerLock))
+	if (!PVRSRVDevicePowerLockIsHeld(psDevInfo->psDeviceNode->sDevId.ui32DeviceIndex))
 	{
 		PVR_DPF((PVR_DBG_ERROR, "RGXSendCommandRaw called without power lock held!"));
-		PVR_ASSERT(OSLockIsLocked(PVRSRVGetPVRSRVData()->hPowerLock));
+		PVR_ASSERT(PVRSRVDevicePowerLockIsHeld(psDevInfo->psDeviceNode->sDevId.ui32DeviceIndex));
 	}
+
+	/* Kicks holding the power lock shared may race for the same kernel CCB */
+	_KCCBGateAcquire(&psDevInfo->asKCCBGate[eKCCBType], ui32Priority);
+	ui32OldWriteOffset = psKCCBCtl->ui32WriteOffset;
  
 
 	/*
@@ -2357,6 +2724,7 @@ PVRSRV_ERROR RGXSendCommandRaw(PVRSRV_RGXDEV_INFO 	*psDevInfo,
 #endif
 
 _RGXSendCommandRaw_Exit:
+	_KCCBGateRelease(&psDevInfo->asKCCBGate[eKCCBType]);
 	return eError;
 }
 
@@ -2386,9 +2754,11 @@ static IMG_VOID _RGXScheduleProcessQueuesMISR(IMG_VOID *pvData)
 	IMG_UINT64			   ui64FWCbEntryCurrent;
 	IMG_BOOL			   bGPUHasWorkWaiting;
 	PVRSRV_DEV_POWER_STATE ePowerState;
+	IMG_UINT32			   ui32DeviceIndex = psDeviceNode->sDevId.ui32DeviceIndex;
+	IMG_BOOL			   bShared;
 
 	/* Ensure RGX is powered up before kicking MTS */
-	eError = PVRSRVPowerLock();
+	eError = PVRSRVDevicePowerLock(ui32DeviceIndex, IMG_FALSE, &bShared);
 	if (eError != PVRSRV_OK) 
 	{
 		PVR_DPF((PVR_DBG_WARNING, "RGXScheduleProcessQueuesKM: failed to acquire powerlock (%s)",
@@ -2397,30 +2767,34 @@ static IMG_VOID _RGXScheduleProcessQueuesMISR(IMG_VOID *pvData)
 		return;
 	}
 
-	ui64FWCbEntryCurrent = psUtilFWCb->aui64CB[(psUtilFWCb->ui32WriteOffset - 1) & RGXFWIF_GPU_UTIL_FWCB_MASK];
-	bGPUHasWorkWaiting = (RGXFWIF_GPU_UTIL_FWCB_ENTRY_STATE(ui64FWCbEntryCurrent) == RGXFWIF_GPU_UTIL_FWCB_STATE_BLOCKED);
+	/* Shared access is only granted while RGX is on */
+	if (!bShared)
+	{
+		ui64FWCbEntryCurrent = psUtilFWCb->aui64CB[(psUtilFWCb->ui32WriteOffset - 1) & RGXFWIF_GPU_UTIL_FWCB_MASK];
+		bGPUHasWorkWaiting = (RGXFWIF_GPU_UTIL_FWCB_ENTRY_STATE(ui64FWCbEntryCurrent) == RGXFWIF_GPU_UTIL_FWCB_STATE_BLOCKED);
 
-	eError = PVRSRVGetDevicePowerState(psDeviceNode->sDevId.ui32DeviceIndex, &ePowerState);
+		eError = PVRSRVGetDevicePowerState(ui32DeviceIndex, &ePowerState);
 
-	/* Check whether it's worth waking up the GPU */
-	if ((eError == PVRSRV_OK) && (ePowerState == PVRSRV_DEV_POWER_STATE_OFF) && !bGPUHasWorkWaiting)
-	{
-		PVRSRVPowerUnlock();
-		return;
-	}
+		/* Check whether it's worth waking up the GPU */
+		if ((eError == PVRSRV_OK) && (ePowerState == PVRSRV_DEV_POWER_STATE_OFF) && !bGPUHasWorkWaiting)
+		{
+			PVRSRVDevicePowerUnlock(ui32DeviceIndex, IMG_FALSE);
+			return;
+		}
 
-	/* We don't need to acquire the BridgeLock as this power transition won't
-	   send a command to the FW */
-	eError = PVRSRVSetDevicePowerStateKM(psDeviceNode->sDevId.ui32DeviceIndex,
-										 PVRSRV_DEV_POWER_STATE_ON,
-										 IMG_FALSE);
-	if (eError != PVRSRV_OK)
-	{
-		PVR_DPF((PVR_DBG_WARNING, "RGXScheduleProcessQueuesKM: failed to transition RGX to ON (%s)",
-					PVRSRVGetErrorStringKM(eError)));
+		/* We don't need to acquire the BridgeLock as this power transition won't
+		   send a command to the FW */
+		eError = PVRSRVSetDevicePowerStateKM(ui32DeviceIndex,
+											 PVRSRV_DEV_POWER_STATE_ON,
+											 IMG_FALSE);
+		if (eError != PVRSRV_OK)
+		{
+			PVR_DPF((PVR_DBG_WARNING, "RGXScheduleProcessQueuesKM: failed to transition RGX to ON (%s)",
+						PVRSRVGetErrorStringKM(eError)));
 
-		PVRSRVPowerUnlock();
-		return;
+			PVRSRVDevicePowerUnlock(ui32DeviceIndex, IMG_FALSE);
+			return;
+		}
 	}
 
 	/* uncounted kick for all DMs */
@@ -2431,7 +2805,7 @@ static IMG_VOID _RGXScheduleProcessQueuesMISR(IMG_VOID *pvData)
 		__MTSScheduleWrite(psDevInfo, ui32MTSRegVal);
 	}
 
-	PVRSRVPowerUnlock();
+	PVRSRVDevicePowerUnlock(ui32DeviceIndex, bShared);
 }
 
 PVRSRV_ERROR RGXInstallProcessQueuesMISR(IMG_HANDLE *phMISR, PVRSRV_DEVICE_NODE *psDeviceNode)
@@ -2465,6 +2839,17 @@ PVRSRV_ERROR RGXScheduleCommand(PVRSRV_RGXDEV_INFO 	*psDevInfo,
 								RGXFWIF_KCCB_CMD	*psKCCBCmd,
 								IMG_UINT32			ui32CmdSize,
 								IMG_BOOL			bPDumpContinuous)
+{
+	return RGXScheduleCommandPriority(psDevInfo, eKCCBType, psKCCBCmd, ui32CmdSize,
+									  bPDumpContinuous, RGX_KCCB_PRIORITY_KERNEL);
+}
+
+PVRSRV_ERROR RGXScheduleCommandPriority(PVRSRV_RGXDEV_INFO 	*psDevInfo,
+										RGXFWIF_DM			eKCCBType,
+										RGXFWIF_KCCB_CMD	*psKCCBCmd,
+										IMG_UINT32			ui32CmdSize,
+										IMG_BOOL			bPDumpContinuous,
+										IMG_UINT32			ui32Priority)
 {
 	PVRSRV_DATA *psData = PVRSRVGetPVRSRVData();
 	PVRSRV_ERROR eError;
@@ -2479,7 +2864,7 @@ PVRSRV_ERROR RGXScheduleCommand(PVRSRV_RGXDEV_INFO 	*psDevInfo,
 	eError = RGXPreKickCacheCommand(psDevInfo);
 	if (eError != PVRSRV_OK) goto RGXScheduleCommand_exit;
 
-	eError = RGXSendCommandWithPowLock(psDevInfo, eKCCBType, psKCCBCmd, ui32CmdSize, bPDumpContinuous);
+	eError = _RGXSendCommandWithPowLock(psDevInfo, eKCCBType, psKCCBCmd, ui32CmdSize, bPDumpContinuous, ui32Priority);
 	if (eError != PVRSRV_OK) goto RGXScheduleCommand_exit;
 
 
@@ -2664,7 +3049,7 @@ PVRSRV_ERROR RGXWaitForFWOp(PVRSRV_RGXDEV_INFO	*psDevInfo,
 	IMG_UINT32 count = 0;
 
 	/* Ensure RGX is powered up before kicking MTS */
-	eError = PVRSRVPowerLock();
+	eError = PVRSRVDevicePowerLock(psDeviceNode->sDevId.ui32DeviceIndex, IMG_FALSE, IMG_NULL);
 
 	if (eError != PVRSRV_OK)
 	{
@@ -2762,7 +3147,7 @@ PVRSRV_ERROR RGXWaitForFWOp(PVRSRV_RGXDEV_INFO	*psDevInfo,
 _RGXSendCommandRaw_Exit:
 _PVRSRVSetDevicePowerStateKM_Exit:
 
-	PVRSRVPowerUnlock();
+	PVRSRVDevicePowerUnlock(psDeviceNode->sDevId.ui32DeviceIndex, IMG_FALSE);
 
 _PVRSRVPowerLock_Exit:
 	return eError;
@@ -3072,6 +3457,9 @@ PVRSRV_ERROR ContextSetPriority(RGX_SERVER_COMMON_CONTEXT *psContext,
 		psCmd = (RGXFWIF_CMD_PRIORITY *) pui8CmdPtr;
 		psCmd->ui32Priority = ui32Priority;
 		pui8CmdPtr += sizeof(*psCmd);
+
+		/* Later kicks are admitted to the kernel CCB at the new priority */
+		psContext->ui32Priority = MIN(ui32Priority, RGX_KCCB_PRIORITY_CONTEXT_MAX);
 	}
 
 	/*
@@ -3105,11 +3493,12 @@ PVRSRV_ERROR ContextSetPriority(RGX_SERVER_COMMON_CONTEXT *psContext,
 
 	LOOP_UNTIL_TIMEOUT(MAX_HW_TIME_US)
 	{
-		eError = RGXScheduleCommand(psDevInfo,
-									eDM,
-									&sPriorityCmd,
-									sizeof(sPriorityCmd),
-									IMG_TRUE);
+		eError = RGXScheduleCommandPriority(psDevInfo,
+											eDM,
+											&sPriorityCmd,
+											sizeof(sPriorityCmd),
+											IMG_TRUE,
+											psContext->ui32Priority);
 		if (eError != PVRSRV_ERROR_RETRY)
 		{
 			break;
@@ -3171,6 +3560,117 @@ PVRSRV_ERROR RGXReadMETAReg(PVRSRV_RGXDEV_INFO	*psDevInfo, IMG_UINT32 ui32RegAdd
 }
 
 
+static IMG_VOID _RGXCheckContextProgressLocked(PVRSRV_RGXDEV_INFO *psDevInfo)
+{
+	IMG_UINT32 ui32Epoch = psDevInfo->ui32StallTrackEpoch;
+	IMG_UINT32 ui32Word;
+
+	for (ui32Word = 0; ui32Word < OS_BITMAP_WORDS(RGX_STALL_TRACK_MAX_CTXS); ui32Word++)
+	{
+		IMG_UINTPTR_T uiActive = psDevInfo->auiStallTrackActiveMap[ui32Word];
+
+		while (uiActive != 0)
+		{
+			IMG_UINT32 ui32Bit = _StallTrackFirstBit(uiActive);
+			IMG_UINTPTR_T uiMask = (IMG_UINTPTR_T)1 << ui32Bit;
+			IMG_UINT32 ui32Slot = (ui32Word * OS_BITMAP_WORD_BITS) + ui32Bit;
+			RGX_SERVER_COMMON_CONTEXT *psServerCommonContext = psDevInfo->apsStallTrackCtxts[ui32Slot];
+			IMG_UINT32 ui32ReadOffset;
+			IMG_BOOL bProgress;
+
+			uiActive &= ~uiMask;
+			if (psServerCommonContext == IMG_NULL)
+			{
+				continue;
+			}
+
+			ui32ReadOffset = RGXGetReadOffsetCCB(psServerCommonContext->psClientCCB);
+			if (ui32ReadOffset == RGXGetHostWriteOffsetCCB(psServerCommonContext->psClientCCB))
+			{
+				/* Everything consumed, drop the context unless a kick raced with us */
+				OSAtomicClearBit(ui32Slot, psDevInfo->auiStallTrackActiveMap);
+				OSMemoryBarrier();
+				if (ui32ReadOffset != RGXGetHostWriteOffsetCCB(psServerCommonContext->psClientCCB))
+				{
+					OSAtomicSetBit(ui32Slot, psDevInfo->auiStallTrackActiveMap);
+				}
+				bProgress = IMG_TRUE;
+			}
+			else
+			{
+				bProgress = (ui32ReadOffset != psServerCommonContext->ui32LastReadOffset) ? IMG_TRUE : IMG_FALSE;
+			}
+
+			if (bProgress)
+			{
+				psServerCommonContext->ui32LastReadOffset = ui32ReadOffset;
+				psServerCommonContext->ui32ProgressEpoch = ui32Epoch;
+				if (psDevInfo->auiStallTrackStalledMap[ui32Word] & uiMask)
+				{
+					psDevInfo->auiStallTrackStalledMap[ui32Word] &= ~uiMask;
+					psDevInfo->ui32StalledCtxtCount--;
+				}
+			}
+			else if ((ui32Epoch - psServerCommonContext->ui32ProgressEpoch) >= RGX_STALL_TRACK_EPOCHS &&
+					 (psDevInfo->auiStallTrackStalledMap[ui32Word] & uiMask) == 0)
+			{
+				psDevInfo->auiStallTrackStalledMap[ui32Word] |= uiMask;
+				psDevInfo->ui32StalledCtxtCount++;
+			}
+		}
+	}
+
+	psDevInfo->ui32StallTrackSampledEpoch = ui32Epoch;
+}
+
+IMG_VOID RGXCheckContextProgress(PVRSRV_RGXDEV_INFO *psDevInfo)
+{
+	OSLockAcquire(psDevInfo->hStallTrackLock);
+	_RGXCheckContextProgressLocked(psDevInfo);
+	OSLockRelease(psDevInfo->hStallTrackLock);
+}
+
+IMG_BOOL RGXDumpStalledContexts(PVRSRV_RGXDEV_INFO *psDevInfo)
+{
+	IMG_UINT32 ui32Word;
+
+	if (psDevInfo->hStallTrackLock == IMG_NULL)
+	{
+		return IMG_FALSE;
+	}
+
+	OSLockAcquire(psDevInfo->hStallTrackLock);
+	if (psDevInfo->ui32UntrackedCtxtCount != 0)
+	{
+		OSLockRelease(psDevInfo->hStallTrackLock);
+		return IMG_FALSE;
+	}
+
+	PVR_LOG(("%u FWCtxs without progress for %u health checks",
+			 psDevInfo->ui32StalledCtxtCount, RGX_STALL_TRACK_EPOCHS));
+
+	for (ui32Word = 0; ui32Word < OS_BITMAP_WORDS(RGX_STALL_TRACK_MAX_CTXS); ui32Word++)
+	{
+		IMG_UINTPTR_T uiActive = psDevInfo->auiStallTrackActiveMap[ui32Word];
+
+		while (uiActive != 0)
+		{
+			IMG_UINT32 ui32Bit = _StallTrackFirstBit(uiActive);
+			RGX_SERVER_COMMON_CONTEXT *psServerCommonContext;
+
+			uiActive &= ~((IMG_UINTPTR_T)1 << ui32Bit);
+			psServerCommonContext = psDevInfo->apsStallTrackCtxts[(ui32Word * OS_BITMAP_WORD_BITS) + ui32Bit];
+			if (psServerCommonContext != IMG_NULL)
+			{
+				DumpStalledFWCommonContext(psServerCommonContext);
+			}
+		}
+	}
+	OSLockRelease(psDevInfo->hStallTrackLock);
+
+	return IMG_TRUE;
+}
+
 /*
 	RGXUpdateHealthStatus
 */
@@ -3313,6 +3813,29 @@ PVRSRV_ERROR RGXUpdateHealthStatus(PVRSRV_DEVICE_NODE* psDevNode,
 		eNewStatus = PVRSRV_DEVICE_HEALTH_STATUS_DEAD;
 	}
 	
+	/*
+	   Client CCB checks. The MISR keeps the stalled context summary up to
+	   date, only sample here if it has not run during this period...
+	*/
+	if (bCheckAfterTimePassed)
+	{
+		IMG_UINT32  ui32StalledCtxtCount;
+
+		OSLockAcquire(psDevInfo->hStallTrackLock);
+		if (psDevInfo->ui32StallTrackSampledEpoch != psDevInfo->ui32StallTrackEpoch)
+		{
+			_RGXCheckContextProgressLocked(psDevInfo);
+		}
+		psDevInfo->ui32StallTrackEpoch++;
+		ui32StalledCtxtCount = psDevInfo->ui32StalledCtxtCount;
+		OSLockRelease(psDevInfo->hStallTrackLock);
+
+		if (ui32StalledCtxtCount != 0)
+		{
+			PVR_DPF((PVR_DBG_WARNING, "RGXGetDeviceHealthStatus: No progress on %u client CCBs", ui32StalledCtxtCount));
+		}
+	}
+
 	/*
 	   If no commands are currently pending and nothing happened since the last poll, then
 	   schedule a dummy command to ping the firmware so we know it is alive and processing.
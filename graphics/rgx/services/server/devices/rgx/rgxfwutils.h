@@ -256,6 +256,10 @@ IMG_VOID FWCommonContextFree(RGX_SERVER_COMMON_CONTEXT *psServerCommonContext);
 
 PRGXFWIF_FWCOMMONCONTEXT FWCommonContextGetFWAddress(RGX_SERVER_COMMON_CONTEXT *psServerCommonContext);
 
+IMG_UINT32 FWCommonContextGetPriority(RGX_SERVER_COMMON_CONTEXT *psServerCommonContext);
+
+IMG_VOID FWCommonContextMarkActive(RGX_SERVER_COMMON_CONTEXT *psServerCommonContext);
+
 RGX_CLIENT_CCB *FWCommonContextGetClientCCB(RGX_SERVER_COMMON_CONTEXT *psServerCommonContext);
 
 RGXFWIF_CONTEXT_RESET_REASON FWCommonContextGetLastResetReason(RGX_SERVER_COMMON_CONTEXT *psServerCommonContext);
@@ -351,6 +355,36 @@ PVRSRV_ERROR RGXScheduleCommand(PVRSRV_RGXDEV_INFO 	*psDevInfo,
 								IMG_UINT32			ui32CmdSize,
 								IMG_BOOL			bPDumpContinuous);
 
+/*************************************************************************/ /*!
+@Function       RGXScheduleCommandPriority
+
+@Description    As RGXScheduleCommand, for a command kicking a context. If
+				other submitters are waiting for the kernel CCB the command
+				is admitted in order of ui32Priority, aged by the time each
+				submitter has waited. RGXScheduleCommand admits ahead of all
+				contexts.
+
+@Input          psDevInfo			Device Info
+@Input          eDM					To which DM the cmd is sent.
+@Input          psKCCBCmd			The cmd to send.
+@Input          ui32CmdSize			The cmd size.
+@Input          bPDumpContinuous
+@Input          ui32Priority		Priority of the kicked context, see
+									FWCommonContextGetPriority().
+
+@Return			PVRSRV_ERROR
+*/ /**************************************************************************/
+PVRSRV_ERROR RGXScheduleCommandPriority(PVRSRV_RGXDEV_INFO 	*psDevInfo,
+										RGXFWIF_DM			eKCCBType,
+										RGXFWIF_KCCB_CMD	*psKCCBCmd,
+										IMG_UINT32			ui32CmdSize,
+										IMG_BOOL			bPDumpContinuous,
+										IMG_UINT32			ui32Priority);
+
+PVRSRV_ERROR RGXKCCBGateInit(RGX_KCCB_GATE *psGate);
+
+IMG_VOID RGXKCCBGateDeInit(RGX_KCCB_GATE *psGate);
+
 /*************************************************************************/ /*!
 @Function       RGXScheduleCommandAndWait
 
@@ -548,6 +582,35 @@ PVRSRV_ERROR RGXReadMETAReg(PVRSRV_RGXDEV_INFO	*psDevInfo,
  ******************************************************************************/
 IMG_VOID RGXCheckFirmwareCCBs(PVRSRV_RGXDEV_INFO *psDevInfo);
 
+/*!
+******************************************************************************
+
+ @Function	RGXCheckContextProgress
+
+ @Description Samples the client CCB read offset of every context that has
+              work outstanding and updates the device's stalled context
+              summary. Contexts without outstanding work are not visited.
+
+ @Input psDevInfo - pointer to device
+
+ ******************************************************************************/
+IMG_VOID RGXCheckContextProgress(PVRSRV_RGXDEV_INFO *psDevInfo);
+
+/*!
+******************************************************************************
+
+ @Function	RGXDumpStalledContexts
+
+ @Description Dumps the command each context with outstanding work is
+              waiting on. Returns IMG_FALSE, without dumping anything, if
+              some contexts are not tracked and the caller has to walk the
+              context lists instead.
+
+ @Input psDevInfo - pointer to device
+
+ ******************************************************************************/
+IMG_BOOL RGXDumpStalledContexts(PVRSRV_RGXDEV_INFO *psDevInfo);
+
 /*!
 ******************************************************************************
 
@@ -64,6 +64,11 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #define HWPERF_TL_STREAM_NAME  "hwperf"
 
+/* Default L1 fill level (percent) at which the MISR wakes the drain worker
+ * and the longest the worker sleeps between drains regardless of level. */
+#define HWPERF_DRAIN_WATERMARK_DEFAULT	50
+#define HWPERF_DRAIN_PERIOD_MS_DEFAULT	50
+
 /* Defined to ensure HWPerf packets are not delayed */
 #define SUPPORT_TL_PROODUCER_CALLBACK 1
 
@@ -213,6 +218,176 @@ e0:
 }
 
 
+/*
+	RGXHWPerfHostFilterPass
+*/
+static INLINE IMG_BOOL RGXHWPerfHostFilterPass(PVRSRV_RGXDEV_INFO *psDevInfo,
+											   RGX_PHWPERF_V2_PACKET_HDR psPkt)
+{
+	IMG_UINT32 ui32Type = RGX_HWPERF_GET_TYPE(psPkt);
+
+	if ((psDevInfo->ui64HWPerfHostEventMask & (IMG_UINT64_C(1) << ui32Type)) == 0)
+	{
+		return IMG_FALSE;
+	}
+
+	/* Only HW packets carry the PID of the originating process */
+	if (psDevInfo->ui32HWPerfHostPID != 0 &&
+		ui32Type >= RGX_HWPERF_HW_TAKICK && ui32Type <= RGX_HWPERF_HW_SHGFINISHED)
+	{
+		RGX_HWPERF_HW_DATA_FIELDS *psHWData =
+			(RGX_HWPERF_HW_DATA_FIELDS *) RGX_HWPERF_GET_PACKET_DATA_BYTES(psPkt);
+
+		return (psHWData->ui32PID == psDevInfo->ui32HWPerfHostPID) ? IMG_TRUE : IMG_FALSE;
+	}
+
+	return IMG_TRUE;
+}
+
+
+/*
+	RGXHWPerfCopyFilteredL1toL2
+
+	Moves only the packets passing the host filter into the L2 stream.
+	Consecutive passing packets are copied as one run. Returns the number
+	of L1 bytes consumed, which includes the packets that were dropped.
+*/
+static IMG_UINT32 RGXHWPerfCopyFilteredL1toL2(PVRSRV_RGXDEV_INFO *psDevInfo,
+											  IMG_BYTE   *pbFwBuffer,
+											  IMG_UINT32 ui32BytesExp)
+{
+	IMG_HANDLE   hHWPerfStream = psDevInfo->hHWPerfStream;
+	RGX_PHWPERF_V2_PACKET_HDR psCurPkt;
+	IMG_BYTE     *pbL2Buffer;
+	IMG_UINT32   ui32L2BufFree;
+	IMG_UINT32   ui32Offset;
+	IMG_UINT32   ui32BytesConsumed = ui32BytesExp;
+	IMG_UINT32   ui32BytesPass = 0;
+	IMG_UINT32   ui32BytesPassMin = 0;
+	IMG_UINT32   ui32RunStart, ui32RunSize = 0, ui32Written = 0;
+	IMG_UINT32   ui32Dropped = 0;
+	PVRSRV_ERROR eError;
+
+	/* Size up the packets that pass the filter */
+	for (ui32Offset = 0; ui32Offset < ui32BytesExp; ui32Offset += RGX_HWPERF_GET_SIZE(psCurPkt))
+	{
+		psCurPkt = RGX_HWPERF_GET_PACKET(pbFwBuffer + ui32Offset);
+		if (RGXHWPerfHostFilterPass(psDevInfo, psCurPkt))
+		{
+			if (ui32BytesPassMin == 0)
+			{
+				ui32BytesPassMin = RGX_HWPERF_GET_SIZE(psCurPkt);
+			}
+			ui32BytesPass += RGX_HWPERF_GET_SIZE(psCurPkt);
+		}
+		else
+		{
+			ui32Dropped++;
+		}
+	}
+
+	if (ui32BytesPass == 0)
+	{
+		/* Nothing of interest, consume the lot without touching L2 */
+		psDevInfo->ui32HWPerfHostFiltered += ui32Dropped;
+		return ui32BytesExp;
+	}
+
+	eError = TLStreamReserve2(hHWPerfStream,
+							  &pbL2Buffer,
+							  (IMG_SIZE_T)ui32BytesPass, ui32BytesPassMin,
+							  &ui32L2BufFree);
+	if (eError == PVRSRV_ERROR_STREAM_FULL)
+	{
+		/* Trim to the passing packets which fit, stop consuming L1 at the
+		 * first one that does not so it is retried on the next pass. */
+		ui32BytesPass = 0;
+		ui32Dropped = 0;
+		for (ui32Offset = 0; ui32Offset < ui32BytesExp; ui32Offset += RGX_HWPERF_GET_SIZE(psCurPkt))
+		{
+			psCurPkt = RGX_HWPERF_GET_PACKET(pbFwBuffer + ui32Offset);
+			if (RGXHWPerfHostFilterPass(psDevInfo, psCurPkt))
+			{
+				if (ui32BytesPass + RGX_HWPERF_GET_SIZE(psCurPkt) >= ui32L2BufFree)
+				{
+					break;
+				}
+				ui32BytesPass += RGX_HWPERF_GET_SIZE(psCurPkt);
+			}
+			else
+			{
+				ui32Dropped++;
+			}
+		}
+		ui32BytesConsumed = ui32Offset;
+
+		if (ui32BytesPass == 0)
+		{
+			/* Only filtered packets ahead of the first that didn't fit */
+			psDevInfo->ui32HWPerfHostFiltered += ui32Dropped;
+			PVR_DPF((PVR_DBG_MESSAGE, "Can not find space in host buffer, check data in case of packet loss, remaining free space: %d", ui32L2BufFree));
+			return ui32BytesConsumed;
+		}
+
+		eError = TLStreamReserve(hHWPerfStream, &pbL2Buffer, (IMG_SIZE_T)ui32BytesPass);
+	}
+	if (eError != PVRSRV_OK)
+	{
+		if (eError != PVRSRV_ERROR_STREAM_FULL)
+		{
+			PVR_DPF((PVR_DBG_ERROR,
+					 "HWPerf enabled: Unexpected Error ( %d ) while copying FW buffer to TL buffer.",
+					 eError));
+		}
+		return 0;
+	}
+
+	/* Copy runs of consecutive passing packets */
+	ui32RunStart = 0;
+	for (ui32Offset = 0; ui32Offset < ui32BytesConsumed; ui32Offset += RGX_HWPERF_GET_SIZE(psCurPkt))
+	{
+		psCurPkt = RGX_HWPERF_GET_PACKET(pbFwBuffer + ui32Offset);
+		if (RGXHWPerfHostFilterPass(psDevInfo, psCurPkt))
+		{
+			if (ui32RunSize == 0)
+			{
+				ui32RunStart = ui32Offset;
+			}
+			ui32RunSize += RGX_HWPERF_GET_SIZE(psCurPkt);
+		}
+		else
+		{
+			if (ui32RunSize != 0)
+			{
+				OSMemCopy(pbL2Buffer + ui32Written, pbFwBuffer + ui32RunStart, ui32RunSize);
+				ui32Written += ui32RunSize;
+				ui32RunSize = 0;
+			}
+		}
+	}
+	if (ui32RunSize != 0)
+	{
+		OSMemCopy(pbL2Buffer + ui32Written, pbFwBuffer + ui32RunStart, ui32RunSize);
+		ui32Written += ui32RunSize;
+	}
+	PVR_ASSERT(ui32Written == ui32BytesPass);
+
+	eError = TLStreamCommit(hHWPerfStream, (IMG_SIZE_T)ui32Written);
+	if (eError != PVRSRV_OK)
+	{
+		PVR_DPF((PVR_DBG_ERROR,
+				 "TLStreamCommit() failed (%d) in %s(), unable to copy packet from L1 to L2 buffer",
+				 eError, __func__));
+		return 0;
+	}
+
+	/* Every packet in the consumed range that wasn't copied was filtered */
+	psDevInfo->ui32HWPerfHostFiltered += ui32Dropped;
+
+	return ui32BytesConsumed;
+}
+
+
 static INLINE IMG_UINT32 RGXHWPerfAdvanceRIdx(
 		const IMG_UINT32 ui32BufSize,
 		const IMG_UINT32 ui32Pos,
@@ -222,6 +397,33 @@ static INLINE IMG_UINT32 RGXHWPerfAdvanceRIdx(
 }
 
 
+/*
+	RGXHWPerfTransportL1toL2
+*/
+static INLINE IMG_UINT32 RGXHWPerfTransportL1toL2(PVRSRV_RGXDEV_INFO *psDevInfo,
+												  IMG_BYTE   *pbFwBuffer,
+												  IMG_UINT32 ui32BytesExp)
+{
+	IMG_UINT32 ui32BytesDone;
+
+	if (psDevInfo->bHWPerfHostFilter)
+	{
+		ui32BytesDone = RGXHWPerfCopyFilteredL1toL2(psDevInfo, pbFwBuffer, ui32BytesExp);
+	}
+	else
+	{
+		ui32BytesDone = RGXHWPerfCopyDataL1toL2(psDevInfo->hHWPerfStream, pbFwBuffer, ui32BytesExp);
+	}
+
+	if (ui32BytesDone < ui32BytesExp)
+	{
+		psDevInfo->ui32HWPerfL2FullCount++;
+	}
+
+	return ui32BytesDone;
+}
+
+
 /*
 	RGXHWPerfDataStore
 */
@@ -263,7 +465,7 @@ static IMG_UINT32 RGXHWPerfDataStore(PVRSRV_RGXDEV_INFO	*psDevInfo)
 #ifdef HWPERF_MISR_FUNC_DEBUG
 			ui32BytesExpSum += ui32BytesExp;
 #endif
-			ui32BytesCopied = RGXHWPerfCopyDataL1toL2(psDevInfo->hHWPerfStream,
+			ui32BytesCopied = RGXHWPerfTransportL1toL2(psDevInfo,
 													  psHwPerfInfo + ui32SrcRIdx,
 													  ui32BytesExp);
 			ui32BytesCopiedSum += ui32BytesCopied;
@@ -287,7 +489,7 @@ static IMG_UINT32 RGXHWPerfDataStore(PVRSRV_RGXDEV_INFO	*psDevInfo)
 			ui32BytesExpSum += ui32BytesExp;
 #endif
 			/* Attempt to transfer the packets to the TL stream buffer */
-			ui32BytesCopied = RGXHWPerfCopyDataL1toL2(psDevInfo->hHWPerfStream,
+			ui32BytesCopied = RGXHWPerfTransportL1toL2(psDevInfo,
 													  psHwPerfInfo + ui32SrcRIdx,
 													  ui32BytesExp);
 			ui32BytesCopiedSum += ui32BytesCopied;
@@ -316,7 +518,7 @@ static IMG_UINT32 RGXHWPerfDataStore(PVRSRV_RGXDEV_INFO	*psDevInfo)
 #ifdef HWPERF_MISR_FUNC_DEBUG
 				ui32BytesExpSum += ui32BytesExp;
 #endif
-				ui32BytesCopied = RGXHWPerfCopyDataL1toL2(psDevInfo->hHWPerfStream,
+				ui32BytesCopied = RGXHWPerfTransportL1toL2(psDevInfo,
 														  psHwPerfInfo,
 														  ui32BytesExp);
 				ui32BytesCopiedSum += ui32BytesCopied;
@@ -379,6 +581,183 @@ PVRSRV_ERROR RGXHWPerfDataStoreCB(PVRSRV_DEVICE_NODE *psDevInfo)
 }
 
 
+/*
+	RGXHWPerfL1FillLevel
+
+	Percentage of the L1 FW buffer holding packets not yet transported.
+*/
+static IMG_UINT32 RGXHWPerfL1FillLevel(PVRSRV_RGXDEV_INFO *psDevInfo)
+{
+	RGXFWIF_TRACEBUF *psRGXFWIfTraceBufCtl = psDevInfo->psRGXFWIfTraceBuf;
+	IMG_UINT32 ui32SrcRIdx, ui32SrcWIdx, ui32Used;
+
+	ui32SrcRIdx = psRGXFWIfTraceBufCtl->ui32HWPerfRIdx;
+	ui32SrcWIdx = psRGXFWIfTraceBufCtl->ui32HWPerfWIdx;
+	OSMemoryBarrier();
+
+	if (ui32SrcWIdx >= ui32SrcRIdx)
+	{
+		ui32Used = ui32SrcWIdx - ui32SrcRIdx;
+	}
+	else
+	{
+		ui32Used = (psRGXFWIfTraceBufCtl->ui32HWPerfWrapCount - ui32SrcRIdx) + ui32SrcWIdx;
+	}
+
+	return (ui32Used * 100) / psDevInfo->ui32RGXFWIfHWPerfBufSize;
+}
+
+
+/*
+	RGXHWPerfCheckDrain
+
+	Called from the MISR. When the drain worker is running the MISR only
+	checks the L1 fill level and wakes the worker at the watermark, so the
+	MISR's other work does not delay HWPerf transport and vice versa.
+*/
+IMG_VOID RGXHWPerfCheckDrain(PVRSRV_DEVICE_NODE *psDeviceNode)
+{
+	PVRSRV_RGXDEV_INFO *psDevInfo = psDeviceNode->pvDevice;
+
+	if (psDevInfo->hHWPerfDrainThread == IMG_NULL)
+	{
+		(void) RGXHWPerfDataStoreCB(psDeviceNode);
+		return;
+	}
+
+	if (!psDevInfo->bHWPerfDrainRequested &&
+		RGXHWPerfL1FillLevel(psDevInfo) >= psDevInfo->ui32HWPerfDrainWatermark)
+	{
+		psDevInfo->ui64HWPerfDrainRequestTime = OSClockus64();
+		psDevInfo->bHWPerfDrainRequested = IMG_TRUE;
+		psDevInfo->ui32HWPerfDrainWakeups++;
+		(void) OSEventObjectSignal(psDevInfo->hHWPerfDrainEvObj);
+	}
+	else if (psDevInfo->bHWPerfDrainIdle)
+	{
+		/* The GPU is running again, let the worker resume polling */
+		(void) OSEventObjectSignal(psDevInfo->hHWPerfDrainEvObj);
+	}
+}
+
+
+static IMG_VOID RGXHWPerfDrainThread(IMG_PVOID pvData)
+{
+	PVRSRV_DEVICE_NODE *psDeviceNode = pvData;
+	PVRSRV_RGXDEV_INFO *psDevInfo = psDeviceNode->pvDevice;
+	IMG_HANDLE         hOSEvent;
+	IMG_UINT32         ui32LatencyUs;
+	PVRSRV_ERROR       eError;
+
+	eError = OSEventObjectOpen(psDevInfo->hHWPerfDrainEvObj, &hOSEvent);
+	PVR_LOGRN_IF_ERROR(eError, "OSEventObjectOpen");
+
+	while (!psDevInfo->bHWPerfDrainStop)
+	{
+		/* Nothing reaches the L1 buffer while events are disabled or the GPU
+		 * is off, so only poll while both are on and otherwise sleep until
+		 * the MISR or PVRSRVRGXCtrlHWPerfKM() signals us.
+		 */
+		if (psDevInfo->bHWPerfEventsEnabled &&
+			PVRSRVIsDevicePowered(psDeviceNode->sDevId.ui32DeviceIndex))
+		{
+			psDevInfo->bHWPerfDrainIdle = IMG_FALSE;
+			eError = OSEventObjectWaitTimeout(hOSEvent, psDevInfo->ui32HWPerfDrainPeriodMs);
+		}
+		else
+		{
+			psDevInfo->bHWPerfDrainIdle = IMG_TRUE;
+			eError = OSEventObjectWaitUntimed(hOSEvent);
+			psDevInfo->bHWPerfDrainIdle = IMG_FALSE;
+		}
+		if (eError != PVRSRV_OK && eError != PVRSRV_ERROR_TIMEOUT)
+		{
+			PVR_DPF((PVR_DBG_ERROR, "RGXHWPerfDrainThread: "
+					"Error (%d) when waiting for event!", eError));
+		}
+
+		if (psDevInfo->bHWPerfDrainStop)
+		{
+			break;
+		}
+
+		(void) RGXHWPerfDataStoreCB(psDeviceNode);
+
+		if (psDevInfo->bHWPerfDrainRequested)
+		{
+			ui32LatencyUs = (IMG_UINT32)(OSClockus64() - psDevInfo->ui64HWPerfDrainRequestTime);
+			psDevInfo->ui32HWPerfDrainLatencyLastUs = ui32LatencyUs;
+			if (ui32LatencyUs > psDevInfo->ui32HWPerfDrainLatencyMaxUs)
+			{
+				psDevInfo->ui32HWPerfDrainLatencyMaxUs = ui32LatencyUs;
+			}
+			psDevInfo->bHWPerfDrainRequested = IMG_FALSE;
+		}
+	}
+
+	eError = OSEventObjectClose(hOSEvent);
+	PVR_LOG_IF_ERROR(eError, "OSEventObjectClose");
+}
+
+
+static PVRSRV_ERROR RGXHWPerfDrainStart(PVRSRV_DEVICE_NODE *psDeviceNode)
+{
+	PVRSRV_RGXDEV_INFO *psDevInfo = psDeviceNode->pvDevice;
+	PVRSRV_ERROR eError;
+
+	psDevInfo->bHWPerfDrainStop = IMG_FALSE;
+	psDevInfo->bHWPerfDrainRequested = IMG_FALSE;
+	psDevInfo->bHWPerfDrainIdle = IMG_FALSE;
+	if (psDevInfo->ui32HWPerfDrainWatermark == 0)
+	{
+		psDevInfo->ui32HWPerfDrainWatermark = HWPERF_DRAIN_WATERMARK_DEFAULT;
+	}
+	if (psDevInfo->ui32HWPerfDrainPeriodMs == 0)
+	{
+		psDevInfo->ui32HWPerfDrainPeriodMs = HWPERF_DRAIN_PERIOD_MS_DEFAULT;
+	}
+
+	eError = OSEventObjectCreate("PVRSRV_HWPERF_DRAIN_EVENTOBJECT", &psDevInfo->hHWPerfDrainEvObj);
+	PVR_LOGR_IF_ERROR(eError, "OSEventObjectCreate");
+
+	eError = OSThreadCreate(&psDevInfo->hHWPerfDrainThread,
+							"pvr_hwperf_drain",
+							RGXHWPerfDrainThread,
+							psDeviceNode);
+	PVR_LOGG_IF_ERROR(eError, "OSThreadCreate", e0);
+
+	return PVRSRV_OK;
+
+e0:
+	OSEventObjectDestroy(psDevInfo->hHWPerfDrainEvObj);
+	psDevInfo->hHWPerfDrainEvObj = IMG_NULL;
+	psDevInfo->hHWPerfDrainThread = IMG_NULL;
+	return eError;
+}
+
+
+static IMG_VOID RGXHWPerfDrainStop(PVRSRV_RGXDEV_INFO *psDevInfo)
+{
+	PVRSRV_ERROR eError;
+
+	if (psDevInfo->hHWPerfDrainThread)
+	{
+		psDevInfo->bHWPerfDrainStop = IMG_TRUE;
+		eError = OSEventObjectSignal(psDevInfo->hHWPerfDrainEvObj);
+		PVR_LOG_IF_ERROR(eError, "OSEventObjectSignal");
+		eError = OSThreadDestroy(psDevInfo->hHWPerfDrainThread);
+		PVR_LOG_IF_ERROR(eError, "OSThreadDestroy");
+		psDevInfo->hHWPerfDrainThread = IMG_NULL;
+	}
+	if (psDevInfo->hHWPerfDrainEvObj)
+	{
+		eError = OSEventObjectDestroy(psDevInfo->hHWPerfDrainEvObj);
+		PVR_LOG_IF_ERROR(eError, "OSEventObjectDestroy");
+		psDevInfo->hHWPerfDrainEvObj = IMG_NULL;
+	}
+}
+
+
 /* Not currently supported by default */
 #if defined(SUPPORT_TL_PROODUCER_CALLBACK)
 static PVRSRV_ERROR RGXHWPerfTLCB(IMG_HANDLE hStream,
@@ -444,6 +823,8 @@ PVRSRV_ERROR RGXHWPerfInit(PVRSRV_DEVICE_NODE *psRgxDevNode, IMG_BOOL bEnable)
 	 */
 	gpsRgxDevInfo->hLockHWPerfStream = IMG_NULL;
 	gpsRgxDevInfo->hHWPerfStream = IMG_NULL;
+	gpsRgxDevInfo->hHWPerfDrainThread = IMG_NULL;
+	gpsRgxDevInfo->hHWPerfDrainEvObj = IMG_NULL;
 
 	/* Does the caller want to enable data collection resources? */
 	if (!bEnable)
@@ -478,8 +859,13 @@ PVRSRV_ERROR RGXHWPerfInit(PVRSRV_DEVICE_NODE *psRgxDevNode, IMG_BOOL bEnable)
 
 	PVR_LOGG_IF_ERROR(eError, "TLStreamCreate", e1);
 
+	eError = RGXHWPerfDrainStart(gpsRgxDevNode);
+	PVR_LOGG_IF_ERROR(eError, "RGXHWPerfDrainStart", e2);
+
 	PVR_DPF_RETURN_OK;
 
+e2:
+	TLStreamClose(gpsRgxDevInfo->hHWPerfStream);
 e1:
 	OSLockDestroy(gpsRgxDevInfo->hLockHWPerfStream);
 	gpsRgxDevInfo->hLockHWPerfStream = IMG_NULL;
@@ -493,6 +879,13 @@ IMG_VOID RGXHWPerfDeinit(void)
 {
 	PVR_DPF_ENTERED;
 
+	/* Stop the drain worker before the stream it writes to goes away
+	 */
+	if (gpsRgxDevInfo)
+	{
+		RGXHWPerfDrainStop(gpsRgxDevInfo);
+	}
+
 	/* Clean up the stream and lock objects if allocated
 	 */
 	if (gpsRgxDevInfo && gpsRgxDevInfo->hHWPerfStream)
@@ -575,6 +968,13 @@ PVRSRV_ERROR PVRSRVRGXCtrlHWPerfKM(
 
 	/* PVR_DPF((PVR_DBG_VERBOSE, "PVRSRVRGXCtrlHWPerfKM firmware completed")); */
 
+	/* Switch the drain worker between polling and sleeping */
+	psDevice->bHWPerfEventsEnabled = (bEnable && ui64Mask != 0) ? IMG_TRUE : IMG_FALSE;
+	if (psDevice->hHWPerfDrainEvObj)
+	{
+		(void) OSEventObjectSignal(psDevice->hHWPerfDrainEvObj);
+	}
+
 	/* If it was being asked to disable then don't delete the stream as the FW
 	 * will continue to generate events during the disabling phase. Clean up
 	 * will be done when the driver is unloaded.
@@ -604,6 +1004,70 @@ PVRSRV_ERROR PVRSRVRGXCtrlHWPerfKM(
 }
 
 
+/*
+	PVRSRVRGXSetHWPerfHostFilterKM
+*/
+PVRSRV_ERROR PVRSRVRGXSetHWPerfHostFilterKM(
+		PVRSRV_DEVICE_NODE*	psDeviceNode,
+		IMG_UINT64			ui64EventMask,
+		IMG_UINT32			ui32PID)
+{
+	PVRSRV_ERROR 		eError;
+	PVRSRV_RGXDEV_INFO* psDevice;
+
+	PVR_DPF_ENTERED;
+	PVR_ASSERT(psDeviceNode);
+	psDevice = psDeviceNode->pvDevice;
+
+	if (psDevice->hHWPerfStream == 0)
+	{
+		eError = RGXHWPerfInit(psDeviceNode, IMG_TRUE);
+		PVR_LOGR_IF_ERROR(eError, "RGXHWPerfInit");
+	}
+
+	/* Packets already in the L1 buffer are transported using the new filter */
+	OSLockAcquire(psDevice->hLockHWPerfStream);
+	psDevice->ui64HWPerfHostEventMask = ui64EventMask;
+	psDevice->ui32HWPerfHostPID = ui32PID;
+	psDevice->bHWPerfHostFilter = (ui64EventMask != IMG_UINT64_C(0xFFFFFFFFFFFFFFFF) || ui32PID != 0) ? IMG_TRUE : IMG_FALSE;
+	OSLockRelease(psDevice->hLockHWPerfStream);
+
+	PVR_DPF((PVR_DBG_MESSAGE, "HWPerf host filter set (%llx, PID %u)", ui64EventMask, ui32PID));
+
+	PVR_DPF_RETURN_OK;
+}
+
+
+/*
+	PVRSRVRGXSetHWPerfDrainKM
+*/
+PVRSRV_ERROR PVRSRVRGXSetHWPerfDrainKM(
+		PVRSRV_DEVICE_NODE*	psDeviceNode,
+		IMG_UINT32			ui32WatermarkPercent,
+		IMG_UINT32			ui32PeriodMs)
+{
+	PVRSRV_RGXDEV_INFO* psDevice;
+
+	PVR_ASSERT(psDeviceNode);
+	psDevice = psDeviceNode->pvDevice;
+
+	if (ui32WatermarkPercent == 0 || ui32WatermarkPercent > 100 || ui32PeriodMs == 0)
+	{
+		return PVRSRV_ERROR_INVALID_PARAMS;
+	}
+
+	/* Wake the worker so its next wait uses the new period */
+	psDevice->ui32HWPerfDrainWatermark = ui32WatermarkPercent;
+	psDevice->ui32HWPerfDrainPeriodMs = ui32PeriodMs;
+	if (psDevice->hHWPerfDrainEvObj)
+	{
+		(void) OSEventObjectSignal(psDevice->hHWPerfDrainEvObj);
+	}
+
+	return PVRSRV_OK;
+}
+
+
 /*
 	PVRSRVRGXEnableHWPerfCountersKM
 */
@@ -58,6 +58,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  *****************************************************************************/
 
 PVRSRV_ERROR RGXHWPerfDataStoreCB(PVRSRV_DEVICE_NODE* psDevInfo);
+IMG_VOID RGXHWPerfCheckDrain(PVRSRV_DEVICE_NODE *psDeviceNode);
 
 PVRSRV_ERROR RGXHWPerfInit(PVRSRV_DEVICE_NODE *psRgxDevInfo, IMG_BOOL bEnable);
 IMG_VOID RGXHWPerfDeinit(void);
@@ -73,6 +74,16 @@ PVRSRV_ERROR PVRSRVRGXCtrlHWPerfKM(
 		IMG_UINT64 			ui64Mask);
 
 
+PVRSRV_ERROR PVRSRVRGXSetHWPerfHostFilterKM(
+		PVRSRV_DEVICE_NODE*	psDeviceNode,
+		IMG_UINT64			ui64EventMask,
+		IMG_UINT32			ui32PID);
+
+PVRSRV_ERROR PVRSRVRGXSetHWPerfDrainKM(
+		PVRSRV_DEVICE_NODE*	psDeviceNode,
+		IMG_UINT32			ui32WatermarkPercent,
+		IMG_UINT32			ui32PeriodMs);
+
 PVRSRV_ERROR PVRSRVRGXConfigEnableHWPerfCountersKM(
 		PVRSRV_DEVICE_NODE* 		psDeviceNode,
 		IMG_UINT32 					ui32ArrayLen,
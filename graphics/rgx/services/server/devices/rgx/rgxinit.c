@@ -66,6 +66,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "rgxdebug.h"
 #include "rgxhwperf.h"
+#include "rgxfwtrace.h"
 
 #include "rgx_options_km.h"
 #include "pvrversion.h"
@@ -285,7 +286,21 @@ static IMG_VOID RGXCheckFWActivePowerState(PVRSRV_DEVICE_NODE *psDeviceNode)
 			PVRSRVDebugRequest(DEBUG_REQUEST_VERBOSITY_MAX);
 		}
 	}
+	else
+	{
+		/* Busy again, a deferred power-down is no longer wanted */
+		RGXActivePowerRecheck(psDevInfo, IMG_FALSE, 0);
+	}
+
+}
 
+static IMG_VOID RGXActivePowerRecheckTimer(IMG_VOID *pvData)
+{
+	PVRSRV_DEVICE_NODE *psDeviceNode = pvData;
+	PVRSRV_RGXDEV_INFO *psDevInfo = psDeviceNode->pvDevice;
+
+	/* The power-down handshake needs the bridge lock, so run it from the MISR */
+	OSScheduleMISR(psDevInfo->pvMISRData);
 }
 
 static RGXFWIF_GPU_UTIL_STATS RGXGetGpuUtilStats(PVRSRV_DEVICE_NODE *psDeviceNode)
@@ -301,19 +316,21 @@ static RGXFWIF_GPU_UTIL_STATS RGXGetGpuUtilStats(PVRSRV_DEVICE_NODE *psDeviceNod
 	RGXFWIF_GPU_UTIL_STATS	sRet;
 	PVRSRV_DEV_POWER_STATE	ePowerState;
 	PVRSRV_ERROR            eError;
+	IMG_BOOL				bShared;
 
 	sRet.ui32GpuStatActive	= 0;
 	sRet.ui32GpuStatBlocked	= 0;
 	sRet.ui32GpuStatIdle	= 0;
 	sRet.bPoweredOn			= IMG_FALSE;
 
-	/* take the power lock as we issue an OSReadHWReg64 below */
-	PVRSRVForcedPowerLock();
+	/* take the power lock as we issue an OSReadHWReg64 below; shared access
+	   is enough as this only reads */
+	PVRSRVDevicePowerLock(psDeviceNode->sDevId.ui32DeviceIndex, IMG_TRUE, &bShared);
 
 	PVRSRVGetDevicePowerState(psDeviceNode->sDevId.ui32DeviceIndex, &ePowerState);
     if (ePowerState != PVRSRV_DEV_POWER_STATE_ON)
 	{
-		PVRSRVPowerUnlock();
+		PVRSRVDevicePowerUnlock(psDeviceNode->sDevId.ui32DeviceIndex, bShared);
 		return sRet;
 	}
 
@@ -394,7 +411,7 @@ static RGXFWIF_GPU_UTIL_STATS RGXGetGpuUtilStats(PVRSRV_DEVICE_NODE *psDeviceNod
 
 	// INTEL TO REVIEW
 	// DDK1.3@271... put the power unlock before the stats update.
-	PVRSRVPowerUnlock();
+	PVRSRVDevicePowerUnlock(psDeviceNode->sDevId.ui32DeviceIndex, bShared);
 
 	if (ui32StatCumulative)
 	{
@@ -423,13 +440,22 @@ static IMG_VOID RGX_MISRHandler (IMG_VOID *pvData)
 	PVRSRVCheckStatus(psDeviceNode);
 
 	/* Give the HWPerf service a chance to transfer some data from the FW
-	 * buffer to the host driver transport layer buffer.
+	 * buffer to the host driver transport layer buffer. With the drain
+	 * worker running this only wakes it once the watermark is reached.
+	 */
+	RGXHWPerfCheckDrain(psDeviceNode);
+
+	/* Likewise wake the firmware trace stream worker if there are new
+	 * trace entries.
 	 */
-	RGXHWPerfDataStoreCB(psDeviceNode);
+	RGXFWTraceStreamCheck(psDevInfo);
 
 	/* Process all firmware CCBs for pending commands */
 	RGXCheckFirmwareCCBs(psDeviceNode->pvDevice);
 
+	/* Sample the client CCBs of contexts with outstanding work */
+	RGXCheckContextProgress(psDevInfo);
+
 	/* Check APM state */
 	if (psDevInfo->pfnActivePowerCheck)
 	{
@@ -465,6 +491,7 @@ PVRSRV_ERROR PVRSRVRGXInitDevPart2KM (PVRSRV_DEVICE_NODE	*psDeviceNode,
 	PVRSRV_RGXDEV_INFO		*psDevInfo = psDeviceNode->pvDevice;
 	PVRSRV_DEV_POWER_STATE	eDefaultPowerState;
 	PVRSRV_DEVICE_CONFIG	*psDevConfig = psDeviceNode->psDevConfig;
+	RGXFWIF_DM				eKCCBType;
 
 	PDUMPCOMMENT("RGX Initialisation Part 2");
 
@@ -540,11 +567,23 @@ PVRSRV_ERROR PVRSRVRGXInitDevPart2KM (PVRSRV_DEVICE_NODE	*psDeviceNode,
 	RGXHWPerfFTraceGPUEventsEnabledSet((ui32DeviceFlags & RGXKMIF_DEVICE_STATE_FTRACE_EN) ? IMG_TRUE: IMG_FALSE);
 #endif
 
+	/* Initialise the kernel CCB gates, kicks may submit concurrently */
+	for (eKCCBType = 0; eKCCBType < RGXFWIF_DM_MAX; eKCCBType++)
+	{
+		eError = RGXKCCBGateInit(&psDevInfo->asKCCBGate[eKCCBType]);
+		PVR_ASSERT(eError == PVRSRV_OK);
+	}
+
+	/* Initialise the stalled context tracking */
+	eError = OSLockCreate(&psDevInfo->hStallTrackLock, LOCK_TYPE_PASSIVE);
+	PVR_ASSERT(eError == PVRSRV_OK);
+
 	/* Initialise lists of ZSBuffers */
 	eError = OSLockCreate(&psDevInfo->hLockZSBuffer,LOCK_TYPE_PASSIVE);
 	PVR_ASSERT(eError == PVRSRV_OK);
 	dllist_init(&psDevInfo->sZSBufferHead);
 	psDevInfo->ui32ZSBufferCurrID = 1;
+	RGXZSBufferPoolInit(psDevInfo);
 
 	/* Initialise lists of growable Freelists */
 	eError = OSLockCreate(&psDevInfo->hLockFreeList,LOCK_TYPE_PASSIVE);
@@ -552,6 +591,14 @@ PVRSRV_ERROR PVRSRVRGXInitDevPart2KM (PVRSRV_DEVICE_NODE	*psDeviceNode,
 	dllist_init(&psDevInfo->sFreeListHead);
 	psDevInfo->ui32FreelistCurrID = 1;
 
+	/* Initialise the reserve of pre-allocated PB blocks */
+	eError = RGXPBReserveInit(psDevInfo);
+	if (eError != PVRSRV_OK)
+	{
+		PVR_DPF((PVR_DBG_ERROR,"PVRSRVRGXInitDevPart2KM: failed to initialise PB reserve"));
+		return eError;
+	}
+
 	/* Allocate DVFS History */
 	psDevInfo->psGpuDVFSHistory = OSAllocZMem(sizeof(*(psDevInfo->psGpuDVFSHistory)));
 	/* Setup GPU Utilization stat update callback */
@@ -576,6 +623,10 @@ PVRSRV_ERROR PVRSRVRGXInitDevPart2KM (PVRSRV_DEVICE_NODE	*psDeviceNode,
 		if (bEnableAPM)
 		{
 			psDevInfo->pfnActivePowerCheck = RGXCheckFWActivePowerState;
+			RGXAPMPolicyInit(&psDevInfo->sAPMPolicy,
+							 RGX_APM_POLICY_PREDICTIVE,
+							 RGX_APM_BREAK_EVEN_US_DEFAULT,
+							 RGX_APM_HYSTERESIS_US_DEFAULT);
 			/* Prevent the device being woken up before there is something to do. */
 			eDefaultPowerState = PVRSRV_DEV_POWER_STATE_OFF;
 		}
@@ -612,10 +663,29 @@ PVRSRV_ERROR PVRSRVRGXInitDevPart2KM (PVRSRV_DEVICE_NODE	*psDeviceNode,
 		return eError;
 	}
 
+	if (psDevInfo->pfnActivePowerCheck)
+	{
+		/* Only ever armed for a single expiry per deferred decision, with
+		   the delay the APM policy asks for, see RGXActivePowerRecheck */
+		psDevInfo->hAPMTimer = OSAddTimer(RGXActivePowerRecheckTimer, psDeviceNode,
+										  RGX_APM_HYSTERESIS_US_DEFAULT / 1000);
+		if (psDevInfo->hAPMTimer == IMG_NULL)
+		{
+			/* Nothing could bring a deferred decision back, so don't defer */
+			PVR_DPF((PVR_DBG_WARNING,"PVRSRVRGXInitDevPart2KM: no APM timer, powering down as soon as idle"));
+			psDevInfo->sAPMPolicy.eType = RGX_APM_POLICY_IMMEDIATE;
+		}
+	}
+
 	eError = OSInstallDeviceLISR(psDevConfig, &psDevInfo->pvLISRData,
 								 RGX_LISRHandler, psDeviceNode);
 	if (eError != PVRSRV_OK)
 	{
+		if (psDevInfo->hAPMTimer != IMG_NULL)
+		{
+			(IMG_VOID) OSRemoveTimer(psDevInfo->hAPMTimer);
+			psDevInfo->hAPMTimer = IMG_NULL;
+		}
 		(IMG_VOID) OSUninstallMISR(psDevInfo->hProcessQueuesMISR);
 		(IMG_VOID) OSUninstallMISR(psDevInfo->pvMISRData);
 		return eError;
@@ -1221,6 +1291,7 @@ PVRSRV_ERROR DevDeInitRGX (PVRSRV_DEVICE_NODE *psDeviceNode)
 	PVRSRV_RGXDEV_INFO			*psDevInfo = (PVRSRV_RGXDEV_INFO*)psDeviceNode->pvDevice;
 	PVRSRV_ERROR				eError;
 	DEVICE_MEMORY_INFO		    *psDevMemoryInfo;
+	RGXFWIF_DM					eKCCBType;
 
 	if (!psDevInfo)
 	{
@@ -1254,6 +1325,12 @@ PVRSRV_ERROR DevDeInitRGX (PVRSRV_DEVICE_NODE *psDeviceNode)
 
 #if !defined(NO_HARDWARE)
 		(IMG_VOID) OSUninstallDeviceLISR(psDevInfo->pvLISRData);
+		if (psDevInfo->hAPMTimer != IMG_NULL)
+		{
+			RGXActivePowerRecheck(psDevInfo, IMG_FALSE, 0);
+			(IMG_VOID) OSRemoveTimer(psDevInfo->hAPMTimer);
+			psDevInfo->hAPMTimer = IMG_NULL;
+		}
 		(IMG_VOID) OSUninstallMISR(psDevInfo->pvMISRData);
 		(IMG_VOID) OSUninstallMISR(psDevInfo->hProcessQueuesMISR);
 #endif /* !NO_HARDWARE */
@@ -1273,6 +1350,8 @@ PVRSRV_ERROR DevDeInitRGX (PVRSRV_DEVICE_NODE *psDeviceNode)
 		}
 
 		/* De-init Freelists/ZBuffers... */
+		RGXPBReserveDeInit(psDevInfo);
+		RGXZSBufferPoolFlush(psDevInfo);
 		OSLockDestroy(psDevInfo->hLockFreeList);
 		OSLockDestroy(psDevInfo->hLockZSBuffer);
 
@@ -1344,6 +1423,18 @@ PVRSRV_ERROR DevDeInitRGX (PVRSRV_DEVICE_NODE *psDeviceNode)
 	 */
 	RGXFreeFirmware(psDevInfo);
 
+	/* No kernel CCB commands can be sent from here on */
+	for (eKCCBType = 0; eKCCBType < RGXFWIF_DM_MAX; eKCCBType++)
+	{
+		RGXKCCBGateDeInit(&psDevInfo->asKCCBGate[eKCCBType]);
+	}
+
+	if (psDevInfo->hStallTrackLock != IMG_NULL)
+	{
+		OSLockDestroy(psDevInfo->hStallTrackLock);
+		psDevInfo->hStallTrackLock = IMG_NULL;
+	}
+
 	/*
 	 * Clear the mem context create callbacks before destroying the RGX firmware
 	 * context to avoid a spurious callback.
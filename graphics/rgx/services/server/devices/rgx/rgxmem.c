@@ -179,9 +179,10 @@ PVRSRV_ERROR RGXPreKickCacheCommand(PVRSRV_RGXDEV_INFO 	*psDevInfo)
 	sFlushCmd.uCmdData.sMMUCacheData.psMemoryContext = ???
 #endif
 
-	/* PVRSRVPowerLock guarantees atomicity between commands and global variables consistency.
-	 * This is helpful in a scenario with several applications allocating resources. */
-	eError = PVRSRVPowerLock();
+	/* Exclusive access to the device power lock guarantees atomicity between commands and
+	 * global variables consistency. This is helpful in a scenario with several applications
+	 * allocating resources. */
+	eError = PVRSRVDevicePowerLock(psDeviceNode->sDevId.ui32DeviceIndex, IMG_FALSE, IMG_NULL);
 
 	if (eError != PVRSRV_OK)
 	{
@@ -232,7 +233,7 @@ PVRSRV_ERROR RGXPreKickCacheCommand(PVRSRV_RGXDEV_INFO 	*psDevInfo)
 	while(eDMcount > 0);
 
 _PVRSRVSetDevicePowerStateKM_Exit:
-	PVRSRVPowerUnlock();
+	PVRSRVDevicePowerUnlock(psDeviceNode->sDevId.ui32DeviceIndex, IMG_FALSE);
 
 _PVRSRVPowerLock_Exit:
 	return eError;
@@ -360,6 +360,37 @@ static IMG_VOID RGXAXIACELiteInit(PVRSRV_RGXDEV_INFO *psDevInfo)
 }
 #endif
 
+/*!
+*******************************************************************************
+
+ @Function	RGXPowerPhaseEnd
+
+ @Description Account the time spent in a power-up phase
+
+ @Input psDevInfo - device info structure
+ @Input ePhase - phase which has just finished
+ @Input ui32StartUs - OSClockus() when the phase started
+
+ @Return   IMG_UINT32 - OSClockus() now, the start of the next phase
+
+******************************************************************************/
+static IMG_UINT32 RGXPowerPhaseEnd(PVRSRV_RGXDEV_INFO	*psDevInfo,
+								   RGX_POWER_PHASE		ePhase,
+								   IMG_UINT32			ui32StartUs)
+{
+	RGX_POWER_TIMING	*psTiming = &psDevInfo->sPowerTiming;
+	IMG_UINT32			ui32NowUs = OSClockus();
+	IMG_UINT32			ui32DeltaUs = ui32NowUs - ui32StartUs;
+
+	psTiming->aui32LastUs[ePhase] = ui32DeltaUs;
+	if (ui32DeltaUs > psTiming->aui32MaxUs[ePhase])
+	{
+		psTiming->aui32MaxUs[ePhase] = ui32DeltaUs;
+	}
+
+	return ui32NowUs;
+}
+
 /*!
 *******************************************************************************
 
@@ -367,17 +398,17 @@ static IMG_VOID RGXAXIACELiteInit(PVRSRV_RGXDEV_INFO *psDevInfo)
 
  @Description
 
- (client invoked) chip-reset and initialisation
+ (client invoked) chip-reset and initialisation. Takes META out of reset
+ but does not wait for the firmware, see RGXWaitForFWStart.
 
  @Input psDevInfo - device info structure
 
- @Return   PVRSRV_ERROR
+ @Return   IMG_VOID
 
 ******************************************************************************/
-static PVRSRV_ERROR RGXStart(PVRSRV_RGXDEV_INFO	*psDevInfo, PVRSRV_DEVICE_CONFIG *psDevConfig)
+static IMG_VOID RGXStart(PVRSRV_RGXDEV_INFO	*psDevInfo, PVRSRV_DEVICE_CONFIG *psDevConfig)
 {
-	PVRSRV_ERROR	eError = PVRSRV_OK;
-	RGXFWIF_INIT	*psRGXFWInit;
+	IMG_UINT32	ui32PhaseStartUs = OSClockus();
 
 #if defined(FIX_HW_BRN_37453)
 	/* Force all clocks on*/
@@ -405,6 +436,8 @@ static PVRSRV_ERROR RGXStart(PVRSRV_RGXDEV_INFO	*psDevInfo, PVRSRV_DEVICE_CONFIG
 	OSWriteHWReg64(psDevInfo->pvRegsBaseKM, RGX_CR_SOFT_RESET, RGX_CR_SOFT_RESET_GARTEN_EN);
 	PDUMPREG64(RGX_PDUMPREG_NAME, RGX_CR_SOFT_RESET, RGX_CR_SOFT_RESET_GARTEN_EN, PDUMP_FLAGS_CONTINUOUS | PDUMP_FLAGS_POWERTRANS);
 
+	ui32PhaseStartUs = RGXPowerPhaseEnd(psDevInfo, RGX_POWER_PHASE_RESET, ui32PhaseStartUs);
+
 #if ! defined(FIX_HW_BRN_37453)
 	/*
 	 * Enable clocks.
@@ -435,6 +468,13 @@ static PVRSRV_ERROR RGXStart(PVRSRV_RGXDEV_INFO	*psDevInfo, PVRSRV_DEVICE_CONFIG
 		PDUMPREG64(RGX_PDUMPREG_NAME, RGX_CR_MTS_GARTEN_WRAPPER_CONFIG, ui32BIFFenceAddr, PDUMP_FLAGS_CONTINUOUS | PDUMP_FLAGS_POWERTRANS);
 	}
 
+	/*
+		The AXI and BIF configuration is always reprogrammed. We only get
+		here after a power-up from OFF, where the system layer released the
+		graphics island, and nothing tells us whether the island actually
+		kept its state. Knowing our configuration hasn't changed since it
+		was last written isn't enough to skip writing it again.
+	*/
 #if defined(RGX_FEATURE_AXI_ACELITE)
 	/*
 		We must init the AXI-ACE interface before 1st BIF transaction
@@ -447,6 +487,8 @@ static PVRSRV_ERROR RGXStart(PVRSRV_RGXDEV_INFO	*psDevInfo, PVRSRV_DEVICE_CONFIG
 	 */
 	RGXInitBIF(psDevInfo);
 
+	ui32PhaseStartUs = RGXPowerPhaseEnd(psDevInfo, RGX_POWER_PHASE_CONFIG, ui32PhaseStartUs);
+
 	PDUMPCOMMENTWITHFLAGS(PDUMP_FLAGS_POWERTRANS, "RGXStart: Take META out of reset");
 	/* need to wait for at least 16 cycles before taking meta out of reset ... */
 	PVRSRVSystemWaitCycles(psDevConfig, 32);
@@ -481,12 +523,34 @@ static PVRSRV_ERROR RGXStart(PVRSRV_RGXDEV_INFO	*psDevInfo, PVRSRV_DEVICE_CONFIG
 	
 	OSMemoryBarrier();
 
+	RGXPowerPhaseEnd(psDevInfo, RGX_POWER_PHASE_META_BOOT, ui32PhaseStartUs);
+}
+
+
+/*!
+*******************************************************************************
+
+ @Function	RGXWaitForFWStart
+
+ @Description Wait for the firmware started by RGXStart to report it is up
+
+ @Input psDevInfo - device info structure
+
+ @Return   PVRSRV_ERROR
+
+******************************************************************************/
+static PVRSRV_ERROR RGXWaitForFWStart(PVRSRV_RGXDEV_INFO	*psDevInfo)
+{
+	PVRSRV_ERROR	eError = PVRSRV_OK;
+	RGXFWIF_INIT	*psRGXFWInit;
+	IMG_UINT32		ui32PhaseStartUs = OSClockus();
+
 	/* Check whether the FW has started by polling on bFirmwareStarted flag */
 	eError = DevmemAcquireCpuVirtAddr(psDevInfo->psRGXFWIfInitMemDesc,
 									  (IMG_VOID **)&psRGXFWInit);
 	if (eError != PVRSRV_OK)
 	{
-		PVR_DPF((PVR_DBG_ERROR,"RGXStart: Failed to acquire kernel fw if ctl (%u)", eError));
+		PVR_DPF((PVR_DBG_ERROR,"RGXWaitForFWStart: Failed to acquire kernel fw if ctl (%u)", eError));
 		return eError;
 	}
 
@@ -494,7 +558,7 @@ static PVRSRV_ERROR RGXStart(PVRSRV_RGXDEV_INFO	*psDevInfo, PVRSRV_DEVICE_CONFIG
 							 IMG_TRUE,
 							 0xFFFFFFFF) != PVRSRV_OK)
 	{
-		PVR_DPF((PVR_DBG_ERROR, "RGXStart: Polling for 'FW started' flag failed."));
+		PVR_DPF((PVR_DBG_ERROR, "RGXWaitForFWStart: Polling for 'FW started' flag failed."));
 		eError = PVRSRV_ERROR_TIMEOUT;
 		DevmemReleaseCpuVirtAddr(psDevInfo->psRGXFWIfInitMemDesc);
 		return eError;
@@ -511,7 +575,7 @@ static PVRSRV_ERROR RGXStart(PVRSRV_RGXDEV_INFO	*psDevInfo, PVRSRV_DEVICE_CONFIG
 	
 	if (eError != PVRSRV_OK)
 	{
-		PVR_DPF((PVR_DBG_ERROR, "RGXStart: problem pdumping POL for psRGXFWIfInitMemDesc (%d)", eError));
+		PVR_DPF((PVR_DBG_ERROR, "RGXWaitForFWStart: problem pdumping POL for psRGXFWIfInitMemDesc (%d)", eError));
 		DevmemReleaseCpuVirtAddr(psDevInfo->psRGXFWIfInitMemDesc);
 		return eError;
 	}
@@ -519,6 +583,8 @@ static PVRSRV_ERROR RGXStart(PVRSRV_RGXDEV_INFO	*psDevInfo, PVRSRV_DEVICE_CONFIG
 
 	DevmemReleaseCpuVirtAddr(psDevInfo->psRGXFWIfInitMemDesc);
 
+	RGXPowerPhaseEnd(psDevInfo, RGX_POWER_PHASE_FW_WAIT, ui32PhaseStartUs);
+
 	return eError;
 }
 
@@ -683,9 +749,7 @@ PVRSRV_ERROR RGXPostPowerState (IMG_HANDLE				hDevHandle,
 
 		if (eCurrentPowerState == PVRSRV_DEV_POWER_STATE_OFF)
 		{
-			/* Reset DVFS history */
-			psDevInfo->psGpuDVFSHistory->ui32CurrentDVFSId = 0;
-			psDevInfo->psGpuDVFSHistory->aui32DVFSClockCB[0] = psRGXData->psRGXTimingInfo->ui32CoreClockSpeed;
+			IMG_UINT32	ui32PowerUpStartUs = OSClockus();
 
 			/* Reset FW CB of GPU state transitions history */
 			psDevInfo->psRGXFWIfGpuUtilFWCb->ui32LastGpuUtilState = RGXFWIF_GPU_UTIL_FWCB_STATE_RESERVED;
@@ -700,15 +764,24 @@ PVRSRV_ERROR RGXPostPowerState (IMG_HANDLE				hDevHandle,
 			/*
 				Run the RGX init script.
 			*/
-			eError = RGXStart(psDevInfo, psDevConfig);
+			RGXStart(psDevInfo, psDevConfig);
+
+			/* Reset DVFS history. It is host-only, so do it while the firmware boots */
+			psDevInfo->psGpuDVFSHistory->ui32CurrentDVFSId = 0;
+			psDevInfo->psGpuDVFSHistory->aui32DVFSClockCB[0] = psRGXData->psRGXTimingInfo->ui32CoreClockSpeed;
+
+			eError = RGXWaitForFWStart(psDevInfo);
 			if (eError != PVRSRV_OK)
 			{
-				PVR_DPF((PVR_DBG_ERROR,"RGXPostPowerState: RGXStart failed"));
+				PVR_DPF((PVR_DBG_ERROR,"RGXPostPowerState: RGXWaitForFWStart failed"));
 				return eError;
 			}
 			
 			psDevInfo->bIgnoreFurtherIRQs = IMG_FALSE;
 
+			RGXPowerPhaseEnd(psDevInfo, RGX_POWER_PHASE_TOTAL, ui32PowerUpStartUs);
+			psDevInfo->sPowerTiming.ui32PowerUps++;
+
 			/*Report dfrgx We have the device back ON*/
 			dfrgx_interface_power_state_set(1);
 			/*Report Punit that We have exited D0i3*/
@@ -977,15 +1050,17 @@ PVRSRV_ERROR RGXActivePowerRequest(IMG_HANDLE hDevHandle)
 
 	PVRSRV_RGXDEV_INFO *psDevInfo = psDeviceNode->pvDevice;
 	RGXFWIF_TRACEBUF *psFWTraceBuf = psDevInfo->psRGXFWIfTraceBuf;
+	IMG_BOOL bRecheck = IMG_FALSE;
+	IMG_UINT32 ui32RecheckUs = 0;
 
 	PDUMPPOWCMDSTART();
 
 	OSAcquireBridgeLock();
 	OSSetKeepPVRLock();
 
-	/* Powerlock to avoid further requests from racing with the FW hand-shake from now on
-	   (previous kicks to this point are detected by the FW) */
-	eError = PVRSRVPowerLock();
+	/* Exclusive powerlock to avoid further requests from racing with the FW hand-shake from now on
+	   (kicks still holding it shared are drained first, and previous kicks are detected by the FW) */
+	eError = PVRSRVDevicePowerLock(psDeviceNode->sDevId.ui32DeviceIndex, IMG_FALSE, IMG_NULL);
 	if(eError != PVRSRV_OK)
 	{
 		PVR_DPF((PVR_DBG_ERROR,"RGXActivePowerRequest: Failed to acquire PowerLock (device index: %d, error: %s)", 
@@ -997,6 +1072,12 @@ PVRSRV_ERROR RGXActivePowerRequest(IMG_HANDLE hDevHandle)
 	/* Check again for IDLE once we have the power lock */
 	if (psFWTraceBuf->ePowState == RGXFWIF_POW_IDLE)
 	{
+		if (!RGXAPMPolicyShouldPowerDown(&psDevInfo->sAPMPolicy, OSClockus64(), &ui32RecheckUs))
+		{
+			/* More work is predicted before a power cycle would pay off */
+			bRecheck = IMG_TRUE;
+			goto _RGXActivePowerRequest_Deferred;
+		}
 
 		psDevInfo->ui32ActivePMReqTotal++;
 
@@ -1010,6 +1091,7 @@ PVRSRV_ERROR RGXActivePowerRequest(IMG_HANDLE hDevHandle)
 		if (eError == PVRSRV_OK)
 		{
 			psDevInfo->ui32ActivePMReqOk++;
+			RGXAPMPolicyPoweredDown(&psDevInfo->sAPMPolicy, OSClockus64());
 		}
 		else if (eError == PVRSRV_ERROR_DEVICE_POWER_CHANGE_DENIED)
 		{
@@ -1018,7 +1100,8 @@ PVRSRV_ERROR RGXActivePowerRequest(IMG_HANDLE hDevHandle)
 
 	}
 
-	PVRSRVPowerUnlock();
+_RGXActivePowerRequest_Deferred:
+	PVRSRVDevicePowerUnlock(psDeviceNode->sDevId.ui32DeviceIndex, IMG_FALSE);
 
 _RGXActivePowerRequest_PowerLock_failed:
 	OSSetReleasePVRLock();
@@ -1026,11 +1109,40 @@ _RGXActivePowerRequest_PowerLock_failed:
 	
 	PDUMPPOWCMDEND();
 
+	RGXActivePowerRecheck(psDevInfo, bRecheck, ui32RecheckUs);
+
 	return eError;
 
 }
 
 
+/*
+	RGXActivePowerRecheck
+*/
+IMG_VOID RGXActivePowerRecheck(PVRSRV_RGXDEV_INFO *psDevInfo, IMG_BOOL bRecheck,
+							   IMG_UINT32 ui32RecheckUs)
+{
+	if (psDevInfo->hAPMTimer == IMG_NULL)
+	{
+		return;
+	}
+
+	/* A timer which has already fired stays enabled until disabled here */
+	if (psDevInfo->bAPMTimerEnabled)
+	{
+		OSDisableTimer(psDevInfo->hAPMTimer);
+		psDevInfo->bAPMTimerEnabled = IMG_FALSE;
+	}
+
+	if (bRecheck)
+	{
+		/* One expiry when the policy expects the decision to change */
+		OSEnableTimerOnce(psDevInfo->hAPMTimer, (ui32RecheckUs + 999) / 1000);
+		psDevInfo->bAPMTimerEnabled = IMG_TRUE;
+	}
+}
+
+
 /******************************************************************************
  End of file (rgxpower.c)
 ******************************************************************************/
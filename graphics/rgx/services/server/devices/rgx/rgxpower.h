@@ -47,6 +47,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "pvrsrv_error.h"
 #include "img_types.h"
 #include "servicesext.h"
+#include "rgxdevice.h"
 
 #if defined (__cplusplus)
 extern "C" {
@@ -167,4 +168,24 @@ PVRSRV_ERROR RGXDustCountChange(IMG_HANDLE				hDevHandle,
 ******************************************************************************/
 PVRSRV_ERROR RGXActivePowerRequest(IMG_HANDLE hDevHandle);
 
+/*!
+******************************************************************************
+
+ @Function	RGXActivePowerRecheck
+
+ @Description Schedule or cancel a single re-run of the active power check
+              while a power-down decision is deferred. Each deferral arms
+              the timer once, so the check runs once per deferral rather
+              than periodically. Called from the MISR.
+
+ @Input	   psDevInfo : RGX device info
+ @Input	   bRecheck : IMG_TRUE to re-run the check
+ @Input	   ui32RecheckUs : delay before the re-run, from the APM policy
+
+ @Return   IMG_VOID
+
+******************************************************************************/
+IMG_VOID RGXActivePowerRecheck(PVRSRV_RGXDEV_INFO *psDevInfo, IMG_BOOL bRecheck,
+							   IMG_UINT32 ui32RecheckUs);
+
 #endif /* __RGXPOWER_H__ */
@@ -393,6 +393,381 @@ _OSAllocMem_Exit:
 #endif
 }
 
+/*
+	PB block reserve
+
+	A small number of PB blocks are allocated ahead of time so that grow
+	requests from the firmware only have to move a block into the freelist
+	rather than allocating physical pages while the TA is stalled. The blocks
+	have their physical addresses locked so writing them into the freelist
+	does not have to fault them in either. The reserve is refilled from a
+	MISR after it has been drawn from.
+
+	Freelists may use different grow sizes, so blocks are kept in a slot per
+	size. A slot is claimed by the first freelist created with that grow size
+	and released (its blocks freed) once the last such freelist is destroyed.
+	When all slots are in use further sizes are simply not reserved and grow
+	requests of those sizes allocate as before.
+*/
+static PVRSRV_ERROR _RGXPBReserveAllocBlock(PVRSRV_RGXDEV_INFO *psDevInfo,
+											IMG_UINT32 ui32NumPages,
+											RGX_PMR_NODE **ppsPMRNode)
+{
+	RGX_PMR_NODE		*psPMRNode;
+	IMG_DEVMEM_SIZE_T	uiSize;
+	IMG_BOOL			bMappingTable = IMG_TRUE;
+	PVRSRV_ERROR		eError;
+
+	psPMRNode = OSAllocMem(sizeof(*psPMRNode));
+	if (psPMRNode == IMG_NULL)
+	{
+		eError = PVRSRV_ERROR_OUT_OF_MEMORY;
+		goto ErrorAllocHost;
+	}
+	OSMemSet(psPMRNode, 0, sizeof(*psPMRNode));
+	psPMRNode->ui32NumPages = ui32NumPages;
+
+	uiSize = (IMG_DEVMEM_SIZE_T)ui32NumPages * RGX_BIF_PM_PHYSICAL_PAGE_SIZE;
+	eError = PhysmemNewRamBackedPMR(psDevInfo->psDeviceNode,
+									uiSize,
+									uiSize,
+									1,
+									1,
+									&bMappingTable,
+									RGX_BIF_PM_PHYSICAL_PAGE_ALIGNSHIFT,
+									PVRSRV_MEMALLOCFLAG_GPU_READABLE,
+									&psPMRNode->psPMR);
+	if (eError != PVRSRV_OK)
+	{
+		goto ErrorBlockAlloc;
+	}
+
+	eError = PMRLockSysPhysAddresses(psPMRNode->psPMR,
+									 RGX_BIF_PM_PHYSICAL_PAGE_ALIGNSHIFT);
+	if (eError != PVRSRV_OK)
+	{
+		goto ErrorLockPhys;
+	}
+
+	if (psDevInfo->ui32DeviceFlags & RGXKM_DEVICE_STATE_ZERO_FREELIST)
+	{
+		eError = PMRZeroingPMR(psPMRNode->psPMR, RGX_BIF_PM_PHYSICAL_PAGE_ALIGNSHIFT);
+		if (eError != PVRSRV_OK)
+		{
+			goto ErrorZero;
+		}
+	}
+
+	*ppsPMRNode = psPMRNode;
+	return PVRSRV_OK;
+
+ErrorZero:
+	PMRUnlockSysPhysAddresses(psPMRNode->psPMR);
+ErrorLockPhys:
+	PMRUnrefPMR(psPMRNode->psPMR);
+ErrorBlockAlloc:
+	OSFreeMem(psPMRNode);
+ErrorAllocHost:
+	PVR_ASSERT(eError != PVRSRV_OK);
+	return eError;
+}
+
+static IMG_VOID _RGXPBReserveFreeBlock(RGX_PMR_NODE *psPMRNode)
+{
+	PMRUnlockSysPhysAddresses(psPMRNode->psPMR);
+	PMRUnrefPMR(psPMRNode->psPMR);
+	OSFreeMem(psPMRNode);
+}
+
+/*
+	Find the reserve slot holding blocks of ui32NumPages pages. Must be called
+	with hLockPBReserve held. Returns RGX_PB_RESERVE_SIZES if there isn't one.
+*/
+static IMG_UINT32 _RGXPBReserveFindSlot(PVRSRV_RGXDEV_INFO *psDevInfo,
+										IMG_UINT32 ui32NumPages)
+{
+	IMG_UINT32 ui32Slot;
+
+	for (ui32Slot = 0; ui32Slot < RGX_PB_RESERVE_SIZES; ui32Slot++)
+	{
+		if (psDevInfo->aui32PBReserveBlockPages[ui32Slot] == ui32NumPages)
+		{
+			break;
+		}
+	}
+
+	return ui32Slot;
+}
+
+/*
+	Take a block of exactly ui32NumPages pages from the reserve. Returns
+	IMG_NULL if the reserve can't serve the request.
+*/
+static RGX_PMR_NODE *_RGXPBReserveTake(PVRSRV_RGXDEV_INFO *psDevInfo,
+									   IMG_UINT32 ui32NumPages)
+{
+	RGX_PMR_NODE	*psPMRNode = IMG_NULL;
+	PDLLIST_NODE	psNode;
+	IMG_UINT32		ui32Slot;
+
+	if (psDevInfo->hLockPBReserve == IMG_NULL)
+	{
+		return IMG_NULL;
+	}
+
+	OSLockAcquire(psDevInfo->hLockPBReserve);
+	ui32Slot = _RGXPBReserveFindSlot(psDevInfo, ui32NumPages);
+	if (ui32Slot < RGX_PB_RESERVE_SIZES)
+	{
+		psNode = dllist_get_next_node(&psDevInfo->asPBReserveHead[ui32Slot]);
+		if (psNode != IMG_NULL)
+		{
+			dllist_remove_node(psNode);
+			psDevInfo->aui32PBReserveCount[ui32Slot]--;
+			psPMRNode = IMG_CONTAINER_OF(psNode, RGX_PMR_NODE, sMemoryBlock);
+		}
+	}
+	if (psPMRNode != IMG_NULL)
+	{
+		psDevInfo->ui32PBReserveHits++;
+	}
+	else
+	{
+		psDevInfo->ui32PBReserveMisses++;
+	}
+	OSLockRelease(psDevInfo->hLockPBReserve);
+
+	return psPMRNode;
+}
+
+static IMG_VOID _RGXPBReserveRefillMISR(IMG_VOID *pvData)
+{
+	PVRSRV_RGXDEV_INFO	*psDevInfo = pvData;
+	RGX_PMR_NODE		*psPMRNode;
+	PDLLIST_NODE		psNode;
+	DLLIST_NODE			sStaleHead;
+	IMG_UINT32			ui32Slot;
+	IMG_UINT32			ui32NumPages;
+	IMG_BOOL			bRefill;
+	PVRSRV_ERROR		eError;
+
+	dllist_init(&sStaleHead);
+
+	/* Release slots no freelist grows by any more */
+	OSLockAcquire(psDevInfo->hLockPBReserve);
+	for (ui32Slot = 0; ui32Slot < RGX_PB_RESERVE_SIZES; ui32Slot++)
+	{
+		if ((psDevInfo->aui32PBReserveBlockPages[ui32Slot] == 0) ||
+			(psDevInfo->aui32PBReserveFreeLists[ui32Slot] != 0))
+		{
+			continue;
+		}
+
+		while ((psNode = dllist_get_next_node(&psDevInfo->asPBReserveHead[ui32Slot])) != IMG_NULL)
+		{
+			dllist_remove_node(psNode);
+			dllist_add_to_tail(&sStaleHead, psNode);
+		}
+		psDevInfo->aui32PBReserveCount[ui32Slot] = 0;
+		psDevInfo->aui32PBReserveBlockPages[ui32Slot] = 0;
+	}
+	OSLockRelease(psDevInfo->hLockPBReserve);
+
+	while ((psNode = dllist_get_next_node(&sStaleHead)) != IMG_NULL)
+	{
+		dllist_remove_node(psNode);
+		_RGXPBReserveFreeBlock(IMG_CONTAINER_OF(psNode, RGX_PMR_NODE, sMemoryBlock));
+	}
+
+	for (ui32Slot = 0; ui32Slot < RGX_PB_RESERVE_SIZES; ui32Slot++)
+	{
+		/* Allocate outside of the lock, a grow may be waiting on it */
+		for (;;)
+		{
+			OSLockAcquire(psDevInfo->hLockPBReserve);
+			ui32NumPages = psDevInfo->aui32PBReserveBlockPages[ui32Slot];
+			bRefill = (ui32NumPages != 0) &&
+					  (psDevInfo->aui32PBReserveCount[ui32Slot] < RGX_PB_RESERVE_BLOCKS);
+			OSLockRelease(psDevInfo->hLockPBReserve);
+
+			if (!bRefill)
+			{
+				break;
+			}
+
+			eError = _RGXPBReserveAllocBlock(psDevInfo, ui32NumPages, &psPMRNode);
+			if (eError != PVRSRV_OK)
+			{
+				PVR_DPF((PVR_DBG_WARNING,"_RGXPBReserveRefillMISR: Failed to allocate PB block of %u pages (%s)",
+						ui32NumPages,
+						PVRSRVGetErrorStringKM(eError)));
+				return;
+			}
+
+			OSLockAcquire(psDevInfo->hLockPBReserve);
+			if ((psDevInfo->aui32PBReserveBlockPages[ui32Slot] == ui32NumPages) &&
+				(psDevInfo->aui32PBReserveFreeLists[ui32Slot] != 0) &&
+				(psDevInfo->aui32PBReserveCount[ui32Slot] < RGX_PB_RESERVE_BLOCKS))
+			{
+				dllist_add_to_tail(&psDevInfo->asPBReserveHead[ui32Slot], &psPMRNode->sMemoryBlock);
+				psDevInfo->aui32PBReserveCount[ui32Slot]++;
+				psPMRNode = IMG_NULL;
+			}
+			OSLockRelease(psDevInfo->hLockPBReserve);
+
+			if (psPMRNode != IMG_NULL)
+			{
+				/* Slot was released (or filled) under our feet */
+				_RGXPBReserveFreeBlock(psPMRNode);
+				break;
+			}
+		}
+	}
+}
+
+/*
+	Register a freelist's grow size with the reserve. Returns IMG_FALSE if all
+	slots are taken by other sizes, in which case the freelist's grows are
+	not reserved for.
+*/
+static IMG_BOOL _RGXPBReserveAddSize(PVRSRV_RGXDEV_INFO *psDevInfo,
+									 IMG_UINT32 ui32NumPages)
+{
+	IMG_UINT32	ui32Slot;
+	IMG_BOOL	bRefill = IMG_FALSE;
+
+	if ((RGX_PB_RESERVE_BLOCKS == 0) || (psDevInfo->hPBReserveMISR == IMG_NULL) || (ui32NumPages == 0))
+	{
+		return IMG_FALSE;
+	}
+
+	OSLockAcquire(psDevInfo->hLockPBReserve);
+	ui32Slot = _RGXPBReserveFindSlot(psDevInfo, ui32NumPages);
+	if (ui32Slot == RGX_PB_RESERVE_SIZES)
+	{
+		/* Claim a free slot */
+		ui32Slot = _RGXPBReserveFindSlot(psDevInfo, 0);
+		if (ui32Slot < RGX_PB_RESERVE_SIZES)
+		{
+			psDevInfo->aui32PBReserveBlockPages[ui32Slot] = ui32NumPages;
+		}
+	}
+	if (ui32Slot < RGX_PB_RESERVE_SIZES)
+	{
+		psDevInfo->aui32PBReserveFreeLists[ui32Slot]++;
+		bRefill = (psDevInfo->aui32PBReserveCount[ui32Slot] < RGX_PB_RESERVE_BLOCKS);
+	}
+	OSLockRelease(psDevInfo->hLockPBReserve);
+
+	if (ui32Slot == RGX_PB_RESERVE_SIZES)
+	{
+		PVR_DPF((PVR_DBG_MESSAGE, "PB reserve: no slot for grow size of %u pages", ui32NumPages));
+		return IMG_FALSE;
+	}
+
+	if (bRefill)
+	{
+		OSScheduleMISR(psDevInfo->hPBReserveMISR);
+	}
+
+	return IMG_TRUE;
+}
+
+/*
+	Drop a freelist's grow size registered by _RGXPBReserveAddSize. The MISR
+	frees the slot's blocks once no freelist uses that size.
+*/
+static IMG_VOID _RGXPBReserveRemoveSize(PVRSRV_RGXDEV_INFO *psDevInfo,
+										IMG_UINT32 ui32NumPages)
+{
+	IMG_UINT32	ui32Slot;
+	IMG_BOOL	bRelease = IMG_FALSE;
+
+	OSLockAcquire(psDevInfo->hLockPBReserve);
+	ui32Slot = _RGXPBReserveFindSlot(psDevInfo, ui32NumPages);
+	if (ui32Slot < RGX_PB_RESERVE_SIZES)
+	{
+		PVR_ASSERT(psDevInfo->aui32PBReserveFreeLists[ui32Slot] > 0);
+		psDevInfo->aui32PBReserveFreeLists[ui32Slot]--;
+		bRelease = (psDevInfo->aui32PBReserveFreeLists[ui32Slot] == 0);
+	}
+	OSLockRelease(psDevInfo->hLockPBReserve);
+
+	if (bRelease)
+	{
+		OSScheduleMISR(psDevInfo->hPBReserveMISR);
+	}
+}
+
+PVRSRV_ERROR RGXPBReserveInit(PVRSRV_RGXDEV_INFO *psDevInfo)
+{
+	PVRSRV_ERROR eError;
+	IMG_UINT32 ui32Slot;
+
+	for (ui32Slot = 0; ui32Slot < RGX_PB_RESERVE_SIZES; ui32Slot++)
+	{
+		dllist_init(&psDevInfo->asPBReserveHead[ui32Slot]);
+		psDevInfo->aui32PBReserveCount[ui32Slot] = 0;
+		psDevInfo->aui32PBReserveBlockPages[ui32Slot] = 0;
+		psDevInfo->aui32PBReserveFreeLists[ui32Slot] = 0;
+	}
+	psDevInfo->ui32PBReserveHits = 0;
+	psDevInfo->ui32PBReserveMisses = 0;
+	psDevInfo->hPBReserveMISR = IMG_NULL;
+
+	eError = OSLockCreate(&psDevInfo->hLockPBReserve, LOCK_TYPE_PASSIVE);
+	if (eError != PVRSRV_OK)
+	{
+		psDevInfo->hLockPBReserve = IMG_NULL;
+		return eError;
+	}
+
+	eError = OSInstallMISR(&psDevInfo->hPBReserveMISR,
+						   _RGXPBReserveRefillMISR,
+						   psDevInfo);
+	if (eError != PVRSRV_OK)
+	{
+		OSLockDestroy(psDevInfo->hLockPBReserve);
+		psDevInfo->hLockPBReserve = IMG_NULL;
+		psDevInfo->hPBReserveMISR = IMG_NULL;
+		return eError;
+	}
+
+	return PVRSRV_OK;
+}
+
+IMG_VOID RGXPBReserveDeInit(PVRSRV_RGXDEV_INFO *psDevInfo)
+{
+	PDLLIST_NODE psNode;
+	IMG_UINT32 ui32Slot;
+
+	if (psDevInfo->hPBReserveMISR != IMG_NULL)
+	{
+		/* Waits for a refill in flight to finish */
+		(IMG_VOID) OSUninstallMISR(psDevInfo->hPBReserveMISR);
+		psDevInfo->hPBReserveMISR = IMG_NULL;
+	}
+
+	if (psDevInfo->hLockPBReserve == IMG_NULL)
+	{
+		return;
+	}
+
+	for (ui32Slot = 0; ui32Slot < RGX_PB_RESERVE_SIZES; ui32Slot++)
+	{
+		while ((psNode = dllist_get_next_node(&psDevInfo->asPBReserveHead[ui32Slot])) != IMG_NULL)
+		{
+			dllist_remove_node(psNode);
+			_RGXPBReserveFreeBlock(IMG_CONTAINER_OF(psNode, RGX_PMR_NODE, sMemoryBlock));
+		}
+		psDevInfo->aui32PBReserveCount[ui32Slot] = 0;
+		psDevInfo->aui32PBReserveBlockPages[ui32Slot] = 0;
+	}
+
+	OSLockDestroy(psDevInfo->hLockPBReserve);
+	psDevInfo->hLockPBReserve = IMG_NULL;
+}
+
 PVRSRV_ERROR RGXGrowFreeList(RGX_FREELIST *psFreeList,
 							IMG_UINT32 ui32NumPages,
 							PDLLIST_NODE pListHeader)
@@ -407,6 +782,7 @@ PVRSRV_ERROR RGXGrowFreeList(RGX_FREELIST *psFreeList,
 	IMG_UINT64 ui64CheckSum;
 	IMG_UINT32 ui32CheckSumXor;
 	IMG_UINT32 ui32CheckSumAdd;
+	IMG_BOOL bFromReserve = IMG_FALSE;
 
 	/* Are we allowed to grow ? */
 	if ((psFreeList->ui32MaxFLPages - psFreeList->ui32CurrentFLPages) < ui32NumPages)
@@ -419,13 +795,22 @@ PVRSRV_ERROR RGXGrowFreeList(RGX_FREELIST *psFreeList,
 		return PVRSRV_ERROR_PBSIZE_ALREADY_MAX;
 	}
 
-	/* Allocate kernel memory block structure */
-	psPMRNode = OSAllocMem(sizeof(*psPMRNode));
-	if (psPMRNode == IMG_NULL)
+	/* Serve the grow from the PB reserve if it holds a block of the right size */
+	psPMRNode = _RGXPBReserveTake(psFreeList->psDevInfo, ui32NumPages);
+	if (psPMRNode != IMG_NULL)
 	{
-		PVR_DPF((PVR_DBG_ERROR, "RGXGrowFreeList: failed to allocate host data structure"));
-		eError = PVRSRV_ERROR_OUT_OF_MEMORY;
-		goto ErrorAllocHost;
+		bFromReserve = IMG_TRUE;
+	}
+	else
+	{
+		/* Allocate kernel memory block structure */
+		psPMRNode = OSAllocMem(sizeof(*psPMRNode));
+		if (psPMRNode == IMG_NULL)
+		{
+			PVR_DPF((PVR_DBG_ERROR, "RGXGrowFreeList: failed to allocate host data structure"));
+			eError = PVRSRV_ERROR_OUT_OF_MEMORY;
+			goto ErrorAllocHost;
+		}
 	}
 
 	/*
@@ -439,28 +824,31 @@ PVRSRV_ERROR RGXGrowFreeList(RGX_FREELIST *psFreeList,
 	psPMRNode->ui32NumPages = ui32NumPages;
 	psPMRNode->psFreeList = psFreeList;
 
-	/* Allocate Memory Block */
-	PDUMPCOMMENT("Allocate PB Block (Pages %08X)", ui32NumPages);
-	uiSize = (IMG_DEVMEM_SIZE_T)ui32NumPages * RGX_BIF_PM_PHYSICAL_PAGE_SIZE;
-	eError = PhysmemNewRamBackedPMR(psFreeList->psDevInfo->psDeviceNode,
-									uiSize,
-									uiSize,
-									1,
-									1,
-									&bMappingTable,
-									RGX_BIF_PM_PHYSICAL_PAGE_ALIGNSHIFT,
-									PVRSRV_MEMALLOCFLAG_GPU_READABLE,
-									&psPMRNode->psPMR);
-	if(eError != PVRSRV_OK)
-	{
-		PVR_DPF((PVR_DBG_ERROR,
-				 "RGXGrowFreeList: Failed to allocate PB block of size: 0x%016llX",
-				 (IMG_UINT64)uiSize));
-		goto ErrorBlockAlloc;
+	if (!bFromReserve)
+	{
+		/* Allocate Memory Block */
+		PDUMPCOMMENT("Allocate PB Block (Pages %08X)", ui32NumPages);
+		uiSize = (IMG_DEVMEM_SIZE_T)ui32NumPages * RGX_BIF_PM_PHYSICAL_PAGE_SIZE;
+		eError = PhysmemNewRamBackedPMR(psFreeList->psDevInfo->psDeviceNode,
+										uiSize,
+										uiSize,
+										1,
+										1,
+										&bMappingTable,
+										RGX_BIF_PM_PHYSICAL_PAGE_ALIGNSHIFT,
+										PVRSRV_MEMALLOCFLAG_GPU_READABLE,
+										&psPMRNode->psPMR);
+		if(eError != PVRSRV_OK)
+		{
+			PVR_DPF((PVR_DBG_ERROR,
+					 "RGXGrowFreeList: Failed to allocate PB block of size: 0x%016llX",
+					 (IMG_UINT64)uiSize));
+			goto ErrorBlockAlloc;
+		}
 	}
 
-	/* Zeroing physical pages pointed by the PMR */
-	if (psFreeList->psDevInfo->ui32DeviceFlags & RGXKM_DEVICE_STATE_ZERO_FREELIST)
+	/* Zeroing physical pages pointed by the PMR (reserve blocks are zeroed when allocated) */
+	if (!bFromReserve && (psFreeList->psDevInfo->ui32DeviceFlags & RGXKM_DEVICE_STATE_ZERO_FREELIST))
 	{
 		eError = PMRZeroingPMR(psPMRNode->psPMR, RGX_BIF_PM_PHYSICAL_PAGE_ALIGNSHIFT);
 		if (eError != PVRSRV_OK)
@@ -496,6 +884,12 @@ PVRSRV_ERROR RGXGrowFreeList(RGX_FREELIST *psFreeList,
 		goto ErrorPopulateFreelist;
 	}
 
+	if (bFromReserve)
+	{
+		/* The page list now holds its own lock on the physical addresses */
+		PMRUnlockSysPhysAddresses(psPMRNode->psPMR);
+	}
+
 	/* We add It must be added to the tail, otherwise the freelist population won't work */
 	dllist_add_to_head(pListHeader, &psPMRNode->sMemoryBlock);
 
@@ -519,16 +913,27 @@ PVRSRV_ERROR RGXGrowFreeList(RGX_FREELIST *psFreeList,
 
 	OSLockRelease(psFreeList->psDevInfo->hLockFreeList);
 
-	PVR_DPF((PVR_DBG_MESSAGE,"Freelist [%p]: grow by %u pages (current pages %u/%u)",
+	PVR_DPF((PVR_DBG_MESSAGE,"Freelist [%p]: grow by %u pages (current pages %u/%u)%s",
 			psFreeList,
 			ui32NumPages,
 			psFreeList->ui32CurrentFLPages,
-			psFreeList->ui32MaxFLPages));
+			psFreeList->ui32MaxFLPages,
+			bFromReserve ? " from reserve" : ""));
+
+	if (bFromReserve)
+	{
+		/* Top the reserve up again outside of the grow path */
+		OSScheduleMISR(psFreeList->psDevInfo->hPBReserveMISR);
+	}
 
 	return PVRSRV_OK;
 
 	/* Error handling */
 ErrorPopulateFreelist:
+	if (bFromReserve)
+	{
+		PMRUnlockSysPhysAddresses(psPMRNode->psPMR);
+	}
 	PMRUnrefPMR(psPMRNode->psPMR);
 
 ErrorBlockAlloc:
@@ -1338,6 +1743,12 @@ PVRSRV_ERROR RGXCreateFreeList(PVRSRV_DEVICE_NODE	*psDeviceNode,
 		goto ErrorAllocBlock;
 	}
 
+	/* Reserve PB blocks for the grow requests this freelist will make */
+	if (ui32MaxFLPages > ui32InitFLPages)
+	{
+		psFreeList->bPBReserved = _RGXPBReserveAddSize(psDevInfo, ui32GrowFLPages);
+	}
+
 	/* return values */
 	*ppsFreeList = psFreeList;
 
@@ -1453,6 +1864,11 @@ PVRSRV_ERROR RGXDestroyFreeList(RGX_FREELIST *psFreeList)
 	dllist_remove_node(&psFreeList->sNode);
 	OSLockRelease(psFreeList->psDevInfo->hLockFreeList);
 
+	if (psFreeList->bPBReserved)
+	{
+		_RGXPBReserveRemoveSize(psFreeList->psDevInfo, psFreeList->ui32GrowFLPages);
+	}
+
 	SyncPrimFree(psFreeList->psCleanupSync);
 
 	/* free Freelist */
@@ -1637,6 +2053,142 @@ PVRSRV_ERROR RGXDestroyRenderTarget(RGX_RT_CLEANUP_DATA *psCleanupData)
 	return PVRSRV_OK;
 }
 
+/*
+	On-demand ZS-Buffer backing pool
+
+	Unbacking a ZS-Buffer normally unmaps its PMR, which gives the pages back
+	to the OS, only for the firmware to ask for the backing again on the next
+	frame. Instead the unbacked buffer keeps its mapping and is parked on a
+	per size class LRU list. A later backing request for the same buffer
+	takes it off the list without touching the page allocator or the MMU.
+	Only RGX_ZSBUFFER_POOL_CLASS_ENTRIES buffers are retained per size class,
+	the least recently used one gets its backing released when that's exceeded.
+
+	All pool state is protected by hLockZSBuffer.
+*/
+static IMG_UINT32 _ZSBufferPoolClass(RGX_ZSBUFFER_DATA *psZSBuffer)
+{
+	IMG_DEVMEM_SIZE_T	uiSize;
+	IMG_UINT32			ui32Class = 0;
+
+	if (PMR_LogicalSize(psZSBuffer->psPMR, &uiSize) != PVRSRV_OK)
+	{
+		return 0;
+	}
+
+	uiSize >>= RGX_ZSBUFFER_POOL_CLASS_MIN_SHIFT;
+	while ((uiSize > 1) && (ui32Class < (RGX_ZSBUFFER_POOL_CLASSES - 1)))
+	{
+		uiSize = (uiSize + 1) >> 1;
+		ui32Class++;
+	}
+
+	return ui32Class;
+}
+
+static PVRSRV_ERROR _ZSBufferReleaseBacking(RGX_ZSBUFFER_DATA *psZSBuffer)
+{
+	PVRSRV_ERROR eError;
+
+	PVR_ASSERT(psZSBuffer->psMapping);
+
+	eError = DevmemIntUnmapPMR(psZSBuffer->psMapping);
+	if (eError != PVRSRV_OK)
+	{
+		PVR_DPF((PVR_DBG_ERROR,"Unable to unpopulate ZS Buffer [%p, ID=0x%08x] with error %u",
+								psZSBuffer,
+								psZSBuffer->ui32ZSBufferID,
+								eError));
+		return eError;
+	}
+	psZSBuffer->psMapping = IMG_NULL;
+
+	PVR_DPF((PVR_DBG_MESSAGE, "ZS Buffer [%p, ID=0x%08x]: Physical backing removed",
+								psZSBuffer,
+								psZSBuffer->ui32ZSBufferID));
+
+	return PVRSRV_OK;
+}
+
+/* Take a ZS-Buffer off its pool LRU list. Called with hLockZSBuffer held. */
+static IMG_VOID _ZSBufferPoolRemove(RGX_ZSBUFFER_DATA *psZSBuffer)
+{
+	PVRSRV_RGXDEV_INFO *psDevInfo = psZSBuffer->psDevInfo;
+
+	PVR_ASSERT(psZSBuffer->bPooled);
+
+	dllist_remove_node(&psZSBuffer->sPoolNode);
+	psDevInfo->aui32ZSBufferPoolCount[psZSBuffer->ui32PoolClass]--;
+	psZSBuffer->bPooled = IMG_FALSE;
+}
+
+/* Park an unbacked ZS-Buffer in the pool. Called with hLockZSBuffer held. */
+static IMG_VOID _ZSBufferPoolInsert(RGX_ZSBUFFER_DATA *psZSBuffer)
+{
+	PVRSRV_RGXDEV_INFO	*psDevInfo = psZSBuffer->psDevInfo;
+	IMG_UINT32			ui32Class = psZSBuffer->ui32PoolClass;
+	PDLLIST_NODE		psNode;
+
+	dllist_add_to_tail(&psDevInfo->asZSBufferPoolHead[ui32Class], &psZSBuffer->sPoolNode);
+	psDevInfo->aui32ZSBufferPoolCount[ui32Class]++;
+	psZSBuffer->bPooled = IMG_TRUE;
+
+	/* Evict the least recently used buffers of this size class */
+	while (psDevInfo->aui32ZSBufferPoolCount[ui32Class] > RGX_ZSBUFFER_POOL_CLASS_ENTRIES)
+	{
+		RGX_ZSBUFFER_DATA *psEvict;
+
+		psNode = dllist_get_next_node(&psDevInfo->asZSBufferPoolHead[ui32Class]);
+		psEvict = IMG_CONTAINER_OF(psNode, RGX_ZSBUFFER_DATA, sPoolNode);
+
+		_ZSBufferPoolRemove(psEvict);
+		if (_ZSBufferReleaseBacking(psEvict) != PVRSRV_OK)
+		{
+			/* Keep it in the pool and try again on the next eviction */
+			dllist_add_to_tail(&psDevInfo->asZSBufferPoolHead[ui32Class], &psEvict->sPoolNode);
+			psDevInfo->aui32ZSBufferPoolCount[ui32Class]++;
+			psEvict->bPooled = IMG_TRUE;
+			break;
+		}
+	}
+}
+
+IMG_VOID RGXZSBufferPoolInit(PVRSRV_RGXDEV_INFO *psDevInfo)
+{
+	IMG_UINT32 ui32Class;
+
+	for (ui32Class = 0; ui32Class < RGX_ZSBUFFER_POOL_CLASSES; ui32Class++)
+	{
+		dllist_init(&psDevInfo->asZSBufferPoolHead[ui32Class]);
+		psDevInfo->aui32ZSBufferPoolCount[ui32Class] = 0;
+	}
+	psDevInfo->ui32ZSBufferPoolHits = 0;
+	psDevInfo->ui32ZSBufferPoolMisses = 0;
+}
+
+IMG_VOID RGXZSBufferPoolFlush(PVRSRV_RGXDEV_INFO *psDevInfo)
+{
+	IMG_UINT32		ui32Class;
+	PDLLIST_NODE	psNode;
+
+	OSLockAcquire(psDevInfo->hLockZSBuffer);
+	for (ui32Class = 0; ui32Class < RGX_ZSBUFFER_POOL_CLASSES; ui32Class++)
+	{
+		while ((psNode = dllist_get_next_node(&psDevInfo->asZSBufferPoolHead[ui32Class])) != IMG_NULL)
+		{
+			RGX_ZSBUFFER_DATA *psZSBuffer = IMG_CONTAINER_OF(psNode, RGX_ZSBUFFER_DATA, sPoolNode);
+
+			_ZSBufferPoolRemove(psZSBuffer);
+			(IMG_VOID) _ZSBufferReleaseBacking(psZSBuffer);
+		}
+	}
+	OSLockRelease(psDevInfo->hLockZSBuffer);
+
+	PVR_DPF((PVR_DBG_MESSAGE, "ZS-Buffer pool: %u backings reused, %u mapped",
+			psDevInfo->ui32ZSBufferPoolHits,
+			psDevInfo->ui32ZSBufferPoolMisses));
+}
+
 /*
 	RGXCreateZSBuffer
 */
@@ -1685,6 +2237,8 @@ PVRSRV_ERROR RGXCreateZSBufferKM(PVRSRV_DEVICE_NODE	*psDeviceNode,
     {
     	psZSBuffer->ui32ZSBufferID = psDevInfo->ui32ZSBufferCurrID++;
     	psZSBuffer->psMapping = IMG_NULL;
+    	psZSBuffer->ui32PoolClass = _ZSBufferPoolClass(psZSBuffer);
+    	psZSBuffer->bPooled = IMG_FALSE;
 
 		OSLockAcquire(psDevInfo->hLockZSBuffer);
     	dllist_add_to_tail(&psDevInfo->sZSBufferHead, &psZSBuffer->sNode);
@@ -1803,6 +2357,13 @@ PVRSRV_ERROR RGXDestroyZSBufferKM(RGX_ZSBUFFER_DATA *psZSBuffer)
 			OSLockAcquire(hLockZSBuffer);
 			PVR_ASSERT(dllist_node_is_in_list(&psZSBuffer->sNode));
 			dllist_remove_node(&psZSBuffer->sNode);
+
+			/* Release a backing retained by the pool */
+			if (psZSBuffer->bPooled)
+			{
+				_ZSBufferPoolRemove(psZSBuffer);
+				(IMG_VOID) _ZSBufferReleaseBacking(psZSBuffer);
+			}
 			OSLockRelease(hLockZSBuffer);
 		}
 
@@ -1846,11 +2407,22 @@ RGXBackingZSBuffer(RGX_ZSBUFFER_DATA *psZSBuffer)
 
 	if (psZSBuffer->ui32RefCount == 0)
 	{
-		if (psZSBuffer->bOnDemand)
+		if (psZSBuffer->bOnDemand && psZSBuffer->bPooled)
+		{
+			/* The backing was retained when the buffer was last unbacked */
+			_ZSBufferPoolRemove(psZSBuffer);
+			psZSBuffer->psDevInfo->ui32ZSBufferPoolHits++;
+
+			PVR_DPF((PVR_DBG_MESSAGE, "ZS Buffer [%p, ID=0x%08x]: Physical backing reused",
+										psZSBuffer,
+										psZSBuffer->ui32ZSBufferID));
+		}
+		else if (psZSBuffer->bOnDemand)
 		{
 			IMG_HANDLE hDevmemHeap;
 
 			PVR_ASSERT(psZSBuffer->psMapping == IMG_NULL);
+			psZSBuffer->psDevInfo->ui32ZSBufferPoolMisses++;
 
 			/* Get Heap */
 			eError = DevmemServerGetHeapHandle(psZSBuffer->psReservation, &hDevmemHeap);
@@ -1929,7 +2501,6 @@ PVRSRV_ERROR
 RGXUnbackingZSBuffer(RGX_ZSBUFFER_DATA *psZSBuffer)
 {
 	POS_LOCK hLockZSBuffer;
-	PVRSRV_ERROR eError;
 
 	if (!psZSBuffer)
 	{
@@ -1952,18 +2523,10 @@ RGXUnbackingZSBuffer(RGX_ZSBUFFER_DATA *psZSBuffer)
 		{
 			PVR_ASSERT(psZSBuffer->psMapping);
 
-			eError = DevmemIntUnmapPMR(psZSBuffer->psMapping);
-			if (eError != PVRSRV_OK)
-			{
-				PVR_DPF((PVR_DBG_ERROR,"Unable to unpopulate ZS Buffer [%p, ID=0x%08x] with error %u",
-										psZSBuffer,
-										psZSBuffer->ui32ZSBufferID,
-										eError));
-				OSLockRelease(hLockZSBuffer);
-				return eError;
-			}
+			/* Keep the backing around for the next request */
+			_ZSBufferPoolInsert(psZSBuffer);
 
-			PVR_DPF((PVR_DBG_MESSAGE, "ZS Buffer [%p, ID=0x%08x]: Physical backing removed",
+			PVR_DPF((PVR_DBG_MESSAGE, "ZS Buffer [%p, ID=0x%08x]: Physical backing retained",
 										psZSBuffer,
 										psZSBuffer->ui32ZSBufferID));
 		}
@@ -2992,11 +3555,12 @@ PVRSRV_ERROR PVRSRVRGXKickTA3DKM(RGX_SERVER_RENDER_CONTEXT	*psRenderContext,
 
 		LOOP_UNTIL_TIMEOUT(MAX_HW_TIME_US)
 		{
-			eError2 = RGXScheduleCommand(psRenderContext->psDeviceNode->pvDevice,
-										RGXFWIF_DM_TA,
-										&sTAKCCBCmd,
-										sizeof(sTAKCCBCmd),
-										bPDumpContinuous);
+			eError2 = RGXScheduleCommandPriority(psRenderContext->psDeviceNode->pvDevice,
+												RGXFWIF_DM_TA,
+												&sTAKCCBCmd,
+												sizeof(sTAKCCBCmd),
+												bPDumpContinuous,
+												FWCommonContextGetPriority(psRenderContext->sTAData.psServerCommonContext));
 			if (eError2 != PVRSRV_ERROR_RETRY)
 			{
 				break;
@@ -3039,11 +3603,12 @@ PVRSRV_ERROR PVRSRVRGXKickTA3DKM(RGX_SERVER_RENDER_CONTEXT	*psRenderContext,
 
 		LOOP_UNTIL_TIMEOUT(MAX_HW_TIME_US)
 		{
-			eError2 = RGXScheduleCommand(psRenderContext->psDeviceNode->pvDevice,
-										RGXFWIF_DM_3D,
-										&s3DKCCBCmd,
-										sizeof(s3DKCCBCmd),
-										bPDumpContinuous);
+			eError2 = RGXScheduleCommandPriority(psRenderContext->psDeviceNode->pvDevice,
+												RGXFWIF_DM_3D,
+												&s3DKCCBCmd,
+												sizeof(s3DKCCBCmd),
+												bPDumpContinuous,
+												FWCommonContextGetPriority(psRenderContext->s3DData.psServerCommonContext));
 			if (eError2 != PVRSRV_ERROR_RETRY)
 			{
 				break;
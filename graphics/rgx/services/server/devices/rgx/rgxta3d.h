@@ -90,6 +90,7 @@ struct _RGX_FREELIST_ {
 	IMG_UINT32				ui32NumGrowReqByApp;	/* Total number of grow requests by Application*/
 	IMG_UINT32				ui32NumGrowReqByFW;		/* Total Number of grow requests by Firmware */
 	IMG_UINT32				ui32NumHighPages;		/* High Mark of pages in the freelist */
+	IMG_BOOL				bPBReserved;			/* grow size registered with the PB reserve */
 
 	/* Memory Blocks */
 	DLLIST_NODE				sMemoryBlockHead;
@@ -135,6 +136,10 @@ typedef struct {
 
 	DLLIST_NODE	sNode;
 
+	IMG_UINT32				ui32PoolClass;			/* Size class in the device backing pool */
+	IMG_BOOL				bPooled;				/* Unbacked, but the mapping is retained in the pool */
+	DLLIST_NODE				sPoolNode;
+
 	PVRSRV_CLIENT_SYNC_PRIM	*psCleanupSync;
 }RGX_ZSBUFFER_DATA;
 
@@ -235,6 +240,20 @@ PVRSRV_ERROR RGXPopulateZSBufferKM(RGX_ZSBUFFER_DATA *psZSBuffer,
 IMG_EXPORT
 PVRSRV_ERROR RGXUnbackingZSBuffer(RGX_ZSBUFFER_DATA *psZSBuffer);
 
+/*
+ * RGXZSBufferPoolInit()
+ *
+ * Initialises the device's pool of retained ZS-Buffer backings
+ */
+IMG_VOID RGXZSBufferPoolInit(PVRSRV_RGXDEV_INFO *psDevInfo);
+
+/*
+ * RGXZSBufferPoolFlush()
+ *
+ * Releases every backing retained in the pool
+ */
+IMG_VOID RGXZSBufferPoolFlush(PVRSRV_RGXDEV_INFO *psDevInfo);
+
 /*
  * RGXUnpopulateZSBufferKM()
  *
@@ -257,6 +276,29 @@ IMG_EXPORT
 IMG_VOID RGXProcessRequestZSBufferUnbacking(PVRSRV_RGXDEV_INFO *psDevInfo,
 										IMG_UINT32 ui32ZSBufferID);
 
+/*
+	Number of pre-allocated PB blocks kept per device so that grow requests
+	from the firmware can be served without allocating pages while the TA
+	is stalled. Blocks are kept per grow size (see RGX_PB_RESERVE_SIZES in
+	rgxdevice.h), RGX_PB_RESERVE_BLOCKS of each. PDump builds don't use the reserve so that the PB allocations
+	stay in script order.
+*/
+#if defined(PDUMP)
+#define RGX_PB_RESERVE_BLOCKS		0
+#else
+#define RGX_PB_RESERVE_BLOCKS		2
+#endif
+
+/*
+	RGXPBReserveInit
+*/
+PVRSRV_ERROR RGXPBReserveInit(PVRSRV_RGXDEV_INFO *psDevInfo);
+
+/*
+	RGXPBReserveDeInit
+*/
+IMG_VOID RGXPBReserveDeInit(PVRSRV_RGXDEV_INFO *psDevInfo);
+
 /*
 	RGXGrowFreeList
 */
@@ -77,6 +77,27 @@ typedef struct {
 	IMG_UINT32					ui32Priority;
 } RGX_SERVER_TQ_2D_DATA;
 
+/*
+	Per-DM submit template, built once when the transfer context is created
+	so the single prepare fast path doesn't have to work out which context,
+	client CCB and kick command to use on every submit.
+	Indexed by the TQ_PREP_FLAGS_COMMAND_xxx value.
+*/
+#define RGX_TQ_SUBMIT_TEMPLATE_COUNT	2
+
+/* Max total client fence, client update and server syncs on the fast path */
+#define RGX_TQ_FAST_SUBMIT_MAX_SYNCS	8
+
+typedef struct {
+	RGX_SERVER_COMMON_CONTEXT	*psServerCommonContext;
+	RGX_CLIENT_CCB				*psClientCCB;
+	RGXFWIF_DM					eDM;
+	RGXFWIF_CCB_CMD_TYPE		eType;
+	IMG_CHAR					*pszCommandName;
+	IMG_CHAR					*pszCCBName;
+	RGXFWIF_KCCB_CMD			sKickCmd;
+} RGX_SERVER_TQ_SUBMIT_TEMPLATE;
+
 struct _RGX_SERVER_TQ_CONTEXT_ {
 	PVRSRV_DEVICE_NODE			*psDeviceNode;
 	DEVMEM_MEMDESC				*psFWFrameworkMemDesc;
@@ -85,8 +106,16 @@ struct _RGX_SERVER_TQ_CONTEXT_ {
 #define RGX_SERVER_TQ_CONTEXT_FLAGS_3D		(1<<1)
 	RGX_SERVER_TQ_3D_DATA		s3DData;
 	RGX_SERVER_TQ_2D_DATA		s2DData;
+	RGX_SERVER_TQ_SUBMIT_TEMPLATE	asSubmitTemplate[RGX_TQ_SUBMIT_TEMPLATE_COUNT];
 	PVRSRV_CLIENT_SYNC_PRIM		*psCleanupSync;
 	DLLIST_NODE					sListNode;
+	/* Submit path stats, timings are only gathered on NO_HARDWARE builds */
+	IMG_UINT32					ui32FastSubmitCount;
+	IMG_UINT32					ui32SlowSubmitCount;
+#if defined(NO_HARDWARE)
+	IMG_UINT64					ui64FastSubmitTimeUs;
+	IMG_UINT64					ui64SlowSubmitTimeUs;
+#endif
 };
 
 /*
@@ -239,6 +268,27 @@ static PVRSRV_ERROR _Destroy3DTransferContext(RGX_SERVER_TQ_3D_DATA *ps3DData,
 	return PVRSRV_OK;
 }
 
+static IMG_VOID _InitSubmitTemplate(RGX_SERVER_TQ_SUBMIT_TEMPLATE *psTemplate,
+									 RGX_SERVER_COMMON_CONTEXT *psServerCommonContext,
+									 RGXFWIF_DM eDM,
+									 RGXFWIF_CCB_CMD_TYPE eType,
+									 IMG_CHAR *pszCommandName,
+									 IMG_CHAR *pszCCBName)
+{
+	psTemplate->psServerCommonContext = psServerCommonContext;
+	psTemplate->psClientCCB = FWCommonContextGetClientCCB(psServerCommonContext);
+	psTemplate->eDM = eDM;
+	psTemplate->eType = eType;
+	psTemplate->pszCommandName = pszCommandName;
+	psTemplate->pszCCBName = pszCCBName;
+
+	/* Everything but the client CCB write offset is fixed for the context's lifetime */
+	OSMemSet(&psTemplate->sKickCmd, 0, sizeof(psTemplate->sKickCmd));
+	psTemplate->sKickCmd.eCmdType = RGXFWIF_KCCB_CMD_KICK;
+	psTemplate->sKickCmd.uCmdData.sCmdKickData.psContext = FWCommonContextGetFWAddress(psServerCommonContext);
+	psTemplate->sKickCmd.uCmdData.sCmdKickData.ui32NumCleanupCtl = 0;
+}
+
 /*
  * PVRSRVCreateTransferContextKM
  */
@@ -329,6 +379,25 @@ PVRSRV_ERROR PVRSRVRGXCreateTransferContextKM(CONNECTION_DATA		*psConnection,
 	}
 	psTransferContext->ui32Flags |= RGX_SERVER_TQ_CONTEXT_FLAGS_2D;
 
+	_InitSubmitTemplate(&psTransferContext->asSubmitTemplate[TQ_PREP_FLAGS_COMMAND_3D],
+						psTransferContext->s3DData.psServerCommonContext,
+						RGXFWIF_DM_3D,
+						RGXFWIF_CCB_CMD_TYPE_TQ_3D,
+						"TQ-3D",
+						"TQ_3D");
+	_InitSubmitTemplate(&psTransferContext->asSubmitTemplate[TQ_PREP_FLAGS_COMMAND_2D],
+						psTransferContext->s2DData.psServerCommonContext,
+						RGXFWIF_DM_2D,
+						RGXFWIF_CCB_CMD_TYPE_TQ_2D,
+						"TQ-2D",
+						"TQ_2D");
+	psTransferContext->ui32FastSubmitCount = 0;
+	psTransferContext->ui32SlowSubmitCount = 0;
+#if defined(NO_HARDWARE)
+	psTransferContext->ui64FastSubmitTimeUs = 0;
+	psTransferContext->ui64SlowSubmitTimeUs = 0;
+#endif
+
 	{
 		PVRSRV_RGXDEV_INFO			*psDevInfo = psDeviceNode->pvDevice;
 		dllist_add_to_tail(&(psDevInfo->sTransferCtxtListHead), &(psTransferContext->sListNode));
@@ -383,6 +452,15 @@ PVRSRV_ERROR PVRSRVRGXDestroyTransferContextKM(RGX_SERVER_TQ_CONTEXT *psTransfer
 		/* We've freed the 3D context, don't try to free it again */
 		psTransferContext->ui32Flags &= ~RGX_SERVER_TQ_CONTEXT_FLAGS_3D;
 	}
+
+#if defined(NO_HARDWARE)
+	PVR_DPF((PVR_DBG_MESSAGE, "%s: %u fast submits (%lluus), %u batch submits (%lluus)",
+			 __FUNCTION__,
+			 psTransferContext->ui32FastSubmitCount,
+			 (unsigned long long) psTransferContext->ui64FastSubmitTimeUs,
+			 psTransferContext->ui32SlowSubmitCount,
+			 (unsigned long long) psTransferContext->ui64SlowSubmitTimeUs));
+#endif
 	dllist_remove_node(&(psTransferContext->sListNode));
 	DevmemFwFree(psTransferContext->psFWFrameworkMemDesc);
 	SyncPrimFree(psTransferContext->psCleanupSync);
@@ -398,10 +476,116 @@ fail_destroy3d:
 }
 
 /*
- * PVRSRVSubmitTQ3DKickKM
- */
-IMG_EXPORT
-PVRSRV_ERROR PVRSRVRGXSubmitTransferKM(RGX_SERVER_TQ_CONTEXT	*psTransferContext,
+	Submit a single 2D or 3D prepare with no fence FDs.
+
+	This is the common case for small blits, so skip the batching support of
+	the general path: no heap allocated helper arrays, no merging of Android
+	syncs and the context, client CCB and kick command come from the
+	template built at context creation.
+*/
+static PVRSRV_ERROR _SubmitTransferFast(RGX_SERVER_TQ_CONTEXT	*psTransferContext,
+										RGX_SERVER_TQ_SUBMIT_TEMPLATE *psTemplate,
+										IMG_UINT32				ui32ClientFenceCount,
+										PRGXFWIF_UFO_ADDR		*pauiClientFenceUFOAddress,
+										IMG_UINT32				*paui32ClientFenceValue,
+										IMG_UINT32				ui32ClientUpdateCount,
+										PRGXFWIF_UFO_ADDR		*pauiClientUpdateUFOAddress,
+										IMG_UINT32				*paui32ClientUpdateValue,
+										IMG_UINT32				ui32ServerSyncCount,
+										IMG_UINT32				*paui32ServerSyncFlags,
+										SERVER_SYNC_PRIMITIVE	**papsServerSyncs,
+										IMG_UINT32				ui32FWCommandSize,
+										IMG_UINT8				*pui8FWCommand,
+										IMG_UINT32				ui32TQPrepareFlags)
+{
+	RGX_CCB_CMD_HELPER_DATA sCmdHelper;
+	IMG_BOOL bKick = IMG_FALSE;
+	IMG_BOOL bPDumpContinuous;
+	PVRSRV_ERROR eError;
+	PVRSRV_ERROR eError2;
+
+	bPDumpContinuous = ((ui32TQPrepareFlags & TQ_PREP_FLAGS_PDUMPCONTINUOUS) == TQ_PREP_FLAGS_PDUMPCONTINUOUS);
+	PDUMPCOMMENTWITHFLAGS((bPDumpContinuous) ? PDUMP_FLAGS_CONTINUOUS : 0,
+			"%s Command Server Submit on FWCtx %08x", psTemplate->pszCommandName,
+			psTemplate->sKickCmd.uCmdData.sCmdKickData.psContext.ui32Addr);
+
+	/*
+		A start without an end means the rest of the transfer operation
+		comes in a later call, so leave the server sync updates until then
+	*/
+	if ((ui32TQPrepareFlags & TQ_PREP_FLAGS_START) && !(ui32TQPrepareFlags & TQ_PREP_FLAGS_END))
+	{
+		IMG_UINT32 k;
+
+		for (k=0;k<ui32ServerSyncCount;k++)
+		{
+			paui32ServerSyncFlags[k] &= ~PVRSRV_CLIENT_SYNC_PRIM_OP_UPDATE;
+		}
+	}
+
+	eError = RGXCmdHelperInitCmdCCB(psTemplate->psClientCCB,
+									ui32ClientFenceCount,
+									pauiClientFenceUFOAddress,
+									paui32ClientFenceValue,
+									ui32ClientUpdateCount,
+									pauiClientUpdateUFOAddress,
+									paui32ClientUpdateValue,
+									ui32ServerSyncCount,
+									paui32ServerSyncFlags,
+									papsServerSyncs,
+									ui32FWCommandSize,
+									pui8FWCommand,
+									psTemplate->eType,
+									bPDumpContinuous,
+									psTemplate->pszCommandName,
+									&sCmdHelper);
+	if (eError != PVRSRV_OK)
+	{
+		return eError;
+	}
+
+	eError = RGXCmdHelperAcquireCmdCCB(1, &sCmdHelper, &bKick);
+	if (eError == PVRSRV_OK)
+	{
+		RGXCmdHelperReleaseCmdCCB(1,
+								  &sCmdHelper,
+								  psTemplate->pszCCBName,
+								  psTemplate->sKickCmd.uCmdData.sCmdKickData.psContext.ui32Addr);
+	}
+
+	/*
+		As in the general path we might still need to kick the HW to process
+		a padding packet even if we failed to acquire the client CCB space
+	*/
+	if (bKick)
+	{
+		RGXFWIF_KCCB_CMD sKCCBCmd = psTemplate->sKickCmd;
+
+		sKCCBCmd.uCmdData.sCmdKickData.ui32CWoffUpdate = RGXGetHostWriteOffsetCCB(psTemplate->psClientCCB);
+
+		LOOP_UNTIL_TIMEOUT(MAX_HW_TIME_US)
+		{
+			eError2 = RGXScheduleCommandPriority(psTransferContext->psDeviceNode->pvDevice,
+												psTemplate->eDM,
+												&sKCCBCmd,
+												sizeof(sKCCBCmd),
+												bPDumpContinuous,
+												FWCommonContextGetPriority(psTemplate->psServerCommonContext));
+			if (eError2 != PVRSRV_ERROR_RETRY)
+			{
+				break;
+			}
+			OSWaitus(MAX_HW_TIME_US/WAIT_TRY_COUNT);
+		} END_LOOP_UNTIL_TIMEOUT();
+	}
+
+	return eError;
+}
+
+/*
+	General submit path, handles batches of 2D and 3D prepares and fence FDs
+*/
+static PVRSRV_ERROR _SubmitTransferBatch(RGX_SERVER_TQ_CONTEXT	*psTransferContext,
 									   IMG_UINT32				ui32PrepareCount,
 									   IMG_UINT32				*paui32ClientFenceCount,
 									   PRGXFWIF_UFO_ADDR		**papauiClientFenceUFOAddress,
@@ -809,11 +993,12 @@ PVRSRV_ERROR PVRSRVRGXSubmitTransferKM(RGX_SERVER_TQ_CONTEXT	*psTransferContext,
 
 		LOOP_UNTIL_TIMEOUT(MAX_HW_TIME_US)
 		{
-			eError2 = RGXScheduleCommand(psDeviceNode->pvDevice,
-										RGXFWIF_DM_3D,
-										&s3DKCCBCmd,
-										sizeof(s3DKCCBCmd),
-										bPDumpContinuous);
+			eError2 = RGXScheduleCommandPriority(psDeviceNode->pvDevice,
+												RGXFWIF_DM_3D,
+												&s3DKCCBCmd,
+												sizeof(s3DKCCBCmd),
+												bPDumpContinuous,
+												FWCommonContextGetPriority(psTransferContext->s3DData.psServerCommonContext));
 			if (eError2 != PVRSRV_ERROR_RETRY)
 			{
 				break;
@@ -834,11 +1019,12 @@ PVRSRV_ERROR PVRSRVRGXSubmitTransferKM(RGX_SERVER_TQ_CONTEXT	*psTransferContext,
 
 		LOOP_UNTIL_TIMEOUT(MAX_HW_TIME_US)
 		{
-			eError2 = RGXScheduleCommand(psDeviceNode->pvDevice,
-										RGXFWIF_DM_2D,
-										&s2DKCCBCmd,
-										sizeof(s2DKCCBCmd),
-										bPDumpContinuous);
+			eError2 = RGXScheduleCommandPriority(psDeviceNode->pvDevice,
+												RGXFWIF_DM_2D,
+												&s2DKCCBCmd,
+												sizeof(s2DKCCBCmd),
+												bPDumpContinuous,
+												FWCommonContextGetPriority(psTransferContext->s2DData.psServerCommonContext));
 			if (eError2 != PVRSRV_ERROR_RETRY)
 			{
 				break;
@@ -923,6 +1109,90 @@ fail_alloc3dhelper:
 	return eError;
 }
 
+/*
+ * PVRSRVSubmitTQ3DKickKM
+ */
+IMG_EXPORT
+PVRSRV_ERROR PVRSRVRGXSubmitTransferKM(RGX_SERVER_TQ_CONTEXT	*psTransferContext,
+									   IMG_UINT32				ui32PrepareCount,
+									   IMG_UINT32				*paui32ClientFenceCount,
+									   PRGXFWIF_UFO_ADDR		**papauiClientFenceUFOAddress,
+									   IMG_UINT32				**papaui32ClientFenceValue,
+									   IMG_UINT32				*paui32ClientUpdateCount,
+									   PRGXFWIF_UFO_ADDR		**papauiClientUpdateUFOAddress,
+									   IMG_UINT32				**papaui32ClientUpdateValue,
+									   IMG_UINT32				*paui32ServerSyncCount,
+									   IMG_UINT32				**papaui32ServerSyncFlags,
+									   SERVER_SYNC_PRIMITIVE	***papapsServerSyncs,
+									   IMG_UINT32				ui32NumFenceFDs,
+									   IMG_INT32				*paui32FenceFDs,
+									   IMG_UINT32				*paui32FWCommandSize,
+									   IMG_UINT8				**papaui8FWCommand,
+									   IMG_UINT32				*pui32TQPrepareFlags)
+{
+	IMG_UINT32 ui32CmdIndex;
+	PVRSRV_ERROR eError;
+#if defined(NO_HARDWARE)
+	IMG_UINT64 ui64StartUs = OSClockus64();
+#endif
+
+	/*
+		Single 2D or 3D prepare with only a few syncs, take the fast path
+	*/
+	if ((ui32PrepareCount == 1) && (ui32NumFenceFDs == 0))
+	{
+		ui32CmdIndex = (pui32TQPrepareFlags[0] & TQ_PREP_FLAGS_COMMAND_MASK) >> TQ_PREP_FLAGS_COMMAND_SHIFT;
+
+		if ((ui32CmdIndex < RGX_TQ_SUBMIT_TEMPLATE_COUNT) &&
+			(paui32ClientFenceCount[0] + paui32ClientUpdateCount[0] + paui32ServerSyncCount[0] <= RGX_TQ_FAST_SUBMIT_MAX_SYNCS))
+		{
+			eError = _SubmitTransferFast(psTransferContext,
+										 &psTransferContext->asSubmitTemplate[ui32CmdIndex],
+										 paui32ClientFenceCount[0],
+										 papauiClientFenceUFOAddress[0],
+										 papaui32ClientFenceValue[0],
+										 paui32ClientUpdateCount[0],
+										 papauiClientUpdateUFOAddress[0],
+										 papaui32ClientUpdateValue[0],
+										 paui32ServerSyncCount[0],
+										 papaui32ServerSyncFlags[0],
+										 papapsServerSyncs[0],
+										 paui32FWCommandSize[0],
+										 papaui8FWCommand[0],
+										 pui32TQPrepareFlags[0]);
+
+			psTransferContext->ui32FastSubmitCount++;
+#if defined(NO_HARDWARE)
+			psTransferContext->ui64FastSubmitTimeUs += OSClockus64() - ui64StartUs;
+#endif
+			return eError;
+		}
+	}
+
+	eError = _SubmitTransferBatch(psTransferContext,
+								  ui32PrepareCount,
+								  paui32ClientFenceCount,
+								  papauiClientFenceUFOAddress,
+								  papaui32ClientFenceValue,
+								  paui32ClientUpdateCount,
+								  papauiClientUpdateUFOAddress,
+								  papaui32ClientUpdateValue,
+								  paui32ServerSyncCount,
+								  papaui32ServerSyncFlags,
+								  papapsServerSyncs,
+								  ui32NumFenceFDs,
+								  paui32FenceFDs,
+								  paui32FWCommandSize,
+								  papaui8FWCommand,
+								  pui32TQPrepareFlags);
+
+	psTransferContext->ui32SlowSubmitCount++;
+#if defined(NO_HARDWARE)
+	psTransferContext->ui64SlowSubmitTimeUs += OSClockus64() - ui64StartUs;
+#endif
+	return eError;
+}
+
 PVRSRV_ERROR PVRSRVRGXSetTransferContextPriorityKM(CONNECTION_DATA *psConnection,
 												   RGX_SERVER_TQ_CONTEXT *psTransferContext,
 												   IMG_UINT32 ui32Priority)
@@ -190,12 +190,14 @@ pvrsrvkm-y += \
  services/server/devices/rgx/rgxinit.o \
  services/server/devices/rgx/rgxdebug.o \
  services/server/devices/rgx/rgxhwperf.o \
+ services/server/devices/rgx/rgxfwtrace.o \
  services/server/devices/rgx/rgxmem.o \
  services/server/devices/rgx/rgxta3d.o \
  services/server/devices/rgx/rgxcompute.o \
  services/server/devices/rgx/rgxccb.o \
  services/server/devices/rgx/rgxmmuinit.o \
  services/server/devices/rgx/rgxpower.o \
+ services/server/devices/rgx/rgxapmpolicy.o \
  services/server/devices/rgx/rgxtransfer.o \
  services/server/devices/rgx/rgxutils.o \
  services/server/devices/rgx/rgxfwutils.o \
@@ -213,12 +215,14 @@ ifneq ($(W),1)
 CFLAGS_rgxinit.o := -Werror
 CFLAGS_rgxdebug.o := -Werror
 CFLAGS_rgxhwperf.o := -Werror
+CFLAGS_rgxfwtrace.o := -Werror
 CFLAGS_rgxmem.o := -Werror
 CFLAGS_rgxta3d.o := -Werror
 CFLAGS_rgxcompute.o := -Werror
 CFLAGS_rgxccb.o := -Werror
 CFLAGS_rgxmmuinit.o := -Werror
 CFLAGS_rgxpower.o := -Werror
+CFLAGS_rgxapmpolicy.o := -Werror
 CFLAGS_rgxsharedpb.o := -Werror
 CFLAGS_rgxtransfer.o := -Werror
 CFLAGS_rgxutils.o := -Werror
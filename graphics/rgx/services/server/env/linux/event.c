@@ -285,20 +285,20 @@ PVRSRV_ERROR LinuxEventObjectSignal(IMG_HANDLE hOSEventObjectList)
 /*!
 ******************************************************************************
 
- @Function	LinuxEventObjectWait
+ @Function	_LinuxEventObjectWait
 
  @Description
 
- Linux wait object routine
+ Common wait routine for the timed and untimed waits
 
  @Input    hOSEventObject : Event object handle
 
- @Input   ui32MSTimeout : Time out value in msec
+ @Input   lTimeOutJiffies : Time out in jiffies, or MAX_SCHEDULE_TIMEOUT
 
  @Return   PVRSRV_ERROR  :  Error code
 
 ******************************************************************************/
-PVRSRV_ERROR LinuxEventObjectWait(IMG_HANDLE hOSEventObject, IMG_UINT32 ui32MSTimeout)
+static PVRSRV_ERROR _LinuxEventObjectWait(IMG_HANDLE hOSEventObject, long lTimeOutJiffies)
 {
 	IMG_UINT32 ui32TimeStamp;
 	IMG_BOOL bReleasePVRLock;
@@ -307,8 +307,6 @@ PVRSRV_ERROR LinuxEventObjectWait(IMG_HANDLE hOSEventObject, IMG_UINT32 ui32MSTi
 
 	PVRSRV_LINUX_EVENT_OBJECT *psLinuxEventObject = (PVRSRV_LINUX_EVENT_OBJECT *) hOSEventObject;
 
-	IMG_UINT32 ui32TimeOutJiffies = msecs_to_jiffies(ui32MSTimeout);
-
 	/* Check if the driver is good shape */
 	if (psPVRSRVData->eServicesState != PVRSRV_SERVICES_STATE_OK)
 	{
@@ -335,7 +333,10 @@ PVRSRV_ERROR LinuxEventObjectWait(IMG_HANDLE hOSEventObject, IMG_UINT32 ui32MSTi
 			LinuxUnLockMutex(&gPVRSRVLock);
 		}
 
-		ui32TimeOutJiffies = (IMG_UINT32)schedule_timeout((IMG_INT32)ui32TimeOutJiffies);
+		/* With MAX_SCHEDULE_TIMEOUT this returns MAX_SCHEDULE_TIMEOUT on
+		 * every wakeup, so the loop only ends once the timestamp moves.
+		 */
+		lTimeOutJiffies = schedule_timeout(lTimeOutJiffies);
 
 		if (bReleasePVRLock == IMG_TRUE)
 		{
@@ -347,12 +348,53 @@ PVRSRV_ERROR LinuxEventObjectWait(IMG_HANDLE hOSEventObject, IMG_UINT32 ui32MSTi
 #endif
 
 
-	} while (ui32TimeOutJiffies);
+	} while (lTimeOutJiffies);
 
 	finish_wait(&psLinuxEventObject->sWait, &sWait);
 
 	psLinuxEventObject->ui32TimeStampPrevious = ui32TimeStamp;
 
-	return ui32TimeOutJiffies ? PVRSRV_OK : PVRSRV_ERROR_TIMEOUT;
+	return lTimeOutJiffies ? PVRSRV_OK : PVRSRV_ERROR_TIMEOUT;
+
+}
+
+/*!
+******************************************************************************
+
+ @Function	LinuxEventObjectWait
+
+ @Description
+
+ Linux wait object routine
+
+ @Input    hOSEventObject : Event object handle
+
+ @Input   ui32MSTimeout : Time out value in msec
 
+ @Return   PVRSRV_ERROR  :  Error code
+
+******************************************************************************/
+PVRSRV_ERROR LinuxEventObjectWait(IMG_HANDLE hOSEventObject, IMG_UINT32 ui32MSTimeout)
+{
+	return _LinuxEventObjectWait(hOSEventObject, (long)msecs_to_jiffies(ui32MSTimeout));
+}
+
+/*!
+******************************************************************************
+
+ @Function	LinuxEventObjectWaitForever
+
+ @Description
+
+ Linux wait object routine without a timeout. Returns once the event
+ object has been signalled.
+
+ @Input    hOSEventObject : Event object handle
+
+ @Return   PVRSRV_ERROR  :  Error code
+
+******************************************************************************/
+PVRSRV_ERROR LinuxEventObjectWaitForever(IMG_HANDLE hOSEventObject)
+{
+	return _LinuxEventObjectWait(hOSEventObject, MAX_SCHEDULE_TIMEOUT);
 }
@@ -150,6 +150,11 @@ MODULE_SUPPORTED_DEVICE(DEVNAME);
 extern IMG_UINT32 gPVRDebugLevel;
 module_param(gPVRDebugLevel, uint, 0644);
 MODULE_PARM_DESC(gPVRDebugLevel, "Sets the level of debug output (default 0x7)");
+#if defined(CONFIG_BINARY_PRINTF)
+extern IMG_UINT32 gPVRDebugBinLogLevel;
+module_param(gPVRDebugBinLogLevel, uint, 0644);
+MODULE_PARM_DESC(gPVRDebugBinLogLevel, "Sets the debug levels kept unformatted in the debug_log ring (default 0x80)");
+#endif /* defined(CONFIG_BINARY_PRINTF) */
 #endif /* defined(PVRSRV_NEED_PVR_DPF) */
 
 /*
@@ -1327,6 +1327,7 @@ typedef struct TIMER_CALLBACK_DATA_TAG
     struct timer_list		sTimer;
     IMG_UINT32			ui32Delay;
     IMG_BOOL			bActive;
+    IMG_BOOL			bOneShot;
 #if defined(PVR_LINUX_TIMERS_USING_WORKQUEUES) || defined(PVR_LINUX_TIMERS_USING_SHARED_WORKQUEUE)
     struct work_struct		sWork;
 #endif
@@ -1357,8 +1358,11 @@ static void OSTimerCallbackBody(TIMER_CALLBACK_DATA *psTimerCBData)
     /* call timer callback */
     psTimerCBData->pfnTimerFunc(psTimerCBData->pvData);
     
-    /* reset timer */
-    mod_timer(&psTimerCBData->sTimer, psTimerCBData->ui32Delay + jiffies);
+    /* reset timer, unless it was armed for a single expiry */
+    if (!psTimerCBData->bOneShot)
+    {
+        mod_timer(&psTimerCBData->sTimer, psTimerCBData->ui32Delay + jiffies);
+    }
 }
 
 
@@ -1450,6 +1454,7 @@ IMG_HANDLE OSAddTimer(PFN_TIMER_FUNC pfnTimerFunc, IMG_VOID *pvData, IMG_UINT32
     psTimerCBData->pfnTimerFunc = pfnTimerFunc;
     psTimerCBData->pvData = pvData;
     psTimerCBData->bActive = IMG_FALSE;
+    psTimerCBData->bOneShot = IMG_FALSE;
     
     /*
         HZ = ticks per second
@@ -1514,6 +1519,7 @@ PVRSRV_ERROR OSEnableTimer (IMG_HANDLE hTimer)
 
     /* Start timer arming */
     psTimerCBData->bActive = IMG_TRUE;
+    psTimerCBData->bOneShot = IMG_FALSE;
 
     /* set the expire time */
     psTimerCBData->sTimer.expires = psTimerCBData->ui32Delay + jiffies;
@@ -1525,6 +1531,38 @@ PVRSRV_ERROR OSEnableTimer (IMG_HANDLE hTimer)
 }
 
 
+/*************************************************************************/ /*!
+@Function       OSEnableTimerOnce
+@Description    OS specific function to enable a timer callback for a single
+                expiry. The timer stays enabled until OSDisableTimer is
+                called, but the callback runs at most once.
+@Input          hTimer          Timer handle
+@Input          ui32MsTimeout   Delay before the callback, overriding the
+                                period given to OSAddTimer
+@Return         PVRSRV_ERROR
+*/ /**************************************************************************/
+PVRSRV_ERROR OSEnableTimerOnce (IMG_HANDLE hTimer, IMG_UINT32 ui32MsTimeout)
+{
+    TIMER_CALLBACK_DATA *psTimerCBData = GetTimerStructure(hTimer);
+    unsigned long ulDelay = msecs_to_jiffies(ui32MsTimeout);
+
+    PVR_ASSERT(psTimerCBData->bInUse);
+    PVR_ASSERT(!psTimerCBData->bActive);
+
+    /* Start timer arming */
+    psTimerCBData->bActive = IMG_TRUE;
+    psTimerCBData->bOneShot = IMG_TRUE;
+
+    /* set the expire time */
+    psTimerCBData->sTimer.expires = ((ulDelay == 0) ? 1 : ulDelay) + jiffies;
+
+    /* Add the timer to the list */
+    add_timer(&psTimerCBData->sTimer);
+    
+    return PVRSRV_OK;
+}
+
+
 /*************************************************************************/ /*!
 @Function       OSDisableTimer
 @Description    OS specific function to disable a timer callback
@@ -1650,6 +1688,30 @@ PVRSRV_ERROR OSEventObjectWaitTimeout(IMG_HANDLE hOSEventKM, IMG_UINT32 uiTimeou
     return eError;
 }
 
+/*************************************************************************/ /*!
+@Function       OSEventObjectWaitUntimed
+@Description    Wait for an event with no timeout. For worker threads that
+                have nothing to do until they are signalled.
+@Input          hOSEventKM    OS and kernel specific handle to event object
+@Return         PVRSRV_ERROR  : any system error code
+*/ /**************************************************************************/
+PVRSRV_ERROR OSEventObjectWaitUntimed(IMG_HANDLE hOSEventKM)
+{
+    PVRSRV_ERROR eError;
+
+    if(hOSEventKM)
+    {
+        eError = LinuxEventObjectWaitForever(hOSEventKM);
+    }
+    else
+    {
+        PVR_DPF((PVR_DBG_ERROR, "OSEventObjectWaitUntimed: hOSEventKM is not a valid handle"));
+        eError = PVRSRV_ERROR_INVALID_PARAMS;
+    }
+
+    return eError;
+}
+
 /*************************************************************************/ /*!
 @Function       OSEventObjectWait
 @Description    OS specific function to wait for an event object. Called
@@ -1879,6 +1941,21 @@ IMG_VOID OSWRLockReleaseWrite(POSWR_LOCK psLock)
 	up_write(&psLock->sRWLock);
 }
 
+IMG_BOOL OSWRLockIsLocked(POSWR_LOCK psLock)
+{
+	return rwsem_is_locked(&psLock->sRWLock) ? IMG_TRUE : IMG_FALSE;
+}
+
+IMG_VOID OSAtomicSetBit(IMG_UINT32 ui32Bit, volatile IMG_UINTPTR_T *puiBitmap)
+{
+	set_bit(ui32Bit, (volatile unsigned long *)puiBitmap);
+}
+
+IMG_VOID OSAtomicClearBit(IMG_UINT32 ui32Bit, volatile IMG_UINTPTR_T *puiBitmap)
+{
+	clear_bit(ui32Bit, (volatile unsigned long *)puiBitmap);
+}
+
 IMG_UINT64 OSDivide64r64(IMG_UINT64 ui64Divident, IMG_UINT32 ui32Divisor, IMG_UINT32 *pui32Remainder)
 {
 	*pui32Remainder = do_div(ui64Divident, ui32Divisor);
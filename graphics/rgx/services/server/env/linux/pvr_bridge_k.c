@@ -122,6 +122,8 @@ PVRSRV_ERROR RegisterRGXHWPERFFunctions(IMG_VOID);
 PVRSRV_ERROR RegisterRGXRAYFunctions(IMG_VOID);
 #endif /* RGX_FEATURE_RAY_TRACING */
 PVRSRV_ERROR RegisterREGCONFIGFunctions(IMG_VOID);
+PVRSRV_ERROR RegisterRGXHWPERF2Functions(IMG_VOID);
+PVRSRV_ERROR RegisterRGXCMP2Functions(IMG_VOID);
 #endif /* SUPPORT_RGX */
 #if (CACHEFLUSH_TYPE == CACHEFLUSH_GENERIC)
 PVRSRV_ERROR RegisterCACHEGENERICFunctions(IMG_VOID);
@@ -335,6 +337,19 @@ LinuxBridgeInit(IMG_VOID)
 		return eError;
 	}
 
+	/* Groups appended after REGCONFIG, registered in ascending ID order */
+	eError = RegisterRGXHWPERF2Functions();
+	if (eError != PVRSRV_OK)
+	{
+		return eError;
+	}
+
+	eError = RegisterRGXCMP2Functions();
+	if (eError != PVRSRV_OK)
+	{
+		return eError;
+	}
+
 #endif /* SUPPORT_RGX */
 
 	return eError;
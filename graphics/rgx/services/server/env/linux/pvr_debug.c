@@ -67,6 +67,254 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #if defined(PVRSRV_NEED_PVR_DPF)
 
+static const IMG_CHAR *_DebugLevelPrefix(IMG_UINT32 ui32DebugLevel)
+{
+	switch (ui32DebugLevel)
+	{
+		case DBGPRIV_FATAL:
+			return "PVR_K:(Fatal): ";
+		case DBGPRIV_ERROR:
+			return "PVR_K:(Error): ";
+		case DBGPRIV_WARNING:
+			return "PVR_K:(Warn):  ";
+		case DBGPRIV_MESSAGE:
+			return "PVR_K:(Mesg):  ";
+		case DBGPRIV_VERBOSE:
+			return "PVR_K:(Verb):  ";
+		case DBGPRIV_DEBUG:
+			return "PVR_K:(Debug): ";
+		case DBGPRIV_CALLTRACE:
+		case DBGPRIV_ALLOC:
+		case DBGPRIV_BUFFERED:
+		default:
+			return "PVR_K:  ";
+	}
+}
+
+/******** BINARY LOG MESSAGES ********/
+
+/* Messages at the levels in gPVRDebugBinLogLevel are not formatted when
+ * they are logged. vbin_printf() copies the raw arguments next to the
+ * format string pointer in a ring owned by the logging CPU, so the fast
+ * path takes no lock and does no string conversion. The text is produced
+ * by bstr_printf() when the ring is read through the "debug_log" debugfs
+ * entry or dumped by PVRSRVDebugPrintfDumpCCB().
+ *
+ * The format and file name pointers are string literals in this module,
+ * so they stay valid for as long as the ring does. String arguments are
+ * copied into the record by vbin_printf().
+ */
+
+#if defined(CONFIG_BINARY_PRINTF)
+
+#define PVRSRV_DEBUG_BINLOG
+
+#include <linux/percpu.h>
+#include <linux/vmalloc.h>
+#include <asm/local.h>
+
+/* Must be a power of two */
+#define PVRSRV_DEBUG_BINLOG_RECORDS	256
+
+/* 32-bit words of vbin_printf() data per record; keeps records at 128 bytes */
+#define PVRSRV_DEBUG_BINLOG_ARGS	21
+
+typedef struct
+{
+	/* Claim number + 1 once the record is complete, 0 while it is written */
+	IMG_UINT32 ui32Seq;
+	IMG_UINT32 ui32Level;
+	IMG_UINT64 ui64Time;
+	const IMG_CHAR *pszFormat;
+	const IMG_CHAR *pszFile;
+	IMG_UINT32 ui32Line;
+	IMG_UINT32 ui32PID;
+	/* Words vbin_printf() needed; more than PVRSRV_DEBUG_BINLOG_ARGS means truncated */
+	IMG_UINT32 ui32ArgWords;
+	u32 aui32Args[PVRSRV_DEBUG_BINLOG_ARGS];
+}
+PVRSRV_DEBUG_BINLOG_RECORD;
+
+typedef struct
+{
+	/* Number of records ever claimed on this CPU */
+	local_t sHead;
+	PVRSRV_DEBUG_BINLOG_RECORD *psRecords;
+}
+PVRSRV_DEBUG_BINLOG_CPU;
+
+static DEFINE_PER_CPU(PVRSRV_DEBUG_BINLOG_CPU, gsDebugBinLog);
+static PVRSRV_DEBUG_BINLOG_RECORD *gpsDebugBinLogRecords;
+
+/* Serialises readers, which share the decode buffer */
+static PVRSRV_LINUX_MUTEX gsDebugBinLogReadMutex;
+static IMG_CHAR gszDebugBinLogReadBuffer[PVR_MAX_DEBUG_MESSAGE_LEN];
+
+/* NOTE: Must NOT be static! Used in module.c.. */
+IMG_UINT32 gPVRDebugBinLogLevel = DBGPRIV_BUFFERED;
+
+static IMG_BOOL
+AddToBinLog(IMG_UINT32 ui32DebugLevel, const IMG_CHAR *pszFileName,
+			IMG_UINT32 ui32Line, const IMG_CHAR *pszFormat, va_list vaArgs)
+{
+	PVRSRV_DEBUG_BINLOG_CPU *psLog;
+	PVRSRV_DEBUG_BINLOG_RECORD *psRecord;
+	IMG_BOOL bLogged = IMG_FALSE;
+	long lClaim;
+
+	/* Keeps this CPU's ring alive and lets _BinLogDeInit() wait for us */
+	preempt_disable();
+
+	psLog = this_cpu_ptr(&gsDebugBinLog);
+	if (psLog->psRecords == IMG_NULL)
+	{
+		goto Exit;
+	}
+
+	/* Interrupts may nest a message here, each gets its own record */
+	lClaim = local_inc_return(&psLog->sHead) - 1;
+	psRecord = &psLog->psRecords[lClaim & (PVRSRV_DEBUG_BINLOG_RECORDS - 1)];
+
+	psRecord->ui32Seq = 0;
+	smp_wmb();
+
+	psRecord->ui32Level = ui32DebugLevel;
+	psRecord->ui64Time = local_clock();
+	psRecord->pszFormat = pszFormat;
+	psRecord->pszFile = pszFileName;
+	psRecord->ui32Line = ui32Line;
+	psRecord->ui32PID = current->pid;
+	psRecord->ui32ArgWords = vbin_printf(psRecord->aui32Args,
+										 PVRSRV_DEBUG_BINLOG_ARGS,
+										 pszFormat, vaArgs);
+
+	smp_wmb();
+	psRecord->ui32Seq = (IMG_UINT32)lClaim + 1;
+
+	bLogged = IMG_TRUE;
+
+Exit:
+	preempt_enable();
+
+	return bLogged;
+}
+
+/*
+ * Copy the ui32Index'th oldest record of a CPU's ring. Fails if there is
+ * no such record or a writer reused it while it was being copied.
+ */
+static IMG_BOOL
+ReadBinLog(IMG_UINT32 ui32CPU, IMG_UINT32 ui32Index,
+		   PVRSRV_DEBUG_BINLOG_RECORD *psOut)
+{
+	PVRSRV_DEBUG_BINLOG_CPU *psLog = &per_cpu(gsDebugBinLog, ui32CPU);
+	PVRSRV_DEBUG_BINLOG_RECORD *psRecord;
+	unsigned long ulHead;
+	unsigned long ulClaim;
+	IMG_UINT32 ui32Seq;
+
+	if (psLog->psRecords == IMG_NULL)
+	{
+		return IMG_FALSE;
+	}
+
+	ulHead = (unsigned long)local_read(&psLog->sHead);
+	ulClaim = ui32Index;
+	if (ulHead > PVRSRV_DEBUG_BINLOG_RECORDS)
+	{
+		ulClaim += ulHead - PVRSRV_DEBUG_BINLOG_RECORDS;
+	}
+	if (ulClaim >= ulHead)
+	{
+		return IMG_FALSE;
+	}
+
+	psRecord = &psLog->psRecords[ulClaim & (PVRSRV_DEBUG_BINLOG_RECORDS - 1)];
+
+	ui32Seq = ACCESS_ONCE(psRecord->ui32Seq);
+	if (ui32Seq != (IMG_UINT32)ulClaim + 1)
+	{
+		return IMG_FALSE;
+	}
+	smp_rmb();
+
+	memcpy(psOut, psRecord, sizeof(*psOut));
+
+	smp_rmb();
+	return (ACCESS_ONCE(psRecord->ui32Seq) == ui32Seq) ? IMG_TRUE : IMG_FALSE;
+}
+
+/* Decode a record in the same layout PVRSRVDebugPrintf() gives printk */
+static const IMG_CHAR *
+FormatBinLog(PVRSRV_DEBUG_BINLOG_RECORD *psRecord)
+{
+	IMG_CHAR *pszBuf = gszDebugBinLogReadBuffer;
+	IMG_UINT32 ui32BufSiz = sizeof(gszDebugBinLogReadBuffer);
+	const IMG_CHAR *pszFileName = psRecord->pszFile;
+	IMG_INT32 i32Len;
+
+#if !defined(__sh__)
+	const IMG_CHAR *pszLeafName = strrchr(pszFileName, '/');
+
+	if (pszLeafName)
+	{
+		pszFileName = pszLeafName + 1;
+	}
+#endif /* __sh__ */
+
+	i32Len = scnprintf(pszBuf, ui32BufSiz, "%s%u: ",
+					   _DebugLevelPrefix(psRecord->ui32Level),
+					   psRecord->ui32PID);
+
+	if (psRecord->ui32ArgWords > PVRSRV_DEBUG_BINLOG_ARGS)
+	{
+		i32Len += scnprintf(&pszBuf[i32Len], ui32BufSiz - i32Len,
+							"(Arguments Truncated) %s", psRecord->pszFormat);
+	}
+	else
+	{
+		i32Len += bstr_printf(&pszBuf[i32Len], ui32BufSiz - i32Len,
+							  psRecord->pszFormat, psRecord->aui32Args);
+	}
+
+	if (i32Len < (IMG_INT32)ui32BufSiz)
+	{
+		snprintf(&pszBuf[i32Len], ui32BufSiz - i32Len, " [%u, %s]",
+				 psRecord->ui32Line, pszFileName);
+	}
+
+	return pszBuf;
+}
+
+static IMG_VOID DumpBinLog(IMG_VOID)
+{
+	PVRSRV_DEBUG_BINLOG_RECORD sRecord;
+	IMG_UINT32 ui32CPU;
+	IMG_UINT32 i;
+
+	LinuxLockMutex(&gsDebugBinLogReadMutex);
+
+	for_each_possible_cpu(ui32CPU)
+	{
+		for (i = 0; i < PVRSRV_DEBUG_BINLOG_RECORDS; i++)
+		{
+			if (ReadBinLog(ui32CPU, i, &sRecord))
+			{
+				u64 ui64Time = sRecord.ui64Time;
+				IMG_UINT32 ui32Rem = do_div(ui64Time, 1000000000);
+
+				printk(KERN_ERR "[%5llu.%06u] cpu%u %s\n",
+					   (unsigned long long)ui64Time, ui32Rem / 1000,
+					   ui32CPU, FormatBinLog(&sRecord));
+			}
+		}
+	}
+
+	LinuxUnLockMutex(&gsDebugBinLogReadMutex);
+}
+
+#endif /* defined(CONFIG_BINARY_PRINTF) */
+
 /******** BUFFERED LOG MESSAGES ********/
 
 /* Because we don't want to have to handle CCB wrapping, each buffered
@@ -148,6 +396,10 @@ IMG_EXPORT IMG_VOID PVRSRVDebugPrintfDumpCCB(void)
 	}
 
 	LinuxUnLockMutex(&gsDebugCCBMutex);
+
+#if defined(PVRSRV_DEBUG_BINLOG)
+	DumpBinLog();
+#endif
 }
 
 #else /* defined(PVRSRV_DEBUG_CCB_MAX) */
@@ -162,7 +414,9 @@ AddToBufferCCB(const IMG_CHAR *pszFileName, IMG_UINT32 ui32Line,
 
 IMG_EXPORT IMG_VOID PVRSRVDebugPrintfDumpCCB(void)
 {
-	/* Not available */
+#if defined(PVRSRV_DEBUG_BINLOG)
+	DumpBinLog();
+#endif
 }
 
 #endif /* defined(PVRSRV_DEBUG_CCB_MAX) */
@@ -405,6 +659,25 @@ IMG_VOID PVRSRVDebugPrintf(IMG_UINT32 ui32DebugLevel,
 	bNoLoc = (IMG_BOOL)((ui32DebugLevel & DBGPRIV_CALLTRACE) |
 						(ui32DebugLevel & DBGPRIV_BUFFERED)) ? IMG_TRUE : IMG_FALSE;
 
+#if defined(PVRSRV_DEBUG_BINLOG)
+	if (gPVRDebugBinLogLevel & ui32DebugLevel)
+	{
+		va_list vaArgs;
+		IMG_BOOL bLogged;
+
+		va_start(vaArgs, pszFormat);
+		bLogged = AddToBinLog(ui32DebugLevel, pszFullFileName, ui32Line,
+							  pszFormat, vaArgs);
+		va_end(vaArgs);
+
+		/* Until the log exists, fall back to formatting the message */
+		if (bLogged)
+		{
+			return;
+		}
+	}
+#endif /* defined(PVRSRV_DEBUG_BINLOG) */
+
 	if (gPVRDebugLevel & ui32DebugLevel)
 	{
 		va_list vaArgs;
@@ -418,47 +691,7 @@ IMG_VOID PVRSRVDebugPrintf(IMG_UINT32 ui32DebugLevel,
 
 		GetBufferLock(&ulLockFlags);
 
-		switch (ui32DebugLevel)
-		{
-			case DBGPRIV_FATAL:
-			{
-				strncpy(pszBuf, "PVR_K:(Fatal): ", (ui32BufSiz - 2));
-				break;
-			}
-			case DBGPRIV_ERROR:
-			{
-				strncpy(pszBuf, "PVR_K:(Error): ", (ui32BufSiz - 2));
-				break;
-			}
-			case DBGPRIV_WARNING:
-			{
-				strncpy(pszBuf, "PVR_K:(Warn):  ", (ui32BufSiz - 2));
-				break;
-			}
-			case DBGPRIV_MESSAGE:
-			{
-				strncpy(pszBuf, "PVR_K:(Mesg):  ", (ui32BufSiz - 2));
-				break;
-			}
-			case DBGPRIV_VERBOSE:
-			{
-				strncpy(pszBuf, "PVR_K:(Verb):  ", (ui32BufSiz - 2));
-				break;
-			}
-			case DBGPRIV_DEBUG:
-			{
-				strncpy(pszBuf, "PVR_K:(Debug): ", (ui32BufSiz - 2));
-				break;
-			}
-			case DBGPRIV_CALLTRACE:
-			case DBGPRIV_ALLOC:
-			case DBGPRIV_BUFFERED:
-			default:
-			{
-				strncpy(pszBuf, "PVR_K:  ", (ui32BufSiz - 2));
-				break;
-			}
-		}
+		strncpy(pszBuf, _DebugLevelPrefix(ui32DebugLevel), (ui32BufSiz - 2));
 		pszBuf[ui32BufSiz - 1] = '\0';
 
 		(void) BAppend(pszBuf, ui32BufSiz, "%u: ", current->pid);
@@ -1226,6 +1459,135 @@ static IMG_INT DebugLevelSet(const char __user *pcBuffer,
 }
 #endif /* defined(DEBUG) */
 
+/*************************************************************************/ /*!
+ Debug log DebugFS entry
+*/ /**************************************************************************/
+
+#if defined(PVRSRV_DEBUG_BINLOG)
+static int _BinLogInit(void)
+{
+	IMG_UINT32 ui32CPU;
+
+	LinuxInitMutex(&gsDebugBinLogReadMutex);
+
+	/* One allocation holds the rings of all CPUs, indexed by CPU number */
+	gpsDebugBinLogRecords = vzalloc(nr_cpu_ids * PVRSRV_DEBUG_BINLOG_RECORDS *
+									sizeof(*gpsDebugBinLogRecords));
+	if (gpsDebugBinLogRecords == IMG_NULL)
+	{
+		return -ENOMEM;
+	}
+
+	for_each_possible_cpu(ui32CPU)
+	{
+		PVRSRV_DEBUG_BINLOG_CPU *psLog = &per_cpu(gsDebugBinLog, ui32CPU);
+
+		local_set(&psLog->sHead, 0);
+		smp_wmb();
+		psLog->psRecords =
+			&gpsDebugBinLogRecords[ui32CPU * PVRSRV_DEBUG_BINLOG_RECORDS];
+	}
+
+	return 0;
+}
+
+static void _BinLogDeInit(void)
+{
+	IMG_UINT32 ui32CPU;
+
+	if (gpsDebugBinLogRecords == IMG_NULL)
+	{
+		return;
+	}
+
+	for_each_possible_cpu(ui32CPU)
+	{
+		per_cpu(gsDebugBinLog, ui32CPU).psRecords = IMG_NULL;
+	}
+
+	/* Writers run with preemption disabled, so once every CPU has
+	 * scheduled none of them can still be using a ring.
+	 */
+#if (LINUX_VERSION_CODE < KERNEL_VERSION(4,20,0))
+	synchronize_sched();
+#else
+	synchronize_rcu();
+#endif
+
+	vfree(gpsDebugBinLogRecords);
+	gpsDebugBinLogRecords = IMG_NULL;
+}
+
+/* Each position is a (CPU, record) pair, oldest record of each CPU first */
+static void *_DebugBinLogPosition(loff_t uiPosition)
+{
+	if (uiPosition >= (loff_t)nr_cpu_ids * PVRSRV_DEBUG_BINLOG_RECORDS)
+	{
+		return NULL;
+	}
+
+	return (void *)(unsigned long)(uiPosition + 1);
+}
+
+static void *_DebugBinLogSeqStart(struct seq_file *psSeqFile, loff_t *puiPosition)
+{
+	PVR_UNREFERENCED_PARAMETER(psSeqFile);
+
+	LinuxLockMutex(&gsDebugBinLogReadMutex);
+
+	return _DebugBinLogPosition(*puiPosition);
+}
+
+static void _DebugBinLogSeqStop(struct seq_file *psSeqFile, void *pvData)
+{
+	PVR_UNREFERENCED_PARAMETER(psSeqFile);
+	PVR_UNREFERENCED_PARAMETER(pvData);
+
+	LinuxUnLockMutex(&gsDebugBinLogReadMutex);
+}
+
+static void *_DebugBinLogSeqNext(struct seq_file *psSeqFile,
+				 void *pvData,
+				 loff_t *puiPosition)
+{
+	PVR_UNREFERENCED_PARAMETER(psSeqFile);
+	PVR_UNREFERENCED_PARAMETER(pvData);
+
+	(*puiPosition)++;
+
+	return _DebugBinLogPosition(*puiPosition);
+}
+
+static int _DebugBinLogSeqShow(struct seq_file *psSeqFile, void *pvData)
+{
+	unsigned long ulPosition = (unsigned long)pvData - 1;
+	IMG_UINT32 ui32CPU = ulPosition / PVRSRV_DEBUG_BINLOG_RECORDS;
+	IMG_UINT32 ui32Index = ulPosition % PVRSRV_DEBUG_BINLOG_RECORDS;
+	PVRSRV_DEBUG_BINLOG_RECORD sRecord;
+
+	if (cpu_possible(ui32CPU) && ReadBinLog(ui32CPU, ui32Index, &sRecord))
+	{
+		u64 ui64Time = sRecord.ui64Time;
+		IMG_UINT32 ui32Rem = do_div(ui64Time, 1000000000);
+
+		seq_printf(psSeqFile, "[%5llu.%06u] cpu%u %s\n",
+			   (unsigned long long)ui64Time, ui32Rem / 1000,
+			   ui32CPU, FormatBinLog(&sRecord));
+	}
+
+	return 0;
+}
+
+static struct seq_operations gsDebugBinLogReadOps =
+{
+	.start = _DebugBinLogSeqStart,
+	.stop = _DebugBinLogSeqStop,
+	.next = _DebugBinLogSeqNext,
+	.show = _DebugBinLogSeqShow,
+};
+#endif /* defined(PVRSRV_DEBUG_BINLOG) */
+
+
 static struct dentry *gpsVersionDebugFSEntry;
 static struct dentry *gpsNodesDebugFSEntry;
 static struct dentry *gpsStatusDebugFSEntry;
@@ -1238,6 +1600,10 @@ static struct dentry *gpsFWTraceDebugFSEntry;
 static struct dentry *gpsDebugLevelDebugFSEntry;
 #endif
 
+#if defined(PVRSRV_DEBUG_BINLOG)
+static struct dentry *gpsDebugBinLogDebugFSEntry;
+#endif
+
 int PVRDebugCreateDebugFSEntries(void)
 {
 	PVRSRV_DATA *psPVRSRVData = PVRSRVGetPVRSRVData();
@@ -1246,6 +1612,25 @@ int PVRDebugCreateDebugFSEntries(void)
 	PVR_ASSERT(psPVRSRVData != NULL);
 	PVR_ASSERT(gpsVersionDebugFSEntry == NULL);
 
+#if defined(PVRSRV_DEBUG_BINLOG)
+	iResult = _BinLogInit();
+	if (iResult != 0)
+	{
+		goto ErrorBinLogDeInit;
+	}
+
+	iResult = PVRDebugFSCreateEntry("debug_log",
+					NULL,
+					&gsDebugBinLogReadOps,
+					NULL,
+					NULL,
+					&gpsDebugBinLogDebugFSEntry);
+	if (iResult != 0)
+	{
+		goto ErrorBinLogDeInit;
+	}
+#endif
+
 	iResult = PVRDebugFSCreateEntry("version",
 					NULL,
 					&gsDebugVersionReadOps,
@@ -1254,7 +1639,11 @@ int PVRDebugCreateDebugFSEntries(void)
 					&gpsVersionDebugFSEntry);
 	if (iResult != 0)
 	{
+#if defined(PVRSRV_DEBUG_BINLOG)
+		goto ErrorRemoveBinLogEntry;
+#else
 		return iResult;
+#endif
 	}
 
 	iResult = PVRDebugFSCreateEntry("nodes",
@@ -1346,6 +1735,15 @@ ErrorRemoveVersionEntry:
 	PVRDebugFSRemoveEntry(gpsVersionDebugFSEntry);
 	gpsVersionDebugFSEntry = NULL;
 
+#if defined(PVRSRV_DEBUG_BINLOG)
+ErrorRemoveBinLogEntry:
+	PVRDebugFSRemoveEntry(gpsDebugBinLogDebugFSEntry);
+	gpsDebugBinLogDebugFSEntry = NULL;
+
+ErrorBinLogDeInit:
+	_BinLogDeInit();
+#endif
+
 	return iResult;
 }
 
@@ -1390,5 +1788,15 @@ void PVRDebugRemoveDebugFSEntries(void)
 		PVRDebugFSRemoveEntry(gpsVersionDebugFSEntry);
 		gpsVersionDebugFSEntry = NULL;
 	}
+
+#if defined(PVRSRV_DEBUG_BINLOG)
+	if (gpsDebugBinLogDebugFSEntry != NULL)
+	{
+		PVRDebugFSRemoveEntry(gpsDebugBinLogDebugFSEntry);
+		gpsDebugBinLogDebugFSEntry = NULL;
+	}
+
+	_BinLogDeInit();
+#endif
 }
 
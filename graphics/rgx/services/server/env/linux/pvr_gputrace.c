@@ -40,6 +40,8 @@ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
 CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */ /**************************************************************************/
 
+#include <linux/string.h>
+
 #include "pvrsrv_error.h"
 #include "srvkm.h"
 #include "pvr_debug.h"
@@ -51,6 +53,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #define CREATE_TRACE_POINTS
 #include <trace/events/gpu.h>
+#include "trace/events/pvr_gpu.h"
 
 #define KM_FTRACE_NO_PRIORITY (0)
 
@@ -101,6 +104,50 @@ typedef struct _PVRSRV_FTRACE_GPU_DATA_
 
 PVRSRV_FTRACE_GPU_DATA gsFTraceGPUData;
 
+/* Emit the compact pvr_gpu events instead of the gpu.h text events */
+static IMG_BOOL gbGpuTraceBinary = IMG_FALSE;
+
+/* Timestamp of the last binary switch record, base for the next delta */
+static IMG_BOOL   gbGpuTraceTsValid = IMG_FALSE;
+static IMG_UINT64 gui64GpuTraceLastTs;
+
+/* Binary event kinds, see trace/events/pvr_gpu.h */
+#define PVR_GPUTRACE_BIN_KIND_ENQUEUE	(0)
+
+
+static IMG_UINT8 GpuTraceWorkType(const IMG_CHAR* pszWorkType)
+{
+	if (strcmp(pszWorkType, "TA") == 0)
+		return PVR_GPUTRACE_WORK_TYPE_TA;
+	if (strcmp(pszWorkType, "3D") == 0)
+		return PVR_GPUTRACE_WORK_TYPE_3D;
+	if (strcmp(pszWorkType, "3DSPM") == 0)
+		return PVR_GPUTRACE_WORK_TYPE_3DSPM;
+	if (strcmp(pszWorkType, "TA3D") == 0)
+		return PVR_GPUTRACE_WORK_TYPE_TA3D;
+
+	return PVR_GPUTRACE_WORK_TYPE_OTHER;
+}
+
+
+static IMG_UINT32 GpuTraceBinaryDelta(IMG_UINT64 ui64Timestamp)
+{
+	IMG_UINT64 ui64Delta = ui64Timestamp - gui64GpuTraceLastTs;
+
+	/* Re-synchronise the decoder when the delta can't be represented */
+	if (!gbGpuTraceTsValid ||
+		ui64Timestamp < gui64GpuTraceLastTs ||
+		ui64Delta > 0xFFFFFFFFULL)
+	{
+		trace_pvr_gpu_ts_sync(ui64Timestamp);
+		gbGpuTraceTsValid = IMG_TRUE;
+		ui64Delta = 0;
+	}
+	gui64GpuTraceLastTs = ui64Timestamp;
+
+	return (IMG_UINT32)ui64Delta;
+}
+
 
 static IMG_VOID CreateJob(IMG_UINT32 ui32PID, IMG_UINT32 ui32FrameNum,
 		IMG_UINT32 ui32RTData)
@@ -211,6 +258,9 @@ static struct dentry* gpsPVRDebugFSGpuTracingOnEntry = NULL;
  	echo Y > /sys/kernel/debug/pvr/gpu_tracing_on
   To disable, type:
   	echo N > /sys/kernel/debug/pvr/gpu_tracing_on
+  To enable GPU events in the compact binary form described in
+  trace/events/pvr_gpu.h instead, type:
+ 	echo B > /sys/kernel/debug/pvr/gpu_tracing_on
 
   It is also possible to enable this feature at driver load by setting the
   default application hint "EnableFTraceGPU=1" in /etc/powervr.ini.
@@ -247,7 +297,7 @@ static int GpuTracingSeqShow(struct seq_file *psSeqFile, void *pvData)
 
 	PVR_UNREFERENCED_PARAMETER(pvData);
 
-	seq_puts(psSeqFile, (bValue ? "Y\n" : "N\n"));
+	seq_puts(psSeqFile, (!bValue ? "N\n" : (gbGpuTraceBinary ? "B\n" : "Y\n")));
 	return 0;
 }
 
@@ -291,6 +341,15 @@ static IMG_INT GpuTracingSet(const IMG_CHAR *buffer, size_t count, loff_t uiPosi
 		case 'y':
 		case 'Y':
 		{
+			gbGpuTraceBinary = IMG_FALSE;
+			PVRGpuTraceEnabledSet(IMG_TRUE);
+			break;
+		}
+		case 'b':
+		case 'B':
+		{
+			gbGpuTraceTsValid = IMG_FALSE;
+			gbGpuTraceBinary = IMG_TRUE;
 			PVRGpuTraceEnabledSet(IMG_TRUE);
 			break;
 		}
@@ -333,7 +392,15 @@ IMG_VOID PVRGpuTraceClientWork(
 		eError = GetCtxAndJobID(ui32Pid, ui32FrameNo, ui32RTDataID, &ui32CtxId,  &psJob);
 		PVR_LOGRN_IF_ERROR(eError, "GetCtxAndJobID");
 
-		trace_gpu_job_enqueue(ui32CtxId, PVRSRV_FTRACE_JOB_GET_ID(psJob), pszKickType);
+		if (gbGpuTraceBinary)
+		{
+			trace_pvr_gpu_job(ui32CtxId, PVRSRV_FTRACE_JOB_GET_ID(psJob),
+					GpuTraceWorkType(pszKickType), PVR_GPUTRACE_BIN_KIND_ENQUEUE, 0);
+		}
+		else
+		{
+			trace_gpu_job_enqueue(ui32CtxId, PVRSRV_FTRACE_JOB_GET_ID(psJob), pszKickType);
+		}
 
 		PVRSRV_FTRACE_JOB_SET_FLAGS(psJob, PVRSRV_FTRACE_JOB_FLAG_ENQUEUED);
 	}
@@ -374,8 +441,17 @@ IMG_VOID PVRGpuTraceWorkSwitch(
 			ui32CtxId = 0;
 		}
 
-		trace_gpu_sched_switch(pszWorkType, ui64HWTimestampInOSTime,
-				ui32CtxId, KM_FTRACE_NO_PRIORITY, PVRSRV_FTRACE_JOB_GET_ID(psJob));
+		if (gbGpuTraceBinary)
+		{
+			trace_pvr_gpu_job(ui32CtxId, PVRSRV_FTRACE_JOB_GET_ID(psJob),
+					GpuTraceWorkType(pszWorkType), eSwType,
+					GpuTraceBinaryDelta(ui64HWTimestampInOSTime));
+		}
+		else
+		{
+			trace_gpu_sched_switch(pszWorkType, ui64HWTimestampInOSTime,
+					ui32CtxId, KM_FTRACE_NO_PRIORITY, PVRSRV_FTRACE_JOB_GET_ID(psJob));
+		}
 	}
 }
 
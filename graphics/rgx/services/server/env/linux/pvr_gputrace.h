@@ -71,6 +71,18 @@ typedef enum {
 } PVR_GPUTRACE_SWITCH_TYPE;
 
 
+/* Work type codes carried by the compact binary trace events */
+typedef enum {
+	PVR_GPUTRACE_WORK_TYPE_OTHER = 0,
+
+	PVR_GPUTRACE_WORK_TYPE_TA = 1,
+	PVR_GPUTRACE_WORK_TYPE_3D = 2,
+	PVR_GPUTRACE_WORK_TYPE_3DSPM = 3,
+	PVR_GPUTRACE_WORK_TYPE_TA3D = 4
+
+} PVR_GPUTRACE_WORK_TYPE;
+
+
 IMG_VOID PVRGpuTraceClientWork(
 		const IMG_UINT32 ui32Pid,
 		const IMG_UINT32 ui32FrameNo,
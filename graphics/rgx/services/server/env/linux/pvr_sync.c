@@ -82,6 +82,15 @@ struct PVR_SYNC_TIMELINE
 	/* Global timeline list support */
     struct list_head sTlList;
 
+	/* Active timeline list support. A timeline is on the active list
+	 * while it owns PVR sync points which have not yet been seen as
+	 * signalled, and only those timelines are checked on a command
+	 * complete notification. */
+	struct list_head sActiveList;
+
+	/* Number of sync points on this timeline not yet signalled */
+	atomic_t sPending;
+
 	IMG_UINT32 ui32Id;
 	atomic_t sValue;
 };
@@ -191,6 +200,13 @@ static struct
 static LIST_HEAD(gTlList);
 static DEFINE_MUTEX(gTlListLock);
 
+/* Timelines with pending sync points. Protected by gActiveTlListLock, which
+ * may be taken in atomic context; removal of a timeline additionally
+ * requires gTlListLock so that the update path can drop the spinlock while
+ * it processes an entry. */
+static LIST_HEAD(gActiveTlList);
+static DEFINE_SPINLOCK(gActiveTlListLock);
+
 /* The "defer-free" object list. Driver global. */
 static LIST_HEAD(gSyncPrimFreeList);
 static DEFINE_SPINLOCK(gSyncPrimFreeListLock);
@@ -243,6 +259,28 @@ static char* _debugInfoPt(struct sync_pt *pt)
 }
 #endif /* DEBUG_OUTPUT */
 
+/* Account for a new unsignalled sync point on a timeline, putting the
+ * timeline on the active list if it was idle. */
+static void PVRSyncTimelinePendingInc(struct PVR_SYNC_TIMELINE *psPVRTl)
+{
+	unsigned long flags;
+
+	if (atomic_inc_return(&psPVRTl->sPending) != 1)
+		return;
+
+	spin_lock_irqsave(&gActiveTlListLock, flags);
+	if (list_empty(&psPVRTl->sActiveList))
+		list_add_tail(&psPVRTl->sActiveList, &gActiveTlList);
+	spin_unlock_irqrestore(&gActiveTlListLock, flags);
+}
+
+/* The timeline stays on the active list until the update path finds the
+ * pending count at zero. */
+static inline void PVRSyncTimelinePendingDec(struct PVR_SYNC_TIMELINE *psPVRTl)
+{
+	atomic_dec(&psPVRTl->sPending);
+}
+
 static struct sync_pt *PVRSyncDup(struct sync_pt *sync_pt)
 {
 	struct PVR_SYNC_PT *psPVRPtOne = (struct PVR_SYNC_PT *)sync_pt;
@@ -266,17 +304,25 @@ static struct sync_pt *PVRSyncDup(struct sync_pt *sync_pt)
 
 	atomic_inc(&psPVRPtTwo->psSyncData->sRefCount);
 
+	if (!psPVRPtTwo->bSignaled)
+		PVRSyncTimelinePendingInc((struct PVR_SYNC_TIMELINE *)psPVRPtTwo->pt.parent);
+
 err_out:
 	return (struct sync_pt*)psPVRPtTwo;
 }
 
+/* Called with the timeline's active_list_lock held */
 static int PVRSyncHasSignaled(struct sync_pt *sync_pt)
 {
     struct PVR_SYNC_PT *psPVRPt = (struct PVR_SYNC_PT *)sync_pt;
 
-	if (ServerSyncFenceIsMeet(psPVRPt->psSyncData->psSyncKernel->psSync,
-							  psPVRPt->psSyncData->psSyncKernel->ui32SyncValue))
+	if (   !psPVRPt->bSignaled
+		&& ServerSyncFenceIsMeet(psPVRPt->psSyncData->psSyncKernel->psSync,
+								 psPVRPt->psSyncData->psSyncKernel->ui32SyncValue))
+	{
 		psPVRPt->bSignaled = IMG_TRUE;
+		PVRSyncTimelinePendingDec((struct PVR_SYNC_TIMELINE *)sync_pt->parent);
+	}
 
 	DPF("%s: r: %d # %s", __func__,
 		psPVRPt->bSignaled, _debugInfoPt(sync_pt));
@@ -299,12 +345,16 @@ static int PVRSyncCompare(struct sync_pt *a, struct sync_pt *b)
 static void PVRSyncReleaseTimeline(struct sync_timeline *psObj)
 {
 	struct PVR_SYNC_TIMELINE *psPVRTl = (struct PVR_SYNC_TIMELINE *)psObj;
+	unsigned long flags;
 
 	DPF("%s: # %s", __func__,
 		_debugInfoTl(psObj));
 
     mutex_lock(&gTlListLock);
     list_del(&psPVRTl->sTlList);
+	spin_lock_irqsave(&gActiveTlListLock, flags);
+	list_del_init(&psPVRTl->sActiveList);
+	spin_unlock_irqrestore(&gActiveTlListLock, flags);
     mutex_unlock(&gTlListLock);
 }
 
@@ -412,6 +462,8 @@ PVRSyncCreateSync(struct PVR_SYNC_TIMELINE *psPVRTl)
 	psSyncData->psSyncKernel->ui32CleanUpValue = 0;
 	psPVRPt->psSyncData = psSyncData;
 
+	PVRSyncTimelinePendingInc(psPVRTl);
+
 err_out:
 	return psPVRPt;
 
@@ -502,10 +554,25 @@ PVRSyncReleaseSyncPrim(struct PVR_SYNC_KERNEL_SYNC_PRIM *psSyncKernel)
 static void PVRSyncFreeSync(struct sync_pt *psPt)
 {
 	struct PVR_SYNC_PT *psPVRPt = (struct PVR_SYNC_PT *)psPt;
+	unsigned long flags;
 
 	DPF("%s: # %s", __func__,
 		_debugInfoPt(psPt));
 
+	/* The point is still on the active list here, so a concurrent signal
+	 * can reach PVRSyncHasSignaled. Both sides test and set bSignaled under
+	 * the active list lock so only one of them drops the pending count. */
+	if (psPVRPt->psSyncData)
+	{
+		spin_lock_irqsave(&psPt->parent->active_list_lock, flags);
+		if (!psPVRPt->bSignaled)
+		{
+			psPVRPt->bSignaled = IMG_TRUE;
+			PVRSyncTimelinePendingDec((struct PVR_SYNC_TIMELINE *)psPt->parent);
+		}
+		spin_unlock_irqrestore(&psPt->parent->active_list_lock, flags);
+	}
+
     /* Only free on the last reference */
 	if (psPVRPt->psSyncData) {
 		if (atomic_dec_return(&psPVRPt->psSyncData->sRefCount) != 0)
@@ -786,6 +853,8 @@ static int PVRSyncOpen(struct inode *inode, struct file *file)
 
 	psPVRTl->ui32Id = atomic_inc_return(&gsPVRSync.sTimelineId);
 	atomic_set(&psPVRTl->sValue, 0);
+	atomic_set(&psPVRTl->sPending, 0);
+	INIT_LIST_HEAD(&psPVRTl->sActiveList);
 
 	DPF("%s: # %s", __func__,
 		_debugInfoTl((struct sync_timeline*)psPVRTl));
@@ -1102,17 +1171,34 @@ IMG_VOID PVRSyncUpdateAllTimelines(PVRSRV_CMDCOMP_HANDLE hCmdCompHandle)
 {
 	IMG_BOOL bSignal;
 	struct PVR_SYNC_TIMELINE *psPVRTl;
-	struct list_head *psTlEntry, *psPtEntry;
+	struct list_head *psPtEntry;
+	LIST_HEAD(sDirtyList);
 	unsigned long flags;
 
 	PVR_UNREFERENCED_PARAMETER(hCmdCompHandle);
 
+	/* Only timelines with unsignalled points can be affected by this
+	 * notification. Take them off the active list for the duration of the
+	 * update; holding gTlListLock keeps them from being released. */
 	mutex_lock(&gTlListLock);
-	list_for_each(psTlEntry, &gTlList)
+	spin_lock_irqsave(&gActiveTlListLock, flags);
+	list_splice_init(&gActiveTlList, &sDirtyList);
+	spin_unlock_irqrestore(&gActiveTlListLock, flags);
+
+	for (;;)
 	{
+		spin_lock_irqsave(&gActiveTlListLock, flags);
+		if (list_empty(&sDirtyList))
+		{
+			spin_unlock_irqrestore(&gActiveTlListLock, flags);
+			break;
+		}
+		psPVRTl = list_first_entry(&sDirtyList, struct PVR_SYNC_TIMELINE,
+								   sActiveList);
+		list_del_init(&psPVRTl->sActiveList);
+		spin_unlock_irqrestore(&gActiveTlListLock, flags);
+
 		bSignal = IMG_FALSE;
-		psPVRTl =
-			container_of(psTlEntry, struct PVR_SYNC_TIMELINE, sTlList);
 
 		spin_lock_irqsave(&psPVRTl->obj.active_list_lock, flags);
 		list_for_each(psPtEntry, &psPVRTl->obj.active_list_head)
@@ -1143,6 +1229,16 @@ IMG_VOID PVRSyncUpdateAllTimelines(PVRSRV_CMDCOMP_HANDLE hCmdCompHandle)
 
 		if (bSignal)
 			sync_timeline_signal((struct sync_timeline *)psPVRTl);
+
+		/* Keep the timeline active while it still has pending points. It
+		 * may already have been re-added by a new point in the meantime. */
+		spin_lock_irqsave(&gActiveTlListLock, flags);
+		if (   atomic_read(&psPVRTl->sPending) != 0
+			&& list_empty(&psPVRTl->sActiveList))
+		{
+			list_add_tail(&psPVRTl->sActiveList, &gActiveTlList);
+		}
+		spin_unlock_irqrestore(&gActiveTlListLock, flags);
 	}
 	mutex_unlock(&gTlListLock);
 }
@@ -1269,6 +1365,15 @@ PVRSRV_ERROR PVRFDSyncQueryFenceKM(IMG_INT32 i32FDFence,
 
 	*pui32NumSyncs = 0;
 
+	/* Fast path: a fence which has already signalled as a whole needs
+	 * nothing to be waited on, so skip the per-point walk, the cleanup syncs
+	 * and any foreign fence waiter. */
+	if (!bUpdate && psFence->status > 0)
+	{
+		DPF("%s: fence %d already signalled", __func__, i32FDFence);
+		goto err_put;
+	}
+
 	/* Optimization: If the fence itself or a single sync point is
 	 * already signaled, then don't return the entry. It makes no real sense to
 	 * send CHECK commands down to the firmware when we already know they are
@@ -1288,8 +1393,10 @@ PVRSRV_ERROR PVRFDSyncQueryFenceKM(IMG_INT32 i32FDFence,
 		if(psPt->parent->ops != &gsPVR_SYNC_TIMELINE_ops)
 		{
 			/* If there are foreign sync points in this fence we will add a
-			 * shadow sync prim for them. */
-			bHaveForeignSync = IMG_TRUE;
+			 * shadow sync prim for them. Points the foreign driver has
+			 * already signalled (or errored) need no waiter. */
+			if (psPt->status == 0)
+				bHaveForeignSync = IMG_TRUE;
 		}
 		else
 		{
@@ -1322,6 +1429,14 @@ PVRSRV_ERROR PVRFDSyncQueryFenceKM(IMG_INT32 i32FDFence,
 				&&  psPVRPt->bSignaled)
 				continue;
 
+			/* The timeline may not have been updated yet for a point the
+			 * firmware has already completed; look at the sync prim directly
+			 * rather than set up a check and a cleanup sync for it. */
+			if (   !bUpdate
+				&&  ServerSyncFenceIsMeet(psPVRPt->psSyncData->psSyncKernel->psSync,
+										  psPVRPt->psSyncData->psSyncKernel->ui32SyncValue))
+				continue;
+
 			/* Save this within the sync point. */
 			aPts[*pui32NumSyncs].ui32FWAddr      = psPVRPt->psSyncData->psSyncKernel->ui32SyncPrimVAddr;
 			aPts[*pui32NumSyncs].ui32Flags       = (bUpdate ? PVRSRV_CLIENT_SYNC_PRIM_OP_UPDATE :
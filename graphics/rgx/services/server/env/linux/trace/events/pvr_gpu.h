@@ -0,0 +1,116 @@
+/*************************************************************************/ /*!
+@File
+@Copyright      Copyright (c) Imagination Technologies Ltd. All Rights Reserved
+@License        Dual MIT/GPLv2
+
+The contents of this file are subject to the MIT license as set out below.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+Alternatively, the contents of this file may be used under the terms of
+the GNU General Public License Version 2 ("GPL") in which case the provisions
+of GPL are applicable instead of those above.
+
+If you wish to allow use of your version of this file only under the terms of
+GPL, and not to allow others to use your version of this file under the terms
+of the MIT license, indicate your decision by deleting the provisions above
+and replace them with the notice and other provisions required by GPL as set
+out in the file called "GPL-COPYING" included in this distribution. If you do
+not delete the provisions above, a recipient may use your version of this file
+under the terms of either the MIT license or GPL.
+
+This License is also included in this distribution in the file called
+"MIT-COPYING".
+
+EXCEPT AS OTHERWISE STATED IN A NEGOTIATED AGREEMENT: (A) THE SOFTWARE IS
+PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT; AND (B) IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/ /**************************************************************************/
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM pvr_gpu
+
+#if !defined(_TRACE_PVR_GPU_H) || defined(TRACE_HEADER_MULTI_READ)
+#define _TRACE_PVR_GPU_H
+
+#include <linux/tracepoint.h>
+
+/*
+  Compact binary form of the gpu_job_enqueue / gpu_sched_switch events,
+  selected by writing 'B' to /sys/kernel/debug/pvr/gpu_tracing_on.
+
+  Each record carries only fixed size fields, no strings:
+    ctx   - context ID as used by the gpu.h events (0 = GPU idle)
+    job   - job ID as used by the gpu.h events
+    type  - work type, see PVR_GPUTRACE_WORK_TYPE in pvr_gputrace.h
+    kind  - 0 enqueue, 1 switch begin, 2 switch end
+    dt    - GPU timestamp in ns relative to the previous switch record,
+            0 for enqueue records which carry no GPU time
+
+  A pvr_gpu_ts_sync record carrying the absolute timestamp is emitted
+  before the first switch record and whenever a delta does not fit in
+  32 bits, so a decoder reconstructs absolute times by accumulating dt
+  from the most recent sync record.
+*/
+TRACE_EVENT(pvr_gpu_job,
+
+	TP_PROTO(u16 ctx, u32 job, u8 type, u8 kind, u32 dt),
+
+	TP_ARGS(ctx, job, type, kind, dt),
+
+	TP_STRUCT__entry(
+		__field(        u32,            dt              )
+		__field(        u32,            job             )
+		__field(        u16,            ctx             )
+		__field(        u8,             type            )
+		__field(        u8,             kind            )
+	),
+
+	TP_fast_assign(
+		__entry->dt = dt;
+		__entry->job = job;
+		__entry->ctx = ctx;
+		__entry->type = type;
+		__entry->kind = kind;
+	),
+
+	TP_printk("c=%u j=%u t=%u k=%u dt=%u",
+		(unsigned int)__entry->ctx,
+		(unsigned int)__entry->job,
+		(unsigned int)__entry->type,
+		(unsigned int)__entry->kind,
+		(unsigned int)__entry->dt)
+);
+
+TRACE_EVENT(pvr_gpu_ts_sync,
+
+	TP_PROTO(u64 ts),
+
+	TP_ARGS(ts),
+
+	TP_STRUCT__entry(
+		__field(        u64,            ts              )
+	),
+
+	TP_fast_assign(
+		__entry->ts = ts;
+	),
+
+	TP_printk("ts=%llu", (unsigned long long)__entry->ts)
+);
+
+#endif /* _TRACE_PVR_GPU_H */
+
+/* This part must be outside protection */
+#include <trace/define_trace.h>
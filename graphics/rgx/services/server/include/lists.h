@@ -316,6 +316,7 @@ DECLARE_LIST_REMOVE(PVRSRV_DEVICE_NODE);
 
 DECLARE_LIST_ANY_VA(PVRSRV_POWER_DEV);
 DECLARE_LIST_ANY_VA_2(PVRSRV_POWER_DEV, PVRSRV_ERROR, PVRSRV_OK);
+DECLARE_LIST_FOR_EACH(PVRSRV_POWER_DEV);
 DECLARE_LIST_INSERT(PVRSRV_POWER_DEV);
 DECLARE_LIST_REMOVE(PVRSRV_POWER_DEV);
 
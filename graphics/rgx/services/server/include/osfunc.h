@@ -173,6 +173,7 @@ PVRSRV_ERROR OSEventObjectDestroy(IMG_HANDLE hEventObject);
 PVRSRV_ERROR OSEventObjectSignal(IMG_HANDLE hEventObject);
 PVRSRV_ERROR OSEventObjectWait(IMG_HANDLE hOSEventKM);
 PVRSRV_ERROR OSEventObjectWaitTimeout(IMG_HANDLE hOSEventKM, IMG_UINT32 uiTimeoutMs);
+PVRSRV_ERROR OSEventObjectWaitUntimed(IMG_HANDLE hOSEventKM);
 PVRSRV_ERROR OSEventObjectOpen(IMG_HANDLE hEventObject,
 											IMG_HANDLE *phOSEvent);
 PVRSRV_ERROR OSEventObjectClose(IMG_HANDLE hOSEventKM);
@@ -229,6 +230,7 @@ typedef IMG_VOID (*PFN_TIMER_FUNC)(IMG_VOID*);
 IMG_HANDLE OSAddTimer(PFN_TIMER_FUNC pfnTimerFunc, IMG_VOID *pvData, IMG_UINT32 ui32MsTimeout);
 PVRSRV_ERROR OSRemoveTimer(IMG_HANDLE hTimer);
 PVRSRV_ERROR OSEnableTimer(IMG_HANDLE hTimer);
+PVRSRV_ERROR OSEnableTimerOnce(IMG_HANDLE hTimer, IMG_UINT32 ui32MsTimeout);
 PVRSRV_ERROR OSDisableTimer(IMG_HANDLE hTimer);
 
 
@@ -285,6 +287,7 @@ IMG_VOID OSWRLockAcquireRead(POSWR_LOCK psLock);
 IMG_VOID OSWRLockReleaseRead(POSWR_LOCK psLock);
 IMG_VOID OSWRLockAcquireWrite(POSWR_LOCK psLock);
 IMG_VOID OSWRLockReleaseWrite(POSWR_LOCK psLock);
+IMG_BOOL OSWRLockIsLocked(POSWR_LOCK psLock);
 #else
 struct _OSWR_LOCK_ {
 	IMG_UINT32 ui32Dummy;
@@ -319,6 +322,37 @@ static INLINE IMG_VOID OSWRLockReleaseWrite(POSWR_LOCK psLock)
 {
 	PVR_UNREFERENCED_PARAMETER(psLock);
 }
+
+static INLINE IMG_BOOL OSWRLockIsLocked(POSWR_LOCK psLock)
+{
+	PVR_UNREFERENCED_PARAMETER(psLock);
+	return IMG_TRUE;
+}
+#endif
+
+/* Bitmaps operated on by OSAtomicSetBit/OSAtomicClearBit are arrays of
+   IMG_UINTPTR_T, i.e. of the native word size */
+#define OS_BITMAP_WORD_BITS		(sizeof(IMG_UINTPTR_T) * 8)
+#define OS_BITMAP_WORDS(n)		(((n) + OS_BITMAP_WORD_BITS - 1) / OS_BITMAP_WORD_BITS)
+
+#if defined(__linux__)
+IMG_VOID OSAtomicSetBit(IMG_UINT32 ui32Bit, volatile IMG_UINTPTR_T *puiBitmap);
+IMG_VOID OSAtomicClearBit(IMG_UINT32 ui32Bit, volatile IMG_UINTPTR_T *puiBitmap);
+#elif defined(__GNUC__)
+/* Full barrier locked read-modify-write, as set_bit/clear_bit on Linux */
+static INLINE IMG_VOID OSAtomicSetBit(IMG_UINT32 ui32Bit, volatile IMG_UINTPTR_T *puiBitmap)
+{
+	(IMG_VOID) __sync_fetch_and_or(&puiBitmap[ui32Bit / OS_BITMAP_WORD_BITS],
+								   ((IMG_UINTPTR_T)1 << (ui32Bit % OS_BITMAP_WORD_BITS)));
+}
+
+static INLINE IMG_VOID OSAtomicClearBit(IMG_UINT32 ui32Bit, volatile IMG_UINTPTR_T *puiBitmap)
+{
+	(IMG_VOID) __sync_fetch_and_and(&puiBitmap[ui32Bit / OS_BITMAP_WORD_BITS],
+									~((IMG_UINTPTR_T)1 << (ui32Bit % OS_BITMAP_WORD_BITS)));
+}
+#else
+#error "OSAtomicSetBit/OSAtomicClearBit need an atomic implementation for this OS"
 #endif
 
 IMG_UINT64 OSDivide64r64(IMG_UINT64 ui64Divident, IMG_UINT32 ui32Divisor, IMG_UINT32 *pui32Remainder);
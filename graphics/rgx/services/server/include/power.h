@@ -48,12 +48,21 @@ extern "C" {
 #endif
 
 #include "pvrsrv_device.h"
+#include "osfunc.h"
 
 /*!
  *****************************************************************************
  *	Power management
  *****************************************************************************/
  
+typedef struct _PVRSRV_POWER_DEV_TIMING_
+{
+	IMG_UINT32						ui32LastSuspendUs;	/*!< pre+post callback time of the last power-down */
+	IMG_UINT32						ui32MaxSuspendUs;
+	IMG_UINT32						ui32LastResumeUs;	/*!< pre+post callback time of the last power-up */
+	IMG_UINT32						ui32MaxResumeUs;
+} PVRSRV_POWER_DEV_TIMING;
+
 typedef struct _PVRSRV_POWER_DEV_TAG_
 {
 	PFN_PRE_POWER					pfnDevicePrePower;
@@ -66,6 +75,11 @@ typedef struct _PVRSRV_POWER_DEV_TAG_
 	IMG_UINT32						ui32DeviceIndex;
 	PVRSRV_DEV_POWER_STATE 			eDefaultPowerState;
 	PVRSRV_DEV_POWER_STATE 			eCurrentPowerState;
+	POSWR_LOCK						hPowerLock;		/*!< shared for kicks to a powered device, exclusive for transitions */
+	IMG_BOOL						bExclusive;		/*!< set while hPowerLock is held for a transition */
+	IMG_UINT32						ui32Dependencies;	/*!< mask of device indices powered up before, and down after, this one */
+	IMG_UINT32						ui32TransitionUs;	/*!< callback time of the transition in progress */
+	PVRSRV_POWER_DEV_TIMING			sTiming;
 	struct _PVRSRV_POWER_DEV_TAG_	*psNext;
 	struct _PVRSRV_POWER_DEV_TAG_	**ppsThis;
 
@@ -90,10 +104,18 @@ PVRSRV_ERROR PVRSRVSetInitServerState(PVRSRV_INIT_SERVER_STATE	eInitServerState,
 
 
 
+/* System power lock: serialises system-wide power transitions */
 IMG_IMPORT PVRSRV_ERROR PVRSRVPowerLock(IMG_VOID);
 IMG_IMPORT IMG_VOID PVRSRVForcedPowerLock(IMG_VOID);
 IMG_IMPORT IMG_VOID PVRSRVPowerUnlock(IMG_VOID);
 
+/* Device power lock: serialises a single device's transitions against its kicks */
+IMG_IMPORT PVRSRV_ERROR PVRSRVDevicePowerLock(IMG_UINT32	ui32DeviceIndex,
+											  IMG_BOOL		bForced,
+											  IMG_BOOL		*pbShared);
+IMG_IMPORT IMG_VOID PVRSRVDevicePowerUnlock(IMG_UINT32 ui32DeviceIndex, IMG_BOOL bShared);
+IMG_IMPORT IMG_BOOL PVRSRVDevicePowerLockIsHeld(IMG_UINT32 ui32DeviceIndex);
+
 IMG_IMPORT
 PVRSRV_ERROR PVRSRVSetDevicePowerStateKM(IMG_UINT32				ui32DeviceIndex,
 										 PVRSRV_DEV_POWER_STATE	eNewPowerState,
@@ -124,6 +146,9 @@ PVRSRV_ERROR PVRSRVGetDevicePowerState(IMG_UINT32 ui32DeviceIndex, PPVRSRV_DEV_P
 IMG_IMPORT
 IMG_BOOL PVRSRVIsDevicePowered(IMG_UINT32 ui32DeviceIndex);
 
+IMG_IMPORT
+PVRSRV_ERROR PVRSRVGetDevicePowerTiming(IMG_UINT32 ui32DeviceIndex, PVRSRV_POWER_DEV_TIMING *psTiming);
+
 IMG_IMPORT
 PVRSRV_ERROR PVRSRVDevicePreClockSpeedChange(IMG_UINT32	ui32DeviceIndex,
 											 IMG_BOOL	bIdleDevice,
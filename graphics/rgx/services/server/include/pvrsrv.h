@@ -76,9 +76,10 @@ typedef struct PVRSRV_DATA_TAG
 	PHYS_HEAP					*apsRegisteredPhysHeaps[SYS_PHYS_HEAP_COUNT];
 
     PVRSRV_POWER_DEV			*psPowerDeviceList;			/*!< list of devices registered with the power manager */
-	POS_LOCK					hPowerLock;					/*!< lock for power state transitions */
+	POS_LOCK					hPowerLock;					/*!< lock for system power state transitions */
    	PVRSRV_SYS_POWER_STATE		eCurrentPowerState;			/*!< current Kernel services power state */
    	PVRSRV_SYS_POWER_STATE		eFailedPowerState;			/*!< Kernel services power state (Failed to transition to) */
+	IMG_BOOL					bParallelPower;				/*!< run independent devices' power callbacks concurrently */
 
    	PVRSRV_SERVICES_STATE		eServicesState;				/*!< global driver state */
 
@@ -147,6 +147,10 @@ struct _PVRSRV_DEVICE_CONFIG_
 	RGXFWIF_DM			eBPDM;
 	/*! A Breakpoint has been set */
 	IMG_BOOL			bBPSet;	
+
+	/*! Mask of the device indices that must be powered up before, and
+	 *! powered down after, this device */
+	IMG_UINT32			ui32PowerDependencies;
 };
 
 typedef PVRSRV_ERROR (*PFN_SYSTEM_PRE_POWER_STATE)(PVRSRV_SYS_POWER_STATE eNewPowerState);
@@ -159,6 +163,10 @@ typedef enum _PVRSRV_SYSTEM_SNOOP_MODE_ {
 	PVRSRV_SYSTEM_SNOOP_CROSS,
 } PVRSRV_SYSTEM_SNOOP_MODE;
 
+/*! Run the power callbacks of independent devices concurrently on system
+ *! power transitions, honouring PVRSRV_DEVICE_CONFIG::ui32PowerDependencies */
+#define PVRSRV_SYS_FLAGS_PARALLEL_POWER		(1U << 0)
+
 typedef struct _PVRSRV_SYSTEM_CONFIG_
 {
 	IMG_UINT32				uiSysFlags;
@@ -128,6 +128,9 @@ enum {
 #define RESMAN_CRITERIA_RESTYPE			0x00000001	/*!< match by criteria type */
 #define RESMAN_CRITERIA_PVOID_PARAM		0x00000002	/*!< match by criteria param1 */
 
+#define RESMAN_DEFER_BATCH_BUDGET_US	2000		/*!< time the clean up thread frees for before dropping the bridge lock */
+#define RESMAN_DISCONNECT_BUDGET_US		2000		/*!< time the disconnect path frees for before deferring the rest to the clean up thread */
+
 typedef PVRSRV_ERROR (*RESMAN_FREE_FN)(IMG_PVOID pvParam); 
 
 typedef struct _RESMAN_ITEM_ *PRESMAN_ITEM;
@@ -183,7 +186,8 @@ IMG_VOID PVRSRVResManDisconnect(PRESMAN_CONTEXT hResManContext);
 PVRSRV_ERROR PVRSRVResManCreateDeferContext(IMG_HANDLE hEventObj,
 										    PRESMAN_DEFER_CONTEXT *phDeferContext);
 
-IMG_BOOL PVRSRVResManFlushDeferContext(PRESMAN_DEFER_CONTEXT hDeferContext);
+PVRSRV_ERROR PVRSRVResManFlushDeferContext(PRESMAN_DEFER_CONTEXT hDeferContext,
+										   IMG_UINT32 ui32BudgetUs);
 
 IMG_VOID PVRSRVResManDestroyDeferContext(PRESMAN_DEFER_CONTEXT hDeferContext);
 
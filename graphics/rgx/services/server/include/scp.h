@@ -73,6 +73,31 @@ IMG_IMPORT
 PVRSRV_ERROR IMG_CALLCONV SCPCreate(IMG_UINT32 ui32CCBSizeLog2,
 									SCP_CONTEXT **ppsContext);
 
+/*************************************************************************/ /*!
+@Function       SCPSetOutOfOrder
+
+@Description    Allow commands to be issued out of order. By default commands
+                are issued strictly in the order they were submitted. When
+                enabled a command whose fences are met may be issued ahead of
+                earlier blocked commands as long as it uses none of their
+                syncs and they all have a drop callback. The commands it
+                overtakes are superseded: once their fences are met their
+                drop callback is called instead of their do callback and
+                their sync updates are done. Commands are still completed in
+                the order they were issued and release fences are signalled
+                in the order the commands were submitted.
+
+@Input          psSCPContext            Context to configure
+
+@Input          bOutOfOrder             IMG_TRUE to allow out of order issue
+
+@Return         None
+*/
+/*****************************************************************************/
+IMG_IMPORT
+IMG_VOID IMG_CALLCONV SCPSetOutOfOrder(SCP_CONTEXT *psContext,
+									   IMG_BOOL bOutOfOrder);
+
 /*************************************************************************/ /*!
 @Function       SCPAllocCommand
 
@@ -98,6 +123,11 @@ PVRSRV_ERROR IMG_CALLCONV SCPCreate(IMG_UINT32 ui32CCBSizeLog2,
 
 @Input          pfnCommandDo            Callback to the function to run
 
+@Input          pfnCommandDrop          Callback to call instead of pfnCommandDo
+                                        if the command is superseded, may be
+                                        IMG_NULL if the command can't be
+                                        dropped
+
 @Input          ui32ReadyDataSize       Size of command ready data to allocate in bytes
 
 @Input          pfnCommandComplete      Callback to call when the command has completed
@@ -121,6 +151,7 @@ PVRSRV_ERROR IMG_CALLCONV SCPAllocCommand(SCP_CONTEXT *psSCPContext,
 										  IMG_INT32 i32AcquireFenceFd,
 										  SCPReady pfnCommandReady,
 										  SCPDo pfnCommandDo,
+										  SCPDo pfnCommandDrop,
 										  IMG_SIZE_T ui32ReadyDataByteSize,
 										  IMG_SIZE_T ui32CompleteDataByteSize,
 										  IMG_PVOID *ppvReadyData,
@@ -163,7 +194,8 @@ PVRSRV_ERROR SCPRun(SCP_CONTEXT *psContext);
 
 @Description    Complete a command which the software command processor
                 has previously issued.
-                Note: Commands _MUST_ be completed in order
+                Note: Commands _MUST_ be completed in the order they
+                were issued
 
 @Input          psSCPContext            Context to process
 
@@ -202,6 +202,10 @@ PVRSRVSyncPrimOpCompleteKM(SERVER_OP_COOKIE *psServerCookie);
 PVRSRV_ERROR
 PVRSRVSyncPrimOpDestroyKM(SERVER_OP_COOKIE *psServerCookie);
 
+IMG_VOID ServerSyncRef(SERVER_SYNC_PRIMITIVE *psSync);
+
+IMG_VOID ServerSyncUnref(SERVER_SYNC_PRIMITIVE *psSync);
+
 IMG_UINT32 ServerSyncGetFWAddr(SERVER_SYNC_PRIMITIVE *psSync);
 
 IMG_UINT32 ServerSyncGetValue(SERVER_SYNC_PRIMITIVE *psSync);
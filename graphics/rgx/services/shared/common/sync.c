@@ -546,6 +546,101 @@ static INLINE IMG_UINT32 _Log2(IMG_UINT32 ui32Align)
 	return ui32Log2Align;
 }
 
+static SYNC_PRIM_MAGAZINE *_SyncPrimGetMagazine(SYNC_PRIM_CONTEXT *psContext)
+{
+#if defined(__KERNEL__)
+	return &psContext->asMagazine[OSGetCurrentThreadIDKM() % SYNC_PRIM_MAGAZINE_COUNT];
+#else
+	return &psContext->asMagazine[0];
+#endif
+}
+
+static SYNC_PRIM *_SyncPrimMagazinePop(SYNC_PRIM_MAGAZINE *psMagazine)
+{
+	SYNC_PRIM *psSyncInt = IMG_NULL;
+
+	OSLockAcquire(psMagazine->hLock);
+	if (psMagazine->ui32Count != 0)
+	{
+		psSyncInt = psMagazine->apsSyncPrim[--psMagazine->ui32Count];
+	}
+	OSLockRelease(psMagazine->hLock);
+
+	return psSyncInt;
+}
+
+static IMG_BOOL _SyncPrimMagazinePush(SYNC_PRIM_MAGAZINE *psMagazine,
+									  SYNC_PRIM *psSyncInt)
+{
+	IMG_BOOL bRet = IMG_FALSE;
+
+	OSLockAcquire(psMagazine->hLock);
+	if (psMagazine->ui32Count < SYNC_PRIM_MAGAZINE_SIZE)
+	{
+		psMagazine->apsSyncPrim[psMagazine->ui32Count++] = psSyncInt;
+		bRet = IMG_TRUE;
+	}
+	OSLockRelease(psMagazine->hLock);
+
+	return bRet;
+}
+
+/*
+	Allocate a local sync prim from the sub-allocation RA, importing a new
+	sync block from the server if the arena has run dry
+*/
+static PVRSRV_ERROR _SyncPrimLocalAlloc(SYNC_PRIM_CONTEXT *psContext,
+										SYNC_PRIM **ppsSyncInt)
+{
+	SYNC_PRIM_BLOCK *psSyncBlock;
+	SYNC_PRIM *psNewSync;
+	RA_BASE_T uiSpanAddr;
+
+	psNewSync = OSAllocMem(sizeof(SYNC_PRIM));
+	if (psNewSync == IMG_NULL)
+	{
+		return PVRSRV_ERROR_OUT_OF_MEMORY;
+	}
+
+	if (!RA_Alloc(psContext->psSubAllocRA,
+				  sizeof(IMG_UINT32),
+				  0,
+				  sizeof(IMG_UINT32),
+				  &uiSpanAddr,
+				  IMG_NULL,
+				  (RA_PERISPAN_HANDLE *) &psSyncBlock))
+	{
+		OSFreeMem(psNewSync);
+		return PVRSRV_ERROR_OUT_OF_MEMORY;
+	}
+	psNewSync->eType = SYNC_PRIM_TYPE_LOCAL;
+	psNewSync->u.sLocal.uiSpanAddr = uiSpanAddr;
+	psNewSync->u.sLocal.psSyncBlock = psSyncBlock;
+	SyncPrimGetCPULinAddr(psNewSync);
+
+	*ppsSyncInt = psNewSync;
+	return PVRSRV_OK;
+}
+
+/*
+	Return every cached sync prim to the RA so the sync blocks can be
+	unimported
+*/
+static IMG_VOID _SyncPrimMagazinesDrain(SYNC_PRIM_CONTEXT *psContext)
+{
+	IMG_UINT32 i;
+	SYNC_PRIM *psSyncInt;
+
+	for (i = 0; i < SYNC_PRIM_MAGAZINE_COUNT; i++)
+	{
+		while ((psSyncInt = _SyncPrimMagazinePop(&psContext->asMagazine[i])) != IMG_NULL)
+		{
+			SyncPrimLocalFree(psSyncInt);
+			OSFreeMem(psSyncInt);
+		}
+	}
+}
+
 /*
 	External interfaces
 */
@@ -557,6 +652,7 @@ SyncPrimContextCreate(SYNC_BRIDGE_HANDLE hBridge,
 {
 	SYNC_PRIM_CONTEXT *psContext;
 	PVRSRV_ERROR eError;
+	IMG_UINT32 i;
 
 	psContext = OSAllocMem(sizeof(SYNC_PRIM_CONTEXT));
 	if (psContext == IMG_NULL)
@@ -573,6 +669,16 @@ SyncPrimContextCreate(SYNC_BRIDGE_HANDLE hBridge,
 	{
 		goto fail_lockcreate;
 	}
+
+	for (i = 0; i < SYNC_PRIM_MAGAZINE_COUNT; i++)
+	{
+		psContext->asMagazine[i].ui32Count = 0;
+		eError = OSLockCreate(&psContext->asMagazine[i].hLock, LOCK_TYPE_PASSIVE);
+		if (eError != PVRSRV_OK)
+		{
+			goto fail_magazinelock;
+		}
+	}
 	
 	OSSNPrintf(psContext->azName, SYNC_PRIM_NAME_SIZE, "Sync Prim RA-%p", psContext);
 	OSSNPrintf(psContext->azSpanName, SYNC_PRIM_NAME_SIZE, "Sync Prim span RA-%p", psContext);
@@ -639,6 +745,12 @@ SyncPrimContextCreate(SYNC_BRIDGE_HANDLE hBridge,
 fail_span:
 	RA_Delete(psContext->psSubAllocRA);
 fail_suballoc:
+	i = SYNC_PRIM_MAGAZINE_COUNT;
+fail_magazinelock:
+	while (i-- > 0)
+	{
+		OSLockDestroy(psContext->asMagazine[i].hLock);
+	}
 	OSLockDestroy(psContext->hLock);
 fail_lockcreate:
 	OSFreeMem(psContext);
@@ -650,6 +762,7 @@ IMG_INTERNAL IMG_VOID SyncPrimContextDestroy(PSYNC_PRIM_CONTEXT hSyncPrimContext
 {
 	SYNC_PRIM_CONTEXT *psContext = hSyncPrimContext;
 	IMG_BOOL bDoRefCheck = IMG_TRUE;
+	IMG_UINT32 i;
 
 /* FIXME */
 #if defined(__KERNEL__)
@@ -659,6 +772,9 @@ IMG_INTERNAL IMG_VOID SyncPrimContextDestroy(PSYNC_PRIM_CONTEXT hSyncPrimContext
 		bDoRefCheck =  IMG_FALSE;
 	}
 #endif
+	/* Cached sync prims hold references on their sync blocks */
+	_SyncPrimMagazinesDrain(psContext);
+
 	OSLockAcquire(psContext->hLock);
 	if (--psContext->ui32RefCount != 0)
 	{
@@ -681,52 +797,69 @@ IMG_INTERNAL IMG_VOID SyncPrimContextDestroy(PSYNC_PRIM_CONTEXT hSyncPrimContext
 
 	RA_Delete(psContext->psSpanRA);
 	RA_Delete(psContext->psSubAllocRA);
+	for (i = 0; i < SYNC_PRIM_MAGAZINE_COUNT; i++)
+	{
+		OSLockDestroy(psContext->asMagazine[i].hLock);
+	}
 	OSLockDestroy(psContext->hLock);
 	OSFreeMem(psContext);
 }
 
+IMG_INTERNAL PVRSRV_ERROR SyncPrimContextReserve(PSYNC_PRIM_CONTEXT hSyncPrimContext,
+												 IMG_UINT32 ui32SyncCount)
+{
+	SYNC_PRIM_CONTEXT *psContext = hSyncPrimContext;
+	SYNC_PRIM *psSyncInt;
+	PVRSRV_ERROR eError;
+	IMG_UINT32 i;
+
+	if (ui32SyncCount > SYNC_PRIM_MAGAZINE_COUNT * SYNC_PRIM_MAGAZINE_SIZE)
+	{
+		ui32SyncCount = SYNC_PRIM_MAGAZINE_COUNT * SYNC_PRIM_MAGAZINE_SIZE;
+	}
+
+	/* Spread the reserve evenly over the magazines */
+	for (i = 0; i < ui32SyncCount; i++)
+	{
+		eError = _SyncPrimLocalAlloc(psContext, &psSyncInt);
+		if (eError != PVRSRV_OK)
+		{
+			return eError;
+		}
+
+		if (!_SyncPrimMagazinePush(&psContext->asMagazine[i % SYNC_PRIM_MAGAZINE_COUNT],
+								   psSyncInt))
+		{
+			SyncPrimLocalFree(psSyncInt);
+			OSFreeMem(psSyncInt);
+			break;
+		}
+	}
+
+	return PVRSRV_OK;
+}
+
 IMG_INTERNAL PVRSRV_ERROR SyncPrimAlloc(PSYNC_PRIM_CONTEXT hSyncPrimContext,
 										PVRSRV_CLIENT_SYNC_PRIM **ppsSync)
 {
 	SYNC_PRIM_CONTEXT *psContext = hSyncPrimContext;
-	SYNC_PRIM_BLOCK *psSyncBlock;
 	SYNC_PRIM *psNewSync;
 	PVRSRV_ERROR eError;
-	RA_BASE_T uiSpanAddr;
 
-	psNewSync = OSAllocMem(sizeof(SYNC_PRIM));
+	/* Fast path: reuse a sync prim from this thread's magazine */
+	psNewSync = _SyncPrimMagazinePop(_SyncPrimGetMagazine(psContext));
 	if (psNewSync == IMG_NULL)
 	{
-		eError = PVRSRV_ERROR_OUT_OF_MEMORY;
-		goto fail_alloc;
+		eError = _SyncPrimLocalAlloc(psContext, &psNewSync);
+		if (eError != PVRSRV_OK)
+		{
+			return eError;
+		}
 	}
 
-	if (!RA_Alloc(psContext->psSubAllocRA,
-				  sizeof(IMG_UINT32),
-				  0,
-				  sizeof(IMG_UINT32),
-				  &uiSpanAddr,
-				  IMG_NULL,
-				  (RA_PERISPAN_HANDLE *) &psSyncBlock))
-	{
-		eError = PVRSRV_ERROR_OUT_OF_MEMORY;
-		goto fail_raalloc;
-	}
-	psNewSync->eType = SYNC_PRIM_TYPE_LOCAL;
-	psNewSync->u.sLocal.uiSpanAddr = uiSpanAddr;
-	psNewSync->u.sLocal.psSyncBlock = psSyncBlock;
-	SyncPrimGetCPULinAddr(psNewSync);
 	*ppsSync = &psNewSync->sCommon;
 
-
 	return PVRSRV_OK;
-
-fail_raalloc:
-	OSFreeMem(psNewSync);
-fail_alloc:
-	PVR_ASSERT(eError != PVRSRV_OK);
-
-	return eError;
 }
 
 IMG_INTERNAL IMG_VOID SyncPrimFree(PVRSRV_CLIENT_SYNC_PRIM *psSync)
@@ -738,6 +871,13 @@ IMG_INTERNAL IMG_VOID SyncPrimFree(PVRSRV_CLIENT_SYNC_PRIM *psSync)
 
 	if (psSyncInt->eType == SYNC_PRIM_TYPE_LOCAL)
 	{
+		SYNC_PRIM_CONTEXT *psContext = psSyncInt->u.sLocal.psSyncBlock->psContext;
+
+		/* Keep the span allocated and park the sync prim for reuse */
+		if (_SyncPrimMagazinePush(_SyncPrimGetMagazine(psContext), psSyncInt))
+		{
+			return;
+		}
 		SyncPrimLocalFree(psSyncInt);
 	}
 	else if (psSyncInt->eType == SYNC_PRIM_TYPE_SERVER)
@@ -72,6 +72,26 @@ SyncPrimContextCreate(SYNC_BRIDGE_HANDLE	hBridge,
 					  IMG_HANDLE			hDeviceNode,
 					  PSYNC_PRIM_CONTEXT	*hSyncPrimContext);
 
+/*************************************************************************/ /*!
+@Function       SyncPrimContextReserve
+
+@Description    Pre-allocate synchronisation primitives into the free
+                caches of a synchronisation context, so that subsequent
+                SyncPrimAlloc calls need neither a new sync block nor a
+                call to the server
+
+@Input          hSyncPrimContext        Handle to the synchronisation
+                                        primitive context
+
+@Input          ui32SyncCount           Number of primitives to reserve
+
+@Return         PVRSRV_OK if the primitives were reserved
+*/
+/*****************************************************************************/
+PVRSRV_ERROR
+SyncPrimContextReserve(PSYNC_PRIM_CONTEXT	hSyncPrimContext,
+					   IMG_UINT32			ui32SyncCount);
+
 /*************************************************************************/ /*!
 @Function       SyncPrimContextDestroy
 
@@ -56,6 +56,26 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 	Private structure's
 */
 #define SYNC_PRIM_NAME_SIZE		50
+
+/*
+	Sync prim magazines
+
+	Freed local sync prims are parked in a small per-context cache instead
+	of being returned to the sub-allocation RA, so that the common
+	alloc/free pair does not touch the RA or the bridge. Callers are spread
+	over several magazines by thread so that each magazine lock is
+	normally uncontended.
+*/
+#define SYNC_PRIM_MAGAZINE_COUNT	4
+#define SYNC_PRIM_MAGAZINE_SIZE		32
+
+typedef struct _SYNC_PRIM_MAGAZINE_
+{
+	POS_LOCK					hLock;							/*!< Lock for this magazine */
+	IMG_UINT32					ui32Count;						/*!< Number of cached sync prims */
+	struct _SYNC_PRIM_			*apsSyncPrim[SYNC_PRIM_MAGAZINE_SIZE];	/*!< Cached sync prims */
+} SYNC_PRIM_MAGAZINE;
+
 typedef struct _SYNC_PRIM_CONTEXT_
 {
 	SYNC_BRIDGE_HANDLE			hBridge;						/*!< Bridge handle */
@@ -66,6 +86,7 @@ typedef struct _SYNC_PRIM_CONTEXT_
 	RA_ARENA					*psSpanRA;						/*!< RA used for span management of SubAllocRA */
 	IMG_UINT32					ui32RefCount;					/*!< Refcount for this context */
 	POS_LOCK					hLock;							/*!< Lock for this context */
+	SYNC_PRIM_MAGAZINE			asMagazine[SYNC_PRIM_MAGAZINE_COUNT];	/*!< Free sync prim caches */
 } SYNC_PRIM_CONTEXT;
 
 typedef struct _SYNC_PRIM_BLOCK_
@@ -116,6 +116,7 @@ typedef struct _DBG_STREAM_
 	struct _DBG_STREAM_ *psInitStream;
 	DBG_STREAM_CONTROL *psCtrl;
 	IMG_BOOL   bCircularAllowed;
+	IMG_BOOL   bCompressed;			/*!< data is written as DEBUG_FLAGS_COMPRESSED packets */
 	IMG_PVOID  pvBase;
 	IMG_UINT32 ui32Size;
 	IMG_UINT32 ui32RPtr;
@@ -202,6 +203,8 @@ IMG_UINT32 IMG_CALLCONV DBGDrivWriteString(PDBG_STREAM psStream,IMG_CHAR * pszSt
 IMG_UINT32 IMG_CALLCONV DBGDrivReadString(PDBG_STREAM psStream,IMG_CHAR * pszString,IMG_UINT32 ui32Limit);
 IMG_UINT32 IMG_CALLCONV DBGDrivWrite(PDBG_STREAM psStream,IMG_UINT8 *pui8InBuf,IMG_UINT32 ui32InBuffSize,IMG_UINT32 ui32Level);
 IMG_UINT32 IMG_CALLCONV DBGDrivRead(PDBG_STREAM psStream, IMG_BOOL bReadInitBuffer, IMG_UINT32 ui32OutBufferSize,IMG_UINT8 *pui8OutBuf);
+IMG_UINT32 IMG_CALLCONV DBGDrivAcquireRead(PDBG_STREAM psStream, IMG_BOOL bReadInitBuffer, IMG_UINT8 **ppui8Data);
+IMG_VOID   IMG_CALLCONV DBGDrivReleaseRead(PDBG_STREAM psStream, IMG_BOOL bReadInitBuffer, IMG_UINT32 ui32Consumed);
 IMG_VOID   IMG_CALLCONV DBGDrivSetCaptureMode(PDBG_STREAM psStream,IMG_UINT32 ui32Mode,IMG_UINT32 ui32Start,IMG_UINT32 ui32Stop,IMG_UINT32 ui32SampleRate);
 IMG_VOID   IMG_CALLCONV DBGDrivSetOutputMode(PDBG_STREAM psStream,IMG_UINT32 ui32OutMode);
 IMG_VOID   IMG_CALLCONV DBGDrivSetDebugLevel(PDBG_STREAM psStream,IMG_UINT32 ui32DebugLevel);
@@ -221,6 +224,8 @@ IMG_UINT32 IMG_CALLCONV DBGDrivWriteLF(PDBG_STREAM psStream, IMG_UINT8 *pui8InBu
 IMG_UINT32 IMG_CALLCONV DBGDrivReadLF(PDBG_STREAM psStream, IMG_UINT32 ui32OutBuffSize, IMG_UINT8 *pui8OutBuf);
 IMG_UINT32 IMG_CALLCONV DBGDrivGetStreamOffset(PDBG_STREAM psStream);
 IMG_VOID   IMG_CALLCONV DBGDrivSetStreamOffset(PDBG_STREAM psStream, IMG_UINT32 ui32StreamOffset);
+IMG_UINT32 IMG_CALLCONV DBGDrivGetStreamFlags(PDBG_STREAM psStream);
+IMG_BOOL   IMG_CALLCONV DBGDrivSetStreamFlags(PDBG_STREAM psStream, IMG_UINT32 ui32Flags);
 IMG_BOOL   IMG_CALLCONV DBGDrivIsCaptureFrame(PDBG_STREAM psStream, IMG_BOOL bCheckPreviousFrame);
 IMG_VOID   IMG_CALLCONV DBGDrivWaitForEvent(DBG_EVENT eEvent);
 //ExtDBGDrivWaitForEvent
@@ -653,6 +658,42 @@ IMG_UINT32 IMG_CALLCONV ExtDBGDrivGetMarker(PDBG_STREAM psStream)
 	return ui32Marker;
 }
 
+/*!
+ @name	ExtDBGDrivGetStreamFlags
+ */
+IMG_UINT32 IMG_CALLCONV ExtDBGDrivGetStreamFlags(PDBG_STREAM psStream)
+{
+	IMG_UINT32	ui32Flags;
+
+	/* Aquire API Mutex */
+	HostAquireMutex(g_pvAPIMutex);
+
+	ui32Flags = DBGDrivGetStreamFlags(psStream);
+
+	/* Release API Mutex */
+	HostReleaseMutex(g_pvAPIMutex);
+
+	return ui32Flags;
+}
+
+/*!
+ @name	ExtDBGDrivSetStreamFlags
+ */
+IMG_BOOL IMG_CALLCONV ExtDBGDrivSetStreamFlags(PDBG_STREAM psStream, IMG_UINT32 ui32Flags)
+{
+	IMG_BOOL	bRet;
+
+	/* Aquire API Mutex */
+	HostAquireMutex(g_pvAPIMutex);
+
+	bRet = DBGDrivSetStreamFlags(psStream, ui32Flags);
+
+	/* Release API Mutex */
+	HostReleaseMutex(g_pvAPIMutex);
+
+	return bRet;
+}
+
 /*!
  @name	ExtDBGDrivWriteLF
  */
@@ -996,6 +1037,141 @@ static void Write(PDBG_STREAM psStream,IMG_PUINT8 pui8Data,IMG_UINT32 ui32InBuff
 }
 
 
+/*
+	Shortest run of identical words worth emitting as a repeat packet. A repeat
+	packet costs two words, so shorter runs are cheaper left in a literal.
+*/
+#define DBGDRIV_COMPRESS_MIN_RUN	4
+
+/*!****************************************************************************
+ @name		RunLength
+ @brief		Counts the identical 32-bit words at the start of a buffer.
+ @param		pui8Data - input buffer
+ @param		ui32Size - bytes available in input buffer
+ @param		ui32MaxWords - stop counting after this many words
+ @return	number of leading identical words, 0 if less than a word remains
+*****************************************************************************/
+static IMG_UINT32 RunLength(IMG_UINT8 *pui8Data, IMG_UINT32 ui32Size, IMG_UINT32 ui32MaxWords)
+{
+	IMG_UINT32 ui32Words;
+	IMG_UINT8 *pui8Next;
+
+	if (ui32Size < sizeof(IMG_UINT32))
+	{
+		return(0);
+	}
+
+	ui32Words = 1;
+	pui8Next = pui8Data + sizeof(IMG_UINT32);
+
+	while ((ui32Words < ui32MaxWords) &&
+		   ((ui32Words + 1) * sizeof(IMG_UINT32) <= ui32Size) &&
+		   (pui8Next[0] == pui8Data[0]) &&
+		   (pui8Next[1] == pui8Data[1]) &&
+		   (pui8Next[2] == pui8Data[2]) &&
+		   (pui8Next[3] == pui8Data[3]))
+	{
+		ui32Words++;
+		pui8Next += sizeof(IMG_UINT32);
+	}
+
+	return(ui32Words);
+}
+
+/*!****************************************************************************
+ @name		WriteCompressed
+ @brief		Run length encodes data from a buffer straight into the selected
+			stream. Only whole packets are written so the reader never sees a
+			truncated one. The stream offset still advances by the number of
+			uncompressed bytes so callers' offsets and markers remain valid.
+ @param		psStream - stream for output
+ @param		pui8InBuf - input buffer
+ @param		ui32InBuffSize - size of input
+ @param		ui32Space - bytes of stream space that may be used
+ @return	input bytes consumed
+*****************************************************************************/
+static IMG_UINT32 WriteCompressed(PDBG_STREAM psStream,IMG_UINT8 * pui8InBuf,IMG_UINT32 ui32InBuffSize,IMG_UINT32 ui32Space)
+{
+	IMG_UINT32 ui32DataWritten = psStream->ui32DataWritten;
+	IMG_UINT32 ui32Consumed = 0;
+	IMG_UINT32 ui32Remaining;
+	IMG_UINT32 ui32Header;
+	IMG_UINT32 ui32Len;
+
+	while (ui32Consumed < ui32InBuffSize)
+	{
+		ui32Remaining = ui32InBuffSize - ui32Consumed;
+		ui32Len = RunLength(pui8InBuf + ui32Consumed,
+							ui32Remaining,
+							DEBUG_COMPRESSED_PACKET_MAXLEN / sizeof(IMG_UINT32));
+
+		if (ui32Len >= DBGDRIV_COMPRESS_MIN_RUN)
+		{
+			/*
+				Repeat packet: header followed by the repeated word.
+			*/
+			if (ui32Space < (2 * sizeof(IMG_UINT32)))
+			{
+				break;
+			}
+
+			ui32Len *= sizeof(IMG_UINT32);
+			ui32Header = DEBUG_COMPRESSED_PACKET_REPEAT | ui32Len;
+
+			Write(psStream, (IMG_UINT8 *) &ui32Header, sizeof(ui32Header));
+			Write(psStream, pui8InBuf + ui32Consumed, sizeof(IMG_UINT32));
+			ui32Space -= 2 * sizeof(IMG_UINT32);
+		}
+		else
+		{
+			/*
+				Literal packet: gather words up to the start of the next run.
+			*/
+			ui32Len = 0;
+			while ((ui32Len < ui32Remaining) && (ui32Len < DEBUG_COMPRESSED_PACKET_MAXLEN))
+			{
+				if ((ui32Remaining - ui32Len) < sizeof(IMG_UINT32))
+				{
+					ui32Len = ui32Remaining;
+					break;
+				}
+
+				if ((ui32Len > 0) &&
+					(RunLength(pui8InBuf + ui32Consumed + ui32Len,
+							   ui32Remaining - ui32Len,
+							   DBGDRIV_COMPRESS_MIN_RUN) >= DBGDRIV_COMPRESS_MIN_RUN))
+				{
+					break;
+				}
+
+				ui32Len += sizeof(IMG_UINT32);
+			}
+
+			if (ui32Space <= sizeof(IMG_UINT32))
+			{
+				break;
+			}
+
+			if (ui32Len > (ui32Space - sizeof(IMG_UINT32)))
+			{
+				ui32Len = ui32Space - sizeof(IMG_UINT32);
+			}
+
+			ui32Header = ui32Len;
+
+			Write(psStream, (IMG_UINT8 *) &ui32Header, sizeof(ui32Header));
+			Write(psStream, pui8InBuf + ui32Consumed, ui32Len);
+			ui32Space -= sizeof(IMG_UINT32) + ui32Len;
+		}
+
+		ui32Consumed += ui32Len;
+	}
+
+	psStream->ui32DataWritten = ui32DataWritten + ui32Consumed;
+
+	return(ui32Consumed);
+}
+
 /*!****************************************************************************
  @name		MonoOut
  @brief		Output data to mono display. [Possibly deprecated]
@@ -1141,18 +1317,28 @@ static IMG_UINT32 WriteExpandingBuffer(PDBG_STREAM psStream,IMG_UINT8 * pui8InBu
 		}
 	}
 
-	/*
-		Only copy what we can..
-	*/
-	if (ui32Space <= (ui32InBuffSize + 4))
+	if (psStream->bCompressed)
 	{
-		ui32InBuffSize = ui32Space - 4;
+		/*
+			Encode straight into the stream, keeping the usual slack.
+		*/
+		ui32InBuffSize = WriteCompressed(psStream, pui8InBuf, ui32InBuffSize, ui32Space - 4);
 	}
+	else
+	{
+		/*
+			Only copy what we can..
+		*/
+		if (ui32Space <= (ui32InBuffSize + 4))
+		{
+			ui32InBuffSize = ui32Space - 4;
+		}
 
-	/*
-		Write the stuff...
-	*/
-	Write(psStream,pui8InBuf,ui32InBuffSize);
+		/*
+			Write the stuff...
+		*/
+		Write(psStream,pui8InBuf,ui32InBuffSize);
+	}
 
 #if defined(SUPPORT_DBGDRV_EVENT_OBJECTS)
 	if (ui32InBuffSize)
@@ -1245,8 +1431,8 @@ IMG_VOID * IMG_CALLCONV DBGDrivCreateStream(IMG_CHAR *		pszName,
 		return((IMG_VOID *) 0);
 	}
 
-	/* Setup control state */
-	psCtrl->ui32Flags = ui32Flags;
+	/* Setup control state, compression is only ever requested by the reader */
+	psCtrl->ui32Flags = ui32Flags & ~DEBUG_FLAGS_COMPRESSED;
 	psCtrl->ui32CapMode = ui32CapMode;
 	psCtrl->ui32OutMode = ui32OutMode;
 	psCtrl->ui32DebugLevel = DEBUG_LEVEL_0;
@@ -1269,6 +1455,7 @@ IMG_VOID * IMG_CALLCONV DBGDrivCreateStream(IMG_CHAR *		pszName,
 	psStream->ui32DataWritten = 0;
 	psStream->ui32Marker = 0;
 	psStream->bCircularAllowed = IMG_TRUE;
+	psStream->bCompressed = IMG_FALSE;
 	psStream->ui32InitPhaseWOff = 0;
 
 	/* Allocate memory for buffer */
@@ -1307,6 +1494,7 @@ IMG_VOID * IMG_CALLCONV DBGDrivCreateStream(IMG_CHAR *		pszName,
 	psInitStream->ui32DataWritten = 0;
 	psInitStream->ui32Marker = 0;
 	psInitStream->bCircularAllowed = IMG_FALSE;
+	psInitStream->bCompressed = IMG_FALSE;
 	psInitStream->ui32InitPhaseWOff = 0;
 	psStream->psInitStream = psInitStream;
 
@@ -1576,6 +1764,10 @@ IMG_VOID * IMG_CALLCONV DBGDrivFindStream(IMG_CHAR * pszName, IMG_BOOL bResetStr
 		psStream->ui32RPtr = 0;
 		psStream->ui32WPtr = 0;
 		psStream->ui32DataWritten = psStream->psInitStream->ui32DataWritten;
+
+		/* A new reader gets plain data until it asks for compression */
+		psStream->bCompressed = IMG_FALSE;
+		psStream->psCtrl->ui32Flags &= ~DEBUG_FLAGS_COMPRESSED;
 		if (psStream->psCtrl->bInitPhaseComplete == IMG_FALSE)
 		{
 			if (psStream->psCtrl->ui32Flags & DEBUG_FLAGS_TEXTSTREAM)
@@ -2176,15 +2368,16 @@ IMG_UINT32 IMG_CALLCONV DBGDrivWrite2(PDBG_STREAM psMainStream,IMG_UINT8 * pui8I
 }
 
 /*!****************************************************************************
- @name		DBGDrivRead
- @brief		Read from debug driver buffers
+ @name		DBGDrivAcquireRead
+ @brief		Exposes the next contiguous run of unread data in a stream without
+			copying it. The data stays valid until DBGDrivReleaseRead is called
+			or the API mutex is dropped, whichever comes first.
  @param		psMainStream - stream
  @param		bReadInitBuffer - whether to read from the init stream or the main stream
- @param		ui32OutBuffSize - available space in client buffer
- @param		pui8OutBuf - output buffer
- @return	bytes read, 0 if failure occurred
+ @param		ppui8Data - receives a pointer to the data in the stream buffer
+ @return	bytes available at *ppui8Data, 0 if none or failure occurred
 *****************************************************************************/
-IMG_UINT32 IMG_CALLCONV DBGDrivRead(PDBG_STREAM psMainStream, IMG_BOOL bReadInitBuffer, IMG_UINT32 ui32OutBuffSize,IMG_UINT8 * pui8OutBuf)
+IMG_UINT32 IMG_CALLCONV DBGDrivAcquireRead(PDBG_STREAM psMainStream, IMG_BOOL bReadInitBuffer, IMG_UINT8 **ppui8Data)
 {
 	IMG_UINT32 ui32Data;
 	DBG_STREAM *psStream;
@@ -2194,7 +2387,7 @@ IMG_UINT32 IMG_CALLCONV DBGDrivRead(PDBG_STREAM psMainStream, IMG_BOOL bReadInit
 	*/
 	if (!StreamValidForRead(psMainStream))
 	{
-		PVR_DPF((PVR_DBG_ERROR, "DBGDrivRead: buffer %p is invalid", psMainStream));
+		PVR_DPF((PVR_DBG_ERROR, "DBGDrivAcquireRead: buffer %p is invalid", psMainStream));
 		return(0);
 	}
 
@@ -2237,11 +2430,11 @@ IMG_UINT32 IMG_CALLCONV DBGDrivRead(PDBG_STREAM psMainStream, IMG_BOOL bReadInit
 	}
 
 	/*
-		Only transfer what target buffer can handle.
+		Only hand out up to the end of the circular buffer.
 	*/
-	if (ui32Data > ui32OutBuffSize)
+	if ((psStream->ui32RPtr + ui32Data) > psStream->ui32Size)
 	{
-		ui32Data = ui32OutBuffSize;
+		ui32Data = psStream->ui32Size - psStream->ui32RPtr;
 	}
 
 	PVR_DPF((PVR_DBGDRIV_MESSAGE, "Send %x b from %s: Roff = %x, WOff = %x",
@@ -2250,41 +2443,98 @@ IMG_UINT32 IMG_CALLCONV DBGDrivRead(PDBG_STREAM psMainStream, IMG_BOOL bReadInit
 			psStream->ui32RPtr,
 			psStream->ui32WPtr));
 
+	*ppui8Data = (IMG_UINT8 *)((IMG_UINTPTR_T)psStream->pvBase + psStream->ui32RPtr);
+
+	return(ui32Data);
+}
+
+/*!****************************************************************************
+ @name		DBGDrivReleaseRead
+ @brief		Consumes data previously exposed by DBGDrivAcquireRead
+ @param		psMainStream - stream
+ @param		bReadInitBuffer - whether to read from the init stream or the main stream
+ @param		ui32Consumed - bytes consumed, no more than DBGDrivAcquireRead returned
+ @return	none
+*****************************************************************************/
+IMG_VOID IMG_CALLCONV DBGDrivReleaseRead(PDBG_STREAM psMainStream, IMG_BOOL bReadInitBuffer, IMG_UINT32 ui32Consumed)
+{
+	DBG_STREAM *psStream;
+
 	/*
-		Split copy into two bits as necessay.
+		Validate buffer.
 	*/
-	if ((psStream->ui32RPtr + ui32Data) > psStream->ui32Size)
-	{	/* Calc block 1 and block 2 sizes */
-		IMG_UINT32 ui32B1 = psStream->ui32Size - psStream->ui32RPtr;
-		IMG_UINT32 ui32B2 = ui32Data - ui32B1;
+	if (!StreamValidForRead(psMainStream))
+	{
+		PVR_DPF((PVR_DBG_ERROR, "DBGDrivReleaseRead: buffer %p is invalid", psMainStream));
+		return;
+	}
 
-		/* Copy up to end of circular buffer */
-		HostMemCopy((IMG_VOID *) pui8OutBuf,
-				(IMG_VOID *)((IMG_UINTPTR_T)psStream->pvBase + psStream->ui32RPtr),
-				ui32B1);
+	if(bReadInitBuffer)
+	{
+		psStream = psMainStream->psInitStream;
+	}
+	else
+	{
+		psStream = psMainStream;
+	}
 
-		/* Copy from start of circular buffer */
-		HostMemCopy((IMG_VOID *)(pui8OutBuf + ui32B1),
-				psStream->pvBase,
-				ui32B2);
+	if ((psStream->ui32RPtr + ui32Consumed) > psStream->ui32Size)
+	{
+		PVR_DPF((PVR_DBG_ERROR, "DBGDrivReleaseRead: %x b from %s overruns buffer", ui32Consumed, psStream->szName));
+		return;
+	}
+
+	/* Update read pointer now that the data has been consumed */
+	psStream->ui32RPtr += ui32Consumed;
 
-		/* Update read pointer now that we've copied the data out */
-		psStream->ui32RPtr = ui32B2;
+	/* Check for wrapping */
+	if (psStream->ui32RPtr == psStream->ui32Size)
+	{
+		psStream->ui32RPtr = 0;
 	}
-	else
-	{	/* Copy data from wherever */
-		HostMemCopy((IMG_VOID *) pui8OutBuf,
-				(IMG_VOID *)((IMG_UINTPTR_T)psStream->pvBase + psStream->ui32RPtr),
-				ui32Data);
+}
+
+/*!****************************************************************************
+ @name		DBGDrivRead
+ @brief		Read from debug driver buffers
+ @param		psMainStream - stream
+ @param		bReadInitBuffer - whether to read from the init stream or the main stream
+ @param		ui32OutBuffSize - available space in client buffer
+ @param		pui8OutBuf - output buffer
+ @return	bytes read, 0 if failure occurred
+*****************************************************************************/
+IMG_UINT32 IMG_CALLCONV DBGDrivRead(PDBG_STREAM psMainStream, IMG_BOOL bReadInitBuffer, IMG_UINT32 ui32OutBuffSize,IMG_UINT8 * pui8OutBuf)
+{
+	IMG_UINT32 ui32Data = 0;
+	IMG_UINT32 ui32Chunk;
+	IMG_UINT8 *pui8Data;
 
-		/* Update read pointer now that we've copied the data out */
-		psStream->ui32RPtr += ui32Data;
+	/*
+		Copy out one contiguous block at a time, so at most twice when the
+		unread data wraps around the end of the circular buffer.
+	*/
+	while (ui32Data < ui32OutBuffSize)
+	{
+		ui32Chunk = DBGDrivAcquireRead(psMainStream, bReadInitBuffer, &pui8Data);
+		if (ui32Chunk == 0)
+		{
+			break;
+		}
 
-		/* Check for wrapping */
-		if (psStream->ui32RPtr == psStream->ui32Size)
+		/*
+			Only transfer what target buffer can handle.
+		*/
+		if (ui32Chunk > (ui32OutBuffSize - ui32Data))
 		{
-			psStream->ui32RPtr = 0;
+			ui32Chunk = ui32OutBuffSize - ui32Data;
 		}
+
+		HostMemCopy((IMG_VOID *)(pui8OutBuf + ui32Data),
+				(IMG_VOID *) pui8Data,
+				ui32Chunk);
+
+		DBGDrivReleaseRead(psMainStream, bReadInitBuffer, ui32Chunk);
+		ui32Data += ui32Chunk;
 	}
 
 	return(ui32Data);
@@ -2641,6 +2891,71 @@ IMG_UINT32 IMG_CALLCONV DBGDrivGetMarker(PDBG_STREAM psStream)
 	return psStream->ui32Marker;
 }
 
+/*!****************************************************************************
+ @name		DBGDrivGetStreamFlags
+ @brief		Gets the stream flags, including whether it is compressed
+ @param		psStream - stream
+ @return	DEBUG_FLAGS value
+*****************************************************************************/
+IMG_UINT32 IMG_CALLCONV DBGDrivGetStreamFlags(PDBG_STREAM psStream)
+{
+	/*
+		Validate buffer
+	*/
+	if (!StreamValid(psStream))
+	{
+		return 0;
+	}
+
+	return psStream->psCtrl->ui32Flags;
+}
+
+/*!****************************************************************************
+ @name		DBGDrivSetStreamFlags
+ @brief		Turns compression of the main buffer on or off for the reader.
+			The encoding only changes while no unread data is left, so the
+			reader knows everything it reads afterwards is in the new format.
+ @param		psStream - stream
+ @param		ui32Flags - DEBUG_FLAGS_COMPRESSED or 0, other flags are ignored
+ @return	IMG_TRUE if the stream now uses the requested encoding
+*****************************************************************************/
+IMG_BOOL IMG_CALLCONV DBGDrivSetStreamFlags(PDBG_STREAM psStream, IMG_UINT32 ui32Flags)
+{
+	IMG_BOOL bCompressed = (ui32Flags & DEBUG_FLAGS_COMPRESSED) ? IMG_TRUE : IMG_FALSE;
+
+	/*
+		Validate buffer
+	*/
+	if (!StreamValid(psStream))
+	{
+		return IMG_FALSE;
+	}
+
+	if (psStream->bCompressed == bCompressed)
+	{
+		return IMG_TRUE;
+	}
+
+	if (psStream->ui32RPtr != psStream->ui32WPtr)
+	{
+		PVR_DPF((PVR_DBGDRIV_MESSAGE, "DBGDrivSetStreamFlags: %s has unread data", psStream->szName));
+		return IMG_FALSE;
+	}
+
+	psStream->bCompressed = bCompressed;
+
+	if (bCompressed)
+	{
+		psStream->psCtrl->ui32Flags |= DEBUG_FLAGS_COMPRESSED;
+	}
+	else
+	{
+		psStream->psCtrl->ui32Flags &= ~DEBUG_FLAGS_COMPRESSED;
+	}
+
+	return IMG_TRUE;
+}
+
 
 /*!****************************************************************************
  @name		DBGDrivGetStreamOffset
@@ -67,6 +67,12 @@ IMG_VOID * IMG_CALLCONV DBGDrivCreateStream(IMG_CHAR *pszName, IMG_UINT32 ii32Ca
  */
 IMG_UINT32 IMG_CALLCONV DBGDrivRead(PDBG_STREAM psMainStream, IMG_BOOL bReadInitBuffer, IMG_UINT32 ui32OutBuffSize,IMG_UINT8 * pui8OutBuf);
 
+/* Called by Linux debug driver main.c, under the API mutex, to copy stream
+ * data straight to the caller without staging it in the IOCTL read buffer
+ */
+IMG_UINT32 IMG_CALLCONV DBGDrivAcquireRead(PDBG_STREAM psMainStream, IMG_BOOL bReadInitBuffer, IMG_UINT8 **ppui8Data);
+IMG_VOID   IMG_CALLCONV DBGDrivReleaseRead(PDBG_STREAM psMainStream, IMG_BOOL bReadInitBuffer, IMG_UINT32 ui32Consumed);
+
 /* Called by WDDM debug driver win7/hostfunc.c */
 IMG_VOID   IMG_CALLCONV DBGDrivSetDebugLevel(PDBG_STREAM psStream,IMG_UINT32 ui32DebugLevel);
 
@@ -131,6 +137,8 @@ IMG_VOID   IMG_CALLCONV ExtDBGDrivWaitForEvent(DBG_EVENT eEvent);
 IMG_VOID   IMG_CALLCONV ExtDBGDrivSetConnectNotifier(DBGKM_CONNECT_NOTIFIER fn_notifier);
 IMG_UINT32 IMG_CALLCONV ExtDBGDrivWritePersist(PDBG_STREAM psStream,IMG_UINT8 *pui8InBuf,IMG_UINT32 ui32InBuffSize,IMG_UINT32 ui32Level);
 IMG_UINT32 IMG_CALLCONV ExtDBGDrivGetCtrlState(PDBG_STREAM psStream, IMG_UINT32 ui32StateID);
+IMG_UINT32 IMG_CALLCONV ExtDBGDrivGetStreamFlags(PDBG_STREAM psStream);
+IMG_BOOL   IMG_CALLCONV ExtDBGDrivSetStreamFlags(PDBG_STREAM psStream, IMG_UINT32 ui32Flags);
 
 #endif
 
@@ -46,7 +46,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  Global vars
 *****************************************************************************/
 
-#define MAX_DBGVXD_W32_API 25
+#define MAX_DBGVXD_W32_API 26
 
 extern IMG_UINT32 (*g_DBGDrivProc[MAX_DBGVXD_W32_API])(IMG_VOID *, IMG_VOID *);
 
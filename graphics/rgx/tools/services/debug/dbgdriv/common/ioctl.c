@@ -888,6 +888,69 @@ static IMG_UINT32 DBGDIOCDrivWaitForEvent(IMG_VOID * pvInBuffer, IMG_VOID * pvOu
 	return(IMG_TRUE);
 }
 
+/*****************************************************************************
+ FUNCTION	: DBGDIOCDrivGetStreamFlags
+
+ PURPOSE	: Gets the stream flags so a reader can tell if it is compressed
+
+ PARAMETERS	: pvInBuffer, pvOutBuffer
+
+ RETURNS	: success
+*****************************************************************************/
+static IMG_UINT32 DBGDIOCDrivGetStreamFlags(IMG_VOID * pvInBuffer, IMG_VOID * pvOutBuffer)
+{
+	PDBG_STREAM  psStream;
+	IMG_UINT32  *pui32Flags;
+
+	pui32Flags = (IMG_UINT32 *) pvOutBuffer;
+
+	psStream = SID2PStream(*(IMG_SID *)pvInBuffer);
+	if (psStream != (PDBG_STREAM)IMG_NULL)
+	{
+		*pui32Flags = ExtDBGDrivGetStreamFlags(psStream);
+		return(IMG_TRUE);
+	}
+	else
+	{
+		/* invalid SID */
+		*pui32Flags = 0;
+		return(IMG_FALSE);
+	}
+}
+
+/*****************************************************************************
+ FUNCTION	: DBGDIOCDrivSetStreamFlags
+
+ PURPOSE	: Lets a reader ask for a compressed stream
+
+ PARAMETERS	: pvInBuffer, pvOutBuffer
+
+ RETURNS	: success
+*****************************************************************************/
+static IMG_UINT32 DBGDIOCDrivSetStreamFlags(IMG_VOID * pvInBuffer, IMG_VOID * pvOutBuffer)
+{
+	PDBG_IN_SETSTREAMFLAGS	psParams;
+	PDBG_STREAM				psStream;
+	IMG_UINT32				*pui32Set;
+
+	psParams = (PDBG_IN_SETSTREAMFLAGS) pvInBuffer;
+	pui32Set = (IMG_UINT32 *) pvOutBuffer;
+
+	psStream = SID2PStream(psParams->hStream);
+	if (psStream != (PDBG_STREAM)IMG_NULL)
+	{
+		/* Fails while unread data is pending, the reader drains and retries */
+		*pui32Set = ExtDBGDrivSetStreamFlags(psStream, psParams->ui32Flags);
+		return(IMG_TRUE);
+	}
+	else
+	{
+		/* invalid SID */
+		*pui32Set = IMG_FALSE;
+		return(IMG_FALSE);
+	}
+}
+
 /*
 	ioctl interface jump table.
 	Accessed from the UM debug driver client and from WDDM KMD server
@@ -917,7 +980,9 @@ IMG_UINT32 (*g_DBGDrivProc[])(IMG_VOID *, IMG_VOID *) =
 	DBGDIOCDrivIsCaptureFrame,  /* Not used by umdbgdrvlnx */
 	DBGDIOCDrivWriteLF,         /* Not used by umdbgdrvlnx */
 	DBGDIOCDrivReadLF,
-	DBGDIOCDrivWaitForEvent
+	DBGDIOCDrivWaitForEvent,
+	DBGDIOCDrivGetStreamFlags,
+	DBGDIOCDrivSetStreamFlags
 };
 
 /*****************************************************************************
@@ -47,7 +47,6 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <linux/pci.h>
 #include <linux/list.h>
 #include <linux/init.h>
-#include <linux/vmalloc.h>
 #include <linux/version.h>
 
 #if defined(LDM_PLATFORM) && !defined(SUPPORT_DRM)
@@ -117,16 +116,6 @@ static struct file_operations dbgdrv_fops =
 
 #endif  /* defined(SUPPORT_DRM) */
 
-/* Outward temp buffer used by ICOTL handler allocated once and grows as needed.
- * This optimisation means the debug driver performs less vmallocs/vfrees
- * reducing the chance of kernel Vmalloc space exhaustion.
- * but is not multi-threaded optimised as it now uses a mutex to protect this
- * shared buffer serialising buffer reads. However the PDump client is not
- * multi-threaded at the moment.
- */
-static IMG_CHAR*  g_outTmpBuf = IMG_NULL;
-static IMG_UINT32 g_outTmpBufSize = 64*PAGE_SIZE;
-
 IMG_VOID DBGDrvGetServiceTable(IMG_VOID **fn_table);
 
 IMG_VOID DBGDrvGetServiceTable(IMG_VOID **fn_table)
@@ -142,12 +131,6 @@ void dbgdrv_cleanup(void)
 void cleanup_module(void)
 #endif
 {
-	if (g_outTmpBuf)
-	{
-		vfree(g_outTmpBuf);
-		g_outTmpBuf = IMG_NULL;
-	}
-
 #if !defined(SUPPORT_DRM)
 	device_destroy(psDbgDrvClass, MKDEV(AssignedMajorNumber, 0));
 	class_destroy(psDbgDrvClass);
@@ -273,6 +256,8 @@ long dbgdrv_ioctl(struct file *file, unsigned int ioctlCmd, unsigned long arg)
 		IMG_UINT32 *pui32BytesCopied = (IMG_UINT32 *)out;
 		DBG_IN_READ *psReadInParams = (DBG_IN_READ *)in;
 		PDBG_STREAM psStream;
+		IMG_UINT8 *pui8Data;
+		IMG_UINT32 ui32Chunk;
 
 		psStream = SID2PStream(psReadInParams->hStream);
 		if (!psStream)
@@ -280,33 +265,38 @@ long dbgdrv_ioctl(struct file *file, unsigned int ioctlCmd, unsigned long arg)
 			goto init_failed;
 		}
 
+		/* The API mutex keeps the stream buffer in place while it is copied
+		 * straight to the caller, one contiguous block at a time.
+		 */
 		HostAquireMutex(g_pvAPIMutex);
 
-		if ((g_outTmpBuf == IMG_NULL) || (psReadInParams->ui32OutBufferSize > g_outTmpBufSize))
+		*pui32BytesCopied = 0;
+
+		while (*pui32BytesCopied < psReadInParams->ui32OutBufferSize)
 		{
-			if (psReadInParams->ui32OutBufferSize > g_outTmpBufSize)
+			ui32Chunk = DBGDrivAcquireRead(psStream,
+										   psReadInParams->bReadInitBuffer,
+										   &pui8Data);
+			if (ui32Chunk == 0)
 			{
-				g_outTmpBufSize = psReadInParams->ui32OutBufferSize;
+				break;
 			}
-			g_outTmpBuf = vmalloc(g_outTmpBufSize);
-			if (!g_outTmpBuf)
+
+			if (ui32Chunk > (psReadInParams->ui32OutBufferSize - *pui32BytesCopied))
+			{
+				ui32Chunk = psReadInParams->ui32OutBufferSize - *pui32BytesCopied;
+			}
+
+			if (pvr_copy_to_user(psReadInParams->u.pui8OutBuffer + *pui32BytesCopied,
+							pui8Data,
+							ui32Chunk) != 0)
 			{
 				HostReleaseMutex(g_pvAPIMutex);
 				goto init_failed;
 			}
-		}
 
-		*pui32BytesCopied = DBGDrivRead(psStream,
-										   psReadInParams->bReadInitBuffer,
-										   psReadInParams->ui32OutBufferSize,
-										   g_outTmpBuf);
-
-		if (pvr_copy_to_user(psReadInParams->u.pui8OutBuffer,
-						g_outTmpBuf,
-						*pui32BytesCopied) != 0)
-		{
-			HostReleaseMutex(g_pvAPIMutex);
-			goto init_failed;
+			DBGDrivReleaseRead(psStream, psReadInParams->bReadInitBuffer, ui32Chunk);
+			*pui32BytesCopied += ui32Chunk;
 		}
 
 		HostReleaseMutex(g_pvAPIMutex);